@@ -36,6 +36,10 @@ type Processor struct {
 	handle *Handle
 	config Config
 	mu     sync.Mutex
+
+	// statsMu only guards the handle against Close, so that GetStats never
+	// waits for a frame being processed under mu.
+	statsMu sync.RWMutex
 }
 
 // New creates a new audio processor with the given configuration
@@ -65,6 +69,17 @@ func (p *Processor) Initialize() {
 	p.handle.Initialize()
 }
 
+// NumSamplesPerFrame returns the number of samples per channel in one 10ms frame
+func (p *Processor) NumSamplesPerFrame() int {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return 0
+	}
+	return p.handle.NumSamplesPerFrame()
+}
+
 // ProcessCapture processes microphone input (near-end signal)
 // Returns processed audio and voice activity detection result
 // Input samples should be float32 in range [-1.0, 1.0]
@@ -115,6 +130,166 @@ func (p *Processor) ProcessRenderInt16(samples []int16) error {
 	return p.handle.ProcessRenderIntFrame(samples, p.config.RenderChannels)
 }
 
+// ProcessCapturePlanar processes microphone input given as one slice per channel
+func (p *Processor) ProcessCapturePlanar(channels [][]float32) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.ProcessCapturePlanar(channels)
+}
+
+// ProcessRenderPlanar provides speaker output given as one slice per channel
+func (p *Processor) ProcessRenderPlanar(channels [][]float32) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.ProcessRenderPlanar(channels)
+}
+
+// PushCapture accepts microphone input in chunks of any length; processed
+// audio becomes available through PullCapture
+func (p *Processor) PushCapture(samples []float32) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.PushCapture(samples, p.config.CaptureChannels)
+}
+
+// PullCapture reads processed microphone audio and returns the number of
+// samples per channel copied into samples
+func (p *Processor) PullCapture(samples []float32) (int, error) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return 0, fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.PullCapture(samples, p.config.CaptureChannels)
+}
+
+// PushRender accepts speaker output in chunks of any length
+func (p *Processor) PushRender(samples []float32) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.PushRender(samples, p.config.RenderChannels)
+}
+
+// ProcessCaptureBatch processes several consecutive 10ms capture frames in one call
+func (p *Processor) ProcessCaptureBatch(samples []float32) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.ProcessCaptureFrames(samples, p.config.CaptureChannels)
+}
+
+// ProcessCaptureBatchInt16 processes several consecutive int16 capture frames in one call
+func (p *Processor) ProcessCaptureBatchInt16(samples []int16) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.ProcessCaptureIntFrames(samples, p.config.CaptureChannels)
+}
+
+// ProcessRenderBatch provides several consecutive 10ms render frames in one call
+func (p *Processor) ProcessRenderBatch(samples []float32) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.ProcessRenderFrames(samples, p.config.RenderChannels)
+}
+
+// ProcessRenderBatchInt16 provides several consecutive int16 render frames in one call
+func (p *Processor) ProcessRenderBatchInt16(samples []int16) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.ProcessRenderIntFrames(samples, p.config.RenderChannels)
+}
+
+// ProcessDuplex provides the speaker frame and processes the matching
+// microphone frame in one call, returning the statistics after processing
+func (p *Processor) ProcessDuplex(render, capture []float32) (Stats, error) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return Stats{}, fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.ProcessDuplexFrame(render, p.config.RenderChannels, capture, p.config.CaptureChannels)
+}
+
+// ProcessDuplexInt16 is ProcessDuplex with int16 samples
+func (p *Processor) ProcessDuplexInt16(render, capture []int16) (Stats, error) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return Stats{}, fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.ProcessDuplexIntFrame(render, p.config.RenderChannels, capture, p.config.CaptureChannels)
+}
+
+// SaveState captures the converged echo canceller and AGC state, e.g. before
+// migrating the call to another node
+func (p *Processor) SaveState() ([]byte, error) {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return nil, fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.SaveState()
+}
+
+// LoadState resumes from state saved by a processor with the same config
+func (p *Processor) LoadState(state []byte) error {
+	p.mu.Lock()
+	defer p.mu.Unlock()
+
+	if p.handle == nil {
+		return fmt.Errorf("processor is closed")
+	}
+
+	return p.handle.LoadState(state)
+}
+
 func (p *Processor) SetStreamAnalogLevel(level int) {
 	p.mu.Lock()
 	defer p.mu.Unlock()
@@ -158,10 +333,11 @@ func (p *Processor) StreamDelay() int {
 	return p.handle.StreamDelayMs()
 }
 
-// GetStats returns statistics from the last ProcessCapture call
+// GetStats returns statistics from the last ProcessCapture call. It may be
+// called concurrently with processing and never delays it.
 func (p *Processor) GetStats() Stats {
-	p.mu.Lock()
-	defer p.mu.Unlock()
+	p.statsMu.RLock()
+	defer p.statsMu.RUnlock()
 
 	if p.handle == nil {
 		return Stats{}
@@ -196,6 +372,8 @@ func (p *Processor) SetKeyPressed(pressed bool) {
 func (p *Processor) Close() error {
 	p.mu.Lock()
 	defer p.mu.Unlock()
+	p.statsMu.Lock()
+	defer p.statsMu.Unlock()
 
 	if p.handle != nil {
 		p.handle.Destroy()
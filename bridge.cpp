@@ -1,8 +1,13 @@
 // apm_wrapper.cpp - C++ implementation of the C wrapper for WebRTC AudioProcessing
 
 #include <bridge.h>
+#include <interleave.h>
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #ifndef WEBRTC_POSIX
@@ -15,10 +20,32 @@
 
 #include <google.com/webrtc/audio_processing/include/audio_processing.h>
 #include <google.com/webrtc/api/audio/builtin_audio_processing_builder.h>
+#include <google.com/webrtc/api/audio/echo_canceller3_config.h>
 #include <google.com/webrtc/api/environment/environment_factory.h>
+#include <google.com/webrtc/audio_processing/aec3/shared_render_analysis.h>
+#include <google.com/webrtc/common_audio/ring_buffer.h>
 
 namespace {
 
+    struct RingBufferDeleter {
+        void operator()(RingBuffer *buffer) const { WebRtc_FreeBuffer(buffer); }
+    };
+
+    using RingBufferPtr = std::unique_ptr<RingBuffer, RingBufferDeleter>;
+
+// Reframing state for the streaming API. One ring element is one sample
+// instant across all channels. Allocated on first use.
+    struct StreamState {
+        // Samples waiting for a complete 10ms frame, at most one frame
+        RingBufferPtr capture_input;
+        RingBufferPtr render_input;
+        // Processed capture samples waiting to be pulled
+        RingBufferPtr capture_output;
+        // Staging for a frame read across the ring's wrap point, and output
+        std::vector<float> frame;
+        std::vector<float> processed;
+    };
+
 // Internal structure holding the processor state
     struct AudioProcessor {
         webrtc::scoped_refptr<webrtc::AudioProcessing> processor;
@@ -26,37 +53,34 @@ namespace {
         webrtc::StreamConfig render_stream_config;
         int capture_channels{};
         int render_channels{};
+        int sample_rate_hz{};
+        int num_samples_per_frame{};
 
         // Buffers for deinterleaved audio
         std::vector<std::vector<float>> capture_buffer;
         std::vector<std::vector<float>> render_buffer;
         std::vector<float *> capture_ptrs;
         std::vector<float *> render_ptrs;
-    };
 
-// Helper to deinterleave audio from interleaved to channel-separated format
-    template<typename T>
-    typename std::enable_if<std::is_arithmetic<T>::value>::type
-    deinterleave(const T *src, std::vector<std::vector<T>> &dst,
-                 int num_channels, int num_samples) {
-        for (int ch = 0; ch < num_channels; ++ch) {
-            for (int i = 0; i < num_samples; ++i) {
-                dst[ch][i] = src[i * num_channels + ch];
-            }
-        }
-    }
+        // Kernel set used to stage interleaved frames, detected at creation
+        apm::InterleaveOptimization interleave_optimization{};
 
-// Helper to interleave audio from channel-separated to interleaved format
-    template<typename T>
-    typename std::enable_if<std::is_arithmetic<T>::value>::type
-    interleave(const std::vector<std::vector<T>> &src, T *dst,
-               int num_channels, int num_samples) {
-        for (int ch = 0; ch < num_channels; ++ch) {
-            for (int i = 0; i < num_samples; ++i) {
-                dst[i * num_channels + ch] = src[ch][i];
-            }
-        }
-    }
+        // Configuration last handed to the processor, for diffing in ApplyConfig
+        webrtc::AudioProcessing::Config config;
+        // Set while posted runtime gains wait for the capture frame applying them
+        bool runtime_gains_pending = false;
+        // The same configuration as given by the caller, for CreateLike
+        ApmConfig apm_config{};
+        // Render analysis shared with the other processors of its group, if any
+        std::shared_ptr<webrtc::SharedRenderAnalysis> render_group;
+
+        std::unique_ptr<StreamState> stream;
+    };
+
+    struct RenderGroup {
+        std::shared_ptr<webrtc::SharedRenderAnalysis> analysis =
+                std::make_shared<webrtc::SharedRenderAnalysis>();
+    };
 
     webrtc::AudioProcessing::Config parseConfig(ApmConfig apmConfig) {
         webrtc::AudioProcessing::Config config;
@@ -64,6 +88,8 @@ namespace {
         // High pass filter
         config.high_pass_filter.enabled = apmConfig.high_pass_filter_enabled;
 
+        config.pipeline.multi_channel_capture = apmConfig.multi_channel_capture;
+
         // Capture level adjustment
         config.capture_level_adjustment.enabled = apmConfig.capture_level_adjustment.enabled;
         if (config.capture_level_adjustment.enabled) {
@@ -98,32 +124,418 @@ namespace {
         return config;
     }
 
+// Shortest refined filter AEC3 supports: its reverb decay estimator analyzes
+// the blocks past the first 3 in sections of 6.
+    constexpr int kMinRefinedLengthBlocks = 9;
+
+// Maps the tuning onto the WebRTC defaults. Returns false if the result is not
+// a valid configuration.
+    bool parseEchoCanceller3Config(const ApmEchoCanceller3Config &apmConfig,
+                                   webrtc::EchoCanceller3Config *config) {
+        if (apmConfig.refined_length_blocks < kMinRefinedLengthBlocks || apmConfig.coarse_length_blocks <= 0 ||
+            apmConfig.refined_initial_length_blocks <= 0 || apmConfig.coarse_initial_length_blocks <= 0 ||
+            apmConfig.down_sampling_factor <= 0 || apmConfig.num_filters <= 0 || apmConfig.erle_num_sections <= 0) {
+            return false;
+        }
+        config->filter.refined.length_blocks = apmConfig.refined_length_blocks;
+        config->filter.coarse.length_blocks = apmConfig.coarse_length_blocks;
+        config->filter.refined_initial.length_blocks = apmConfig.refined_initial_length_blocks;
+        config->filter.coarse_initial.length_blocks = apmConfig.coarse_initial_length_blocks;
+        config->filter.adaptive_length = apmConfig.adaptive_filter_length;
+        config->delay.down_sampling_factor = apmConfig.down_sampling_factor;
+        config->delay.num_filters = apmConfig.num_filters;
+        config->delay.estimator = apmConfig.delay_estimator == AEC3_DELAY_ESTIMATOR_FFT_CORRELATION
+                                  ? webrtc::EchoCanceller3Config::Delay::Estimator::kFftCorrelation
+                                  : webrtc::EchoCanceller3Config::Delay::Estimator::kMatchedFilter;
+        config->erle.num_sections = apmConfig.erle_num_sections;
+        config->echo_removal_control.idle_during_inactive_render = apmConfig.idle_during_inactive_render;
+        config->delay.compensate_clock_drift = apmConfig.compensate_clock_drift;
+        // Validate() clamps what is out of range and reports it
+        return webrtc::EchoCanceller3Config::Validate(config);
+    }
+
+// Returns true if a and b differ at most in the gains APM can update through
+// runtime settings, without re-creating any submodule.
+    bool onlyRuntimeGainsDiffer(const webrtc::AudioProcessing::Config &a,
+                                const webrtc::AudioProcessing::Config &b) {
+        webrtc::AudioProcessing::Config adjusted = b;
+        if (a.gain_controller2.enabled && b.gain_controller2.enabled) {
+            adjusted.gain_controller2.fixed_digital.gain_db = a.gain_controller2.fixed_digital.gain_db;
+        }
+        if (a.capture_level_adjustment.enabled && b.capture_level_adjustment.enabled) {
+            adjusted.capture_level_adjustment.pre_gain_factor = a.capture_level_adjustment.pre_gain_factor;
+            adjusted.capture_level_adjustment.post_gain_factor = a.capture_level_adjustment.post_gain_factor;
+        }
+        return a.pipeline.maximum_internal_processing_rate == adjusted.pipeline.maximum_internal_processing_rate &&
+               a.pipeline.multi_channel_render == adjusted.pipeline.multi_channel_render &&
+               a.pipeline.multi_channel_capture == adjusted.pipeline.multi_channel_capture &&
+               a.pipeline.capture_downmix_method == adjusted.pipeline.capture_downmix_method &&
+               a.pre_amplifier.enabled == adjusted.pre_amplifier.enabled &&
+               a.pre_amplifier.fixed_gain_factor == adjusted.pre_amplifier.fixed_gain_factor &&
+               a.capture_level_adjustment == adjusted.capture_level_adjustment &&
+               a.high_pass_filter.enabled == adjusted.high_pass_filter.enabled &&
+               a.high_pass_filter.apply_in_full_band == adjusted.high_pass_filter.apply_in_full_band &&
+               a.echo_canceller.enabled == adjusted.echo_canceller.enabled &&
+               a.echo_canceller.mobile_mode == adjusted.echo_canceller.mobile_mode &&
+               a.echo_canceller.enforce_high_pass_filtering == adjusted.echo_canceller.enforce_high_pass_filtering &&
+               a.noise_suppression.enabled == adjusted.noise_suppression.enabled &&
+               a.noise_suppression.level == adjusted.noise_suppression.level &&
+               a.noise_suppression.analyze_linear_aec_output_when_available ==
+               adjusted.noise_suppression.analyze_linear_aec_output_when_available &&
+               a.transient_suppression.enabled == adjusted.transient_suppression.enabled &&
+               a.gain_controller1 == adjusted.gain_controller1 &&
+               a.gain_controller2 == adjusted.gain_controller2;
+    }
+
+// Hands the gains of config to APM as runtime settings, only those that
+// differ from ap->config unless all is set. They are queued without taking
+// APM's locks and applied at the start of the next capture frame. Returns
+// false if the queue is full.
+    bool postRuntimeGains(AudioProcessor *ap, const webrtc::AudioProcessing::Config &config, bool all) {
+        using RuntimeSetting = webrtc::AudioProcessing::RuntimeSetting;
+        const webrtc::AudioProcessing::Config &current = ap->config;
+        bool posted = true;
+        if (config.gain_controller2.enabled &&
+            (all || config.gain_controller2.fixed_digital.gain_db != current.gain_controller2.fixed_digital.gain_db)) {
+            posted &= ap->processor->PostRuntimeSetting(
+                    RuntimeSetting::CreateCaptureFixedPostGain(config.gain_controller2.fixed_digital.gain_db));
+        }
+        if (config.capture_level_adjustment.enabled &&
+            (all || config.capture_level_adjustment.pre_gain_factor !=
+                    current.capture_level_adjustment.pre_gain_factor)) {
+            posted &= ap->processor->PostRuntimeSetting(
+                    RuntimeSetting::CreateCapturePreGain(config.capture_level_adjustment.pre_gain_factor));
+        }
+        if (config.capture_level_adjustment.enabled &&
+            (all || config.capture_level_adjustment.post_gain_factor !=
+                    current.capture_level_adjustment.post_gain_factor)) {
+            posted &= ap->processor->PostRuntimeSetting(
+                    RuntimeSetting::CreateCapturePostGain(config.capture_level_adjustment.post_gain_factor));
+        }
+        return posted;
+    }
+
+// Processes the deinterleaved capture channels in place. The runtime settings
+// queued so far are applied at its start.
+    int processStream(AudioProcessor *ap, float *const *channels) {
+        int result = ap->processor->ProcessStream(
+                channels,
+                ap->capture_stream_config,
+                ap->capture_stream_config,
+                channels);
+        if (result == webrtc::AudioProcessing::kNoError) {
+            ap->runtime_gains_pending = false;
+        }
+        return result;
+    }
+
+// Processes one interleaved capture frame from src into dst, which may alias.
+// Channel count is validated by the caller.
+    int processCaptureFrame(AudioProcessor *ap, const float *src, float *dst) {
+        // Deinterleave input
+        apm::Deinterleave(ap->interleave_optimization, src, ap->capture_ptrs.data(),
+                          ap->capture_channels, ap->num_samples_per_frame);
+
+        // Process
+        int result = processStream(ap, ap->capture_ptrs.data());
+
+        if (result == webrtc::AudioProcessing::kNoError) {
+            // Interleave output back
+            apm::Interleave(ap->interleave_optimization, ap->capture_ptrs.data(), dst,
+                            ap->capture_channels, ap->num_samples_per_frame);
+        }
+
+        return result;
+    }
+
+    int processCaptureFrame(AudioProcessor *ap, float *samples) {
+        return processCaptureFrame(ap, samples, samples);
+    }
+
+// int16 frames are converted while they are staged and processed as float
+// frames, so that both sample formats give the same output.
+    int processCaptureFrame(AudioProcessor *ap, int16_t *samples) {
+        apm::DeinterleaveS16ToFloat(ap->interleave_optimization, samples, ap->capture_ptrs.data(),
+                                    ap->capture_channels, ap->num_samples_per_frame);
+
+        int result = processStream(ap, ap->capture_ptrs.data());
+
+        if (result == webrtc::AudioProcessing::kNoError) {
+            apm::InterleaveFloatToS16(ap->interleave_optimization, ap->capture_ptrs.data(), samples,
+                                      ap->capture_channels, ap->num_samples_per_frame);
+        }
+
+        return result;
+    }
+
+// Processes one interleaved render frame from src into dst, which may alias.
+// dst may be NULL when the processed render signal is not needed. Channel
+// count is validated by the caller.
+    int processRenderFrame(AudioProcessor *ap, const float *src, float *dst) {
+        // Deinterleave input
+        apm::Deinterleave(ap->interleave_optimization, src, ap->render_ptrs.data(),
+                          ap->render_channels, ap->num_samples_per_frame);
+
+        // Process reverse stream
+        int result = ap->processor->ProcessReverseStream(
+                ap->render_ptrs.data(),
+                ap->render_stream_config,
+                ap->render_stream_config,
+                ap->render_ptrs.data());
+
+        if (result == webrtc::AudioProcessing::kNoError && dst) {
+            // Interleave output back
+            apm::Interleave(ap->interleave_optimization, ap->render_ptrs.data(), dst,
+                            ap->render_channels, ap->num_samples_per_frame);
+        }
+
+        return result;
+    }
+
+    int processRenderFrame(AudioProcessor *ap, float *samples) {
+        return processRenderFrame(ap, samples, samples);
+    }
+
+    int processRenderFrame(AudioProcessor *ap, int16_t *samples) {
+        apm::DeinterleaveS16ToFloat(ap->interleave_optimization, samples, ap->render_ptrs.data(),
+                                    ap->render_channels, ap->num_samples_per_frame);
+
+        int result = ap->processor->ProcessReverseStream(
+                ap->render_ptrs.data(),
+                ap->render_stream_config,
+                ap->render_stream_config,
+                ap->render_ptrs.data());
+
+        if (result == webrtc::AudioProcessing::kNoError) {
+            apm::InterleaveFloatToS16(ap->interleave_optimization, ap->render_ptrs.data(), samples,
+                                      ap->render_channels, ap->num_samples_per_frame);
+        }
+
+        return result;
+    }
+
+// Walks num_frames consecutive interleaved 10ms frames. Every frame is
+// processed even if an earlier one fails; per-frame results go to
+// error_codes (if non-null) and the first failure is returned.
+    template<typename T>
+    int processBatch(AudioProcessor *ap, T *samples, int num_frames, int num_channels, int *error_codes,
+                     int (*process)(AudioProcessor *, T *)) {
+        const int frame_length = num_channels * ap->num_samples_per_frame;
+        int result = webrtc::AudioProcessing::kNoError;
+        for (int i = 0; i < num_frames; ++i) {
+            int code = process(ap, samples + i * frame_length);
+            if (error_codes) error_codes[i] = code;
+            if (result == webrtc::AudioProcessing::kNoError) result = code;
+        }
+        return result;
+    }
+
+    StreamState *streamState(AudioProcessor *ap) {
+        if (!ap->stream) {
+            auto stream = std::make_unique<StreamState>();
+            const size_t frame = ap->num_samples_per_frame;
+            const size_t max_buffered = ap->sample_rate_hz * APM_STREAM_MAX_BUFFERED_MS / 1000;
+            stream->capture_input.reset(WebRtc_CreateBuffer(frame, ap->capture_channels * sizeof(float)));
+            stream->render_input.reset(WebRtc_CreateBuffer(frame, ap->render_channels * sizeof(float)));
+            stream->capture_output.reset(WebRtc_CreateBuffer(max_buffered, ap->capture_channels * sizeof(float)));
+            if (!stream->capture_input || !stream->render_input || !stream->capture_output) return nullptr;
+            stream->frame.resize(frame * std::max(ap->capture_channels, ap->render_channels));
+            stream->processed.resize(frame * ap->capture_channels);
+            ap->stream = std::move(stream);
+        }
+        return ap->stream.get();
+    }
+
+// Appends num_frames samples per channel to input and runs process on every
+// 10ms frame that completes. Returns the first frame error.
+    template<typename Process>
+    int pushStream(AudioProcessor *ap, RingBuffer *input, const float *samples, int num_frames, int num_channels,
+                   Process process) {
+        StreamState *stream = ap->stream.get();
+        const size_t frame = ap->num_samples_per_frame;
+        int result = webrtc::AudioProcessing::kNoError;
+        while (num_frames > 0) {
+            size_t written = WebRtc_WriteBuffer(input, samples, std::min<size_t>(num_frames, WebRtc_available_write(input)));
+            samples += written * num_channels;
+            num_frames -= static_cast<int>(written);
+            if (WebRtc_available_read(input) < frame) break;
+
+            void *data = nullptr;
+            WebRtc_ReadBuffer(input, &data, stream->frame.data(), frame);
+            int code = process(static_cast<const float *>(data));
+            if (result == webrtc::AudioProcessing::kNoError) result = code;
+        }
+        return result;
+    }
+
+    ApmStageTiming toStageTiming(const std::optional<webrtc::AudioProcessingStats::StageTiming> &timing) {
+        ApmStageTiming result = {};
+        if (timing) {
+            result.min_ns = timing->min_ns;
+            result.mean_ns = timing->mean_ns;
+            result.p99_ns = timing->p99_ns;
+        }
+        return result;
+    }
+
+    void fillStats(AudioProcessor *ap, ApmStats *stats) {
+        webrtc::AudioProcessingStats s = ap->processor->GetStatistics();
+        // Echo detection
+        stats->echo_return_loss = s.echo_return_loss.value_or(0.0);
+        stats->echo_return_loss_enhancement = s.echo_return_loss_enhancement.value_or(0.0);
+        stats->divergent_filter_fraction = s.divergent_filter_fraction.value_or(0.0);
+        stats->residual_echo_likelihood = s.residual_echo_likelihood.value_or(0.0);
+
+        // Delay
+        stats->delay_median_ms = s.delay_median_ms.value_or(0);
+        stats->delay_std_ms = s.delay_standard_deviation_ms.value_or(0);
+        stats->delay_ms = s.delay_ms.value_or(0);
+        stats->linear_filter_length_ms = s.linear_filter_length_ms.value_or(0);
+
+        // Processing timings
+        stats->capture_processing_time = toStageTiming(s.capture_processing_time);
+        stats->capture_band_split_time = toStageTiming(s.capture_band_split_time);
+        stats->high_pass_filter_time = toStageTiming(s.high_pass_filter_time);
+        stats->echo_controller_time = toStageTiming(s.echo_controller_time);
+        stats->noise_suppressor_time = toStageTiming(s.noise_suppressor_time);
+        stats->gain_controller2_time = toStageTiming(s.gain_controller2_time);
+        stats->render_processing_time = toStageTiming(s.render_processing_time);
+        stats->render_band_split_time = toStageTiming(s.render_band_split_time);
+        stats->render_analysis_time = toStageTiming(s.render_analysis_time);
+    }
+
+// Feeds one render frame, then processes one capture frame. The capture frame
+// is processed even if the render frame is rejected so the near-end stream
+// never stalls; the render error takes precedence in the return value.
+    template<typename T>
+    int processDuplex(AudioProcessor *ap, T *render, T *capture, ApmStats *stats) {
+        int render_result = processRenderFrame(ap, render);
+        int capture_result = processCaptureFrame(ap, capture);
+        if (stats) fillStats(ap, stats);
+        return render_result != webrtc::AudioProcessing::kNoError ? render_result : capture_result;
+    }
+
+    bool hasAllChannels(float *const *channels, int num_channels) {
+        for (int ch = 0; ch < num_channels; ++ch) {
+            if (!channels[ch]) return false;
+        }
+        return true;
+    }
+
+    bool isValidSampleRate(int sample_rate_hz) {
+        switch (sample_rate_hz) {
+            case webrtc::AudioProcessing::kSampleRate8kHz:
+            case webrtc::AudioProcessing::kSampleRate16kHz:
+            case webrtc::AudioProcessing::kSampleRate32kHz:
+            case webrtc::AudioProcessing::kSampleRate48kHz:
+                return true;
+            default:
+                return false;
+        }
+    }
+
 } // anonymous namespace
 
 extern "C" {
 
+ApmEchoCanceller3Config GetEchoCanceller3Preset(Aec3Preset preset) {
+    ApmEchoCanceller3Config config = {};
+    config.refined_length_blocks = 13;
+    config.coarse_length_blocks = 13;
+    config.refined_initial_length_blocks = 12;
+    config.coarse_initial_length_blocks = 12;
+    config.adaptive_filter_length = true;
+    config.down_sampling_factor = 4;
+    config.num_filters = 5;
+    config.delay_estimator = AEC3_DELAY_ESTIMATOR_MATCHED_FILTER;
+    config.erle_num_sections = 1;
+    config.idle_during_inactive_render = true;
+    switch (preset) {
+        case AEC3_PRESET_LOW_CPU_SERVER:
+            config.refined_length_blocks = 10;
+            config.coarse_length_blocks = 10;
+            config.refined_initial_length_blocks = 10;
+            config.coarse_initial_length_blocks = 10;
+            config.down_sampling_factor = 8;
+            config.num_filters = 3;
+            break;
+        case AEC3_PRESET_HIGH_QUALITY_DESKTOP:
+            config.refined_length_blocks = 24;
+            config.coarse_length_blocks = 24;
+            config.refined_initial_length_blocks = 16;
+            config.coarse_initial_length_blocks = 16;
+            config.num_filters = 7;
+            config.erle_num_sections = 4;
+            break;
+        default:
+            break;
+    }
+    return config;
+}
+
 ApmHandle Create(ApmConfig apmConfig, int *error_code) {
+    return CreateInRenderGroup(apmConfig, nullptr, error_code);
+}
+
+ApmRenderGroup CreateRenderGroup(void) {
+    return static_cast<ApmRenderGroup>(new RenderGroup);
+}
+
+void DestroyRenderGroup(ApmRenderGroup group) {
+    delete static_cast<RenderGroup *>(group);
+}
+
+ApmHandle CreateInRenderGroup(ApmConfig apmConfig, ApmRenderGroup group, int *error_code) {
     *error_code = 0;
     if (apmConfig.capture_channels == 0 || apmConfig.render_channels == 0) {
         *error_code = webrtc::AudioProcessing::kBadParameterError;
         return nullptr;
     }
-
-    auto *ap = new AudioProcessor;
+    int sample_rate_hz = apmConfig.sample_rate_hz == 0 ? APM_SAMPLE_RATE_HZ : apmConfig.sample_rate_hz;
+    if (!isValidSampleRate(sample_rate_hz)) {
+        *error_code = webrtc::AudioProcessing::kBadSampleRateError;
+        return nullptr;
+    }
 
     webrtc::AudioProcessing::Config config = parseConfig(apmConfig);
-    ap->processor = webrtc::BuiltinAudioProcessingBuilder(config)
-            .Build(webrtc::CreateEnvironment());
+    webrtc::BuiltinAudioProcessingBuilder builder(config);
+    // The echo canceller tuning is fixed at creation, like the channels
+    if (apmConfig.echo_cancellation.use_aec3_config || apmConfig.echo_cancellation.worker_threads != 0) {
+        webrtc::EchoCanceller3Config aec3_config;
+        aec3_config.multi_channel.num_worker_threads = apmConfig.echo_cancellation.worker_threads;
+        const bool valid = apmConfig.echo_cancellation.use_aec3_config
+                           ? parseEchoCanceller3Config(apmConfig.echo_cancellation.aec3_config, &aec3_config)
+                           : webrtc::EchoCanceller3Config::Validate(&aec3_config);
+        if (!valid) {
+            *error_code = webrtc::AudioProcessing::kBadParameterError;
+            return nullptr;
+        }
+        // Without multi_channel_capture the echo canceller sees a single channel
+        // and never starts the worker threads
+        if (apmConfig.echo_cancellation.use_aec3_config || apmConfig.multi_channel_capture) {
+            builder.SetEchoCanceller3Config(aec3_config, std::nullopt);
+        }
+    }
+    std::shared_ptr<webrtc::SharedRenderAnalysis> render_group;
+    if (group) {
+        render_group = static_cast<RenderGroup *>(group)->analysis;
+        builder.SetSharedRenderAnalysis(render_group);
+    }
+
+    auto *ap = new AudioProcessor;
+    ap->processor = builder.Build(webrtc::CreateEnvironment());
     if (!ap->processor) {
         *error_code = -2;
         delete ap;
         return nullptr;
     }
 
+    ap->sample_rate_hz = sample_rate_hz;
+    ap->num_samples_per_frame = sample_rate_hz * APM_FRAME_MS / 1000;
     ap->capture_stream_config = webrtc::StreamConfig(
-            APM_SAMPLE_RATE_HZ, apmConfig.capture_channels);
+            sample_rate_hz, apmConfig.capture_channels);
     ap->render_stream_config = webrtc::StreamConfig(
-            APM_SAMPLE_RATE_HZ, apmConfig.render_channels);
+            sample_rate_hz, apmConfig.render_channels);
 
     webrtc::ProcessingConfig pconfig = {
             ap->capture_stream_config,
@@ -134,6 +546,11 @@ ApmHandle Create(ApmConfig apmConfig, int *error_code) {
 
     ap->capture_channels = apmConfig.capture_channels;
     ap->render_channels = apmConfig.render_channels;
+    ap->interleave_optimization = apm::DetectInterleaveOptimization();
+    ap->config = config;
+    ap->apm_config = apmConfig;
+    ap->apm_config.sample_rate_hz = sample_rate_hz;
+    ap->render_group = std::move(render_group);
 
     int code = ap->processor->Initialize(pconfig);
     if (code != webrtc::AudioProcessing::kNoError) {
@@ -150,14 +567,14 @@ ApmHandle Create(ApmConfig apmConfig, int *error_code) {
     ap->capture_buffer.resize(apmConfig.capture_channels);
     ap->capture_ptrs.resize(apmConfig.capture_channels);
     for (int i = 0; i < apmConfig.capture_channels; ++i) {
-        ap->capture_buffer[i].resize(APM_NUM_SAMPLES_PER_FRAME);
+        ap->capture_buffer[i].resize(ap->num_samples_per_frame);
         ap->capture_ptrs[i] = ap->capture_buffer[i].data();
     }
 
     ap->render_buffer.resize(apmConfig.render_channels);
     ap->render_ptrs.resize(apmConfig.render_channels);
     for (int i = 0; i < apmConfig.render_channels; ++i) {
-        ap->render_buffer[i].resize(APM_NUM_SAMPLES_PER_FRAME);
+        ap->render_buffer[i].resize(ap->num_samples_per_frame);
         ap->render_ptrs[i] = ap->render_buffer[i].data();
     }
     return static_cast<ApmHandle>(ap);
@@ -178,10 +595,109 @@ void Initialize(ApmHandle handle) {
 }
 
 void ApplyConfig(ApmHandle handle, ApmConfig apmConfig) {
+    if (!handle) return;
+
     webrtc::AudioProcessing::Config config = parseConfig(apmConfig);
 
     auto *ap = static_cast<AudioProcessor *>(handle);
-    ap->processor->ApplyConfig(config);
+    // A full ApplyConfig takes both APM locks and re-creates every submodule
+    // whose config compares unequal, so gain-only changes go through runtime
+    // settings instead. Out-of-range AGC2 gains still take the full path,
+    // which falls back to the default config like before. While earlier gains
+    // are still queued, they would be applied over whatever a full apply sets
+    // in the meantime, so only one batch is queued at a time, and a full apply
+    // queues its own gains again behind it.
+    const float gain_db = config.gain_controller2.fixed_digital.gain_db;
+    if (!ap->runtime_gains_pending && gain_db >= 0.0f && gain_db < 50.0f &&
+        onlyRuntimeGainsDiffer(ap->config, config) && postRuntimeGains(ap, config, false)) {
+        ap->runtime_gains_pending = true;
+        ap->config = config;
+    } else {
+        ap->processor->ApplyConfig(config);
+        ap->config = config;
+        if (ap->runtime_gains_pending) {
+            postRuntimeGains(ap, config, true);
+        }
+    }
+    // Channels, sample rate and echo canceller tuning are fixed at creation
+    apmConfig.capture_channels = ap->apm_config.capture_channels;
+    apmConfig.render_channels = ap->apm_config.render_channels;
+    apmConfig.sample_rate_hz = ap->apm_config.sample_rate_hz;
+    apmConfig.echo_cancellation.use_aec3_config = ap->apm_config.echo_cancellation.use_aec3_config;
+    apmConfig.echo_cancellation.aec3_config = ap->apm_config.echo_cancellation.aec3_config;
+    ap->apm_config = apmConfig;
+}
+
+ApmHandle CreateLike(ApmHandle prototype, int *error_code) {
+    *error_code = 0;
+    if (!prototype) {
+        *error_code = webrtc::AudioProcessing::kNullPointerError;
+        return nullptr;
+    }
+
+    auto *proto = static_cast<AudioProcessor *>(prototype);
+    // The group may be gone, but its render analysis lives on in the prototype
+    RenderGroup group{proto->render_group};
+    ApmHandle handle = CreateInRenderGroup(proto->apm_config, proto->render_group ? &group : nullptr, error_code);
+    if (handle && proto->apm_config.echo_cancellation.enabled) {
+        static_cast<AudioProcessor *>(handle)->processor->set_stream_delay_ms(proto->processor->stream_delay_ms());
+    }
+    return handle;
+}
+
+void ResetHandle(ApmHandle handle) {
+    if (!handle) return;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+    // Queued runtime gains would otherwise be applied to the next frame after
+    // the reset. A silent frame takes them off the queue; its effect on the
+    // submodules is undone by the re-initialization.
+    if (ap->runtime_gains_pending) {
+        for (std::vector<float> &channel : ap->capture_buffer) {
+            std::fill(channel.begin(), channel.end(), 0.0f);
+        }
+        processStream(ap, ap->capture_ptrs.data());
+    }
+    ap->processor->Initialize();
+    ap->processor->set_output_will_be_muted(false);
+    ap->processor->set_stream_key_pressed(false);
+    if (ap->apm_config.echo_cancellation.enabled) {
+        ap->processor->set_stream_delay_ms(ap->apm_config.echo_cancellation.stream_delay);
+    }
+    // Keep the streaming buffers allocated, only drop their contents
+    if (ap->stream) {
+        WebRtc_InitBuffer(ap->stream->capture_input.get());
+        WebRtc_InitBuffer(ap->stream->render_input.get());
+        WebRtc_InitBuffer(ap->stream->capture_output.get());
+    }
+}
+
+int SaveState(ApmHandle handle, uint8_t *buffer, int capacity, int *size) {
+    *size = 0;
+    if (!handle)
+        return webrtc::AudioProcessing::kNullPointerError;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+    std::vector<uint8_t> state;
+    if (!ap->processor->SaveAdaptiveState(&state))
+        return webrtc::AudioProcessing::kUnsupportedFunctionError;
+
+    *size = static_cast<int>(state.size());
+    if (!buffer || capacity < *size)
+        return webrtc::AudioProcessing::kBadDataLengthError;
+    std::memcpy(buffer, state.data(), state.size());
+    return webrtc::AudioProcessing::kNoError;
+}
+
+int LoadState(ApmHandle handle, const uint8_t *state, int size) {
+    if (!handle || !state || size <= 0)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+    if (!ap->processor->LoadAdaptiveState(
+            webrtc::ArrayView<const uint8_t>(state, static_cast<size_t>(size))))
+        return webrtc::AudioProcessing::kBadParameterError;
+    return webrtc::AudioProcessing::kNoError;
 }
 
 int ProcessStream(ApmHandle handle, float *samples, int num_channels) {
@@ -193,22 +709,7 @@ int ProcessStream(ApmHandle handle, float *samples, int num_channels) {
     if (num_channels != ap->capture_channels)
         return webrtc::AudioProcessing::kBadParameterError;
 
-    // Deinterleave input
-    deinterleave(samples, ap->capture_buffer, num_channels, APM_NUM_SAMPLES_PER_FRAME);
-
-    // Process
-    int result = ap->processor->ProcessStream(
-            ap->capture_ptrs.data(),
-            ap->capture_stream_config,
-            ap->capture_stream_config,
-            ap->capture_ptrs.data());
-
-    if (result == webrtc::AudioProcessing::kNoError) {
-        // Interleave output back
-        interleave(ap->capture_buffer, samples, num_channels, APM_NUM_SAMPLES_PER_FRAME);
-    }
-
-    return result;
+    return processCaptureFrame(ap, samples);
 }
 
 int ProcessIntStream(ApmHandle handle, int16_t *samples, int num_channels) {
@@ -220,14 +721,7 @@ int ProcessIntStream(ApmHandle handle, int16_t *samples, int num_channels) {
     if (num_channels != ap->capture_channels)
         return webrtc::AudioProcessing::kBadParameterError;
 
-    // Process
-    int result = ap->processor->ProcessStream(
-            samples,
-            ap->capture_stream_config,
-            ap->capture_stream_config,
-            samples);
-
-    return result;
+    return processCaptureFrame(ap, samples);
 }
 
 int ProcessReverseStream(ApmHandle handle, float *samples, int num_channels) {
@@ -237,42 +731,189 @@ int ProcessReverseStream(ApmHandle handle, float *samples, int num_channels) {
     auto *ap = static_cast<AudioProcessor *>(handle);
 
     if (num_channels != ap->render_channels)
-        return webrtc::AudioProcessing::kBadParameterError;;
+        return webrtc::AudioProcessing::kBadParameterError;
 
-    // Deinterleave input
-    deinterleave(samples, ap->render_buffer, num_channels, APM_NUM_SAMPLES_PER_FRAME);
+    return processRenderFrame(ap, samples);
+}
+
+int ProcessReverseIntStream(ApmHandle handle, int16_t *samples, int num_channels) {
+    if (!handle || !samples) return -1;
 
-    // Process reverse stream
-    int result = ap->processor->ProcessReverseStream(
-            ap->render_ptrs.data(),
+    auto *ap = static_cast<AudioProcessor *>(handle);
+
+    if (num_channels != ap->render_channels)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    return processRenderFrame(ap, samples);
+}
+
+int ProcessStreamPlanar(ApmHandle handle, float *const *channels, int num_channels) {
+    if (!handle || !channels)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+
+    if (num_channels != ap->capture_channels || !hasAllChannels(channels, num_channels))
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    // Process directly on the caller's channel buffers
+    return processStream(ap, channels);
+}
+
+int ProcessReverseStreamPlanar(ApmHandle handle, float *const *channels, int num_channels) {
+    if (!handle || !channels)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+
+    if (num_channels != ap->render_channels || !hasAllChannels(channels, num_channels))
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    // Process reverse stream directly on the caller's channel buffers
+    return ap->processor->ProcessReverseStream(
+            channels,
             ap->render_stream_config,
             ap->render_stream_config,
-            ap->render_ptrs.data());
+            channels);
+}
 
-    if (result == webrtc::AudioProcessing::kNoError) {
-        // Interleave output back
-        interleave(ap->render_buffer, samples, num_channels, APM_NUM_SAMPLES_PER_FRAME);
-    }
+int PushStream(ApmHandle handle, const float *samples, int num_frames, int num_channels) {
+    if (!handle || !samples || num_frames < 0)
+        return webrtc::AudioProcessing::kBadParameterError;
 
-    return result;
+    auto *ap = static_cast<AudioProcessor *>(handle);
+
+    if (num_channels != ap->capture_channels)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    StreamState *stream = streamState(ap);
+    if (!stream)
+        return webrtc::AudioProcessing::kCreationFailedError;
+
+    // Refuse the whole chunk rather than drop output that was not pulled
+    const size_t completed = (WebRtc_available_read(stream->capture_input.get()) + num_frames) /
+                             ap->num_samples_per_frame;
+    if (completed * ap->num_samples_per_frame > WebRtc_available_write(stream->capture_output.get()))
+        return webrtc::AudioProcessing::kBadDataLengthError;
+
+    return pushStream(ap, stream->capture_input.get(), samples, num_frames, num_channels,
+                      [ap, stream](const float *frame) {
+                          int result = processCaptureFrame(ap, frame, stream->processed.data());
+                          // Keep the output stream continuous: pass a failed frame through.
+                          const float *output = result == webrtc::AudioProcessing::kNoError
+                                                ? stream->processed.data() : frame;
+                          WebRtc_WriteBuffer(stream->capture_output.get(), output, ap->num_samples_per_frame);
+                          return result;
+                      });
 }
 
-int ProcessReverseIntStream(ApmHandle handle, int16_t *samples, int num_channels) {
-    if (!handle || !samples) return -1;
+int PullStream(ApmHandle handle, float *samples, int num_frames, int num_channels) {
+    if (!handle || !samples || num_frames < 0)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+
+    if (num_channels != ap->capture_channels)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    if (!ap->stream) return 0;
+
+    // Force a copy into samples so the caller never sees ring storage
+    return static_cast<int>(WebRtc_ReadBuffer(ap->stream->capture_output.get(), nullptr, samples, num_frames));
+}
+
+int PushReverseStream(ApmHandle handle, const float *samples, int num_frames, int num_channels) {
+    if (!handle || !samples || num_frames < 0)
+        return webrtc::AudioProcessing::kBadParameterError;
 
     auto *ap = static_cast<AudioProcessor *>(handle);
 
     if (num_channels != ap->render_channels)
-        return webrtc::AudioProcessing::kBadParameterError;;
+        return webrtc::AudioProcessing::kBadParameterError;
 
-    // Process reverse stream
-    int result = ap->processor->ProcessReverseStream(
-            samples,
-            ap->render_stream_config,
-            ap->render_stream_config,
-            samples);
+    StreamState *stream = streamState(ap);
+    if (!stream)
+        return webrtc::AudioProcessing::kCreationFailedError;
+
+    return pushStream(ap, stream->render_input.get(), samples, num_frames, num_channels,
+                      [ap](const float *frame) {
+                          return processRenderFrame(ap, frame, nullptr);
+                      });
+}
+
+int ProcessStreamBatch(ApmHandle handle, float *samples, int num_frames, int num_channels, int *error_codes) {
+    if (!handle || !samples || num_frames <= 0)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+
+    if (num_channels != ap->capture_channels)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    return processBatch(ap, samples, num_frames, num_channels, error_codes, processCaptureFrame);
+}
+
+int ProcessIntStreamBatch(ApmHandle handle, int16_t *samples, int num_frames, int num_channels, int *error_codes) {
+    if (!handle || !samples || num_frames <= 0)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+
+    if (num_channels != ap->capture_channels)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    return processBatch(ap, samples, num_frames, num_channels, error_codes, processCaptureFrame);
+}
+
+int ProcessReverseStreamBatch(ApmHandle handle, float *samples, int num_frames, int num_channels, int *error_codes) {
+    if (!handle || !samples || num_frames <= 0)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+
+    if (num_channels != ap->render_channels)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    return processBatch(ap, samples, num_frames, num_channels, error_codes, processRenderFrame);
+}
+
+int ProcessReverseIntStreamBatch(ApmHandle handle, int16_t *samples, int num_frames, int num_channels,
+                                 int *error_codes) {
+    if (!handle || !samples || num_frames <= 0)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+
+    if (num_channels != ap->render_channels)
+        return webrtc::AudioProcessing::kBadParameterError;
 
-    return result;
+    return processBatch(ap, samples, num_frames, num_channels, error_codes, processRenderFrame);
+}
+
+int ProcessDuplex(ApmHandle handle, float *render, int render_channels, float *capture, int capture_channels,
+                  ApmStats *stats) {
+    if (!handle || !render || !capture)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+
+    if (render_channels != ap->render_channels || capture_channels != ap->capture_channels)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    return processDuplex(ap, render, capture, stats);
+}
+
+int ProcessIntDuplex(ApmHandle handle, int16_t *render, int render_channels, int16_t *capture, int capture_channels,
+                     ApmStats *stats) {
+    if (!handle || !render || !capture)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    auto *ap = static_cast<AudioProcessor *>(handle);
+
+    if (render_channels != ap->render_channels || capture_channels != ap->capture_channels)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    return processDuplex(ap, render, capture, stats);
 }
 
 ApmStats GetStatistics(ApmHandle handle) {
@@ -281,17 +922,7 @@ ApmStats GetStatistics(ApmHandle handle) {
     if (!handle) return stats;
 
     auto *ap = static_cast<AudioProcessor *>(handle);
-    webrtc::AudioProcessingStats s = ap->processor->GetStatistics();
-    // Echo detection
-    stats.echo_return_loss = s.echo_return_loss.value_or(0.0);
-    stats.echo_return_loss_enhancement = s.echo_return_loss_enhancement.value_or(0.0);
-    stats.divergent_filter_fraction = s.divergent_filter_fraction.value_or(0.0);
-    stats.residual_echo_likelihood = s.residual_echo_likelihood.value_or(0.0);
-
-    // Delay
-    stats.delay_median_ms = s.delay_median_ms.value_or(0);
-    stats.delay_std_ms = s.delay_standard_deviation_ms.value_or(0);
-    stats.delay_ms = s.delay_ms.value_or(0);
+    fillStats(ap, &stats);
 
     return stats;
 }
@@ -348,4 +979,30 @@ int get_sample_rate_hz(void) {
     return APM_SAMPLE_RATE_HZ;
 }
 
+int stream_pending_frames(ApmHandle handle) {
+    if (!handle) return 0;
+    auto *ap = static_cast<AudioProcessor *>(handle);
+    if (!ap->stream) return 0;
+    return static_cast<int>(WebRtc_available_read(ap->stream->capture_input.get()));
+}
+
+int stream_available_frames(ApmHandle handle) {
+    if (!handle) return 0;
+    auto *ap = static_cast<AudioProcessor *>(handle);
+    if (!ap->stream) return 0;
+    return static_cast<int>(WebRtc_available_read(ap->stream->capture_output.get()));
+}
+
+int num_samples_per_frame(ApmHandle handle) {
+    if (!handle) return 0;
+    auto *ap = static_cast<AudioProcessor *>(handle);
+    return ap->num_samples_per_frame;
+}
+
+int sample_rate_hz(ApmHandle handle) {
+    if (!handle) return 0;
+    auto *ap = static_cast<AudioProcessor *>(handle);
+    return ap->sample_rate_hz;
+}
+
 } // extern "C"
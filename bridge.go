@@ -5,6 +5,7 @@ package apm
 #cgo CXXFLAGS:  -I${SRCDIR}/google.com/webrtc
 #cgo CXXFLAGS:  -I${SRCDIR}/google.com/abseil-cpp
 #cgo CXXFLAGS: -std=c++17
+#cgo CXXFLAGS: -DWEBRTC_APM_DEBUG_DUMP=0
 #cgo arm,neon CXXFLAGS: -mfpu=neon -mfloat-abi=hard -DWEBRTC_HAS_NEON
 #cgo arm64 CXXFLAGS: -DWEBRTC_HAS_NEON -DWEBRTC_ARCH_ARM64
 #cgo arm7 CXXFLAGS: -mfpu=neon -mfloat-abi=hard -DWEBRTC_HAS_NEON -DWEBRTC_ARCH_ARM_V7
@@ -19,16 +20,22 @@ package apm
 import "C"
 import (
 	"fmt"
+	"runtime"
+	"time"
 	"unsafe"
 
 	_ "github.com/CoyAce/apm/google.com/webrtc"
 )
 
-// Constants exported from the C library
+// Constants exported from the C library.
+// SampleRateHz and NumSamplesPerFrame describe the default rate used when
+// Config.SampleRateHz is left at 0.
 const (
 	SampleRateHz       = C.APM_SAMPLE_RATE_HZ
 	FrameMs            = C.APM_FRAME_MS
 	NumSamplesPerFrame = C.APM_NUM_SAMPLES_PER_FRAME
+	// StreamMaxBufferedMs bounds the processed audio PushCapture holds before it must be pulled
+	StreamMaxBufferedMs = C.APM_STREAM_MAX_BUFFERED_MS
 )
 
 // NsLevel represents noise suppression levels
@@ -60,6 +67,91 @@ type EchoCancellationConfig struct {
 	Enabled       bool
 	MobileMode    bool
 	StreamDelayMs int // nil means use delay-agnostic mode
+	// Tuning replaces the default echo canceller tuning, see
+	// EchoCancellerPreset. nil keeps the WebRTC defaults. It is fixed at
+	// creation time and ignored by ApplyConfig.
+	Tuning *EchoCancellerTuning
+	// WorkerThreads is the number of threads, besides the capture thread,
+	// that the echo canceller spreads the capture channels over when
+	// MultiChannelCapture is set, in [0, 16]. The output is the same for any
+	// number. Each thread needs a core of its own to pay off; on fewer cores
+	// the threads only add switching overhead, see
+	// BenchmarkEchoCancellerWorkerThreads. 0, the default, uses none. It is
+	// fixed at creation time and ignored by ApplyConfig.
+	WorkerThreads int
+}
+
+// DelayEstimator selects how the echo canceller estimates the echo path delay
+type DelayEstimator int
+
+const (
+	DelayEstimatorMatchedFilter  DelayEstimator = C.AEC3_DELAY_ESTIMATOR_MATCHED_FILTER
+	DelayEstimatorFftCorrelation DelayEstimator = C.AEC3_DELAY_ESTIMATOR_FFT_CORRELATION
+)
+
+// EchoCancellerPresetName names a built-in echo canceller tuning. The costs
+// are the mean render plus capture time per 10 ms mono frame with only the
+// echo canceller enabled, at 16 kHz (48 kHz), on an x86-64 machine with
+// AVX-512.
+type EchoCancellerPresetName int
+
+const (
+	// The WebRTC defaults. ~105 us (~160 us) per frame.
+	EchoCancellerPresetDefault EchoCancellerPresetName = C.AEC3_PRESET_DEFAULT
+	// 40 ms filters and a coarser, shorter delay search for servers running
+	// many calls. ~70 us (~125 us) per frame.
+	EchoCancellerPresetLowCPUServer EchoCancellerPresetName = C.AEC3_PRESET_LOW_CPU_SERVER
+	// 96 ms filters, a longer delay search and frequency dependent ERLE
+	// estimation for desktop clients in reverberant rooms. ~130 us (~195 us)
+	// per frame.
+	EchoCancellerPresetHighQualityDesktop EchoCancellerPresetName = C.AEC3_PRESET_HIGH_QUALITY_DESKTOP
+)
+
+// EchoCancellerTuning is the subset of the echo canceller (AEC3)
+// configuration that trades CPU for echo removal quality. Lengths are in
+// 4 ms blocks. Start from EchoCancellerPreset rather than the zero value.
+type EchoCancellerTuning struct {
+	// Linear filter lengths after and during the initial convergence. The
+	// initial lengths must not exceed the regular ones, and the refined
+	// filter must be at least 9 blocks long.
+	RefinedLengthBlocks        int
+	CoarseLengthBlocks         int
+	RefinedInitialLengthBlocks int
+	CoarseInitialLengthBlocks  int
+	// Shorten the filters to the measured echo path once converged
+	AdaptiveFilterLength bool
+	// Render downsampling for the delay search, 4 or 8, and the number of
+	// matched filters. n filters cover (24*n + 32) blocks of delay.
+	DownSamplingFactor int
+	NumFilters         int
+	DelayEstimator     DelayEstimator
+	// Number of frequency sections with a separate ERLE estimate, in
+	// [1, RefinedLengthBlocks]
+	ErleNumSections int
+	// Skip echo removal while the render signal is inactive
+	IdleDuringInactiveRender bool
+	// Resample the render signal to the capture clock once the delay
+	// estimates show a clock drift, keeping the delay and the filters
+	// aligned. From then on the render signal is delayed by about 8 ms.
+	CompensateClockDrift bool
+}
+
+// EchoCancellerPreset returns the tuning of a named preset.
+func EchoCancellerPreset(name EchoCancellerPresetName) EchoCancellerTuning {
+	c := C.GetEchoCanceller3Preset(C.Aec3Preset(name))
+	return EchoCancellerTuning{
+		RefinedLengthBlocks:        int(c.refined_length_blocks),
+		CoarseLengthBlocks:         int(c.coarse_length_blocks),
+		RefinedInitialLengthBlocks: int(c.refined_initial_length_blocks),
+		CoarseInitialLengthBlocks:  int(c.coarse_initial_length_blocks),
+		AdaptiveFilterLength:       bool(c.adaptive_filter_length),
+		DownSamplingFactor:         int(c.down_sampling_factor),
+		NumFilters:                 int(c.num_filters),
+		DelayEstimator:             DelayEstimator(c.delay_estimator),
+		ErleNumSections:            int(c.erle_num_sections),
+		IdleDuringInactiveRender:   bool(c.idle_during_inactive_render),
+		CompensateClockDrift:       bool(c.compensate_clock_drift),
+	}
 }
 
 // GainControlConfig holds automatic gain control settings
@@ -86,6 +178,12 @@ type Config struct {
 	HighPassFilterEnabled  bool
 	CaptureChannels        int
 	RenderChannels         int
+	// SampleRateHz is one of 8000, 16000, 32000, 48000; 0 selects SampleRateHz.
+	// It is fixed at creation time and ignored by ApplyConfig.
+	SampleRateHz int
+	// MultiChannelCapture processes each capture channel separately instead
+	// of a mono downmix copied to all output channels.
+	MultiChannelCapture bool
 }
 
 // Stats holds statistics from the audio processor
@@ -97,11 +195,41 @@ type Stats struct {
 	DelayMedianMs             int
 	DelayStdMs                int
 	DelayMs                   int
+
+	// Length of the echo path covered by the echo canceller's linear
+	// filter. It shrinks to the measured echo path once the filter has
+	// converged.
+	LinearFilterLengthMs int
+
+	// Time spent per 10 ms frame in each processing stage, summarized over
+	// the last window of 100 frames. Zero until a stage has run for a full
+	// window.
+	CaptureProcessingTime StageTiming
+	CaptureBandSplitTime  StageTiming
+	HighPassFilterTime    StageTiming
+	EchoControllerTime    StageTiming
+	NoiseSuppressorTime   StageTiming
+	GainController2Time   StageTiming
+	RenderProcessingTime  StageTiming
+	RenderBandSplitTime   StageTiming
+	RenderAnalysisTime    StageTiming
+}
+
+// StageTiming summarizes the per-frame processing time of one stage.
+type StageTiming struct {
+	Min  time.Duration
+	Mean time.Duration
+	P99  time.Duration
 }
 
 // Handle represents an opaque handle to the audio processor
 type Handle struct {
-	ptr C.ApmHandle
+	ptr                C.ApmHandle
+	numSamplesPerFrame int
+
+	// Reused by the planar calls to pass channel pointers without allocating
+	pinner      runtime.Pinner
+	channelPtrs []*C.float
 }
 
 // Create creates a new audio processor with the given initialization config
@@ -114,7 +242,116 @@ func Create(config Config) (*Handle, error) {
 		return nil, fmt.Errorf("failed to create audio processor: error code %d", int(errorCode))
 	}
 
-	return &Handle{ptr: ptr}, nil
+	return &Handle{ptr: ptr, numSamplesPerFrame: int(C.num_samples_per_frame(ptr))}, nil
+}
+
+// RenderGroup lets audio processors that are fed the same render signal,
+// such as one per microphone beam, analyze each render frame once between
+// them. See CreateInRenderGroup.
+type RenderGroup struct {
+	ptr C.ApmRenderGroup
+}
+
+// NewRenderGroup creates an empty render group.
+func NewRenderGroup() *RenderGroup {
+	return &RenderGroup{ptr: C.CreateRenderGroup()}
+}
+
+// Destroy releases the group. Its processors remain valid.
+func (g *RenderGroup) Destroy() {
+	if g.ptr != nil {
+		C.DestroyRenderGroup(g.ptr)
+		g.ptr = nil
+	}
+}
+
+// CreateInRenderGroup creates an audio processor like Create that joins
+// group, or no group when it is nil. All processors of a group must be given
+// the same render frames and be kept within 60ms of render audio of each
+// other; one that falls further behind resets its echo path delay estimate.
+// Handles made with CreateLike join the group of their prototype.
+func CreateInRenderGroup(config Config, group *RenderGroup) (*Handle, error) {
+	var groupPtr C.ApmRenderGroup
+	if group != nil {
+		if group.ptr == nil {
+			return nil, fmt.Errorf("render group destroyed")
+		}
+		groupPtr = group.ptr
+	}
+	cConfig := parseConfig(config)
+
+	var errorCode C.int
+	ptr := C.CreateInRenderGroup(cConfig, groupPtr, &errorCode)
+	if ptr == nil {
+		return nil, fmt.Errorf("failed to create audio processor: error code %d", int(errorCode))
+	}
+
+	return &Handle{ptr: ptr, numSamplesPerFrame: int(C.num_samples_per_frame(ptr))}, nil
+}
+
+// CreateLike creates a new handle with the same configuration and render
+// group as h, including later ApplyConfig calls and the current stream delay.
+// Processing state is not copied: the new handle starts fresh.
+func (h *Handle) CreateLike() (*Handle, error) {
+	if h.ptr == nil {
+		return nil, fmt.Errorf("audio processor not initialized")
+	}
+
+	var errorCode C.int
+	ptr := C.CreateLike(h.ptr, &errorCode)
+	if ptr == nil {
+		return nil, fmt.Errorf("failed to create audio processor: error code %d", int(errorCode))
+	}
+
+	return &Handle{ptr: ptr, numSamplesPerFrame: h.numSamplesPerFrame}, nil
+}
+
+// Reset returns the handle to its just-created state without reallocating
+// it. The configuration is kept.
+func (h *Handle) Reset() {
+	if h.ptr != nil {
+		C.ResetHandle(h.ptr)
+	}
+}
+
+// SaveState returns the adaptive echo canceller and AGC state as a versioned
+// binary blob that LoadState accepts on a handle with the same configuration.
+func (h *Handle) SaveState() ([]byte, error) {
+	if h.ptr == nil {
+		return nil, fmt.Errorf("audio processor not initialized")
+	}
+
+	var size C.int
+	result := C.SaveState(h.ptr, nil, 0, &size)
+	if result != C.int(0) && size == 0 {
+		return nil, fmt.Errorf("failed to save state: error code %d", int(result))
+	}
+
+	state := make([]byte, int(size))
+	result = C.SaveState(h.ptr, (*C.uint8_t)(unsafe.Pointer(&state[0])), size, &size)
+	if C.is_success(result) == 0 {
+		return nil, fmt.Errorf("failed to save state: error code %d", int(result))
+	}
+
+	return state[:int(size)], nil
+}
+
+// LoadState restores state saved by SaveState. On error the handle is left
+// unchanged.
+func (h *Handle) LoadState(state []byte) error {
+	if h.ptr == nil {
+		return fmt.Errorf("audio processor not initialized")
+	}
+	if len(state) == 0 {
+		return fmt.Errorf("empty state")
+	}
+
+	result := C.LoadState(h.ptr, (*C.uint8_t)(unsafe.Pointer(&state[0])), C.int(len(state)))
+	if C.is_success(result) == 0 {
+		return fmt.Errorf("failed to load state: error code %d", int(result))
+	}
+
+	return nil
 }
 
 func (h *Handle) Initialize() {
@@ -146,6 +383,7 @@ func parseConfig(config Config) C.ApmConfig {
 	cConfig := C.ApmConfig{
 		capture_channels: C.int(config.CaptureChannels),
 		render_channels:  C.int(config.RenderChannels),
+		sample_rate_hz:   C.int(config.SampleRateHz),
 		capture_level_adjustment: C.ApmCaptureLevelAdjustment{
 			enabled:          C.bool(config.CaptureLevelAdjustment.Enabled),
 			pre_gain_factor:  C.float(config.CaptureLevelAdjustment.PreGainFactor),
@@ -156,9 +394,10 @@ func parseConfig(config Config) C.ApmConfig {
 			},
 		},
 		echo_cancellation: C.ApmEchoCancellation{
-			enabled:      C.bool(config.EchoCancellation.Enabled),
-			mobile_mode:  C.bool(config.EchoCancellation.MobileMode),
-			stream_delay: C.int(config.EchoCancellation.StreamDelayMs),
+			enabled:        C.bool(config.EchoCancellation.Enabled),
+			mobile_mode:    C.bool(config.EchoCancellation.MobileMode),
+			stream_delay:   C.int(config.EchoCancellation.StreamDelayMs),
+			worker_threads: C.int(config.EchoCancellation.WorkerThreads),
 		},
 		gain_control: C.ApmGainControl{
 			enabled:                         C.bool(config.GainControl.Enabled),
@@ -172,18 +411,35 @@ func parseConfig(config Config) C.ApmConfig {
 			suppression_level: C.NsLevel(config.NoiseSuppression.SuppressionLevel),
 		},
 		high_pass_filter_enabled: C.bool(config.HighPassFilterEnabled),
+		multi_channel_capture:    C.bool(config.MultiChannelCapture),
+	}
+	if t := config.EchoCancellation.Tuning; t != nil {
+		cConfig.echo_cancellation.use_aec3_config = C.bool(true)
+		cConfig.echo_cancellation.aec3_config = C.ApmEchoCanceller3Config{
+			refined_length_blocks:         C.int(t.RefinedLengthBlocks),
+			coarse_length_blocks:          C.int(t.CoarseLengthBlocks),
+			refined_initial_length_blocks: C.int(t.RefinedInitialLengthBlocks),
+			coarse_initial_length_blocks:  C.int(t.CoarseInitialLengthBlocks),
+			adaptive_filter_length:        C.bool(t.AdaptiveFilterLength),
+			down_sampling_factor:          C.int(t.DownSamplingFactor),
+			num_filters:                   C.int(t.NumFilters),
+			delay_estimator:               C.Aec3DelayEstimator(t.DelayEstimator),
+			erle_num_sections:             C.int(t.ErleNumSections),
+			idle_during_inactive_render:   C.bool(t.IdleDuringInactiveRender),
+			compensate_clock_drift:        C.bool(t.CompensateClockDrift),
+		}
 	}
 	return cConfig
 }
 
 // ProcessCaptureFrame processes a capture (microphone) frame
-// samples should be interleaved float32 samples with length = numChannels * NumSamplesPerFrame
+// samples should be interleaved float32 samples with length = numChannels * h.NumSamplesPerFrame()
 func (h *Handle) ProcessCaptureFrame(samples []float32, numChannels int) error {
 	if h.ptr == nil {
 		return fmt.Errorf("audio processor not initialized")
 	}
 
-	expectedLen := numChannels * NumSamplesPerFrame
+	expectedLen := numChannels * h.numSamplesPerFrame
 	if len(samples) != expectedLen {
 		return fmt.Errorf("expected %d samples, got %d", expectedLen, len(samples))
 	}
@@ -206,7 +462,7 @@ func (h *Handle) ProcessCaptureIntFrame(samples []int16, numChannels int) error
 		return fmt.Errorf("audio processor not initialized")
 	}
 
-	expectedLen := numChannels * NumSamplesPerFrame
+	expectedLen := numChannels * h.numSamplesPerFrame
 	if len(samples) != expectedLen {
 		return fmt.Errorf("expected %d samples, got %d", expectedLen, len(samples))
 	}
@@ -225,13 +481,13 @@ func (h *Handle) ProcessCaptureIntFrame(samples []int16, numChannels int) error
 }
 
 // ProcessRenderFrame processes a render (speaker) frame for echo cancellation
-// samples should be interleaved float32 samples with length = numChannels * NumSamplesPerFrame
+// samples should be interleaved float32 samples with length = numChannels * h.NumSamplesPerFrame()
 func (h *Handle) ProcessRenderFrame(samples []float32, numChannels int) error {
 	if h.ptr == nil {
 		return fmt.Errorf("audio processor not initialized")
 	}
 
-	expectedLen := numChannels * NumSamplesPerFrame
+	expectedLen := numChannels * h.numSamplesPerFrame
 	if len(samples) != expectedLen {
 		return fmt.Errorf("expected %d samples, got %d", expectedLen, len(samples))
 	}
@@ -254,7 +510,7 @@ func (h *Handle) ProcessRenderIntFrame(samples []int16, numChannels int) error {
 		return fmt.Errorf("audio processor not initialized")
 	}
 
-	expectedLen := numChannels * NumSamplesPerFrame
+	expectedLen := numChannels * h.numSamplesPerFrame
 	if len(samples) != expectedLen {
 		return fmt.Errorf("expected %d samples, got %d", expectedLen, len(samples))
 	}
@@ -272,15 +528,394 @@ func (h *Handle) ProcessRenderIntFrame(samples []int16, numChannels int) error {
 	return nil
 }
 
+// pinChannels pins every channel buffer and returns a C array of their data
+// pointers. The caller must call h.unpinChannels once C returns.
+func (h *Handle) pinChannels(channels [][]float32) (**C.float, error) {
+	if len(channels) == 0 {
+		return nil, fmt.Errorf("expected at least one channel")
+	}
+	for ch, samples := range channels {
+		if len(samples) != h.numSamplesPerFrame {
+			return nil, fmt.Errorf("channel %d: expected %d samples, got %d", ch, h.numSamplesPerFrame, len(samples))
+		}
+	}
+
+	if cap(h.channelPtrs) < len(channels) {
+		h.channelPtrs = make([]*C.float, len(channels))
+	}
+	ptrs := h.channelPtrs[:len(channels)]
+	for ch, samples := range channels {
+		h.pinner.Pin(&samples[0])
+		ptrs[ch] = (*C.float)(unsafe.Pointer(&samples[0]))
+	}
+	return &ptrs[0], nil
+}
+
+// unpinChannels releases the pins taken by pinChannels. The pointer array is
+// cleared too: cgo checks the whole array, so stale entries from a call with
+// more channels would otherwise count as unpinned Go pointers.
+func (h *Handle) unpinChannels() {
+	clear(h.channelPtrs)
+	h.pinner.Unpin()
+}
+
+// ProcessCapturePlanar processes a capture frame already split into channels.
+// Each channel must hold h.NumSamplesPerFrame() samples; the buffers are
+// pinned and processed in place without intermediate copies.
+func (h *Handle) ProcessCapturePlanar(channels [][]float32) error {
+	if h.ptr == nil {
+		return fmt.Errorf("audio processor not initialized")
+	}
+
+	ptrs, err := h.pinChannels(channels)
+	if err != nil {
+		return err
+	}
+	defer h.unpinChannels()
+
+	result := C.ProcessStreamPlanar(h.ptr, ptrs, C.int(len(channels)))
+
+	if C.is_success(result) == 0 {
+		return fmt.Errorf("failed to process capture frame: error code %d", int(result))
+	}
+
+	return nil
+}
+
+// ProcessRenderPlanar processes a render frame already split into channels.
+// See ProcessCapturePlanar for the buffer requirements.
+func (h *Handle) ProcessRenderPlanar(channels [][]float32) error {
+	if h.ptr == nil {
+		return fmt.Errorf("audio processor not initialized")
+	}
+
+	ptrs, err := h.pinChannels(channels)
+	if err != nil {
+		return err
+	}
+	defer h.unpinChannels()
+
+	result := C.ProcessReverseStreamPlanar(h.ptr, ptrs, C.int(len(channels)))
+
+	if C.is_success(result) == 0 {
+		return fmt.Errorf("failed to process render frame: error code %d", int(result))
+	}
+
+	return nil
+}
+
+// PushCapture appends interleaved capture samples of any length. Every 10ms
+// frame that completes is processed right away and queued for PullCapture.
+// It fails without consuming anything if the unpulled output would exceed
+// StreamMaxBufferedMs.
+func (h *Handle) PushCapture(samples []float32, numChannels int) error {
+	if h.ptr == nil {
+		return fmt.Errorf("audio processor not initialized")
+	}
+	if numChannels <= 0 || len(samples)%numChannels != 0 {
+		return fmt.Errorf("expected a multiple of %d samples, got %d", numChannels, len(samples))
+	}
+	if len(samples) == 0 {
+		return nil
+	}
+
+	result := C.PushStream(
+		h.ptr,
+		(*C.float)(unsafe.Pointer(&samples[0])),
+		C.int(len(samples)/numChannels),
+		C.int(numChannels),
+	)
+
+	if C.is_success(result) == 0 {
+		return fmt.Errorf("failed to push capture samples: error code %d", int(result))
+	}
+
+	return nil
+}
+
+// PullCapture copies processed capture samples into samples and returns the
+// number of samples per channel copied
+func (h *Handle) PullCapture(samples []float32, numChannels int) (int, error) {
+	if h.ptr == nil {
+		return 0, fmt.Errorf("audio processor not initialized")
+	}
+	if numChannels <= 0 || len(samples)%numChannels != 0 {
+		return 0, fmt.Errorf("expected a multiple of %d samples, got %d", numChannels, len(samples))
+	}
+	if len(samples) == 0 {
+		return 0, nil
+	}
+
+	result := C.PullStream(
+		h.ptr,
+		(*C.float)(unsafe.Pointer(&samples[0])),
+		C.int(len(samples)/numChannels),
+		C.int(numChannels),
+	)
+
+	if result < 0 {
+		return 0, fmt.Errorf("failed to pull capture samples: error code %d", int(result))
+	}
+
+	return int(result), nil
+}
+
+// PushRender appends interleaved render samples of any length; every 10ms
+// frame that completes is fed to the echo canceller
+func (h *Handle) PushRender(samples []float32, numChannels int) error {
+	if h.ptr == nil {
+		return fmt.Errorf("audio processor not initialized")
+	}
+	if numChannels <= 0 || len(samples)%numChannels != 0 {
+		return fmt.Errorf("expected a multiple of %d samples, got %d", numChannels, len(samples))
+	}
+	if len(samples) == 0 {
+		return nil
+	}
+
+	result := C.PushReverseStream(
+		h.ptr,
+		(*C.float)(unsafe.Pointer(&samples[0])),
+		C.int(len(samples)/numChannels),
+		C.int(numChannels),
+	)
+
+	if C.is_success(result) == 0 {
+		return fmt.Errorf("failed to push render samples: error code %d", int(result))
+	}
+
+	return nil
+}
+
+// StreamPendingFrames returns the capture samples per channel waiting for a
+// complete 10ms frame. It is always below NumSamplesPerFrame and is the
+// latency PushCapture adds.
+func (h *Handle) StreamPendingFrames() int {
+	if h.ptr == nil {
+		return 0
+	}
+	return int(C.stream_pending_frames(h.ptr))
+}
+
+// StreamAvailableFrames returns the processed samples per channel ready to pull
+func (h *Handle) StreamAvailableFrames() int {
+	if h.ptr == nil {
+		return 0
+	}
+	return int(C.stream_available_frames(h.ptr))
+}
+
+// BatchError reports the per-frame results of a failed batched call
+type BatchError struct {
+	Op string
+	// Codes holds the error code of every frame in the batch, 0 on success
+	Codes []int
+}
+
+func (e *BatchError) Error() string {
+	failed, first := 0, -1
+	for i, code := range e.Codes {
+		if code != 0 {
+			failed++
+			if first < 0 {
+				first = i
+			}
+		}
+	}
+	if first < 0 {
+		return fmt.Sprintf("failed to %s", e.Op)
+	}
+	return fmt.Sprintf("failed to %s: %d of %d frames failed, first at frame %d with error code %d",
+		e.Op, failed, len(e.Codes), first, e.Codes[first])
+}
+
+// batchFrames validates that a batch holds whole frames and returns the frame count
+func (h *Handle) batchFrames(numSamples, numChannels int) (int, error) {
+	frameLen := numChannels * h.numSamplesPerFrame
+	if frameLen <= 0 || numSamples == 0 || numSamples%frameLen != 0 {
+		return 0, fmt.Errorf("expected a non-zero multiple of %d samples, got %d", frameLen, numSamples)
+	}
+	return numSamples / frameLen, nil
+}
+
+func batchResult(op string, result C.int, codes []C.int) error {
+	if C.is_success(result) != 0 {
+		return nil
+	}
+	err := &BatchError{Op: op, Codes: make([]int, len(codes))}
+	for i, code := range codes {
+		err.Codes[i] = int(code)
+	}
+	return err
+}
+
+// ProcessCaptureFrames processes consecutive capture frames in a single call.
+// samples holds the interleaved frames back to back; its length must be a
+// multiple of numChannels * h.NumSamplesPerFrame(). A failure is reported as
+// a *BatchError carrying every frame's result.
+func (h *Handle) ProcessCaptureFrames(samples []float32, numChannels int) error {
+	if h.ptr == nil {
+		return fmt.Errorf("audio processor not initialized")
+	}
+
+	numFrames, err := h.batchFrames(len(samples), numChannels)
+	if err != nil {
+		return err
+	}
+
+	codes := make([]C.int, numFrames)
+	result := C.ProcessStreamBatch(
+		h.ptr,
+		(*C.float)(unsafe.Pointer(&samples[0])),
+		C.int(numFrames),
+		C.int(numChannels),
+		&codes[0],
+	)
+
+	return batchResult("process capture frames", result, codes)
+}
+
+func (h *Handle) ProcessCaptureIntFrames(samples []int16, numChannels int) error {
+	if h.ptr == nil {
+		return fmt.Errorf("audio processor not initialized")
+	}
+
+	numFrames, err := h.batchFrames(len(samples), numChannels)
+	if err != nil {
+		return err
+	}
+
+	codes := make([]C.int, numFrames)
+	result := C.ProcessIntStreamBatch(
+		h.ptr,
+		(*C.int16_t)(unsafe.Pointer(&samples[0])),
+		C.int(numFrames),
+		C.int(numChannels),
+		&codes[0],
+	)
+
+	return batchResult("process capture frames", result, codes)
+}
+
+// ProcessRenderFrames processes consecutive render frames in a single call.
+// See ProcessCaptureFrames for the sample layout.
+func (h *Handle) ProcessRenderFrames(samples []float32, numChannels int) error {
+	if h.ptr == nil {
+		return fmt.Errorf("audio processor not initialized")
+	}
+
+	numFrames, err := h.batchFrames(len(samples), numChannels)
+	if err != nil {
+		return err
+	}
+
+	codes := make([]C.int, numFrames)
+	result := C.ProcessReverseStreamBatch(
+		h.ptr,
+		(*C.float)(unsafe.Pointer(&samples[0])),
+		C.int(numFrames),
+		C.int(numChannels),
+		&codes[0],
+	)
+
+	return batchResult("process render frames", result, codes)
+}
+
+func (h *Handle) ProcessRenderIntFrames(samples []int16, numChannels int) error {
+	if h.ptr == nil {
+		return fmt.Errorf("audio processor not initialized")
+	}
+
+	numFrames, err := h.batchFrames(len(samples), numChannels)
+	if err != nil {
+		return err
+	}
+
+	codes := make([]C.int, numFrames)
+	result := C.ProcessReverseIntStreamBatch(
+		h.ptr,
+		(*C.int16_t)(unsafe.Pointer(&samples[0])),
+		C.int(numFrames),
+		C.int(numChannels),
+		&codes[0],
+	)
+
+	return batchResult("process render frames", result, codes)
+}
+
+// ProcessDuplexFrame feeds one render frame and processes one capture frame in
+// a single call, returning the statistics after the capture frame. Both
+// buffers are interleaved and processed in place. The capture frame is
+// processed even if the render frame is rejected.
+func (h *Handle) ProcessDuplexFrame(render []float32, renderChannels int, capture []float32, captureChannels int) (Stats, error) {
+	if h.ptr == nil {
+		return Stats{}, fmt.Errorf("audio processor not initialized")
+	}
+
+	if expectedLen := renderChannels * h.numSamplesPerFrame; len(render) != expectedLen {
+		return Stats{}, fmt.Errorf("expected %d render samples, got %d", expectedLen, len(render))
+	}
+	if expectedLen := captureChannels * h.numSamplesPerFrame; len(capture) != expectedLen {
+		return Stats{}, fmt.Errorf("expected %d capture samples, got %d", expectedLen, len(capture))
+	}
+
+	var cStats C.ApmStats
+	result := C.ProcessDuplex(
+		h.ptr,
+		(*C.float)(unsafe.Pointer(&render[0])),
+		C.int(renderChannels),
+		(*C.float)(unsafe.Pointer(&capture[0])),
+		C.int(captureChannels),
+		&cStats,
+	)
+
+	if C.is_success(result) == 0 {
+		return convertStats(cStats), fmt.Errorf("failed to process duplex frame: error code %d", int(result))
+	}
+
+	return convertStats(cStats), nil
+}
+
+func (h *Handle) ProcessDuplexIntFrame(render []int16, renderChannels int, capture []int16, captureChannels int) (Stats, error) {
+	if h.ptr == nil {
+		return Stats{}, fmt.Errorf("audio processor not initialized")
+	}
+
+	if expectedLen := renderChannels * h.numSamplesPerFrame; len(render) != expectedLen {
+		return Stats{}, fmt.Errorf("expected %d render samples, got %d", expectedLen, len(render))
+	}
+	if expectedLen := captureChannels * h.numSamplesPerFrame; len(capture) != expectedLen {
+		return Stats{}, fmt.Errorf("expected %d capture samples, got %d", expectedLen, len(capture))
+	}
+
+	var cStats C.ApmStats
+	result := C.ProcessIntDuplex(
+		h.ptr,
+		(*C.int16_t)(unsafe.Pointer(&render[0])),
+		C.int(renderChannels),
+		(*C.int16_t)(unsafe.Pointer(&capture[0])),
+		C.int(captureChannels),
+		&cStats,
+	)
+
+	if C.is_success(result) == 0 {
+		return convertStats(cStats), fmt.Errorf("failed to process duplex frame: error code %d", int(result))
+	}
+
+	return convertStats(cStats), nil
+}
+
 // GetStats returns statistics from the last capture frame processing
 func (h *Handle) GetStats() Stats {
-	var stats Stats
-
 	if h.ptr == nil {
-		return stats
+		return Stats{}
 	}
 
-	cStats := C.GetStatistics(h.ptr)
+	return convertStats(C.GetStatistics(h.ptr))
+}
+
+func convertStats(cStats C.ApmStats) Stats {
+	var stats Stats
 
 	stats.ResidualEchoLikelihood = float64(cStats.residual_echo_likelihood)
 	stats.DivergentFilterFraction = float64(cStats.divergent_filter_fraction)
@@ -289,10 +924,29 @@ func (h *Handle) GetStats() Stats {
 	stats.DelayMedianMs = int(cStats.delay_median_ms)
 	stats.DelayStdMs = int(cStats.delay_std_ms)
 	stats.DelayMs = int(cStats.delay_ms)
+	stats.LinearFilterLengthMs = int(cStats.linear_filter_length_ms)
+
+	stats.CaptureProcessingTime = convertStageTiming(cStats.capture_processing_time)
+	stats.CaptureBandSplitTime = convertStageTiming(cStats.capture_band_split_time)
+	stats.HighPassFilterTime = convertStageTiming(cStats.high_pass_filter_time)
+	stats.EchoControllerTime = convertStageTiming(cStats.echo_controller_time)
+	stats.NoiseSuppressorTime = convertStageTiming(cStats.noise_suppressor_time)
+	stats.GainController2Time = convertStageTiming(cStats.gain_controller2_time)
+	stats.RenderProcessingTime = convertStageTiming(cStats.render_processing_time)
+	stats.RenderBandSplitTime = convertStageTiming(cStats.render_band_split_time)
+	stats.RenderAnalysisTime = convertStageTiming(cStats.render_analysis_time)
 
 	return stats
 }
 
+func convertStageTiming(cTiming C.ApmStageTiming) StageTiming {
+	return StageTiming{
+		Min:  time.Duration(cTiming.min_ns),
+		Mean: time.Duration(cTiming.mean_ns),
+		P99:  time.Duration(cTiming.p99_ns),
+	}
+}
+
 func (h *Handle) SetStreamAnalogLevel(level int) {
 	if h.ptr == nil {
 		return
@@ -338,12 +992,25 @@ func (h *Handle) SetStreamKeyPressed(pressed bool) {
 	C.set_stream_key_pressed(h.ptr, C.bool(pressed))
 }
 
-// GetNumSamplesPerFrame returns the number of samples per frame
+// NumSamplesPerFrame returns the number of samples per channel in one 10ms frame
+func (h *Handle) NumSamplesPerFrame() int {
+	return h.numSamplesPerFrame
+}
+
+// SampleRateHz returns the sample rate the handle was created with
+func (h *Handle) SampleRateHz() int {
+	if h.ptr == nil {
+		return 0
+	}
+	return int(C.sample_rate_hz(h.ptr))
+}
+
+// GetNumSamplesPerFrame returns the number of samples per frame at the default sample rate
 func GetNumSamplesPerFrame() int {
 	return int(C.get_num_samples_per_frame())
 }
 
-// GetSampleRateHz returns the sample rate in Hz
+// GetSampleRateHz returns the default sample rate in Hz
 func GetSampleRateHz() int {
 	return int(C.get_sample_rate_hz())
 }
@@ -13,14 +13,21 @@ extern "C" {
 // Opaque handle to the audio processor
 typedef void *ApmHandle;
 
+// Opaque handle to a render group, see CreateInRenderGroup()
+typedef void *ApmRenderGroup;
+
 // Sample rate must be one of: 8000, 16000, 32000, 48000 Hz
 // Frame duration is fixed at 10ms
 // So NUM_SAMPLES_PER_FRAME = SAMPLE_RATE_HZ * 10 / 1000
 
 // Constants
+// APM_SAMPLE_RATE_HZ is the default rate, used when ApmConfig.sample_rate_hz
+// is left at 0.
 #define APM_SAMPLE_RATE_HZ 48000
 #define APM_FRAME_MS 10
 #define APM_NUM_SAMPLES_PER_FRAME (APM_SAMPLE_RATE_HZ * APM_FRAME_MS / 1000)
+// Processed capture audio the streaming API holds before it must be pulled
+#define APM_STREAM_MAX_BUFFERED_MS 120
 
 // Noise suppression levels
 typedef enum {
@@ -52,11 +59,72 @@ typedef struct ApmCaptureLevelAdjustment {
     ApmAnalogMicGainEmulation analog_mic_gain_emulation;
 } ApmCaptureLevelAdjustment;
 
+// Echo canceller (AEC3) delay estimators
+typedef enum {
+    AEC3_DELAY_ESTIMATOR_MATCHED_FILTER = 0,
+    AEC3_DELAY_ESTIMATOR_FFT_CORRELATION = 1
+} Aec3DelayEstimator;
+
+// Named echo canceller tunings. Costs are the mean render plus capture time per
+// 10 ms frame of a mono call with only the echo canceller enabled, at 16 kHz
+// (48 kHz), measured on an x86-64 machine with AVX-512.
+typedef enum {
+    // The WebRTC defaults: 52 ms filters, 5 matched filters covering ~600 ms
+    // of delay. ~105 us (~160 us) per frame.
+    AEC3_PRESET_DEFAULT = 0,
+    // For servers running many calls: 40 ms filters and 3 matched filters
+    // covering ~400 ms of delay at half the delay resolution. Longer echo
+    // tails are left to the suppressor. ~70 us (~125 us) per frame.
+    AEC3_PRESET_LOW_CPU_SERVER = 1,
+    // For desktop clients in reverberant rooms: 96 ms filters, 7 matched
+    // filters covering ~800 ms of delay and frequency dependent ERLE
+    // estimation. ~130 us (~195 us) per frame.
+    AEC3_PRESET_HIGH_QUALITY_DESKTOP = 2
+} Aec3Preset;
+
+// Echo canceller tuning, the subset of WebRTC's EchoCanceller3Config that
+// trades CPU for echo removal quality. Lengths are in 4 ms blocks.
+typedef struct ApmEchoCanceller3Config {
+    // Linear filter lengths after and during the initial convergence. The
+    // initial lengths must not exceed the regular ones, and the refined filter
+    // must be at least 9 blocks long.
+    int refined_length_blocks;
+    int coarse_length_blocks;
+    int refined_initial_length_blocks;
+    int coarse_initial_length_blocks;
+    // Shorten the filters to the measured echo path once converged
+    bool adaptive_filter_length;
+    // Delay estimation: the render downsampling factor, 4 or 8, and the
+    // number of matched filters. n filters cover (24 * n + 32) blocks of
+    // delay; downsampling by 8 halves their cost at half the resolution.
+    int down_sampling_factor;
+    int num_filters;
+    Aec3DelayEstimator delay_estimator;
+    // Number of frequency sections with a separate ERLE estimate, in
+    // [1, refined_length_blocks]
+    int erle_num_sections;
+    // Skip echo removal while the render signal is inactive
+    bool idle_during_inactive_render;
+    // Resample the render signal to the capture clock once the delay
+    // estimates show a clock drift, keeping the delay and the filters
+    // aligned. From then on the render signal is delayed by about 8 ms.
+    bool compensate_clock_drift;
+} ApmEchoCanceller3Config;
+
 // Echo cancellation configuration
 typedef struct ApmEchoCancellation {
     bool enabled;
     bool mobile_mode;
     int stream_delay;
+    // Use aec3_config instead of the default echo canceller tuning. Both are
+    // only read by Create().
+    bool use_aec3_config;
+    ApmEchoCanceller3Config aec3_config;
+    // Threads, besides the capture thread, that the echo canceller spreads
+    // the capture channels over when multi_channel_capture is set, in
+    // [0, 16]. The output is the same for any number. Each thread needs a
+    // core of its own to pay off. 0 uses none. Only read by Create().
+    int worker_threads;
 } ApmEchoCancellation;
 
 // Gain control configuration
@@ -83,8 +151,22 @@ typedef struct ApmConfig {
     bool high_pass_filter_enabled;
     int capture_channels;
     int render_channels;
+    // Sample rate of both capture and render streams, one of 8000, 16000,
+    // 32000, 48000 Hz. 0 selects APM_SAMPLE_RATE_HZ. Only read by Create().
+    int sample_rate_hz;
+    // Process each capture channel separately instead of a mono downmix that
+    // is copied to all output channels. Costs a processing chain per channel.
+    bool multi_channel_capture;
 } ApmConfig;
 
+// Time spent in a processing stage per 10 ms frame over the last window of
+// 100 frames. All zero until the stage has run for a full window.
+typedef struct ApmStageTiming {
+    int64_t min_ns;
+    int64_t mean_ns;
+    int64_t p99_ns;
+} ApmStageTiming;
+
 // Statistics from processing
 typedef struct ApmStats {
     double residual_echo_likelihood;
@@ -96,33 +178,151 @@ typedef struct ApmStats {
     int delay_median_ms;
     int delay_std_ms;
     int delay_ms;
+    // Length of the echo path covered by the AEC linear filter, 0 when the
+    // echo canceller is disabled.
+    int linear_filter_length_ms;
+
+    // Processing timings
+    ApmStageTiming capture_processing_time;
+    ApmStageTiming capture_band_split_time;
+    ApmStageTiming high_pass_filter_time;
+    ApmStageTiming echo_controller_time;
+    ApmStageTiming noise_suppressor_time;
+    ApmStageTiming gain_controller2_time;
+    ApmStageTiming render_processing_time;
+    ApmStageTiming render_band_split_time;
+    ApmStageTiming render_analysis_time;
 } ApmStats;
 
+// Get the echo canceller tuning of a preset, e.g. as a starting point for a
+// custom ApmEchoCancellation.aec3_config
+ApmEchoCanceller3Config GetEchoCanceller3Preset(Aec3Preset preset);
+
 // Create a new audio processor instance
-// Returns NULL on failure, sets error code
+// Returns NULL on failure, sets error code. An invalid aec3_config fails with
+// kBadParameterError.
 ApmHandle Create(ApmConfig apmConfig, int *error_code);
 
+// Create a group of audio processors that are fed the same render (speaker)
+// signal, e.g. one per microphone beam of a conference room device. Their
+// echo cancellers analyze each render frame once between them instead of once
+// each. Processors stay valid after the group is destroyed.
+ApmRenderGroup CreateRenderGroup(void);
+
+void DestroyRenderGroup(ApmRenderGroup group);
+
+// Like Create(), but the processor joins group, or no group when it is NULL.
+// Every processor of a group must be given the same render frames, and none
+// may fall more than 60ms of render audio behind another: one that does
+// resets its echo path delay estimate. A clone joins the group of its prototype.
+ApmHandle CreateInRenderGroup(ApmConfig apmConfig, ApmRenderGroup group, int *error_code);
+
 void Initialize(ApmHandle handle);
 
-// ApplyConfig to audio processor
+// ApplyConfig to audio processor. Only the submodules whose settings changed
+// are touched: when nothing but the AGC fixed gain or the capture level
+// adjustment gains changed, they are queued as runtime settings and take
+// effect from the next capture frame without re-initializing anything.
 void ApplyConfig(ApmHandle handle, ApmConfig apmConfig);
 
 // Destroy an audio processor instance
 void Destroy(ApmHandle handle);
 
+// Create a new audio processor with the same configuration, channels, sample
+// rate and render group as prototype, including later ApplyConfig() calls and
+// the current stream delay. Processing state is not copied: the new processor
+// starts fresh. Returns NULL on failure, sets error code
+ApmHandle CreateLike(ApmHandle prototype, int *error_code);
+
+// Return a processor to its just-created state without reallocating it:
+// re-initializes every submodule, restores the configured stream delay,
+// clears the muted and key-pressed flags and drops buffered streaming audio
+// and runtime gain changes not applied yet. The configuration is kept.
+void ResetHandle(ApmHandle handle);
+
+// Save the adaptive state of the echo canceller (linear filters, render
+// delay, ERL/ERLE estimates) and of the digital AGC (speech level, applied
+// gain) as a versioned binary blob, so that another handle can resume without
+// reconverging. If buffer is NULL or capacity is too small, nothing is written
+// and kBadDataLengthError is returned; *size always receives the blob length.
+// Returns 0 on success, error code on failure
+int SaveState(ApmHandle handle, uint8_t *buffer, int capacity, int *size);
+
+// Restore a blob written by SaveState(). The handle must have the same
+// config, channels and sample rate as the one that saved it; otherwise
+// kBadParameterError is returned and the handle is left unchanged.
+int LoadState(ApmHandle handle, const uint8_t *state, int size);
+
 // Process a capture (microphone) frame
-// samples: interleaved float samples, length = num_channels * NUM_SAMPLES_PER_FRAME
+// samples: interleaved float samples, length = num_channels * num_samples_per_frame(handle)
 // Returns 0 on success, error code on failure
 int ProcessStream(ApmHandle handle, float *samples, int num_channels);
 int ProcessIntStream(ApmHandle handle, int16_t *samples, int num_channels);
 
 // Process a render (speaker) frame for echo cancellation reference
-// samples: interleaved float samples, length = num_channels * NUM_SAMPLES_PER_FRAME
+// samples: interleaved float samples, length = num_channels * num_samples_per_frame(handle)
 // Returns 0 on success, error code on failure
 int ProcessReverseStream(ApmHandle handle, float *samples, int num_channels);
 int ProcessReverseIntStream(ApmHandle handle, int16_t *samples, int num_channels);
 
-// Get statistics from the last capture frame processing
+// Process a frame already split into channels, without staging copies.
+// channels: num_channels pointers, each to num_samples_per_frame(handle)
+// floats, processed in place. The buffers are handed straight to WebRTC.
+int ProcessStreamPlanar(ApmHandle handle, float *const *channels, int num_channels);
+int ProcessReverseStreamPlanar(ApmHandle handle, float *const *channels, int num_channels);
+
+// Streaming API for callers whose chunks are not 10ms long (jitter buffers,
+// 2.5-60ms Opus frames). Push any number of interleaved samples; every 10ms
+// frame that completes is processed immediately and queued for PullStream().
+// num_frames counts samples per channel. Audio waits in the push buffer for
+// at most num_samples_per_frame(handle) - 1 samples, which bounds the added
+// latency below 10ms; stream_pending_frames() reports the current amount.
+// PushStream() fails with kBadDataLengthError, consuming nothing, if the
+// frames it would complete do not fit in the APM_STREAM_MAX_BUFFERED_MS of
+// unpulled output. A frame that fails to process is passed through and its
+// error returned.
+int PushStream(ApmHandle handle, const float *samples, int num_frames, int num_channels);
+
+// Copy up to num_frames processed samples per channel into samples.
+// Returns the number of samples per channel copied.
+int PullStream(ApmHandle handle, float *samples, int num_frames, int num_channels);
+
+// Push render audio of any chunk size; complete 10ms frames are fed to the
+// echo canceller immediately. The processed render signal is discarded.
+int PushReverseStream(ApmHandle handle, const float *samples, int num_frames, int num_channels);
+
+// Capture samples per channel pushed but not yet processed
+int stream_pending_frames(ApmHandle handle);
+
+// Processed capture samples per channel ready to pull
+int stream_available_frames(ApmHandle handle);
+
+// Process num_frames consecutive 10ms frames in a single call. samples holds
+// the frames back to back, each interleaved, so its length is
+// num_frames * num_channels * num_samples_per_frame(handle). Frames are
+// processed in place and in order. If error_codes is non-NULL it must hold
+// num_frames entries and receives the result of each frame. Returns 0 if
+// every frame succeeded, otherwise the first failing frame's error code.
+int ProcessStreamBatch(ApmHandle handle, float *samples, int num_frames, int num_channels, int *error_codes);
+int ProcessIntStreamBatch(ApmHandle handle, int16_t *samples, int num_frames, int num_channels, int *error_codes);
+int ProcessReverseStreamBatch(ApmHandle handle, float *samples, int num_frames, int num_channels, int *error_codes);
+int ProcessReverseIntStreamBatch(ApmHandle handle, int16_t *samples, int num_frames, int num_channels,
+                                 int *error_codes);
+
+// Process one full-duplex 10ms tick in a single call: the render frame is fed
+// to the echo canceller first, then the capture frame is processed. Both
+// buffers are interleaved and processed in place. The capture frame is
+// processed even if the render frame fails; the render error is returned in
+// that case. If stats is non-NULL it receives the statistics after the
+// capture frame, as GetStatistics() would return them.
+int ProcessDuplex(ApmHandle handle, float *render, int render_channels, float *capture, int capture_channels,
+                  ApmStats *stats);
+int ProcessIntDuplex(ApmHandle handle, int16_t *render, int render_channels, int16_t *capture, int capture_channels,
+                     ApmStats *stats);
+
+// Get statistics from the last capture frame processing. Safe to call from any
+// thread while frames are being processed: the statistics are read from a
+// snapshot published once per frame, without taking the processing locks.
 ApmStats GetStatistics(ApmHandle handle);
 
 // Set stream delay for echo cancellation (in milliseconds)
@@ -149,12 +349,18 @@ void set_stream_key_pressed(ApmHandle handle, bool pressed);
 // Check if a return code indicates success
 int is_success(int code);
 
-// Get the number of samples per frame for the fixed sample rate
+// Get the number of samples per frame for the default sample rate
 int get_num_samples_per_frame(void);
 
-// Get the sample rate in Hz
+// Get the default sample rate in Hz
 int get_sample_rate_hz(void);
 
+// Get the number of samples per channel in one 10ms frame of this handle
+int num_samples_per_frame(ApmHandle handle);
+
+// Get the sample rate in Hz this handle was created with
+int sample_rate_hz(ApmHandle handle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,7 +1,10 @@
 package apm
 
 import (
+	"bytes"
+	"fmt"
 	"math"
+	"sync"
 	"testing"
 )
 
@@ -95,6 +98,220 @@ func TestCreateInvalidChannels(t *testing.T) {
 	}
 }
 
+func TestCreateSampleRates(t *testing.T) {
+	for _, rate := range []int{8000, 16000, 32000, 48000} {
+		config := Config{
+			CaptureChannels: 1,
+			RenderChannels:  1,
+			SampleRateHz:    rate,
+		}
+
+		h, err := Create(config)
+		if err != nil {
+			t.Fatalf("Create at %d Hz failed: %v", rate, err)
+		}
+		if h.SampleRateHz() != rate {
+			t.Errorf("SampleRateHz() = %d, want %d", h.SampleRateHz(), rate)
+		}
+		if h.NumSamplesPerFrame() != rate/100 {
+			t.Errorf("NumSamplesPerFrame() = %d, want %d", h.NumSamplesPerFrame(), rate/100)
+		}
+		h.Destroy()
+	}
+}
+
+func TestCreateDefaultSampleRate(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	if h.SampleRateHz() != SampleRateHz {
+		t.Errorf("SampleRateHz() = %d, want %d", h.SampleRateHz(), SampleRateHz)
+	}
+	if h.NumSamplesPerFrame() != NumSamplesPerFrame {
+		t.Errorf("NumSamplesPerFrame() = %d, want %d", h.NumSamplesPerFrame(), NumSamplesPerFrame)
+	}
+}
+
+func TestCreateInvalidSampleRate(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		SampleRateHz:    44100,
+	}
+
+	h, err := Create(config)
+	if err == nil {
+		h.Destroy()
+		t.Fatal("Create should fail with 44100 Hz")
+	}
+}
+
+func TestCreateEchoCancellerPresets(t *testing.T) {
+	// The linear filter length each preset reports once it has converged on an
+	// echo path with a 30 ms reverberant tail, which keeps the adaptive length
+	// from shortening the longer filters.
+	tests := []struct {
+		preset       EchoCancellerPresetName
+		minMs, maxMs int
+	}{
+		{EchoCancellerPresetDefault, defaultLinearFilterLengthMs, defaultLinearFilterLengthMs},
+		{EchoCancellerPresetLowCPUServer, minLinearFilterLengthMs, defaultLinearFilterLengthMs - 1},
+		{EchoCancellerPresetHighQualityDesktop, defaultLinearFilterLengthMs + 1, math.MaxInt},
+	}
+	for _, tt := range tests {
+		tuning := EchoCancellerPreset(tt.preset)
+		config := Config{
+			CaptureChannels: 1,
+			RenderChannels:  1,
+			SampleRateHz:    16000,
+			EchoCancellation: EchoCancellationConfig{
+				Enabled: true,
+				Tuning:  &tuning,
+			},
+		}
+
+		h, err := Create(config)
+		if err != nil {
+			t.Fatalf("Create with preset %d failed: %v", tt.preset, err)
+		}
+
+		e := &echoPathSimulator{h: make([]float32, 480), delay: 480, seed: 1}
+		for k, g := 0, float32(0.5); k < len(e.h); k, g = k+1, g*-0.993 {
+			e.h[k] = g
+		}
+		processEchoPath(t, h, e, 800)
+
+		maxLengthMs := min(tt.maxMs, tuning.RefinedLengthBlocks*4)
+		if got := h.GetStats().LinearFilterLengthMs; got < tt.minMs || got > maxLengthMs {
+			t.Errorf("preset %d: linear filter length %d ms, want %d to %d ms",
+				tt.preset, got, tt.minMs, maxLengthMs)
+		}
+		h.Destroy()
+	}
+}
+
+func TestCreateInvalidEchoCancellerTuning(t *testing.T) {
+	tuning := EchoCancellerPreset(EchoCancellerPresetDefault)
+	tuning.DownSamplingFactor = 3
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+			Tuning:  &tuning,
+		},
+	}
+
+	h, err := Create(config)
+	if err == nil {
+		h.Destroy()
+		t.Fatal("Create should fail with a down-sampling factor of 3")
+	}
+}
+
+func TestEchoCancellerClockDriftCompensation(t *testing.T) {
+	const numFrames = 3000
+	tuning := EchoCancellerPreset(EchoCancellerPresetDefault)
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		SampleRateHz:    16000,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+			Tuning:  &tuning,
+		},
+	}
+
+	// process runs a call where the loudspeaker clock runs drift samples per
+	// sample fast: the render device pulls an extra frame now and then, and
+	// plays the render faster than the microphone records. It returns the
+	// echo attenuation over the last 15 s and the capture output.
+	process := func(drift float64, compensate bool) (attenuation float64, output []float32) {
+		tuning.CompensateClockDrift = compensate
+		h, err := Create(config)
+		if err != nil {
+			t.Fatalf("Create failed: %v", err)
+		}
+		defer h.Destroy()
+
+		n := h.NumSamplesPerFrame()
+		render := make([]float32, numFrames*n*11/10)
+		seed, lowpass := uint32(1), float32(0)
+		for i := range render {
+			seed = seed*1664525 + 1013904223
+			lowpass = 0.5*lowpass + 0.5*(float32(seed>>8)/16777216-0.5)
+			render[i] = lowpass
+		}
+		echo := func(t float64) float32 {
+			if t < 0 {
+				return 0
+			}
+			i := int(t)
+			f := float32(t - float64(i))
+			return 0.5 * ((1-f)*render[i] + f*render[i+1])
+		}
+
+		renderFrame := make([]float32, n)
+		capture := make([]float32, n)
+		var in, out float64
+		sent := 0
+		for i := 0; i < numFrames; i++ {
+			for float64(sent) < float64(i+1)*(1+drift) {
+				copy(renderFrame, render[sent*n:])
+				if err := h.ProcessRenderFrame(renderFrame, 1); err != nil {
+					t.Fatalf("ProcessRenderFrame failed at frame %d: %v", i, err)
+				}
+				sent++
+			}
+			for k := range capture {
+				capture[k] = echo(float64(i*n+k-800) * (1 + drift))
+			}
+			if i >= numFrames/2 {
+				for _, x := range capture {
+					in += float64(x) * float64(x)
+				}
+			}
+			if err := h.ProcessCaptureFrame(capture, 1); err != nil {
+				t.Fatalf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+			}
+			if i >= numFrames/2 {
+				for _, x := range capture {
+					out += float64(x) * float64(x)
+				}
+			}
+			output = append(output, capture...)
+		}
+		return 10 * math.Log10(in/out), output
+	}
+
+	// 300 ppm fast. The rate the delay estimator measures and the resampling
+	// are checked in internal/kerneltest.
+	uncompensated, _ := process(300e-6, false)
+	compensated, _ := process(300e-6, true)
+	t.Logf("echo attenuation over the last 15 s: %.2f dB, compensated %.2f dB", uncompensated, compensated)
+	if compensated <= uncompensated {
+		t.Errorf("drift compensation lowered the echo attenuation from %.2f dB to %.2f dB", uncompensated, compensated)
+	}
+
+	// Without drift the compensation never starts, and the render signal and
+	// so the output are exactly those without it.
+	_, want := process(0, false)
+	_, got := process(0, true)
+	for k := range want {
+		if got[k] != want[k] {
+			t.Fatalf("without drift, sample %d with compensation %g, want %g", k, got[k], want[k])
+		}
+	}
+}
+
 // =============================================================================
 // Configuration Tests
 // =============================================================================
@@ -132,6 +349,84 @@ func TestSetConfigNoiseSuppression(t *testing.T) {
 	defer h.Destroy()
 }
 
+func TestNoiseSuppressionMatchesScalarReference(t *testing.T) {
+	// Noise attenuation in the pauses between tone bursts, measured with the
+	// scalar per-bin computations and the Ooura FFT. The SIMD kernels and the
+	// pffft FFT round differently and must stay within the tolerance.
+	const toleranceDb = 0.05
+	const numFrames = 1000
+	tests := []struct {
+		sampleRateHz int
+		channels     int
+		level        NsLevel
+		want         []float64
+	}{
+		{16000, 1, NsLevelHigh, []float64{16.5132}},
+		{32000, 1, NsLevelLow, []float64{5.9694}},
+		{48000, 2, NsLevelVeryHigh, []float64{17.4566, 17.4430}},
+	}
+
+	for _, tt := range tests {
+		config := Config{
+			CaptureChannels:     tt.channels,
+			RenderChannels:      1,
+			SampleRateHz:        tt.sampleRateHz,
+			MultiChannelCapture: true,
+			NoiseSuppression: NoiseSuppressionConfig{
+				Enabled:          true,
+				SuppressionLevel: tt.level,
+			},
+		}
+		h, err := Create(config)
+		if err != nil {
+			t.Fatalf("Create failed: %v", err)
+		}
+
+		n := h.NumSamplesPerFrame()
+		frame := make([]float32, n*tt.channels)
+		in := make([]float64, tt.channels)
+		out := make([]float64, tt.channels)
+		seed := uint32(1)
+		for i := 0; i < numFrames; i++ {
+			for j := 0; j < n; j++ {
+				ts := float64(i*n+j) / float64(tt.sampleRateHz)
+				for ch := 0; ch < tt.channels; ch++ {
+					seed = seed*1664525 + 1013904223
+					x := 0.02 * (float32(seed>>8)/16777216 - 0.5)
+					if math.Mod(ts, 1) < 0.5 {
+						x += float32(0.1 * math.Sin(2*math.Pi*float64(300+100*ch)*ts))
+					}
+					frame[j*tt.channels+ch] = x
+				}
+			}
+			// Skips the first 100 ms of each pause, which hold the tail of the
+			// delayed burst.
+			measured := i >= numFrames/2 && math.Mod(float64(i*n)/float64(tt.sampleRateHz), 1) >= 0.6
+			if measured {
+				for j, x := range frame {
+					in[j%tt.channels] += float64(x) * float64(x)
+				}
+			}
+			if err := h.ProcessCaptureFrame(frame, tt.channels); err != nil {
+				t.Fatalf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+			}
+			if measured {
+				for j, x := range frame {
+					out[j%tt.channels] += float64(x) * float64(x)
+				}
+			}
+		}
+		h.Destroy()
+
+		for ch := 0; ch < tt.channels; ch++ {
+			got := 10 * math.Log10(in[ch]/out[ch])
+			if math.Abs(got-tt.want[ch]) > toleranceDb {
+				t.Errorf("%d Hz, level %d, channel %d: noise attenuation %.4f dB, want %.4f dB", tt.sampleRateHz, tt.level, ch, got, tt.want[ch])
+			}
+		}
+	}
+}
+
 func TestSetConfigGainControl(t *testing.T) {
 	config := Config{
 		CaptureChannels: 1,
@@ -172,32 +467,1111 @@ func TestSetConfigAll(t *testing.T) {
 		},
 	}
 
-	h, err := Create(config)
-	if err != nil {
-		t.Fatalf("Create failed: %v", err)
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+}
+
+func TestSetConfigWithStreamDelay(t *testing.T) {
+	delayMs := 50
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled:       true,
+			StreamDelayMs: delayMs,
+		},
+		GainControl: GainControlConfig{
+			Enabled:           true,
+			Mode:              AgcModeAdaptiveDigital,
+			TargetLevelDbfs:   3,
+			CompressionGainDb: 9,
+			EnableLimiter:     true,
+		},
+		NoiseSuppression: NoiseSuppressionConfig{
+			Enabled:          true,
+			SuppressionLevel: NsLevelHigh,
+		},
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+}
+
+func TestApplyConfigUnchangedKeepsState(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+		NoiseSuppression: NoiseSuppressionConfig{
+			Enabled:          true,
+			SuppressionLevel: NsLevelHigh,
+		},
+		HighPassFilterEnabled: true,
+	}
+
+	reapplied, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer reapplied.Destroy()
+	untouched, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer untouched.Destroy()
+
+	input := generateSineWave(440, 0.5, NumSamplesPerFrame)
+	for i := 0; i < 20; i++ {
+		if i == 10 {
+			reapplied.ApplyConfig(config)
+		}
+		got := append([]float32(nil), input...)
+		want := append([]float32(nil), input...)
+		if err := reapplied.ProcessCaptureFrame(got, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed: %v", err)
+		}
+		if err := untouched.ProcessCaptureFrame(want, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed: %v", err)
+		}
+		for j := range want {
+			if got[j] != want[j] {
+				t.Fatalf("frame %d sample %d: %v after re-applying the config, want %v", i, j, got[j], want[j])
+			}
+		}
+	}
+}
+
+func TestApplyConfigFixedGain(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		GainControl: GainControlConfig{
+			Enabled:    true,
+			HeadroomDB: 5,
+			MaxGainDB:  1,
+		},
+	}
+
+	boosted, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer boosted.Destroy()
+	reference, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer reference.Destroy()
+
+	gainConfig := config
+	gainConfig.GainControl.GainDB = 12
+	boosted.ApplyConfig(gainConfig)
+
+	input := generateSineWave(440, 0.01, NumSamplesPerFrame)
+	got := make([]float32, NumSamplesPerFrame)
+	want := make([]float32, NumSamplesPerFrame)
+	for i := 0; i < 20; i++ {
+		copy(got, input)
+		copy(want, input)
+		if err := boosted.ProcessCaptureFrame(got, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed: %v", err)
+		}
+		if err := reference.ProcessCaptureFrame(want, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed: %v", err)
+		}
+	}
+
+	var gotEnergy, wantEnergy float64
+	for i := range got {
+		gotEnergy += float64(got[i]) * float64(got[i])
+		wantEnergy += float64(want[i]) * float64(want[i])
+	}
+	// 12dB is an amplitude ratio of about 4
+	if ratio := math.Sqrt(gotEnergy / wantEnergy); ratio < 3.5 || ratio > 4.5 {
+		t.Errorf("amplitude ratio after a 12dB fixed gain = %.2f, want about 4", ratio)
+	}
+}
+
+// A full apply made while a runtime gain is still queued must win over it.
+func TestApplyConfigGainBeforeFullApply(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		GainControl: GainControlConfig{
+			Enabled:    true,
+			HeadroomDB: 5,
+			MaxGainDB:  1,
+		},
+	}
+	final := config
+	final.GainControl.GainDB = 0
+	final.NoiseSuppression = NoiseSuppressionConfig{Enabled: true, SuppressionLevel: NsLevelLow}
+
+	p, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer p.Destroy()
+	reference, err := Create(final)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer reference.Destroy()
+
+	gainConfig := config
+	gainConfig.GainControl.GainDB = 12
+	p.ApplyConfig(gainConfig)
+	p.ApplyConfig(final)
+	// Applying the same config again posts nothing.
+	p.ApplyConfig(final)
+
+	input := generateSineWave(440, 0.01, NumSamplesPerFrame)
+	got := make([]float32, NumSamplesPerFrame)
+	want := make([]float32, NumSamplesPerFrame)
+	for i := 0; i < 20; i++ {
+		copy(got, input)
+		copy(want, input)
+		if err := p.ProcessCaptureFrame(got, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed: %v", err)
+		}
+		if err := reference.ProcessCaptureFrame(want, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed: %v", err)
+		}
+	}
+
+	var gotEnergy, wantEnergy float64
+	for i := range got {
+		gotEnergy += float64(got[i]) * float64(got[i])
+		wantEnergy += float64(want[i]) * float64(want[i])
+	}
+	if ratio := math.Sqrt(gotEnergy / wantEnergy); ratio < 0.9 || ratio > 1.1 {
+		t.Errorf("amplitude ratio to a handle created with the final config = %.2f, want 1", ratio)
+	}
+}
+
+// =============================================================================
+// Processing Tests
+// =============================================================================
+
+func TestProcessCaptureFrame(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	samples := generateSineWave(440, 0.5, NumSamplesPerFrame)
+
+	err = h.ProcessCaptureFrame(samples, 1)
+	if err != nil {
+		t.Fatalf("ProcessCaptureFrame failed: %v", err)
+	}
+}
+
+func TestProcessRenderAndCapture16k(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		SampleRateHz:    16000,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+		NoiseSuppression: NoiseSuppressionConfig{
+			Enabled: true,
+		},
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	renderSamples := generateSineWave(1000, 0.4, h.NumSamplesPerFrame())
+	captureSamples := generateSineWave(500, 0.3, h.NumSamplesPerFrame())
+
+	for i := 0; i < 50; i++ {
+		if err := h.ProcessRenderFrame(renderSamples, 1); err != nil {
+			t.Fatalf("ProcessRenderFrame failed at frame %d: %v", i, err)
+		}
+		if err := h.ProcessCaptureFrame(captureSamples, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+		}
+	}
+
+	// A 48 kHz frame must be rejected by a 16 kHz handle
+	if err := h.ProcessCaptureFrame(make([]float32, NumSamplesPerFrame), 1); err == nil {
+		t.Error("ProcessCaptureFrame should fail with a 48 kHz frame on a 16 kHz handle")
+	}
+}
+
+func TestProcessCaptureFrameStereo(t *testing.T) {
+	config := Config{
+		CaptureChannels: 2,
+		RenderChannels:  2,
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	// Interleaved stereo samples
+	samples := make([]float32, NumSamplesPerFrame*2)
+	for i := 0; i < NumSamplesPerFrame; i++ {
+		samples[i*2] = float32(math.Sin(2*math.Pi*440*float64(i)/float64(SampleRateHz))) * 0.5
+		samples[i*2+1] = float32(math.Sin(2*math.Pi*880*float64(i)/float64(SampleRateHz))) * 0.3
+	}
+
+	err = h.ProcessCaptureFrame(samples, 2)
+	if err != nil {
+		t.Fatalf("ProcessCaptureFrame failed: %v", err)
+	}
+}
+
+func TestProcessRenderFrame(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	samples := generateSineWave(1000, 0.4, NumSamplesPerFrame)
+
+	err = h.ProcessRenderFrame(samples, 1)
+	if err != nil {
+		t.Fatalf("ProcessRenderFrame failed: %v", err)
+	}
+}
+
+func TestProcessRenderAndCapture(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	renderSamples := generateSineWave(1000, 0.4, NumSamplesPerFrame)
+	captureSamples := generateSineWave(500, 0.3, NumSamplesPerFrame)
+
+	for i := 0; i < 50; i++ {
+		err := h.ProcessRenderFrame(renderSamples, 1)
+		if err != nil {
+			t.Fatalf("ProcessRenderFrame failed at frame %d: %v", i, err)
+		}
+
+		err = h.ProcessCaptureFrame(captureSamples, 1)
+		if err != nil {
+			t.Fatalf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+		}
+	}
+}
+
+func TestRenderGroupMatchesUnshared(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+	}
+
+	group := NewRenderGroup()
+	const numBeams = 3
+	grouped := make([]*Handle, numBeams)
+	unshared := make([]*Handle, numBeams)
+	for beam := range grouped {
+		var err error
+		if beam == 0 {
+			grouped[beam], err = CreateInRenderGroup(config, group)
+		} else {
+			grouped[beam], err = grouped[0].CreateLike()
+		}
+		if err != nil {
+			t.Fatalf("creating grouped beam %d failed: %v", beam, err)
+		}
+		defer grouped[beam].Destroy()
+		if unshared[beam], err = CreateInRenderGroup(config, nil); err != nil {
+			t.Fatalf("creating unshared beam %d failed: %v", beam, err)
+		}
+		defer unshared[beam].Destroy()
+	}
+	// The processors keep the shared analysis alive.
+	group.Destroy()
+	if _, err := CreateInRenderGroup(config, group); err == nil {
+		t.Error("CreateInRenderGroup with a destroyed group succeeded")
+	}
+
+	render := make([]float32, NumSamplesPerFrame)
+	want := make([]float32, NumSamplesPerFrame)
+	got := make([]float32, NumSamplesPerFrame)
+	for i := 0; i < 100; i++ {
+		previous := append([]float32(nil), render...)
+		for n := range render {
+			render[n] = 0.4 * float32(math.Sin(float64(i*NumSamplesPerFrame+n)*0.37))
+		}
+		for beam := 0; beam < numBeams; beam++ {
+			// Each beam hears the echo of the last frame and its own talker.
+			capture := generateSineWave(200*float64(beam+1), 0.1, NumSamplesPerFrame)
+			for n := range capture {
+				capture[n] += 0.5 * previous[n]
+			}
+			copy(want, capture)
+			copy(got, capture)
+			if err := unshared[beam].ProcessRenderFrame(render, 1); err != nil {
+				t.Fatalf("ProcessRenderFrame failed at frame %d: %v", i, err)
+			}
+			if err := unshared[beam].ProcessCaptureFrame(want, 1); err != nil {
+				t.Fatalf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+			}
+			if err := grouped[beam].ProcessRenderFrame(render, 1); err != nil {
+				t.Fatalf("ProcessRenderFrame failed at frame %d: %v", i, err)
+			}
+			if err := grouped[beam].ProcessCaptureFrame(got, 1); err != nil {
+				t.Fatalf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+			}
+			for n := range want {
+				if got[n] != want[n] {
+					t.Fatalf("frame %d beam %d sample %d: grouped %v, unshared %v", i, beam, n, got[n], want[n])
+				}
+			}
+		}
+	}
+}
+
+// renderGroupFrame returns the render frame i and the capture frame of beam,
+// which hears the echo of the previous render frame and its own talker.
+func renderGroupFrame(i, beam int) (render, capture []float32) {
+	render = make([]float32, NumSamplesPerFrame)
+	previous := make([]float32, NumSamplesPerFrame)
+	for n := range render {
+		render[n] = 0.4 * float32(math.Sin(float64(i*NumSamplesPerFrame+n)*0.37))
+		if i > 0 {
+			previous[n] = 0.4 * float32(math.Sin(float64((i-1)*NumSamplesPerFrame+n)*0.37))
+		}
+	}
+	capture = generateSineWave(200*float64(beam+1), 0.1, NumSamplesPerFrame)
+	for n := range capture {
+		capture[n] += 0.5 * previous[n]
+	}
+	return render, capture
+}
+
+func TestRenderGroupConcurrentBeams(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+	}
+	const numBeams = 4
+	const numFrames = 200
+
+	// The output of each beam without sharing, to compare with.
+	want := make([][][]float32, numBeams)
+	for beam := range want {
+		h, err := CreateInRenderGroup(config, nil)
+		if err != nil {
+			t.Fatalf("creating unshared beam %d failed: %v", beam, err)
+		}
+		for i := 0; i < numFrames; i++ {
+			render, capture := renderGroupFrame(i, beam)
+			if err := h.ProcessRenderFrame(render, 1); err != nil {
+				t.Fatalf("ProcessRenderFrame failed at frame %d: %v", i, err)
+			}
+			if err := h.ProcessCaptureFrame(capture, 1); err != nil {
+				t.Fatalf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+			}
+			want[beam] = append(want[beam], capture)
+		}
+		h.Destroy()
+	}
+
+	newGroup := func(t *testing.T) []*Handle {
+		group := NewRenderGroup()
+		defer group.Destroy()
+		beams := make([]*Handle, numBeams)
+		for beam := range beams {
+			var err error
+			if beams[beam], err = CreateInRenderGroup(config, group); err != nil {
+				t.Fatalf("creating grouped beam %d failed: %v", beam, err)
+			}
+			t.Cleanup(beams[beam].Destroy)
+		}
+		return beams
+	}
+
+	// run processes frames [from, to) of each beam on its own goroutine.
+	run := func(t *testing.T, beams []*Handle, from, to []int) [][][]float32 {
+		got := make([][][]float32, len(beams))
+		errs := make([]error, len(beams))
+		var wg sync.WaitGroup
+		for beam, h := range beams {
+			wg.Add(1)
+			go func(beam int, h *Handle) {
+				defer wg.Done()
+				for i := from[beam]; i < to[beam]; i++ {
+					render, capture := renderGroupFrame(i, beam)
+					if err := h.ProcessRenderFrame(render, 1); err != nil {
+						errs[beam] = fmt.Errorf("ProcessRenderFrame failed at frame %d: %v", i, err)
+						return
+					}
+					if err := h.ProcessCaptureFrame(capture, 1); err != nil {
+						errs[beam] = fmt.Errorf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+						return
+					}
+					got[beam] = append(got[beam], capture)
+				}
+			}(beam, h)
+		}
+		wg.Wait()
+		for beam, err := range errs {
+			if err != nil {
+				t.Fatalf("beam %d: %v", beam, err)
+			}
+		}
+		return got
+	}
+
+	t.Run("WithinSkew", func(t *testing.T) {
+		// The beams run concurrently in steps of 40ms, within the 60ms the
+		// beams of a group may be apart, so sharing the analysis must not
+		// change their output.
+		beams := newGroup(t)
+		const step = 4
+		for i := 0; i < numFrames; i += step {
+			from := []int{i, i, i, i}
+			to := []int{i + step, i + step, i + step, i + step}
+			got := run(t, beams, from, to)
+			for beam := range beams {
+				for k, frame := range got[beam] {
+					for n := range frame {
+						if frame[n] != want[beam][i+k][n] {
+							t.Fatalf("frame %d beam %d sample %d: grouped %v, unshared %v",
+								i+k, beam, n, frame[n], want[beam][i+k][n])
+						}
+					}
+				}
+			}
+		}
+	})
+
+	t.Run("BeyondSkew", func(t *testing.T) {
+		// Beam 0 falls 200ms behind the others while they all run
+		// concurrently, then catches up. It must recover instead of reading
+		// render data that the others have overwritten.
+		beams := newGroup(t)
+		run(t, beams, []int{0, 0, 0, 0}, []int{50, 70, 70, 70})
+		run(t, beams, []int{50, 70, 70, 70}, []int{numFrames, numFrames, numFrames, numFrames})
+		got := run(t, beams, []int{numFrames, numFrames, numFrames, numFrames},
+			[]int{numFrames + 1, numFrames + 1, numFrames + 1, numFrames + 1})
+		for beam := range beams {
+			for n, v := range got[beam][0] {
+				if math.IsNaN(float64(v)) || math.IsInf(float64(v), 0) || math.Abs(float64(v)) > 1 {
+					t.Fatalf("beam %d sample %d after catching up: %v", beam, n, v)
+				}
+			}
+		}
+	})
+}
+
+func TestEchoCancellerWorkerThreadsMatchSerial(t *testing.T) {
+	const numChannels = 4
+	config := Config{
+		CaptureChannels:     numChannels,
+		RenderChannels:      1,
+		MultiChannelCapture: true,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+	}
+
+	serial, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer serial.Destroy()
+	config.EchoCancellation.WorkerThreads = 3
+	parallel, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create with worker threads failed: %v", err)
+	}
+	defer parallel.Destroy()
+
+	render := make([]float32, NumSamplesPerFrame)
+	want := make([]float32, numChannels*NumSamplesPerFrame)
+	got := make([]float32, numChannels*NumSamplesPerFrame)
+	for i := 0; i < 100; i++ {
+		for n := range render {
+			render[n] = 0.4 * float32(math.Sin(float64(i*NumSamplesPerFrame+n)*0.37))
+		}
+		// Each microphone hears the echo at its own level and its own talker.
+		for n := 0; n < NumSamplesPerFrame; n++ {
+			for ch := 0; ch < numChannels; ch++ {
+				talker := 0.1 * math.Sin(float64(i*NumSamplesPerFrame+n)*0.05*float64(ch+1))
+				want[n*numChannels+ch] = float32(0.2*float64(ch+1))*render[n] + float32(talker)
+			}
+		}
+		copy(got, want)
+		for _, h := range []*Handle{serial, parallel} {
+			if err := h.ProcessRenderFrame(render, 1); err != nil {
+				t.Fatalf("ProcessRenderFrame failed at frame %d: %v", i, err)
+			}
+		}
+		if err := serial.ProcessCaptureFrame(want, numChannels); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+		}
+		if err := parallel.ProcessCaptureFrame(got, numChannels); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+		}
+		for n := range want {
+			if got[n] != want[n] {
+				t.Fatalf("frame %d sample %d: parallel %v, serial %v", i, n, got[n], want[n])
+			}
+		}
+	}
+}
+
+func TestCreateInvalidEchoCancellerWorkerThreads(t *testing.T) {
+	for _, threads := range []int{-1, 17} {
+		config := Config{
+			CaptureChannels:     2,
+			RenderChannels:      1,
+			MultiChannelCapture: true,
+			EchoCancellation: EchoCancellationConfig{
+				Enabled:       true,
+				WorkerThreads: threads,
+			},
+		}
+		if h, err := Create(config); err == nil {
+			h.Destroy()
+			t.Errorf("Create with %d worker threads succeeded", threads)
+		}
+	}
+}
+
+func TestProcessCaptureFrameWrongChannels(t *testing.T) {
+	config := Config{
+		CaptureChannels: 2,
+		RenderChannels:  2,
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	// Provide mono samples for stereo processor
+	samples := generateSineWave(440, 0.5, NumSamplesPerFrame)
+
+	err = h.ProcessCaptureFrame(samples, 1)
+	if err == nil {
+		t.Error("ProcessCaptureFrame should fail with wrong channel count")
+	}
+}
+
+func TestProcessCaptureFrameWrongSampleCount(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	// Provide wrong number of samples
+	samples := make([]float32, NumSamplesPerFrame-10)
+
+	err = h.ProcessCaptureFrame(samples, 1)
+	if err == nil {
+		t.Error("ProcessCaptureFrame should fail with wrong sample count")
+	}
+}
+
+func TestProcessPlanarMatchesInterleaved(t *testing.T) {
+	config := Config{
+		CaptureChannels: 2,
+		RenderChannels:  2,
+		NoiseSuppression: NoiseSuppressionConfig{
+			Enabled: true,
+		},
+	}
+
+	interleaved, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer interleaved.Destroy()
+	planar, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer planar.Destroy()
+
+	left := generateSineWave(440, 0.5, NumSamplesPerFrame)
+	right := generateSineWave(880, 0.3, NumSamplesPerFrame)
+	samples := make([]float32, 2*NumSamplesPerFrame)
+	for i := 0; i < NumSamplesPerFrame; i++ {
+		samples[i*2] = left[i]
+		samples[i*2+1] = right[i]
+	}
+
+	if err := interleaved.ProcessRenderFrame(append([]float32(nil), samples...), 2); err != nil {
+		t.Fatalf("ProcessRenderFrame failed: %v", err)
+	}
+	if err := planar.ProcessRenderPlanar([][]float32{append([]float32(nil), left...), append([]float32(nil), right...)}); err != nil {
+		t.Fatalf("ProcessRenderPlanar failed: %v", err)
+	}
+
+	if err := interleaved.ProcessCaptureFrame(samples, 2); err != nil {
+		t.Fatalf("ProcessCaptureFrame failed: %v", err)
+	}
+	if err := planar.ProcessCapturePlanar([][]float32{left, right}); err != nil {
+		t.Fatalf("ProcessCapturePlanar failed: %v", err)
+	}
+
+	for i := 0; i < NumSamplesPerFrame; i++ {
+		if left[i] != samples[i*2] || right[i] != samples[i*2+1] {
+			t.Fatalf("sample %d: planar (%v, %v), interleaved (%v, %v)", i, left[i], right[i], samples[i*2], samples[i*2+1])
+		}
+	}
+
+	if err := planar.ProcessCapturePlanar([][]float32{left}); err == nil {
+		t.Error("ProcessCapturePlanar should fail with wrong channel count")
+	}
+	if err := planar.ProcessCapturePlanar([][]float32{left, right[:10]}); err == nil {
+		t.Error("ProcessCapturePlanar should fail with a short channel")
+	}
+}
+
+func TestProcessIntMatchesFloat(t *testing.T) {
+	// The int16 frames must come out as the float frames do, rounded half away
+	// from zero, including clipped samples.
+	toS16 := func(v float32) int16 {
+		v *= 32768
+		v = min(max(v, -32768), 32767)
+		if v < 0 {
+			return int16(v - 0.5)
+		}
+		return int16(v + 0.5)
+	}
+	for _, channels := range []int{1, 2, 3} {
+		t.Run(fmt.Sprintf("%d channels", channels), func(t *testing.T) {
+			config := Config{
+				CaptureChannels:  channels,
+				RenderChannels:   channels,
+				SampleRateHz:     48000,
+				EchoCancellation: EchoCancellationConfig{Enabled: true},
+				NoiseSuppression: NoiseSuppressionConfig{Enabled: true},
+			}
+			floats, err := Create(config)
+			if err != nil {
+				t.Fatalf("Create failed: %v", err)
+			}
+			defer floats.Destroy()
+			ints, err := Create(config)
+			if err != nil {
+				t.Fatalf("Create failed: %v", err)
+			}
+			defer ints.Destroy()
+
+			n := floats.NumSamplesPerFrame() * channels
+			seed := uint32(channels)
+			for i := 0; i < 50; i++ {
+				render := make([]int16, n)
+				capture := make([]int16, n)
+				for k := range render {
+					seed = seed*1664525 + 1013904223
+					render[k] = int16(seed >> 16)
+					capture[k] = render[k] / 2
+				}
+				renderFloat := make([]float32, n)
+				captureFloat := make([]float32, n)
+				for k := range render {
+					renderFloat[k] = float32(render[k]) / 32768
+					captureFloat[k] = float32(capture[k]) / 32768
+				}
+
+				if err := floats.ProcessRenderFrame(renderFloat, channels); err != nil {
+					t.Fatalf("ProcessRenderFrame failed: %v", err)
+				}
+				if err := ints.ProcessRenderIntFrame(render, channels); err != nil {
+					t.Fatalf("ProcessRenderIntFrame failed: %v", err)
+				}
+				if err := floats.ProcessCaptureFrame(captureFloat, channels); err != nil {
+					t.Fatalf("ProcessCaptureFrame failed: %v", err)
+				}
+				if err := ints.ProcessCaptureIntFrame(capture, channels); err != nil {
+					t.Fatalf("ProcessCaptureIntFrame failed: %v", err)
+				}
+				for k := range capture {
+					if want := toS16(captureFloat[k]); capture[k] != want {
+						t.Fatalf("frame %d, sample %d: int16 output %d, float output %v", i, k, capture[k], captureFloat[k])
+					}
+				}
+			}
+		})
+	}
+}
+
+func TestProcessFramesBatch(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	const numFrames = 6
+	renderSamples := generateSineWave(1000, 0.4, numFrames*NumSamplesPerFrame)
+	captureSamples := generateSineWave(500, 0.3, numFrames*NumSamplesPerFrame)
+
+	if err := h.ProcessRenderFrames(renderSamples, 1); err != nil {
+		t.Fatalf("ProcessRenderFrames failed: %v", err)
+	}
+	if err := h.ProcessCaptureFrames(captureSamples, 1); err != nil {
+		t.Fatalf("ProcessCaptureFrames failed: %v", err)
+	}
+
+	intSamples := make([]int16, numFrames*NumSamplesPerFrame)
+	if err := h.ProcessRenderIntFrames(intSamples, 1); err != nil {
+		t.Fatalf("ProcessRenderIntFrames failed: %v", err)
+	}
+	if err := h.ProcessCaptureIntFrames(intSamples, 1); err != nil {
+		t.Fatalf("ProcessCaptureIntFrames failed: %v", err)
+	}
+}
+
+func TestProcessFramesBatchMatchesSingle(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		NoiseSuppression: NoiseSuppressionConfig{
+			Enabled: true,
+		},
+	}
+
+	single, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer single.Destroy()
+	batched, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer batched.Destroy()
+
+	const numFrames = 4
+	want := generateSineWave(440, 0.5, numFrames*NumSamplesPerFrame)
+	got := append([]float32(nil), want...)
+
+	for i := 0; i < numFrames; i++ {
+		if err := single.ProcessCaptureFrame(want[i*NumSamplesPerFrame:(i+1)*NumSamplesPerFrame], 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+		}
+	}
+	if err := batched.ProcessCaptureFrames(got, 1); err != nil {
+		t.Fatalf("ProcessCaptureFrames failed: %v", err)
+	}
+
+	for i := range want {
+		if got[i] != want[i] {
+			t.Fatalf("sample %d: batched %v, single %v", i, got[i], want[i])
+		}
+	}
+}
+
+func TestProcessFramesBatchPartialFrame(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	samples := make([]float32, 2*NumSamplesPerFrame+10)
+	if err := h.ProcessCaptureFrames(samples, 1); err == nil {
+		t.Error("ProcessCaptureFrames should fail with a partial frame")
+	}
+	if err := h.ProcessCaptureFrames(nil, 1); err == nil {
+		t.Error("ProcessCaptureFrames should fail with no samples")
+	}
+}
+
+func TestProcessDuplexFrame(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  2,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	renderSamples := make([]float32, 2*NumSamplesPerFrame)
+	captureSamples := generateSineWave(500, 0.3, NumSamplesPerFrame)
+
+	for i := 0; i < 50; i++ {
+		if _, err := h.ProcessDuplexFrame(renderSamples, 2, captureSamples, 1); err != nil {
+			t.Fatalf("ProcessDuplexFrame failed at frame %d: %v", i, err)
+		}
+	}
+
+	intRender := make([]int16, 2*NumSamplesPerFrame)
+	intCapture := make([]int16, NumSamplesPerFrame)
+	if _, err := h.ProcessDuplexIntFrame(intRender, 2, intCapture, 1); err != nil {
+		t.Fatalf("ProcessDuplexIntFrame failed: %v", err)
+	}
+
+	// Channel counts are checked per direction
+	if _, err := h.ProcessDuplexFrame(captureSamples, 1, renderSamples, 2); err == nil {
+		t.Error("ProcessDuplexFrame should fail with swapped channel counts")
+	}
+}
+
+func TestPushPullStream(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		NoiseSuppression: NoiseSuppressionConfig{
+			Enabled: true,
+		},
+	}
+
+	streamed, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer streamed.Destroy()
+	framed, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer framed.Destroy()
+
+	const numFrames = 6
+	input := generateSineWave(440, 0.5, numFrames*NumSamplesPerFrame)
+	want := append([]float32(nil), input...)
+	if err := framed.ProcessCaptureFrames(want, 1); err != nil {
+		t.Fatalf("ProcessCaptureFrames failed: %v", err)
+	}
+
+	// 20ms, 2.5ms and 7.5ms chunks, as a jitter buffer or Opus decoder would emit
+	chunks := []int{2 * NumSamplesPerFrame, NumSamplesPerFrame / 4, 3 * NumSamplesPerFrame / 4}
+	var got []float32
+	out := make([]float32, 2*NumSamplesPerFrame)
+	for pos, i := 0, 0; pos < len(input); i++ {
+		n := min(chunks[i%len(chunks)], len(input)-pos)
+		if err := streamed.PushRender(make([]float32, n), 1); err != nil {
+			t.Fatalf("PushRender failed: %v", err)
+		}
+		if err := streamed.PushCapture(input[pos:pos+n], 1); err != nil {
+			t.Fatalf("PushCapture failed: %v", err)
+		}
+		pos += n
+
+		if pending := streamed.StreamPendingFrames(); pending != pos%NumSamplesPerFrame {
+			t.Errorf("StreamPendingFrames() = %d, want %d", pending, pos%NumSamplesPerFrame)
+		}
+		pulled, err := streamed.PullCapture(out, 1)
+		if err != nil {
+			t.Fatalf("PullCapture failed: %v", err)
+		}
+		got = append(got, out[:pulled]...)
+	}
+
+	if len(got) != len(want) {
+		t.Fatalf("pulled %d samples, want %d", len(got), len(want))
+	}
+	for i := range want {
+		if got[i] != want[i] {
+			t.Fatalf("sample %d: streamed %v, framed %v", i, got[i], want[i])
+		}
+	}
+}
+
+func TestPushStreamOverflow(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	maxFrames := StreamMaxBufferedMs / FrameMs
+	if err := h.PushCapture(make([]float32, maxFrames*NumSamplesPerFrame), 1); err != nil {
+		t.Fatalf("PushCapture failed: %v", err)
+	}
+	if err := h.PushCapture(make([]float32, NumSamplesPerFrame), 1); err == nil {
+		t.Error("PushCapture should fail once the output is full")
+	}
+	if h.StreamAvailableFrames() != maxFrames*NumSamplesPerFrame {
+		t.Errorf("StreamAvailableFrames() = %d, want %d", h.StreamAvailableFrames(), maxFrames*NumSamplesPerFrame)
+	}
+}
+
+// =============================================================================
+// Statistics Tests
+// =============================================================================
+
+func TestGetStatsWithAEC(t *testing.T) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	renderSamples := generateSineWave(1000, 0.4, NumSamplesPerFrame)
+	captureSamples := generateSineWave(500, 0.3, NumSamplesPerFrame)
+
+	// Add echo to capture
+	for i := range captureSamples {
+		captureSamples[i] += renderSamples[i] * 0.2
+	}
+
+	// Process many frames for AEC to converge
+	for i := 0; i < 100; i++ {
+		h.ProcessRenderFrame(renderSamples, 1)
+		h.ProcessCaptureFrame(captureSamples, 1)
+	}
+
+	stats := h.GetStats()
+
+	t.Logf("ERL: %.2f dB", stats.EchoReturnLoss)
+	t.Logf("ERLE: %.2f dB", stats.EchoReturnLossEnhancement)
+}
+
+// echoPathSimulator plays lowpass noise through an echo path of impulse
+// response h after delay samples. The far end is silent while muted is set.
+type echoPathSimulator struct {
+	h       []float32
+	delay   int
+	seed    uint32
+	muted   bool
+	lowpass float32
+	render  []float32
+}
+
+// next returns the next render frame of n samples and its echo.
+func (e *echoPathSimulator) next(n int) (render, capture []float32) {
+	for k := 0; k < n; k++ {
+		e.seed = e.seed*1664525 + 1013904223
+		e.lowpass = 0.5*e.lowpass + 0.5*(float32(e.seed>>8)/16777216-0.5)
+		if e.muted {
+			e.render = append(e.render, 0)
+		} else {
+			e.render = append(e.render, e.lowpass)
+		}
+	}
+	render = e.render[len(e.render)-n:]
+	capture = make([]float32, n)
+	for k := range capture {
+		i := len(e.render) - n + k - e.delay
+		for j, hj := range e.h {
+			if i-j >= 0 {
+				capture[k] += hj * e.render[i-j]
+			}
+		}
+	}
+	return render, capture
+}
+
+// processEchoPath runs numFrames frames of e through h, returning the
+// smallest linear filter length reported after each frame.
+func processEchoPath(t testing.TB, h *Handle, e *echoPathSimulator, numFrames int) (minLengthMs int) {
+	t.Helper()
+	minLengthMs = math.MaxInt
+	for i := 0; i < numFrames; i++ {
+		render, capture := e.next(h.NumSamplesPerFrame())
+		if err := h.ProcessRenderFrame(render, 1); err != nil {
+			t.Fatalf("ProcessRenderFrame failed: %v", err)
+		}
+		if err := h.ProcessCaptureFrame(capture, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed: %v", err)
+		}
+		minLengthMs = min(minLengthMs, h.GetStats().LinearFilterLengthMs)
 	}
-	defer h.Destroy()
+	return minLengthMs
 }
 
-func TestSetConfigWithStreamDelay(t *testing.T) {
-	delayMs := 50
+// The default refined filter covers 13 blocks of 4 ms, and is shortened to no
+// less than 9 blocks.
+const (
+	defaultLinearFilterLengthMs = 52
+	minLinearFilterLengthMs     = 36
+)
+
+func TestGetStatsLinearFilterLength(t *testing.T) {
 	config := Config{
 		CaptureChannels: 1,
 		RenderChannels:  1,
+		SampleRateHz:    16000,
 		EchoCancellation: EchoCancellationConfig{
-			Enabled:       true,
-			StreamDelayMs: delayMs,
-		},
-		GainControl: GainControlConfig{
-			Enabled:           true,
-			Mode:              AgcModeAdaptiveDigital,
-			TargetLevelDbfs:   3,
-			CompressionGainDb: 9,
-			EnableLimiter:     true,
-		},
-		NoiseSuppression: NoiseSuppressionConfig{
-			Enabled:          true,
-			SuppressionLevel: NsLevelHigh,
+			Enabled: true,
 		},
 	}
 
@@ -206,16 +1580,25 @@ func TestSetConfigWithStreamDelay(t *testing.T) {
 		t.Fatalf("Create failed: %v", err)
 	}
 	defer h.Destroy()
-}
 
-// =============================================================================
-// Processing Tests
-// =============================================================================
+	// A two tap echo path 30 ms late converges to the shortest filter.
+	e := &echoPathSimulator{h: []float32{0.5, 0.2}, delay: 480, seed: 1}
+	if got := processEchoPath(t, h, e, 600); got != minLinearFilterLengthMs {
+		t.Errorf("shortest linear filter length %d ms, want %d ms", got, minLinearFilterLengthMs)
+	}
+	if got := h.GetStats().LinearFilterLengthMs; got != minLinearFilterLengthMs {
+		t.Errorf("linear filter length %d ms, want %d ms", got, minLinearFilterLengthMs)
+	}
+}
 
-func TestProcessCaptureFrame(t *testing.T) {
+func TestLinearFilterLengthFollowsEchoPath(t *testing.T) {
 	config := Config{
 		CaptureChannels: 1,
 		RenderChannels:  1,
+		SampleRateHz:    16000,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
 	}
 
 	h, err := Create(config)
@@ -224,18 +1607,39 @@ func TestProcessCaptureFrame(t *testing.T) {
 	}
 	defer h.Destroy()
 
-	samples := generateSineWave(440, 0.5, NumSamplesPerFrame)
+	e := &echoPathSimulator{h: []float32{0.5, 0.2}, delay: 480, seed: 1}
+	processEchoPath(t, h, e, 600)
+	if got := h.GetStats().LinearFilterLengthMs; got != minLinearFilterLengthMs {
+		t.Fatalf("linear filter length on a short echo path %d ms, want %d ms", got, minLinearFilterLengthMs)
+	}
 
-	err = h.ProcessCaptureFrame(samples, 1)
-	if err != nil {
-		t.Fatalf("ProcessCaptureFrame failed: %v", err)
+	// The room changes to one with a 30 ms reverberant tail, which does not
+	// fit in the shortened filter. The filter must grow back within 0.5 s.
+	e.h = make([]float32, 480)
+	for k, g := 0, float32(0.5); k < len(e.h); k, g = k+1, g*-0.993 {
+		e.h[k] = g
+	}
+	processEchoPath(t, h, e, 50)
+	if got := h.GetStats().LinearFilterLengthMs; got != defaultLinearFilterLengthMs {
+		t.Errorf("linear filter length after the echo path change %d ms, want %d ms", got, defaultLinearFilterLengthMs)
+	}
+
+	// It stays at full length while the long echo path is cancelled.
+	if got := processEchoPath(t, h, e, 500); got != defaultLinearFilterLengthMs {
+		t.Errorf("linear filter length shrank to %d ms on the long echo path", got)
 	}
 }
 
-func TestProcessCaptureFrameStereo(t *testing.T) {
+func TestGetStatsTimings(t *testing.T) {
 	config := Config{
-		CaptureChannels: 2,
-		RenderChannels:  2,
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+		NoiseSuppression: NoiseSuppressionConfig{
+			Enabled: true,
+		},
 	}
 
 	h, err := Create(config)
@@ -244,20 +1648,41 @@ func TestProcessCaptureFrameStereo(t *testing.T) {
 	}
 	defer h.Destroy()
 
-	// Interleaved stereo samples
-	samples := make([]float32, NumSamplesPerFrame*2)
-	for i := 0; i < NumSamplesPerFrame; i++ {
-		samples[i*2] = float32(math.Sin(2*math.Pi*440*float64(i)/float64(SampleRateHz))) * 0.5
-		samples[i*2+1] = float32(math.Sin(2*math.Pi*880*float64(i)/float64(SampleRateHz))) * 0.3
+	renderSamples := generateSineWave(1000, 0.4, NumSamplesPerFrame)
+	captureSamples := generateSineWave(500, 0.3, NumSamplesPerFrame)
+
+	if stats := h.GetStats(); stats.CaptureProcessingTime != (StageTiming{}) {
+		t.Errorf("expected no timings before processing, got %+v", stats.CaptureProcessingTime)
 	}
 
-	err = h.ProcessCaptureFrame(samples, 2)
-	if err != nil {
-		t.Fatalf("ProcessCaptureFrame failed: %v", err)
+	// Timings are summarized over windows of 100 frames.
+	for i := 0; i < 150; i++ {
+		h.ProcessRenderFrame(renderSamples, 1)
+		h.ProcessCaptureFrame(captureSamples, 1)
+	}
+
+	stats := h.GetStats()
+	for name, timing := range map[string]StageTiming{
+		"capture":          stats.CaptureProcessingTime,
+		"echo controller":  stats.EchoControllerTime,
+		"noise suppressor": stats.NoiseSuppressorTime,
+		"render":           stats.RenderProcessingTime,
+		"render analysis":  stats.RenderAnalysisTime,
+	} {
+		if timing.Mean <= 0 || timing.Min > timing.Mean || timing.Min > timing.P99 {
+			t.Errorf("unexpected %s timing: %+v", name, timing)
+		}
 	}
+	if stats.EchoControllerTime.Mean > stats.CaptureProcessingTime.Mean {
+		t.Errorf("echo controller mean %v exceeds capture mean %v",
+			stats.EchoControllerTime.Mean, stats.CaptureProcessingTime.Mean)
+	}
+
+	t.Logf("capture: %+v", stats.CaptureProcessingTime)
+	t.Logf("render: %+v", stats.RenderProcessingTime)
 }
 
-func TestProcessRenderFrame(t *testing.T) {
+func TestGetStatsConcurrentWithProcessing(t *testing.T) {
 	config := Config{
 		CaptureChannels: 1,
 		RenderChannels:  1,
@@ -272,124 +1697,222 @@ func TestProcessRenderFrame(t *testing.T) {
 	}
 	defer h.Destroy()
 
-	samples := generateSineWave(1000, 0.4, NumSamplesPerFrame)
+	renderSamples := generateSineWave(1000, 0.4, NumSamplesPerFrame)
+	captureSamples := generateSineWave(500, 0.3, NumSamplesPerFrame)
 
-	err = h.ProcessRenderFrame(samples, 1)
-	if err != nil {
-		t.Fatalf("ProcessRenderFrame failed: %v", err)
+	done := make(chan struct{})
+	polls := make(chan int)
+	go func() {
+		n := 0
+		for {
+			select {
+			case <-done:
+				polls <- n
+				return
+			default:
+				h.GetStats()
+				n++
+			}
+		}
+	}()
+
+	for i := 0; i < 150; i++ {
+		if err := h.ProcessRenderFrame(renderSamples, 1); err != nil {
+			t.Fatalf("ProcessRenderFrame failed: %v", err)
+		}
+		if err := h.ProcessCaptureFrame(captureSamples, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed: %v", err)
+		}
+	}
+	close(done)
+	t.Logf("GetStats polled %d times during processing", <-polls)
+
+	// Stats are published every frame, so a single read after processing
+	// returns those of the last frame.
+	if stats := h.GetStats(); stats.CaptureProcessingTime.Mean <= 0 {
+		t.Errorf("expected capture timings after processing, got %+v", stats.CaptureProcessingTime)
 	}
 }
 
-func TestProcessRenderAndCapture(t *testing.T) {
+func TestSaveLoadState(t *testing.T) {
 	config := Config{
 		CaptureChannels: 1,
 		RenderChannels:  1,
 		EchoCancellation: EchoCancellationConfig{
 			Enabled: true,
 		},
+		GainControl: GainControlConfig{
+			Enabled:    true,
+			HeadroomDB: 5,
+			MaxGainDB:  50,
+		},
 	}
 
-	h, err := Create(config)
+	source, err := Create(config)
 	if err != nil {
 		t.Fatalf("Create failed: %v", err)
 	}
-	defer h.Destroy()
+	defer source.Destroy()
 
 	renderSamples := generateSineWave(1000, 0.4, NumSamplesPerFrame)
-	captureSamples := generateSineWave(500, 0.3, NumSamplesPerFrame)
-
-	for i := 0; i < 50; i++ {
-		err := h.ProcessRenderFrame(renderSamples, 1)
-		if err != nil {
-			t.Fatalf("ProcessRenderFrame failed at frame %d: %v", i, err)
+	for i := 0; i < 200; i++ {
+		render := append([]float32(nil), renderSamples...)
+		capture := generateSineWave(500, 0.3, NumSamplesPerFrame)
+		for j := range capture {
+			capture[j] += renderSamples[j] * 0.2
 		}
-
-		err = h.ProcessCaptureFrame(captureSamples, 1)
-		if err != nil {
-			t.Fatalf("ProcessCaptureFrame failed at frame %d: %v", i, err)
+		if err := source.ProcessRenderFrame(render, 1); err != nil {
+			t.Fatalf("ProcessRenderFrame failed: %v", err)
+		}
+		if err := source.ProcessCaptureFrame(capture, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed: %v", err)
 		}
 	}
-}
 
-func TestProcessCaptureFrameWrongChannels(t *testing.T) {
-	config := Config{
-		CaptureChannels: 2,
-		RenderChannels:  2,
+	state, err := source.SaveState()
+	if err != nil {
+		t.Fatalf("SaveState failed: %v", err)
 	}
 
-	h, err := Create(config)
+	target, err := Create(config)
 	if err != nil {
 		t.Fatalf("Create failed: %v", err)
 	}
-	defer h.Destroy()
-
-	// Provide mono samples for stereo processor
-	samples := generateSineWave(440, 0.5, NumSamplesPerFrame)
-
-	err = h.ProcessCaptureFrame(samples, 1)
-	if err == nil {
-		t.Error("ProcessCaptureFrame should fail with wrong channel count")
+	defer target.Destroy()
+	if err := target.LoadState(state); err != nil {
+		t.Fatalf("LoadState failed: %v", err)
 	}
-}
 
-func TestProcessCaptureFrameWrongSampleCount(t *testing.T) {
-	config := Config{
-		CaptureChannels: 1,
-		RenderChannels:  1,
+	restored, err := target.SaveState()
+	if err != nil {
+		t.Fatalf("SaveState failed: %v", err)
+	}
+	if !bytes.Equal(restored, state) {
+		t.Errorf("state saved after LoadState differs from the loaded state")
 	}
 
-	h, err := Create(config)
+	// A handle with a different sample rate rejects the state
+	config.SampleRateHz = 16000
+	wideband, err := Create(config)
 	if err != nil {
 		t.Fatalf("Create failed: %v", err)
 	}
-	defer h.Destroy()
-
-	// Provide wrong number of samples
-	samples := make([]float32, NumSamplesPerFrame-10)
+	defer wideband.Destroy()
+	if err := wideband.LoadState(state); err == nil {
+		t.Errorf("LoadState accepted state saved at a different sample rate")
+	}
 
-	err = h.ProcessCaptureFrame(samples, 1)
-	if err == nil {
-		t.Error("ProcessCaptureFrame should fail with wrong sample count")
+	if err := target.LoadState(state[:len(state)/2]); err == nil {
+		t.Errorf("LoadState accepted truncated state")
 	}
 }
 
-// =============================================================================
-// Statistics Tests
-// =============================================================================
-
-func TestGetStatsWithAEC(t *testing.T) {
+// A rejected state must leave the handle as it was, including the parts that
+// come before the corruption in the state.
+func TestLoadStateCorruptedLeavesHandleUnchanged(t *testing.T) {
 	config := Config{
 		CaptureChannels: 1,
 		RenderChannels:  1,
 		EchoCancellation: EchoCancellationConfig{
 			Enabled: true,
 		},
+		GainControl: GainControlConfig{
+			Enabled:    true,
+			HeadroomDB: 5,
+			MaxGainDB:  50,
+		},
 	}
 
-	h, err := Create(config)
-	if err != nil {
-		t.Fatalf("Create failed: %v", err)
+	process := func(h *Handle, frames int, capture []float32) {
+		renderSamples := generateSineWave(1000, 0.4, NumSamplesPerFrame)
+		for i := 0; i < frames; i++ {
+			render := append([]float32(nil), renderSamples...)
+			copy(capture, generateSineWave(500, 0.3, NumSamplesPerFrame))
+			for j := range capture {
+				capture[j] += renderSamples[j] * 0.2
+			}
+			if err := h.ProcessRenderFrame(render, 1); err != nil {
+				t.Fatalf("ProcessRenderFrame failed: %v", err)
+			}
+			if err := h.ProcessCaptureFrame(capture, 1); err != nil {
+				t.Fatalf("ProcessCaptureFrame failed: %v", err)
+			}
+		}
 	}
-	defer h.Destroy()
-
-	renderSamples := generateSineWave(1000, 0.4, NumSamplesPerFrame)
-	captureSamples := generateSineWave(500, 0.3, NumSamplesPerFrame)
 
-	// Add echo to capture
-	for i := range captureSamples {
-		captureSamples[i] += renderSamples[i] * 0.2
+	source, err := Create(config)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
 	}
-
-	// Process many frames for AEC to converge
-	for i := 0; i < 100; i++ {
-		h.ProcessRenderFrame(renderSamples, 1)
-		h.ProcessCaptureFrame(captureSamples, 1)
+	defer source.Destroy()
+	capture := make([]float32, NumSamplesPerFrame)
+	process(source, 300, capture)
+	state, err := source.SaveState()
+	if err != nil {
+		t.Fatalf("SaveState failed: %v", err)
+	}
+
+	nan := []byte{0x00, 0x00, 0xc0, 0x7f}
+	corruptions := []struct {
+		name    string
+		corrupt func(state []byte)
+	}{
+		// Mostly filter coefficients, past the delay controller and the
+		// start of the echo remover.
+		{"echo canceller", func(state []byte) {
+			for i := len(state) / 2; i < len(state)/2+64; i++ {
+				state[i] = 0xff
+			}
+		}},
+		// The last AGC2 gain, loaded after the echo canceller.
+		{"gain controller", func(state []byte) {
+			copy(state[len(state)-8:], nan)
+		}},
+	}
+	for _, c := range corruptions {
+		t.Run(c.name, func(t *testing.T) {
+			target, err := Create(config)
+			if err != nil {
+				t.Fatalf("Create failed: %v", err)
+			}
+			defer target.Destroy()
+			untouched, err := Create(config)
+			if err != nil {
+				t.Fatalf("Create failed: %v", err)
+			}
+			defer untouched.Destroy()
+			got := make([]float32, NumSamplesPerFrame)
+			want := make([]float32, NumSamplesPerFrame)
+			process(target, 100, got)
+			process(untouched, 100, want)
+
+			corrupted := append([]byte(nil), state...)
+			c.corrupt(corrupted)
+			if err := target.LoadState(corrupted); err == nil {
+				t.Fatal("LoadState accepted corrupted state")
+			}
+
+			gotState, err := target.SaveState()
+			if err != nil {
+				t.Fatalf("SaveState failed: %v", err)
+			}
+			wantState, err := untouched.SaveState()
+			if err != nil {
+				t.Fatalf("SaveState failed: %v", err)
+			}
+			if !bytes.Equal(gotState, wantState) {
+				t.Error("state after a rejected LoadState differs from an untouched handle")
+			}
+
+			process(target, 50, got)
+			process(untouched, 50, want)
+			for i := range want {
+				if got[i] != want[i] {
+					t.Fatalf("sample %d after a rejected LoadState = %v, untouched handle %v", i, got[i], want[i])
+				}
+			}
+		})
 	}
-
-	stats := h.GetStats()
-
-	t.Logf("ERL: %.2f dB", stats.EchoReturnLoss)
-	t.Logf("ERLE: %.2f dB", stats.EchoReturnLossEnhancement)
 }
 
 // =============================================================================
@@ -552,6 +2075,126 @@ func BenchmarkProcessCaptureFrame(b *testing.B) {
 	}
 }
 
+func BenchmarkProcessCaptureFrameStereo(b *testing.B) {
+	config := Config{
+		CaptureChannels: 2,
+		RenderChannels:  2,
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		b.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	samples := generateSineWave(440, 0.5, 2*NumSamplesPerFrame)
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		h.ProcessCaptureFrame(samples, 2)
+	}
+}
+
+func BenchmarkNoiseSuppressionChannels(b *testing.B) {
+	for _, channels := range []int{1, 2, 4, 8} {
+		b.Run(fmt.Sprintf("%dch", channels), func(b *testing.B) {
+			config := Config{
+				CaptureChannels:     channels,
+				RenderChannels:      1,
+				MultiChannelCapture: true,
+				NoiseSuppression: NoiseSuppressionConfig{
+					Enabled:          true,
+					SuppressionLevel: NsLevelHigh,
+				},
+			}
+
+			h, err := Create(config)
+			if err != nil {
+				b.Fatalf("Create failed: %v", err)
+			}
+			defer h.Destroy()
+
+			// A tone in white noise, different in each channel.
+			samples := make([]float32, channels*NumSamplesPerFrame)
+			seed := uint32(1)
+			for i := range samples {
+				seed = seed*1664525 + 1013904223
+				tone := 0.1 * math.Sin(2*math.Pi*440*float64(i/channels)/float64(SampleRateHz))
+				samples[i] = float32(tone) + 0.02*(float32(seed>>8)/16777216-0.5)
+			}
+			frame := make([]float32, len(samples))
+
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				copy(frame, samples)
+				h.ProcessCaptureFrame(frame, channels)
+			}
+		})
+	}
+}
+
+// Needs a core per thread, plus one for the capture thread, to show a speedup.
+func BenchmarkEchoCancellerWorkerThreads(b *testing.B) {
+	const numFrames = 100
+	for _, channels := range []int{4, 8} {
+		for _, threads := range []int{0, 1, 3, 7} {
+			if threads >= channels {
+				continue
+			}
+			b.Run(fmt.Sprintf("%dch/%dthreads", channels, threads), func(b *testing.B) {
+				config := Config{
+					CaptureChannels:     channels,
+					RenderChannels:      1,
+					MultiChannelCapture: true,
+					EchoCancellation: EchoCancellationConfig{
+						Enabled:       true,
+						WorkerThreads: threads,
+					},
+				}
+
+				h, err := Create(config)
+				if err != nil {
+					b.Fatalf("Create failed: %v", err)
+				}
+				defer h.Destroy()
+
+				// Low-passed noise, heard one frame late at a different level
+				// and with a different talker by each microphone.
+				render := make([]float32, (numFrames+1)*NumSamplesPerFrame)
+				seed, lowpass := uint32(1), float32(0)
+				for i := range render {
+					seed = seed*1664525 + 1013904223
+					lowpass = 0.5*lowpass + 0.5*(float32(seed>>8)/16777216-0.5)
+					render[i] = lowpass
+				}
+				capture := make([]float32, numFrames*channels*NumSamplesPerFrame)
+				for n := 0; n < numFrames*NumSamplesPerFrame; n++ {
+					for ch := 0; ch < channels; ch++ {
+						talker := 0.05 * math.Sin(float64(n)*0.05*float64(ch+1))
+						capture[n*channels+ch] = 0.1*float32(ch+1)*render[n] + float32(talker)
+					}
+				}
+				frame := make([]float32, channels*NumSamplesPerFrame)
+				process := func(i int) {
+					k := i % numFrames
+					h.ProcessRenderFrame(render[(k+1)*NumSamplesPerFrame:(k+2)*NumSamplesPerFrame], 1)
+					copy(frame, capture[k*channels*NumSamplesPerFrame:])
+					h.ProcessCaptureFrame(frame, channels)
+				}
+				// Let the filters converge before timing.
+				for i := 0; i < 3*numFrames; i++ {
+					process(i)
+				}
+
+				b.ResetTimer()
+				for i := 0; i < b.N; i++ {
+					process(i)
+				}
+			})
+		}
+	}
+}
+
 func BenchmarkProcessCaptureFrameWithAEC(b *testing.B) {
 	config := Config{
 		CaptureChannels: 1,
@@ -581,6 +2224,199 @@ func BenchmarkProcessCaptureFrameWithAEC(b *testing.B) {
 	}
 }
 
+func BenchmarkProcessCaptureFrames(b *testing.B) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		NoiseSuppression: NoiseSuppressionConfig{
+			Enabled:          true,
+			SuppressionLevel: NsLevelHigh,
+		},
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		b.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	const numFrames = 10
+	samples := generateSineWave(440, 0.5, numFrames*NumSamplesPerFrame)
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		h.ProcessCaptureFrames(samples, 1)
+	}
+}
+
+func BenchmarkProcessDuplexFrame(b *testing.B) {
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		EchoCancellation: EchoCancellationConfig{
+			Enabled: true,
+		},
+		NoiseSuppression: NoiseSuppressionConfig{
+			Enabled:          true,
+			SuppressionLevel: NsLevelHigh,
+		},
+	}
+
+	h, err := Create(config)
+	if err != nil {
+		b.Fatalf("Create failed: %v", err)
+	}
+	defer h.Destroy()
+
+	renderSamples := generateSineWave(1000, 0.4, NumSamplesPerFrame)
+	captureSamples := generateSineWave(500, 0.3, NumSamplesPerFrame)
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		h.ProcessDuplexFrame(renderSamples, 1, captureSamples, 1)
+	}
+}
+
+func TestEchoCancellerIdleDuringInactiveRender(t *testing.T) {
+	// The far end talks, is silent for 3 s while only the near end talks, and
+	// talks again. The echo arrives 3 frames after the render.
+	const (
+		mute    = 500
+		resume  = 800
+		echo    = resume + 3
+		end     = 900
+		nearend = 0.05
+	)
+	run := func(idle bool) (in, out [][]float32) {
+		tuning := EchoCancellerPreset(EchoCancellerPresetDefault)
+		tuning.IdleDuringInactiveRender = idle
+		h, err := Create(Config{
+			CaptureChannels: 1,
+			RenderChannels:  1,
+			SampleRateHz:    16000,
+			EchoCancellation: EchoCancellationConfig{
+				Enabled: true,
+				Tuning:  &tuning,
+			},
+		})
+		if err != nil {
+			t.Fatalf("Create failed: %v", err)
+		}
+		defer h.Destroy()
+
+		e := &echoPathSimulator{h: []float32{0.5, 0.2}, delay: 480, seed: 1}
+		seed := uint32(7)
+		for i := 0; i < end; i++ {
+			e.muted = i >= mute && i < resume
+			render, capture := e.next(h.NumSamplesPerFrame())
+			if e.muted {
+				for k := range capture {
+					seed = seed*1664525 + 1013904223
+					capture[k] += nearend * (float32(seed>>8)/16777216 - 0.5)
+				}
+			}
+			in = append(in, append([]float32(nil), capture...))
+			if err := h.ProcessRenderFrame(render, 1); err != nil {
+				t.Fatalf("ProcessRenderFrame failed: %v", err)
+			}
+			if err := h.ProcessCaptureFrame(capture, 1); err != nil {
+				t.Fatalf("ProcessCaptureFrame failed: %v", err)
+			}
+			out = append(out, capture)
+		}
+		return in, out
+	}
+	in, idle := run(true)
+	_, full := run(false)
+
+	// Going idle and staying idle passes the near end through as the full
+	// processing does.
+	for i := mute; i < resume; i++ {
+		for k := range idle[i] {
+			if d := math.Abs(float64(idle[i][k] - full[i][k])); d > 1e-7 {
+				t.Fatalf("frame %d, sample %d: idle output differs from the full processing by %g", i, k, d)
+			}
+		}
+	}
+
+	// When the far end resumes, the echo is cancelled from its first frame on
+	// with the filters converged before the silence, and the output is as
+	// smooth as with the full processing.
+	attenuationDb := func(out [][]float32, from, to int) float64 {
+		var e, y float64
+		for i := from; i < to; i++ {
+			for k := range out[i] {
+				y += float64(in[i][k]) * float64(in[i][k])
+				e += float64(out[i][k]) * float64(out[i][k])
+			}
+		}
+		return 10 * math.Log10(y/e)
+	}
+	for i := echo; i < echo+10; i++ {
+		if got := attenuationDb(idle, i, i+1); got < 20 {
+			t.Errorf("frame %d after the far end resumed: echo attenuated by %.1f dB, want at least 20 dB", i-resume, got)
+		}
+	}
+	idleDb, fullDb := attenuationDb(idle, echo, echo+10), attenuationDb(full, echo, echo+10)
+	t.Logf("echo attenuation in the first 100 ms after resuming: %.1f dB, full processing %.1f dB", idleDb, fullDb)
+	if idleDb < fullDb-1 {
+		t.Errorf("echo attenuation in the first 100 ms after resuming %.1f dB, want at least %.1f dB", idleDb, fullDb-1)
+	}
+	maxStep := func(out [][]float32) (step float64) {
+		previous := out[resume-1][len(out[resume-1])-1]
+		for i := resume; i < echo+10; i++ {
+			for _, v := range out[i] {
+				step = math.Max(step, math.Abs(float64(v-previous)))
+				previous = v
+			}
+		}
+		return step
+	}
+	if idleStep, fullStep := maxStep(idle), maxStep(full); idleStep > 1.25*fullStep {
+		t.Errorf("largest step between output samples after resuming %g, full processing %g", idleStep, fullStep)
+	}
+}
+
+// BenchmarkEchoCancellerInactiveRender measures AEC3 while the far end is
+// silent, with and without the idle mode, after it has converged on an echo.
+func BenchmarkEchoCancellerInactiveRender(b *testing.B) {
+	for _, idle := range []bool{false, true} {
+		b.Run(fmt.Sprintf("idle=%v", idle), func(b *testing.B) {
+			tuning := EchoCancellerPreset(EchoCancellerPresetDefault)
+			tuning.IdleDuringInactiveRender = idle
+			h, err := Create(Config{
+				CaptureChannels: 1,
+				RenderChannels:  1,
+				SampleRateHz:    16000,
+				EchoCancellation: EchoCancellationConfig{
+					Enabled: true,
+					Tuning:  &tuning,
+				},
+			})
+			if err != nil {
+				b.Fatalf("Create failed: %v", err)
+			}
+			defer h.Destroy()
+
+			e := &echoPathSimulator{h: []float32{0.5, 0.2}, delay: 480, seed: 1}
+			processEchoPath(b, h, e, 500)
+			e.muted = true
+			nearend := generateSineWave(500, 0.1, h.NumSamplesPerFrame())
+
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				render, _ := e.next(h.NumSamplesPerFrame())
+				h.ProcessRenderFrame(render, 1)
+				h.ProcessCaptureFrame(nearend, 1)
+			}
+			b.StopTimer()
+			stats := h.GetStats()
+			b.ReportMetric(float64(stats.EchoControllerTime.Mean.Nanoseconds())/1e3, "capture-us/frame")
+			b.ReportMetric(float64(stats.RenderAnalysisTime.Mean.Nanoseconds())/1e3, "render-us/frame")
+		})
+	}
+}
+
 func BenchmarkGetStats(b *testing.B) {
 	config := Config{
 		CaptureChannels: 1,
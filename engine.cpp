@@ -0,0 +1,347 @@
+// engine.cpp - Multi-session processing engine with a work-stealing worker pool
+
+#include <engine.h>
+
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifndef WEBRTC_POSIX
+#define WEBRTC_POSIX
+#endif
+
+#include <google.com/webrtc/audio_processing/include/audio_processing.h>
+#include <google.com/webrtc/rtc_base/logging.h>
+
+namespace {
+
+    struct Session {
+        ApmHandle handle{};
+        int capture_channels{};
+        int render_channels{};
+        int home_worker{};
+        // Generation of the last tick this session was scheduled in, used to
+        // reject a session appearing twice in one tick.
+        uint64_t scheduled_generation{};
+    };
+
+// Frames whose home is one worker. The owner and thieves claim items through
+// the same atomic cursor, so each frame is processed exactly once.
+    struct WorkQueue {
+        std::vector<int> items;
+        std::atomic<int> next{0};
+    };
+
+    class Engine {
+    public:
+        Engine(int num_workers, bool pin_workers) {
+            queues_.resize(num_workers);
+            for (auto &queue: queues_) queue = std::make_unique<WorkQueue>();
+            sessions_per_worker_.resize(num_workers);
+            workers_.reserve(num_workers);
+            for (int w = 0; w < num_workers; ++w) {
+                workers_.emplace_back([this, w, pin_workers] {
+                    if (pin_workers) pinToCpu(w);
+                    run(w);
+                });
+            }
+        }
+
+        ~Engine() {
+            Wait();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto &worker: workers_) worker.join();
+            for (auto &session: sessions_) {
+                if (session) Destroy(session->handle);
+            }
+        }
+
+        int CreateSession(ApmConfig apmConfig, int *error_code) {
+            ApmHandle handle = Create(apmConfig, error_code);
+            if (!handle) return -1;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto session = std::make_unique<Session>();
+            session->handle = handle;
+            session->capture_channels = apmConfig.capture_channels;
+            session->render_channels = apmConfig.render_channels;
+            // Home the session on the worker with the fewest sessions
+            int home = 0;
+            for (int w = 1; w < static_cast<int>(sessions_per_worker_.size()); ++w) {
+                if (sessions_per_worker_[w] < sessions_per_worker_[home]) home = w;
+            }
+            session->home_worker = home;
+            ++sessions_per_worker_[home];
+
+            for (int id = 0; id < static_cast<int>(sessions_.size()); ++id) {
+                if (!sessions_[id]) {
+                    sessions_[id] = std::move(session);
+                    return id;
+                }
+            }
+            sessions_.push_back(std::move(session));
+            return static_cast<int>(sessions_.size()) - 1;
+        }
+
+        int DestroySession(int id) {
+            std::unique_ptr<Session> session;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (in_flight_ || !validSession(id))
+                    return webrtc::AudioProcessing::kBadParameterError;
+                session = std::move(sessions_[id]);
+                --sessions_per_worker_[session->home_worker];
+            }
+            Destroy(session->handle);
+            return webrtc::AudioProcessing::kNoError;
+        }
+
+        ApmHandle SessionHandle(int id) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return validSession(id) ? sessions_[id]->handle : nullptr;
+        }
+
+        int Submit(ApmEngineFrame *frames, int num_frames, ApmEngineTickCallback callback, void *user_data) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (in_flight_)
+                    return webrtc::AudioProcessing::kBadParameterError;
+
+                const uint64_t generation = generation_ + 1;
+                for (auto &queue: queues_) {
+                    queue->items.clear();
+                    queue->next.store(0, std::memory_order_relaxed);
+                }
+                frame_sessions_.assign(num_frames, nullptr);
+                for (int i = 0; i < num_frames; ++i) {
+                    ApmEngineFrame &frame = frames[i];
+                    if (!validSession(frame.session) ||
+                        sessions_[frame.session]->scheduled_generation == generation) {
+                        frame.result = webrtc::AudioProcessing::kBadParameterError;
+                        continue;
+                    }
+                    Session *session = sessions_[frame.session].get();
+                    session->scheduled_generation = generation;
+                    frame_sessions_[i] = session;
+                    frame.result = webrtc::AudioProcessing::kNoError;
+                    queues_[session->home_worker]->items.push_back(i);
+                }
+
+                frames_ = frames;
+                num_frames_ = num_frames;
+                callback_ = callback;
+                user_data_ = user_data;
+                pending_workers_.store(static_cast<int>(workers_.size()), std::memory_order_relaxed);
+                in_flight_ = true;
+                generation_ = generation;
+            }
+            wake_.notify_all();
+            return webrtc::AudioProcessing::kNoError;
+        }
+
+        int Wait() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return !in_flight_; });
+            return last_result_;
+        }
+
+        int NumWorkers() const {
+            return static_cast<int>(workers_.size());
+        }
+
+    private:
+        bool validSession(int id) const {
+            return id >= 0 && id < static_cast<int>(sessions_.size()) && sessions_[id];
+        }
+
+        // Binds the calling thread to the worker-th CPU of those the process
+        // may run on, wrapping around when there are more workers.
+        static void pinToCpu(int worker) {
+#if defined(__linux__)
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+            if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+                RTC_LOG(LS_WARNING) << "engine worker " << worker << ": sched_getaffinity failed: " << errno;
+                return;
+            }
+            const int num_cpus = CPU_COUNT(&allowed);
+            if (num_cpus <= 0) return;
+            int index = worker % num_cpus;
+            int cpu = 0;
+            for (; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &allowed) && index-- == 0) break;
+            }
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(cpu, &cpus);
+            if (int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus)) {
+                RTC_LOG(LS_WARNING) << "engine worker " << worker << ": cannot pin to CPU " << cpu << ": " << error;
+            }
+#else
+            (void) worker;
+#endif
+        }
+
+        void run(int worker) {
+            uint64_t seen = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                    if (stopping_) return;
+                    seen = generation_;
+                }
+
+                // Drain the home queue first, then steal from the others.
+                const int num_workers = static_cast<int>(queues_.size());
+                for (int k = 0; k < num_workers; ++k) {
+                    WorkQueue &queue = *queues_[(worker + k) % num_workers];
+                    const int size = static_cast<int>(queue.items.size());
+                    for (int i = queue.next.fetch_add(1); i < size; i = queue.next.fetch_add(1)) {
+                        processFrame(queue.items[i]);
+                    }
+                }
+
+                if (pending_workers_.fetch_sub(1, std::memory_order_acq_rel) == 1) complete();
+            }
+        }
+
+        void processFrame(int index) {
+            ApmEngineFrame &frame = frames_[index];
+            Session *session = frame_sessions_[index];
+            int result = webrtc::AudioProcessing::kNoError;
+            if (frame.render) {
+                result = ProcessReverseStream(session->handle, frame.render, session->render_channels);
+            }
+            if (frame.capture) {
+                int capture_result = ProcessStream(session->handle, frame.capture, session->capture_channels);
+                if (result == webrtc::AudioProcessing::kNoError) result = capture_result;
+            }
+            frame.result = result;
+        }
+
+        // Runs on the last worker to finish the tick.
+        void complete() {
+            int result = webrtc::AudioProcessing::kNoError;
+            for (int i = 0; i < num_frames_ && result == webrtc::AudioProcessing::kNoError; ++i) {
+                result = frames_[i].result;
+            }
+            ApmEngineTickCallback callback;
+            void *user_data;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                callback = callback_;
+                user_data = user_data_;
+                last_result_ = result;
+                in_flight_ = false;
+            }
+            done_.notify_all();
+            if (callback) callback(user_data, result);
+        }
+
+        std::vector<std::thread> workers_;
+        std::vector<std::unique_ptr<WorkQueue>> queues_;
+        std::vector<std::unique_ptr<Session>> sessions_;
+        std::vector<int> sessions_per_worker_;
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        uint64_t generation_ = 0;
+        bool stopping_ = false;
+        bool in_flight_ = false;
+        int last_result_ = webrtc::AudioProcessing::kNoError;
+
+        // State of the in-flight tick, written under mutex_ before waking the
+        // workers.
+        ApmEngineFrame *frames_ = nullptr;
+        int num_frames_ = 0;
+        std::vector<Session *> frame_sessions_;
+        ApmEngineTickCallback callback_ = nullptr;
+        void *user_data_ = nullptr;
+        std::atomic<int> pending_workers_{0};
+    };
+
+} // anonymous namespace
+
+extern "C" {
+
+ApmEngineHandle CreateEngine(int num_workers, bool pin_workers, int *error_code) {
+    *error_code = 0;
+    if (num_workers < 0) {
+        *error_code = webrtc::AudioProcessing::kBadParameterError;
+        return nullptr;
+    }
+    if (num_workers == 0) {
+        num_workers = static_cast<int>(std::thread::hardware_concurrency());
+        if (num_workers <= 0) num_workers = 1;
+    }
+    return static_cast<ApmEngineHandle>(new Engine(num_workers, pin_workers));
+}
+
+void DestroyEngine(ApmEngineHandle engine) {
+    if (engine) {
+        delete static_cast<Engine *>(engine);
+    }
+}
+
+int CreateEngineSession(ApmEngineHandle engine, ApmConfig apmConfig, int *error_code) {
+    if (!engine) {
+        *error_code = webrtc::AudioProcessing::kNullPointerError;
+        return -1;
+    }
+    return static_cast<Engine *>(engine)->CreateSession(apmConfig, error_code);
+}
+
+int DestroyEngineSession(ApmEngineHandle engine, int session) {
+    if (!engine) return webrtc::AudioProcessing::kNullPointerError;
+    return static_cast<Engine *>(engine)->DestroySession(session);
+}
+
+ApmHandle GetEngineSessionHandle(ApmEngineHandle engine, int session) {
+    if (!engine) return nullptr;
+    return static_cast<Engine *>(engine)->SessionHandle(session);
+}
+
+int ProcessEngineTick(ApmEngineHandle engine, ApmEngineFrame *frames, int num_frames) {
+    if (!engine || (!frames && num_frames > 0) || num_frames < 0)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    auto *e = static_cast<Engine *>(engine);
+    int result = e->Submit(frames, num_frames, nullptr, nullptr);
+    if (result != webrtc::AudioProcessing::kNoError) return result;
+    return e->Wait();
+}
+
+int SubmitEngineTick(ApmEngineHandle engine, ApmEngineFrame *frames, int num_frames,
+                     ApmEngineTickCallback callback, void *user_data) {
+    if (!engine || (!frames && num_frames > 0) || num_frames < 0)
+        return webrtc::AudioProcessing::kBadParameterError;
+
+    return static_cast<Engine *>(engine)->Submit(frames, num_frames, callback, user_data);
+}
+
+int WaitEngineTick(ApmEngineHandle engine) {
+    if (!engine) return webrtc::AudioProcessing::kNullPointerError;
+    return static_cast<Engine *>(engine)->Wait();
+}
+
+int engine_num_workers(ApmEngineHandle engine) {
+    if (!engine) return 0;
+    return static_cast<Engine *>(engine)->NumWorkers();
+}
+
+} // extern "C"
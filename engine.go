@@ -0,0 +1,193 @@
+package apm
+
+/*
+#include <engine.h>
+*/
+import "C"
+import (
+	"fmt"
+	"runtime"
+	"sync"
+	"unsafe"
+)
+
+// EngineFrame is one session's work for an engine tick. Render and Capture
+// are interleaved frames processed in place; either may be nil to skip that
+// direction for this tick.
+type EngineFrame struct {
+	Session int
+	Render  []float32
+	Capture []float32
+	// Err is set by ProcessTick to the frame's result
+	Err error
+}
+
+// sessionInfo mirrors what Go needs to validate a session's buffers
+type sessionInfo struct {
+	captureChannels int
+	renderChannels  int
+	samplesPerFrame int
+}
+
+// Engine processes one 10ms tick for many sessions in a single call,
+// spreading them over a fixed pool of worker threads. Its methods are safe
+// for concurrent use; ticks run one at a time.
+type Engine struct {
+	ptr      C.ApmEngineHandle
+	sessions map[int]sessionInfo
+	mu       sync.Mutex
+
+	// Reused across ticks so steady-state calls do not allocate
+	pinner  runtime.Pinner
+	cFrames []C.ApmEngineFrame
+}
+
+// NewEngine creates an engine with numWorkers threads (0 picks the number of
+// CPUs). With pinWorkers each worker is bound to its own CPU where supported.
+func NewEngine(numWorkers int, pinWorkers bool) (*Engine, error) {
+	var errorCode C.int
+	ptr := C.CreateEngine(C.int(numWorkers), C.bool(pinWorkers), &errorCode)
+	if ptr == nil {
+		return nil, fmt.Errorf("failed to create engine: error code %d", int(errorCode))
+	}
+
+	return &Engine{ptr: ptr, sessions: make(map[int]sessionInfo)}, nil
+}
+
+// Close destroys the engine and every session it owns
+func (e *Engine) Close() {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+
+	if e.ptr != nil {
+		C.DestroyEngine(e.ptr)
+		e.ptr = nil
+	}
+}
+
+// NumWorkers returns the number of worker threads
+func (e *Engine) NumWorkers() int {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+
+	if e.ptr == nil {
+		return 0
+	}
+	return int(C.engine_num_workers(e.ptr))
+}
+
+// AddSession creates a session owned by the engine and returns its id
+func (e *Engine) AddSession(config Config) (int, error) {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+
+	if e.ptr == nil {
+		return -1, fmt.Errorf("engine is closed")
+	}
+
+	var errorCode C.int
+	session := int(C.CreateEngineSession(e.ptr, parseConfig(config), &errorCode))
+	if session < 0 {
+		return -1, fmt.Errorf("failed to create session: error code %d", int(errorCode))
+	}
+
+	handle := C.GetEngineSessionHandle(e.ptr, C.int(session))
+	e.sessions[session] = sessionInfo{
+		captureChannels: config.CaptureChannels,
+		renderChannels:  config.RenderChannels,
+		samplesPerFrame: int(C.num_samples_per_frame(handle)),
+	}
+	return session, nil
+}
+
+// RemoveSession destroys a session
+func (e *Engine) RemoveSession(session int) error {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+
+	if e.ptr == nil {
+		return fmt.Errorf("engine is closed")
+	}
+
+	if result := C.DestroyEngineSession(e.ptr, C.int(session)); C.is_success(result) == 0 {
+		return fmt.Errorf("failed to remove session %d: error code %d", session, int(result))
+	}
+	delete(e.sessions, session)
+	return nil
+}
+
+// Session returns the Handle behind a session, for the per-handle setters and
+// GetStats. It stays owned by the engine: use the setters only between ticks,
+// and do not call Destroy on it. GetStats may also be called during a tick.
+func (e *Engine) Session(session int) *Handle {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+
+	info, ok := e.sessions[session]
+	if e.ptr == nil || !ok {
+		return nil
+	}
+	return &Handle{ptr: C.GetEngineSessionHandle(e.ptr, C.int(session)), numSamplesPerFrame: info.samplesPerFrame}
+}
+
+// ProcessTick processes one tick for all frames and blocks until it completes.
+// Each session may appear at most once. Per-frame failures are stored in
+// frames[i].Err; the first one is also returned.
+func (e *Engine) ProcessTick(frames []EngineFrame) error {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+
+	if e.ptr == nil {
+		return fmt.Errorf("engine is closed")
+	}
+	if len(frames) == 0 {
+		return nil
+	}
+
+	if cap(e.cFrames) < len(frames) {
+		e.cFrames = make([]C.ApmEngineFrame, len(frames))
+	}
+	cFrames := e.cFrames[:len(frames)]
+	defer func() {
+		clear(cFrames)
+		e.pinner.Unpin()
+	}()
+
+	for i := range frames {
+		frame := &frames[i]
+		frame.Err = nil
+		info, ok := e.sessions[frame.Session]
+		if !ok {
+			return fmt.Errorf("frame %d: unknown session %d", i, frame.Session)
+		}
+		if frame.Render != nil && len(frame.Render) != info.renderChannels*info.samplesPerFrame {
+			return fmt.Errorf("frame %d: expected %d render samples, got %d", i, info.renderChannels*info.samplesPerFrame, len(frame.Render))
+		}
+		if frame.Capture != nil && len(frame.Capture) != info.captureChannels*info.samplesPerFrame {
+			return fmt.Errorf("frame %d: expected %d capture samples, got %d", i, info.captureChannels*info.samplesPerFrame, len(frame.Capture))
+		}
+
+		cFrames[i] = C.ApmEngineFrame{session: C.int(frame.Session)}
+		if frame.Render != nil {
+			e.pinner.Pin(&frame.Render[0])
+			cFrames[i].render = (*C.float)(unsafe.Pointer(&frame.Render[0]))
+		}
+		if frame.Capture != nil {
+			e.pinner.Pin(&frame.Capture[0])
+			cFrames[i].capture = (*C.float)(unsafe.Pointer(&frame.Capture[0]))
+		}
+	}
+
+	result := C.ProcessEngineTick(e.ptr, &cFrames[0], C.int(len(frames)))
+
+	for i := range frames {
+		if code := int(cFrames[i].result); code != 0 {
+			frames[i].Err = fmt.Errorf("failed to process session %d: error code %d", frames[i].Session, code)
+		}
+	}
+
+	if C.is_success(result) == 0 {
+		return fmt.Errorf("failed to process engine tick: error code %d", int(result))
+	}
+	return nil
+}
@@ -0,0 +1,80 @@
+// engine.h - C interface to a multi-session processing engine
+//
+// An engine owns many audio processors ("sessions") and processes one 10ms
+// tick for all of them in a single call, spreading the sessions over a fixed
+// pool of worker threads. Each session has a home worker so its state stays
+// in that core's caches; idle workers steal frames from busy ones.
+
+#ifndef APM_ENGINE_H
+#define APM_ENGINE_H
+
+#include <bridge.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Opaque handle to the engine
+typedef void *ApmEngineHandle;
+
+// One session's work for a tick. render and capture are interleaved frames
+// of num_samples_per_frame(handle) samples per channel, processed in place.
+// Either may be NULL to skip that direction for this tick.
+typedef struct ApmEngineFrame {
+    int session;
+    float *render;
+    float *capture;
+    // Set by the engine: result of the frame, 0 on success
+    int result;
+} ApmEngineFrame;
+
+// Called from a worker thread once a tick submitted with SubmitEngineTick()
+// completes. result is 0 if every frame succeeded, otherwise the first
+// failing frame's error code.
+typedef void (*ApmEngineTickCallback)(void *user_data, int result);
+
+// Create an engine with num_workers threads (0 picks the number of CPUs).
+// With pin_workers, worker i is bound to the i-th CPU the process may run on,
+// modulo their count, where the platform supports it.
+// Returns NULL on failure, sets error code
+ApmEngineHandle CreateEngine(int num_workers, bool pin_workers, int *error_code);
+
+// Destroy the engine and every session it owns. Waits for an in-flight tick.
+void DestroyEngine(ApmEngineHandle engine);
+
+// Create a session owned by the engine.
+// Returns the session id (>= 0), or -1 on failure and sets error code
+int CreateEngineSession(ApmEngineHandle engine, ApmConfig apmConfig, int *error_code);
+
+// Destroy a session. Must not be called while a tick is in flight.
+int DestroyEngineSession(ApmEngineHandle engine, int session);
+
+// Get the processor behind a session, for the per-handle setters and
+// GetStatistics(). It stays owned by the engine: do not Destroy() it, and
+// only use it between ticks.
+ApmHandle GetEngineSessionHandle(ApmEngineHandle engine, int session);
+
+// Process one tick and block until every frame is done. Each session may
+// appear at most once per tick. frames must stay valid until return.
+// Returns 0 if every frame succeeded, otherwise the first failing frame's
+// error code; per-frame results are stored in frames[i].result.
+int ProcessEngineTick(ApmEngineHandle engine, ApmEngineFrame *frames, int num_frames);
+
+// Start processing one tick and return immediately. callback (may be NULL)
+// runs on a worker thread when the tick completes; WaitEngineTick() can be
+// used instead. frames must stay valid until then. Only one tick may be in
+// flight at a time.
+int SubmitEngineTick(ApmEngineHandle engine, ApmEngineFrame *frames, int num_frames,
+                     ApmEngineTickCallback callback, void *user_data);
+
+// Block until the in-flight tick (if any) completes and return its result
+int WaitEngineTick(ApmEngineHandle engine);
+
+// Get the number of worker threads
+int engine_num_workers(ApmEngineHandle engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APM_ENGINE_H
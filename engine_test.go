@@ -0,0 +1,196 @@
+package apm
+
+import (
+	"sync"
+	"testing"
+)
+
+func TestEngineProcessTick(t *testing.T) {
+	e, err := NewEngine(2, false)
+	if err != nil {
+		t.Fatalf("NewEngine failed: %v", err)
+	}
+	defer e.Close()
+
+	if e.NumWorkers() != 2 {
+		t.Errorf("NumWorkers() = %d, want 2", e.NumWorkers())
+	}
+
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		NoiseSuppression: NoiseSuppressionConfig{
+			Enabled: true,
+		},
+	}
+
+	const numSessions = 8
+	frames := make([]EngineFrame, numSessions)
+	reference := make([]*Handle, numSessions)
+	for i := range frames {
+		session, err := e.AddSession(config)
+		if err != nil {
+			t.Fatalf("AddSession failed: %v", err)
+		}
+		reference[i], err = Create(config)
+		if err != nil {
+			t.Fatalf("Create failed: %v", err)
+		}
+		defer reference[i].Destroy()
+		frames[i] = EngineFrame{Session: session}
+	}
+
+	for tick := 0; tick < 10; tick++ {
+		want := make([][]float32, numSessions)
+		for i := range frames {
+			frames[i].Capture = generateSineWave(float64(200+100*i), 0.3, NumSamplesPerFrame)
+			want[i] = append([]float32(nil), frames[i].Capture...)
+			if err := reference[i].ProcessCaptureFrame(want[i], 1); err != nil {
+				t.Fatalf("ProcessCaptureFrame failed: %v", err)
+			}
+		}
+
+		if err := e.ProcessTick(frames); err != nil {
+			t.Fatalf("ProcessTick failed at tick %d: %v", tick, err)
+		}
+
+		// Each session must match a handle processed on its own
+		for i := range frames {
+			if frames[i].Err != nil {
+				t.Fatalf("session %d failed: %v", i, frames[i].Err)
+			}
+			for j := range want[i] {
+				if frames[i].Capture[j] != want[i][j] {
+					t.Fatalf("tick %d session %d sample %d: engine %v, reference %v", tick, i, j, frames[i].Capture[j], want[i][j])
+				}
+			}
+		}
+	}
+}
+
+func TestEngineDuplicateSession(t *testing.T) {
+	e, err := NewEngine(1, false)
+	if err != nil {
+		t.Fatalf("NewEngine failed: %v", err)
+	}
+	defer e.Close()
+
+	session, err := e.AddSession(Config{CaptureChannels: 1, RenderChannels: 1})
+	if err != nil {
+		t.Fatalf("AddSession failed: %v", err)
+	}
+
+	frames := []EngineFrame{
+		{Session: session, Capture: make([]float32, NumSamplesPerFrame)},
+		{Session: session, Capture: make([]float32, NumSamplesPerFrame)},
+	}
+	if err := e.ProcessTick(frames); err == nil {
+		t.Error("ProcessTick should fail with a session appearing twice")
+	}
+	if frames[0].Err != nil || frames[1].Err == nil {
+		t.Errorf("expected only the second frame to fail, got %v and %v", frames[0].Err, frames[1].Err)
+	}
+}
+
+func TestEngineRemoveSession(t *testing.T) {
+	e, err := NewEngine(1, false)
+	if err != nil {
+		t.Fatalf("NewEngine failed: %v", err)
+	}
+	defer e.Close()
+
+	session, err := e.AddSession(Config{CaptureChannels: 1, RenderChannels: 1})
+	if err != nil {
+		t.Fatalf("AddSession failed: %v", err)
+	}
+	if h := e.Session(session); h == nil || h.NumSamplesPerFrame() != NumSamplesPerFrame {
+		t.Fatal("Session should return the session handle")
+	}
+	if err := e.RemoveSession(session); err != nil {
+		t.Fatalf("RemoveSession failed: %v", err)
+	}
+	if err := e.RemoveSession(session); err == nil {
+		t.Error("RemoveSession should fail for a removed session")
+	}
+	if err := e.ProcessTick([]EngineFrame{{Session: session}}); err == nil {
+		t.Error("ProcessTick should fail for a removed session")
+	}
+}
+
+func TestEngineConcurrentUse(t *testing.T) {
+	e, err := NewEngine(2, true)
+	if err != nil {
+		t.Fatalf("NewEngine failed: %v", err)
+	}
+	defer e.Close()
+
+	config := Config{CaptureChannels: 1, RenderChannels: 1}
+	var wg sync.WaitGroup
+	for g := 0; g < 2; g++ {
+		session, err := e.AddSession(config)
+		if err != nil {
+			t.Fatalf("AddSession failed: %v", err)
+		}
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			frames := []EngineFrame{{Session: session}}
+			for tick := 0; tick < 50; tick++ {
+				frames[0].Capture = generateSineWave(440, 0.3, NumSamplesPerFrame)
+				if err := e.ProcessTick(frames); err != nil {
+					t.Errorf("ProcessTick failed at tick %d: %v", tick, err)
+					return
+				}
+			}
+		}()
+	}
+	wg.Add(1)
+	go func() {
+		defer wg.Done()
+		for i := 0; i < 20; i++ {
+			session, err := e.AddSession(config)
+			if err != nil {
+				t.Errorf("AddSession failed: %v", err)
+				return
+			}
+			if e.Session(session) == nil {
+				t.Errorf("Session(%d) = nil", session)
+			}
+			if err := e.RemoveSession(session); err != nil {
+				t.Errorf("RemoveSession failed: %v", err)
+			}
+		}
+	}()
+	wg.Wait()
+}
+
+func BenchmarkEngineProcessTick(b *testing.B) {
+	e, err := NewEngine(0, true)
+	if err != nil {
+		b.Fatalf("NewEngine failed: %v", err)
+	}
+	defer e.Close()
+
+	config := Config{
+		CaptureChannels: 1,
+		RenderChannels:  1,
+		NoiseSuppression: NoiseSuppressionConfig{
+			Enabled:          true,
+			SuppressionLevel: NsLevelHigh,
+		},
+	}
+
+	frames := make([]EngineFrame, 64)
+	for i := range frames {
+		session, err := e.AddSession(config)
+		if err != nil {
+			b.Fatalf("AddSession failed: %v", err)
+		}
+		frames[i] = EngineFrame{Session: session, Capture: generateSineWave(440, 0.5, NumSamplesPerFrame)}
+	}
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		e.ProcessTick(frames)
+	}
+}
@@ -26,6 +26,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "absl/base/nullability.h"
 #include "absl/strings/string_view.h"
@@ -635,6 +636,22 @@ class RTC_EXPORT AudioProcessing : public RefCountInterface {
   // Returns the last applied configuration.
   virtual AudioProcessing::Config GetConfig() const = 0;
 
+  // Writes the adaptive state of the echo controller and of the adaptive
+  // digital gain controller (AGC2) to `state`, replacing its contents. Loading
+  // it into a new instance with the same configuration lets that instance skip
+  // the convergence period, e.g., when a call is resumed or migrated. Returns
+  // false if the state cannot be saved.
+  virtual bool SaveAdaptiveState(std::vector<uint8_t>* /* state */) {
+    return false;
+  }
+
+  // Restores state written by SaveAdaptiveState(). Returns false, leaving the
+  // instance unchanged, if `state` is malformed or was saved by an instance
+  // with a different configuration or channel setup.
+  virtual bool LoadAdaptiveState(ArrayView<const uint8_t> /* state */) {
+    return false;
+  }
+
   enum Error {
     // Fatal errors.
     kNoError = 0,
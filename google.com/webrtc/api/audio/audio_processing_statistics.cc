@@ -14,9 +14,4 @@ namespace webrtc {
 
 AudioProcessingStats::AudioProcessingStats() = default;
 
-AudioProcessingStats::AudioProcessingStats(const AudioProcessingStats& other) =
-    default;
-
-AudioProcessingStats::~AudioProcessingStats() = default;
-
 }  // namespace webrtc
@@ -20,10 +20,12 @@
 namespace webrtc {
 // This version of the stats uses Optionals, it will replace the regular
 // AudioProcessingStatistics struct.
+// The struct is kept trivially copyable so that it can be published to other
+// threads through a SeqLock.
 struct RTC_EXPORT AudioProcessingStats {
   AudioProcessingStats();
-  AudioProcessingStats(const AudioProcessingStats& other);
-  ~AudioProcessingStats();
+  AudioProcessingStats(const AudioProcessingStats& other) = default;
+  ~AudioProcessingStats() = default;
 
   // Deprecated.
   // TODO(bugs.webrtc.org/11226): Remove.
@@ -61,6 +63,38 @@ struct RTC_EXPORT AudioProcessingStats {
   // milliseconds and the value is the instantaneous value at the time of the
   // call to `GetStatistics()`.
   std::optional<int32_t> delay_ms;
+
+  // Length of the echo path covered by the linear filter of the AEC, in
+  // milliseconds. It follows the measured echo path when the AEC adapts the
+  // filter length.
+  std::optional<int32_t> linear_filter_length_ms;
+
+  // Wall-clock time spent in a processing stage per 10 ms frame, summarized
+  // over the last completed window of about one second of frames.
+  struct StageTiming {
+    int64_t min_ns = 0;
+    int64_t mean_ns = 0;
+    int64_t p99_ns = 0;
+  };
+
+  // Processing timings. A stage is reported once it has been active in a full
+  // window of frames and keeps its last summary while it is inactive.
+  // Whole capture frame, excluding format conversion.
+  std::optional<StageTiming> capture_processing_time;
+  // Splitting into and merging of the capture frequency bands.
+  std::optional<StageTiming> capture_band_split_time;
+  std::optional<StageTiming> high_pass_filter_time;
+  // Capture analysis and processing of the echo controller.
+  std::optional<StageTiming> echo_controller_time;
+  // Analysis and processing of the noise suppressor.
+  std::optional<StageTiming> noise_suppressor_time;
+  std::optional<StageTiming> gain_controller2_time;
+  // Whole render frame, excluding format conversion.
+  std::optional<StageTiming> render_processing_time;
+  // Splitting into and merging of the render frequency bands.
+  std::optional<StageTiming> render_band_split_time;
+  // Render analysis of the echo controller.
+  std::optional<StageTiming> render_analysis_time;
 };
 
 }  // namespace webrtc
@@ -9,10 +9,14 @@
  */
 #include "api/audio/builtin_audio_processing_builder.h"
 
+#include <memory>
 #include <utility>
 
 #include "absl/base/nullability.h"
 #include "api/audio/audio_processing.h"
+#include "api/audio/echo_canceller3_config.h"
+#include "api/audio/echo_canceller3_factory.h"
+#include "api/audio/echo_control.h"
 #include "api/environment/environment.h"
 #include "api/make_ref_counted.h"
 #include "api/scoped_refptr.h"
@@ -22,10 +26,17 @@ namespace webrtc {
 
 absl_nullable scoped_refptr<AudioProcessing>
 BuiltinAudioProcessingBuilder::Build(const Environment& env) {
+  std::unique_ptr<EchoControlFactory> echo_canceller3_factory;
+  if (echo_canceller3_config_ || shared_render_analysis_) {
+    echo_canceller3_factory = std::make_unique<EchoCanceller3Factory>(
+        echo_canceller3_config_.value_or(EchoCanceller3Config()),
+        echo_canceller3_multichannel_config_, shared_render_analysis_);
+  }
   return make_ref_counted<AudioProcessingImpl>(
       env, config_, std::move(capture_post_processing_),
       std::move(render_pre_processing_), std::move(echo_control_factory_),
-      std::move(echo_detector_), std::move(capture_analyzer_));
+      std::move(echo_detector_), std::move(capture_analyzer_),
+      std::move(echo_canceller3_factory));
 }
 
 }  // namespace webrtc
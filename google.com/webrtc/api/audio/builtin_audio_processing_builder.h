@@ -12,10 +12,13 @@
 #define API_AUDIO_BUILTIN_AUDIO_PROCESSING_BUILDER_H_
 
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "absl/base/nullability.h"
 #include "api/audio/audio_processing.h"
+#include "api/audio/echo_canceller3_config.h"
+#include "api/audio/echo_canceller3_factory.h"
 #include "api/audio/echo_control.h"
 #include "api/environment/environment.h"
 #include "api/scoped_refptr.h"
@@ -23,6 +26,8 @@
 
 namespace webrtc {
 
+class SharedRenderAnalysis;
+
 class RTC_EXPORT BuiltinAudioProcessingBuilder
     : public AudioProcessingBuilderInterface {
  public:
@@ -48,6 +53,29 @@ class RTC_EXPORT BuiltinAudioProcessingBuilder
     return *this;
   }
 
+  // Sets the configurations of the built-in echo canceller (AEC3). Unlike an
+  // injected echo controller factory, which is used regardless of the config,
+  // the echo canceller is still enabled and disabled through
+  // AudioProcessing::Config. An injected echo controller factory takes
+  // precedence.
+  BuiltinAudioProcessingBuilder& SetEchoCanceller3Config(
+      const EchoCanceller3Config& config,
+      std::optional<EchoCanceller3Config> multichannel_config) {
+    echo_canceller3_config_ = config;
+    echo_canceller3_multichannel_config_ = multichannel_config;
+    return *this;
+  }
+
+  // Makes the built-in echo canceller share its render analysis with those of
+  // the other APMs built with the same `shared_render_analysis`, e.g. one APM
+  // per microphone beam. All of them must be fed the same render signal. Uses
+  // the default echo canceller configurations unless they are set.
+  BuiltinAudioProcessingBuilder& SetSharedRenderAnalysis(
+      std::shared_ptr<SharedRenderAnalysis> shared_render_analysis) {
+    shared_render_analysis_ = std::move(shared_render_analysis);
+    return *this;
+  }
+
   // Sets the capture post-processing sub-module to inject when APM is created.
   BuiltinAudioProcessingBuilder& SetCapturePostProcessing(
       std::unique_ptr<CustomProcessing> capture_post_processing) {
@@ -85,6 +113,9 @@ class RTC_EXPORT BuiltinAudioProcessingBuilder
  private:
   AudioProcessing::Config config_;
   std::unique_ptr<EchoControlFactory> echo_control_factory_;
+  std::optional<EchoCanceller3Config> echo_canceller3_config_;
+  std::optional<EchoCanceller3Config> echo_canceller3_multichannel_config_;
+  std::shared_ptr<SharedRenderAnalysis> shared_render_analysis_;
   std::unique_ptr<CustomProcessing> capture_post_processing_;
   std::unique_ptr<CustomProcessing> render_pre_processing_;
   scoped_refptr<EchoDetector> echo_detector_;
@@ -274,6 +274,8 @@ bool EchoCanceller3Config::Validate(EchoCanceller3Config* config) {
 
   res = res & Limit(&c->suppressor.floor_first_increase, 0.f, 1000000.f);
 
+  res = res & Limit(&c->multi_channel.num_worker_threads, 0, 16);
+
   return res;
 }
 
@@ -63,6 +63,18 @@ struct RTC_EXPORT EchoCanceller3Config {
     AlignmentMixing render_alignment_mixing = {false, true, 10000.f, true};
     AlignmentMixing capture_alignment_mixing = {false, true, 10000.f, false};
     bool detect_pre_echo = true;
+    // Method used to estimate the echo path delay. The matched filters
+    // adapt within a fraction of a second but their cost grows linearly with
+    // the delay range set by `num_filters`. The FFT correlation updates its
+    // estimate about every half range and its cost barely grows with the
+    // range, which suits long render-to-capture delays.
+    enum class Estimator { kMatchedFilter, kFftCorrelation };
+    Estimator estimator = Estimator::kMatchedFilter;
+    // Resamples the render signal to the capture clock once the delay
+    // estimates show a clock drift, which keeps the delay and the linear
+    // filters aligned. From then on the render signal is delayed by about two
+    // blocks. Not used with an external delay estimator.
+    bool compensate_clock_drift = false;
   } delay;
 
   struct Filter {
@@ -97,6 +109,9 @@ struct RTC_EXPORT EchoCanceller3Config {
     bool use_linear_filter = true;
     bool high_pass_filter_echo_reference = false;
     bool export_linear_aec_output = false;
+    // Shortens the linear filters to the measured length of the echo path
+    // while the filters are converged. The lengths above are then maximums.
+    bool adaptive_length = true;
   } filter;
 
   struct Erle {
@@ -140,6 +155,10 @@ struct RTC_EXPORT EchoCanceller3Config {
   struct EchoRemovalControl {
     bool has_clock_drift = false;
     bool linear_and_stable_echo_path = false;
+    // Bypasses the linear filter and the suppressor while there has been no
+    // render activity for longer than the echo path, which leaves the capture
+    // signal unchanged but for the delay of the suppressor filter bank.
+    bool idle_during_inactive_render = true;
   } echo_removal_control;
 
   struct EchoModel {
@@ -246,6 +265,11 @@ struct RTC_EXPORT EchoCanceller3Config {
     float stereo_detection_threshold = 0.0f;
     int stereo_detection_timeout_threshold_seconds = 300;
     float stereo_detection_hysteresis_seconds = 2.0f;
+    // Number of threads, besides the capture thread, that the echo remover
+    // spreads the linear filtering and suppression of the capture channels
+    // over. 0 processes the channels one after the other on the capture
+    // thread. The output does not depend on the number of threads.
+    int num_worker_threads = 0;
   } multi_channel;
 };
 }  // namespace webrtc
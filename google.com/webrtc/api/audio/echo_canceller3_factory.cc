@@ -11,12 +11,14 @@
 
 #include <memory>
 #include <optional>
+#include <utility>
 
 #include "absl/base/nullability.h"
 #include "api/audio/echo_canceller3_config.h"
 #include "api/audio/echo_control.h"
 #include "api/environment/environment.h"
 #include "audio_processing/aec3/echo_canceller3.h"
+#include "audio_processing/aec3/shared_render_analysis.h"
 
 namespace webrtc {
 
@@ -30,14 +32,22 @@ EchoCanceller3Factory::EchoCanceller3Factory(
     std::optional<EchoCanceller3Config> multichannel_config)
     : config_(config), multichannel_config_(multichannel_config) {}
 
+EchoCanceller3Factory::EchoCanceller3Factory(
+    const EchoCanceller3Config config,
+    std::optional<EchoCanceller3Config> multichannel_config,
+    std::shared_ptr<SharedRenderAnalysis> shared_render_analysis)
+    : config_(config),
+      multichannel_config_(multichannel_config),
+      shared_render_analysis_(std::move(shared_render_analysis)) {}
+
 absl_nonnull std::unique_ptr<EchoControl> EchoCanceller3Factory::Create(
     const Environment& env,
     int sample_rate_hz,
     int num_render_channels,
     int num_capture_channels) {
-  return std::make_unique<EchoCanceller3>(env, config_, multichannel_config_,
-                                          sample_rate_hz, num_render_channels,
-                                          num_capture_channels);
+  return std::make_unique<EchoCanceller3>(
+      env, config_, multichannel_config_, sample_rate_hz, num_render_channels,
+      num_capture_channels, shared_render_analysis_);
 }
 
 }  // namespace webrtc
@@ -22,6 +22,8 @@
 
 namespace webrtc {
 
+class SharedRenderAnalysis;
+
 class RTC_EXPORT EchoCanceller3Factory : public EchoControlFactory {
  public:
   // Factory producing EchoCanceller3 instances with the default configuration.
@@ -37,6 +39,14 @@ class RTC_EXPORT EchoCanceller3Factory : public EchoControlFactory {
       const EchoCanceller3Config config,
       std::optional<EchoCanceller3Config> multichannel_config);
 
+  // Factory producing EchoCanceller3 instances with the specified
+  // configurations, which share their render analysis through
+  // `shared_render_analysis`. They must all be fed the same render signal.
+  EchoCanceller3Factory(
+      const EchoCanceller3Config config,
+      std::optional<EchoCanceller3Config> multichannel_config,
+      std::shared_ptr<SharedRenderAnalysis> shared_render_analysis);
+
   // Creates an EchoCanceller3 with a specified channel count and sampling rate.
   absl_nonnull std::unique_ptr<EchoControl> Create(
       const Environment& env,
@@ -47,6 +57,7 @@ class RTC_EXPORT EchoCanceller3Factory : public EchoControlFactory {
  private:
   const EchoCanceller3Config config_;
   const std::optional<EchoCanceller3Config> multichannel_config_;
+  const std::shared_ptr<SharedRenderAnalysis> shared_render_analysis_;
 };
 }  // namespace webrtc
 
@@ -11,9 +11,14 @@
 #ifndef API_AUDIO_ECHO_CONTROL_H_
 #define API_AUDIO_ECHO_CONTROL_H_
 
+#include <stdint.h>
+
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "absl/base/nullability.h"
+#include "api/array_view.h"
 #include "api/environment/environment.h"
 
 namespace webrtc {
@@ -41,6 +46,8 @@ class EchoControl {
     double echo_return_loss;
     double echo_return_loss_enhancement;
     int delay_ms;
+    // Length of the echo path covered by the linear filter, if there is one.
+    std::optional<int> linear_filter_length_ms;
   };
 
   // Collect current metrics from the echo controller.
@@ -59,6 +66,20 @@ class EchoControl {
   // Returns wheter the signal is altered.
   virtual bool ActiveProcessing() const = 0;
 
+  // Appends the adaptive state (e.g., converged filters and delay) to `state`
+  // so that a new instance with the same configuration can start from it.
+  // Returns false if the echo controller does not support this.
+  virtual bool SaveState(std::vector<uint8_t>* /* state */) const {
+    return false;
+  }
+
+  // Restores state written by SaveState(). Returns false, leaving the state
+  // unchanged, if the state was not produced by an instance with the same
+  // configuration and channel setup.
+  virtual bool LoadState(ArrayView<const uint8_t> /* state */) {
+    return false;
+  }
+
   virtual ~EchoControl() {}
 };
 
@@ -563,6 +563,9 @@ void AdaptiveFirFilter::Filter(const RenderBuffer& render_buffer,
     case Aec3Optimization::kAvx2:
       aec3::ApplyFilter_Avx2(render_buffer, current_size_partitions_, H_, S);
       break;
+    case Aec3Optimization::kAvx512:
+      aec3::ApplyFilter_Avx512(render_buffer, current_size_partitions_, H_, S);
+      break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
     case Aec3Optimization::kNeon:
@@ -607,6 +610,9 @@ void AdaptiveFirFilter::ComputeFrequencyResponse(
     case Aec3Optimization::kAvx2:
       aec3::ComputeFrequencyResponse_Avx2(current_size_partitions_, H_, H2);
       break;
+    case Aec3Optimization::kAvx512:
+      aec3::ComputeFrequencyResponse_Avx512(current_size_partitions_, H_, H2);
+      break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
     case Aec3Optimization::kNeon:
@@ -634,6 +640,10 @@ void AdaptiveFirFilter::AdaptAndUpdateSize(const RenderBuffer& render_buffer,
       aec3::AdaptPartitions_Avx2(render_buffer, G, current_size_partitions_,
                                  &H_);
       break;
+    case Aec3Optimization::kAvx512:
+      aec3::AdaptPartitions_Avx512(render_buffer, G, current_size_partitions_,
+                                   &H_);
+      break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
     case Aec3Optimization::kNeon:
@@ -741,4 +751,27 @@ void AdaptiveFirFilter::SetFilter(size_t num_partitions,
   }
 }
 
+void AdaptiveFirFilter::SaveState(StateWriter* writer) const {
+  writer->WriteUint32(current_size_partitions_);
+  for (size_t p = 0; p < max_size_partitions_; ++p) {
+    for (size_t ch = 0; ch < num_render_channels_; ++ch) {
+      writer->WriteFloats(H_[p][ch].re);
+      writer->WriteFloats(H_[p][ch].im);
+    }
+  }
+}
+
+void AdaptiveFirFilter::LoadState(StateReader* reader) {
+  const size_t size_partitions = reader->ReadUint32();
+  SetSizePartitions(std::max<size_t>(
+                        std::min(size_partitions, max_size_partitions_), 1),
+                    true);
+  for (size_t p = 0; p < max_size_partitions_; ++p) {
+    for (size_t ch = 0; ch < num_render_channels_; ++ch) {
+      reader->ReadFloats(H_[p][ch].re);
+      reader->ReadFloats(H_[p][ch].im);
+    }
+  }
+}
+
 }  // namespace webrtc
@@ -23,6 +23,7 @@
 #include "audio_processing/aec3/fft_data.h"
 #include "audio_processing/aec3/render_buffer.h"
 #include "audio_processing/logging/apm_data_dumper.h"
+#include "audio_processing/utility/state_serializer.h"
 #include "rtc_base/system/arch.h"
 
 namespace webrtc {
@@ -48,6 +49,11 @@ void ComputeFrequencyResponse_Avx2(
     size_t num_partitions,
     const std::vector<std::vector<FftData>>& H,
     std::vector<std::array<float, kFftLengthBy2Plus1>>* H2);
+
+void ComputeFrequencyResponse_Avx512(
+    size_t num_partitions,
+    const std::vector<std::vector<FftData>>& H,
+    std::vector<std::array<float, kFftLengthBy2Plus1>>* H2);
 #endif
 
 // Adapts the filter partitions.
@@ -71,6 +77,11 @@ void AdaptPartitions_Avx2(const RenderBuffer& render_buffer,
                           const FftData& G,
                           size_t num_partitions,
                           std::vector<std::vector<FftData>>* H);
+
+void AdaptPartitions_Avx512(const RenderBuffer& render_buffer,
+                            const FftData& G,
+                            size_t num_partitions,
+                            std::vector<std::vector<FftData>>* H);
 #endif
 
 // Produces the filter output.
@@ -94,6 +105,11 @@ void ApplyFilter_Avx2(const RenderBuffer& render_buffer,
                       size_t num_partitions,
                       const std::vector<std::vector<FftData>>& H,
                       FftData* S);
+
+void ApplyFilter_Avx512(const RenderBuffer& render_buffer,
+                        size_t num_partitions,
+                        const std::vector<std::vector<FftData>>& H,
+                        FftData* S);
 #endif
 
 }  // namespace aec3
@@ -159,6 +175,11 @@ class AdaptiveFirFilter {
   // Gets the filter coefficients.
   const std::vector<std::vector<FftData>>& GetFilter() const { return H_; }
 
+  // Saves and restores the filter size and coefficients. Loading assumes the
+  // state was saved by a filter with the same dimensions.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
  private:
   // Adapts the filter and updates the filter size.
   void AdaptAndUpdateSize(const RenderBuffer& render_buffer, const FftData& G);
@@ -183,6 +204,8 @@ class AdaptiveFirFilter {
   size_t target_size_partitions_;
   size_t old_target_size_partitions_;
   int size_change_counter_ = 0;
+  // One allocation per partition. Keeping all partitions in one aligned slab
+  // was measured to be no faster, with mono or multi-channel capture.
   std::vector<std::vector<FftData>> H_;
   size_t partition_to_constrain_ = 0;
 };
@@ -0,0 +1,184 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#if defined(__i386__) || defined(_M_IX86) || defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+
+#include "audio_processing/aec3/adaptive_fir_filter.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace aec3 {
+
+namespace {
+
+// Number of 16 bin vectors below the Nyquist bin, which is processed
+// separately.
+constexpr size_t kNumSixteenBinBands = kFftLengthBy2 / 16;
+
+}  // namespace
+
+// Computes and stores the frequency response of the filter.
+__attribute__((target("avx512f")))
+void ComputeFrequencyResponse_Avx512(
+    size_t num_partitions,
+    const std::vector<std::vector<FftData>>& H,
+    std::vector<std::array<float, kFftLengthBy2Plus1>>* H2) {
+  const size_t num_render_channels = H[0].size();
+  RTC_DCHECK_EQ(H.size(), H2->capacity());
+  for (size_t p = 0; p < num_partitions; ++p) {
+    RTC_DCHECK_EQ(kFftLengthBy2Plus1, (*H2)[p].size());
+    auto& H2_p = (*H2)[p];
+    __m512 H2_p_k[kNumSixteenBinBands];
+    for (size_t n = 0; n < kNumSixteenBinBands; ++n) {
+      H2_p_k[n] = _mm512_setzero_ps();
+    }
+    float H2_p_nyquist = 0.f;
+    for (size_t ch = 0; ch < num_render_channels; ++ch) {
+      const FftData& H_p_ch = H[p][ch];
+      for (size_t n = 0, k = 0; n < kNumSixteenBinBands; ++n, k += 16) {
+        const __m512 re = _mm512_loadu_ps(&H_p_ch.re[k]);
+        const __m512 im = _mm512_loadu_ps(&H_p_ch.im[k]);
+        const __m512 re2 = _mm512_mul_ps(re, re);
+        H2_p_k[n] = _mm512_max_ps(H2_p_k[n], _mm512_fmadd_ps(im, im, re2));
+      }
+      const float H2_p_ch_nyquist =
+          H_p_ch.re[kFftLengthBy2] * H_p_ch.re[kFftLengthBy2] +
+          H_p_ch.im[kFftLengthBy2] * H_p_ch.im[kFftLengthBy2];
+      H2_p_nyquist = std::max(H2_p_nyquist, H2_p_ch_nyquist);
+    }
+    for (size_t n = 0, k = 0; n < kNumSixteenBinBands; ++n, k += 16) {
+      _mm512_storeu_ps(&H2_p[k], H2_p_k[n]);
+    }
+    H2_p[kFftLengthBy2] = H2_p_nyquist;
+  }
+  for (size_t p = num_partitions; p < H2->size(); ++p) {
+    (*H2)[p].fill(0.f);
+  }
+}
+
+// Adapts the filter partitions.
+__attribute__((target("avx512f")))
+void AdaptPartitions_Avx512(const RenderBuffer& render_buffer,
+                            const FftData& G,
+                            size_t num_partitions,
+                            std::vector<std::vector<FftData>>* H) {
+  ArrayView<const std::vector<FftData>> render_buffer_data =
+      render_buffer.GetFftBuffer();
+  const size_t num_render_channels = render_buffer_data[0].size();
+  const size_t lim1 = std::min(
+      render_buffer_data.size() - render_buffer.Position(), num_partitions);
+  const size_t lim2 = num_partitions;
+
+  // The gain is the same for all partitions and is kept in registers.
+  __m512 G_re[kNumSixteenBinBands];
+  __m512 G_im[kNumSixteenBinBands];
+  for (size_t n = 0, k = 0; n < kNumSixteenBinBands; ++n, k += 16) {
+    G_re[n] = _mm512_loadu_ps(&G.re[k]);
+    G_im[n] = _mm512_loadu_ps(&G.im[k]);
+  }
+
+  size_t X_partition = render_buffer.Position();
+  size_t limit = lim1;
+  size_t p = 0;
+  do {
+    for (; p < limit; ++p, ++X_partition) {
+      for (size_t ch = 0; ch < num_render_channels; ++ch) {
+        FftData& H_p_ch = (*H)[p][ch];
+        const FftData& X = render_buffer_data[X_partition][ch];
+
+        for (size_t n = 0, k = 0; n < kNumSixteenBinBands; ++n, k += 16) {
+          const __m512 X_re = _mm512_loadu_ps(&X.re[k]);
+          const __m512 X_im = _mm512_loadu_ps(&X.im[k]);
+          __m512 H_re = _mm512_loadu_ps(&H_p_ch.re[k]);
+          __m512 H_im = _mm512_loadu_ps(&H_p_ch.im[k]);
+          H_re = _mm512_fmadd_ps(X_re, G_re[n], H_re);
+          H_re = _mm512_fmadd_ps(X_im, G_im[n], H_re);
+          H_im = _mm512_fmadd_ps(X_re, G_im[n], H_im);
+          H_im = _mm512_fnmadd_ps(X_im, G_re[n], H_im);
+          _mm512_storeu_ps(&H_p_ch.re[k], H_re);
+          _mm512_storeu_ps(&H_p_ch.im[k], H_im);
+        }
+
+        H_p_ch.re[kFftLengthBy2] += X.re[kFftLengthBy2] * G.re[kFftLengthBy2] +
+                                    X.im[kFftLengthBy2] * G.im[kFftLengthBy2];
+        H_p_ch.im[kFftLengthBy2] += X.re[kFftLengthBy2] * G.im[kFftLengthBy2] -
+                                    X.im[kFftLengthBy2] * G.re[kFftLengthBy2];
+      }
+    }
+    X_partition = 0;
+    limit = lim2;
+  } while (p < lim2);
+}
+
+// Produces the filter output (AVX-512 variant).
+__attribute__((target("avx512f")))
+void ApplyFilter_Avx512(const RenderBuffer& render_buffer,
+                        size_t num_partitions,
+                        const std::vector<std::vector<FftData>>& H,
+                        FftData* S) {
+  RTC_DCHECK_GE(H.size(), H.size() - 1);
+  ArrayView<const std::vector<FftData>> render_buffer_data =
+      render_buffer.GetFftBuffer();
+  const size_t num_render_channels = render_buffer_data[0].size();
+  const size_t lim1 = std::min(
+      render_buffer_data.size() - render_buffer.Position(), num_partitions);
+  const size_t lim2 = num_partitions;
+
+  // The output is accumulated in registers over all partitions.
+  __m512 S_re[kNumSixteenBinBands];
+  __m512 S_im[kNumSixteenBinBands];
+  for (size_t n = 0; n < kNumSixteenBinBands; ++n) {
+    S_re[n] = _mm512_setzero_ps();
+    S_im[n] = _mm512_setzero_ps();
+  }
+  float S_re_nyquist = 0.f;
+  float S_im_nyquist = 0.f;
+
+  size_t X_partition = render_buffer.Position();
+  size_t p = 0;
+  size_t limit = lim1;
+  do {
+    for (; p < limit; ++p, ++X_partition) {
+      for (size_t ch = 0; ch < num_render_channels; ++ch) {
+        const FftData& H_p_ch = H[p][ch];
+        const FftData& X = render_buffer_data[X_partition][ch];
+        for (size_t n = 0, k = 0; n < kNumSixteenBinBands; ++n, k += 16) {
+          const __m512 X_re = _mm512_loadu_ps(&X.re[k]);
+          const __m512 X_im = _mm512_loadu_ps(&X.im[k]);
+          const __m512 H_re = _mm512_loadu_ps(&H_p_ch.re[k]);
+          const __m512 H_im = _mm512_loadu_ps(&H_p_ch.im[k]);
+          S_re[n] = _mm512_fmadd_ps(X_re, H_re, S_re[n]);
+          S_re[n] = _mm512_fnmadd_ps(X_im, H_im, S_re[n]);
+          S_im[n] = _mm512_fmadd_ps(X_re, H_im, S_im[n]);
+          S_im[n] = _mm512_fmadd_ps(X_im, H_re, S_im[n]);
+        }
+        S_re_nyquist += X.re[kFftLengthBy2] * H_p_ch.re[kFftLengthBy2] -
+                        X.im[kFftLengthBy2] * H_p_ch.im[kFftLengthBy2];
+        S_im_nyquist += X.re[kFftLengthBy2] * H_p_ch.im[kFftLengthBy2] +
+                        X.im[kFftLengthBy2] * H_p_ch.re[kFftLengthBy2];
+      }
+    }
+    limit = lim2;
+    X_partition = 0;
+  } while (p < lim2);
+
+  for (size_t n = 0, k = 0; n < kNumSixteenBinBands; ++n, k += 16) {
+    _mm512_storeu_ps(&S->re[k], S_re[n]);
+    _mm512_storeu_ps(&S->im[k], S_im[n]);
+  }
+  S->re[kFftLengthBy2] = S_re_nyquist;
+  S->im[kFftLengthBy2] = S_im_nyquist;
+}
+
+}  // namespace aec3
+}  // namespace webrtc
+#endif
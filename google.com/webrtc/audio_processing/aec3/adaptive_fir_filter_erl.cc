@@ -88,6 +88,9 @@ void ComputeErl(const Aec3Optimization& optimization,
     case Aec3Optimization::kAvx2:
       aec3::ErlComputer_AVX2(H2, erl);
       break;
+    case Aec3Optimization::kAvx512:
+      aec3::ErlComputer_AVX512(H2, erl);
+      break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
     case Aec3Optimization::kNeon:
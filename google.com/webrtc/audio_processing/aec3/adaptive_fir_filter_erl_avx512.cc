@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#if defined(__i386__) || defined(_M_IX86) || defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+
+#include "audio_processing/aec3/adaptive_fir_filter_erl.h"
+
+namespace webrtc {
+
+namespace aec3 {
+
+// Computes and stores the echo return loss estimate of the filter, which is the
+// sum of the partition frequency responses.
+__attribute__((target("avx512f")))
+void ErlComputer_AVX512(
+    const std::vector<std::array<float, kFftLengthBy2Plus1>>& H2,
+    ArrayView<float> erl) {
+  constexpr size_t kNumSixteenBinBands = kFftLengthBy2 / 16;
+  __m512 erl_k[kNumSixteenBinBands];
+  for (size_t n = 0; n < kNumSixteenBinBands; ++n) {
+    erl_k[n] = _mm512_setzero_ps();
+  }
+  float erl_nyquist = 0.f;
+  for (auto& H2_j : H2) {
+    for (size_t n = 0, k = 0; n < kNumSixteenBinBands; ++n, k += 16) {
+      erl_k[n] = _mm512_add_ps(erl_k[n], _mm512_loadu_ps(&H2_j[k]));
+    }
+    erl_nyquist += H2_j[kFftLengthBy2];
+  }
+  for (size_t n = 0, k = 0; n < kNumSixteenBinBands; ++n, k += 16) {
+    _mm512_storeu_ps(&erl[k], erl_k[n]);
+  }
+  erl[kFftLengthBy2] = erl_nyquist;
+}
+
+}  // namespace aec3
+}  // namespace webrtc
+#endif
@@ -20,7 +20,10 @@ namespace webrtc {
 
 Aec3Optimization DetectOptimization() {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-  if (GetCPUInfo(kAVX2) != 0) {
+  // The AVX-512 level keeps using the AVX2 FFT, so it requires AVX2 as well.
+  if (GetCPUInfo(kAVX512) != 0 && GetCPUInfo(kAVX2) != 0) {
+    return Aec3Optimization::kAvx512;
+  } else if (GetCPUInfo(kAVX2) != 0) {
     return Aec3Optimization::kAvx2;
   } else if (GetCPUInfo(kSSE2) != 0) {
     return Aec3Optimization::kSse2;
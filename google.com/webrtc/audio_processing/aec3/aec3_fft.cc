@@ -81,7 +81,14 @@ bool IsSse2Available() {
 
 }  // namespace
 
-Aec3Fft::Aec3Fft() : ooura_fft_(IsSse2Available()) {}
+Aec3Fft::Aec3Fft() : Aec3Fft(DetectOptimization()) {}
+
+// DetectOptimization() only reports kAvx512 when AVX2 is available as well.
+Aec3Fft::Aec3Fft(Aec3Optimization optimization)
+    : ooura_fft_(optimization != Aec3Optimization::kNone &&
+                 IsSse2Available()),
+      use_avx2_(optimization == Aec3Optimization::kAvx2 ||
+                optimization == Aec3Optimization::kAvx512) {}
 
 // TODO(peah): Change x to be std::array once the rest of the code allows this.
 void Aec3Fft::ZeroPaddedFft(ArrayView<const float> x,
@@ -89,6 +96,17 @@ void Aec3Fft::ZeroPaddedFft(ArrayView<const float> x,
                             FftData* X) const {
   RTC_DCHECK(X);
   RTC_DCHECK_EQ(kFftLengthBy2, x.size());
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_avx2_) {
+    RTC_DCHECK(window == Window::kRectangular || window == Window::kHanning);
+    aec3::PaddedFft_Avx2(x, ArrayView<const float>(),
+                         window == Window::kHanning
+                             ? ArrayView<const float>(kHanning64)
+                             : ArrayView<const float>(),
+                         X);
+    return;
+  }
+#endif
   std::array<float, kFftLength> fft;
   std::fill(fft.begin(), fft.begin() + kFftLengthBy2, 0.f);
   switch (window) {
@@ -117,6 +135,18 @@ void Aec3Fft::PaddedFft(ArrayView<const float> x,
   RTC_DCHECK(X);
   RTC_DCHECK_EQ(kFftLengthBy2, x.size());
   RTC_DCHECK_EQ(kFftLengthBy2, x_old.size());
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (use_avx2_) {
+    RTC_DCHECK(window == Window::kRectangular ||
+               window == Window::kSqrtHanning);
+    aec3::PaddedFft_Avx2(x, x_old,
+                         window == Window::kSqrtHanning
+                             ? ArrayView<const float>(kSqrtHanning128)
+                             : ArrayView<const float>(),
+                         X);
+    return;
+  }
+#endif
   std::array<float, kFftLength> fft;
 
   switch (window) {
@@ -18,8 +18,25 @@
 #include "audio_processing/aec3/aec3_common.h"
 #include "audio_processing/aec3/fft_data.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
 
 namespace webrtc {
+namespace aec3 {
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Computes the Fft of the concatenation of x_old and x, multiplied by window.
+// An empty x_old is treated as zeros, and does not take part in the windowing.
+// An empty window corresponds to a rectangular window.
+void PaddedFft_Avx2(ArrayView<const float> x,
+                    ArrayView<const float> x_old,
+                    ArrayView<const float> window,
+                    FftData* X);
+
+// Computes the inverse Fft, with the same scaling as the Ooura Fft.
+void Ifft_Avx2(const FftData& X, ArrayView<float> x);
+#endif
+
+}  // namespace aec3
 
 // Wrapper class that provides 128 point real valued FFT functionality with the
 // FftData type.
@@ -28,20 +45,36 @@ class Aec3Fft {
   enum class Window { kRectangular, kHanning, kSqrtHanning };
 
   Aec3Fft();
+  explicit Aec3Fft(Aec3Optimization optimization);
 
   Aec3Fft(const Aec3Fft&) = delete;
   Aec3Fft& operator=(const Aec3Fft&) = delete;
 
-  // Computes the FFT. Note that both the input and output are modified.
+  // Computes the FFT. Note that both the input and output may be modified.
   void Fft(std::array<float, kFftLength>* x, FftData* X) const {
     RTC_DCHECK(x);
     RTC_DCHECK(X);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (use_avx2_) {
+      aec3::PaddedFft_Avx2(ArrayView<const float>(&(*x)[kFftLengthBy2],
+                                                  kFftLengthBy2),
+                           ArrayView<const float>(x->data(), kFftLengthBy2),
+                           ArrayView<const float>(), X);
+      return;
+    }
+#endif
     ooura_fft_.Fft(x->data());
     X->CopyFromPackedArray(*x);
   }
   // Computes the inverse Fft.
   void Ifft(const FftData& X, std::array<float, kFftLength>* x) const {
     RTC_DCHECK(x);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    if (use_avx2_) {
+      aec3::Ifft_Avx2(X, *x);
+      return;
+    }
+#endif
     X.CopyToPackedArray(x);
     ooura_fft_.InverseFft(x->data());
   }
@@ -66,6 +99,7 @@ class Aec3Fft {
 
  private:
   const OouraFft ooura_fft_;
+  const bool use_avx2_;
 };
 
 }  // namespace webrtc
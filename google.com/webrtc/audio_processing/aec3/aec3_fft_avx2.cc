@@ -0,0 +1,358 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#if defined(__i386__) || defined(_M_IX86) || defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+
+#include "api/array_view.h"
+#include "audio_processing/aec3/aec3_fft.h"
+#include "rtc_base/checks.h"
+
+// The 128 point real valued FFT is computed as a 64 point complex valued FFT of
+// the signal with the even samples as real part and the odd samples as
+// imaginary part, followed by a post-processing step that separates the spectra
+// of the even and odd samples. The 64 point FFT is in turn decomposed into two
+// steps of eight 8 point DFTs, which allows all the data to be kept in split
+// (real and imaginary parts separately) format in sixteen 8 lane vectors.
+
+namespace webrtc {
+namespace aec3 {
+
+namespace {
+
+// Twiddle factors exp(-j*2*pi*k1*c/64), applied between the two 8 point DFT
+// steps of the 64 point FFT.
+alignas(32) constexpr float kDft64TwiddlesRe[8][8] = {
+    {1.0000000000f, 1.0000000000f, 1.0000000000f, 1.0000000000f,
+     1.0000000000f, 1.0000000000f, 1.0000000000f, 1.0000000000f},
+    {1.0000000000f, 0.9951847267f, 0.9807852804f, 0.9569403357f,
+     0.9238795325f, 0.8819212643f, 0.8314696123f, 0.7730104534f},
+    {1.0000000000f, 0.9807852804f, 0.9238795325f, 0.8314696123f,
+     0.7071067812f, 0.5555702330f, 0.3826834324f, 0.1950903220f},
+    {1.0000000000f, 0.9569403357f, 0.8314696123f, 0.6343932842f,
+     0.3826834324f, 0.0980171403f, -0.1950903220f, -0.4713967368f},
+    {1.0000000000f, 0.9238795325f, 0.7071067812f, 0.3826834324f,
+     0.0000000000f, -0.3826834324f, -0.7071067812f, -0.9238795325f},
+    {1.0000000000f, 0.8819212643f, 0.5555702330f, 0.0980171403f,
+     -0.3826834324f, -0.7730104534f, -0.9807852804f, -0.9569403357f},
+    {1.0000000000f, 0.8314696123f, 0.3826834324f, -0.1950903220f,
+     -0.7071067812f, -0.9807852804f, -0.9238795325f, -0.5555702330f},
+    {1.0000000000f, 0.7730104534f, 0.1950903220f, -0.4713967368f,
+     -0.9238795325f, -0.9569403357f, -0.5555702330f, 0.0980171403f},
+};
+
+alignas(32) constexpr float kDft64TwiddlesIm[8][8] = {
+    {0.0000000000f, 0.0000000000f, 0.0000000000f, 0.0000000000f,
+     0.0000000000f, 0.0000000000f, 0.0000000000f, 0.0000000000f},
+    {0.0000000000f, -0.0980171403f, -0.1950903220f, -0.2902846773f,
+     -0.3826834324f, -0.4713967368f, -0.5555702330f, -0.6343932842f},
+    {0.0000000000f, -0.1950903220f, -0.3826834324f, -0.5555702330f,
+     -0.7071067812f, -0.8314696123f, -0.9238795325f, -0.9807852804f},
+    {0.0000000000f, -0.2902846773f, -0.5555702330f, -0.7730104534f,
+     -0.9238795325f, -0.9951847267f, -0.9807852804f, -0.8819212643f},
+    {0.0000000000f, -0.3826834324f, -0.7071067812f, -0.9238795325f,
+     -1.0000000000f, -0.9238795325f, -0.7071067812f, -0.3826834324f},
+    {0.0000000000f, -0.4713967368f, -0.8314696123f, -0.9951847267f,
+     -0.9238795325f, -0.6343932842f, -0.1950903220f, 0.2902846773f},
+    {0.0000000000f, -0.5555702330f, -0.9238795325f, -0.9807852804f,
+     -0.7071067812f, -0.1950903220f, 0.3826834324f, 0.8314696123f},
+    {0.0000000000f, -0.6343932842f, -0.9807852804f, -0.8819212643f,
+     -0.3826834324f, 0.2902846773f, 0.8314696123f, 0.9951847267f},
+};
+
+// Twiddle factors exp(-j*2*pi*k/128) for the real valued FFT post-processing.
+alignas(32) constexpr float kRealFftTwiddlesRe[64] = {
+    1.0000000000f, 0.9987954562f, 0.9951847267f, 0.9891765100f, 0.9807852804f,
+    0.9700312532f, 0.9569403357f, 0.9415440652f, 0.9238795325f, 0.9039892931f,
+    0.8819212643f, 0.8577286100f, 0.8314696123f, 0.8032075315f, 0.7730104534f,
+    0.7409511254f, 0.7071067812f, 0.6715589548f, 0.6343932842f, 0.5956993045f,
+    0.5555702330f, 0.5141027442f, 0.4713967368f, 0.4275550934f, 0.3826834324f,
+    0.3368898534f, 0.2902846773f, 0.2429801799f, 0.1950903220f, 0.1467304745f,
+    0.0980171403f, 0.0490676743f, 0.0000000000f, -0.0490676743f, -0.0980171403f,
+    -0.1467304745f, -0.1950903220f, -0.2429801799f, -0.2902846773f,
+    -0.3368898534f, -0.3826834324f, -0.4275550934f, -0.4713967368f,
+    -0.5141027442f, -0.5555702330f, -0.5956993045f, -0.6343932842f,
+    -0.6715589548f, -0.7071067812f, -0.7409511254f, -0.7730104534f,
+    -0.8032075315f, -0.8314696123f, -0.8577286100f, -0.8819212643f,
+    -0.9039892931f, -0.9238795325f, -0.9415440652f, -0.9569403357f,
+    -0.9700312532f, -0.9807852804f, -0.9891765100f, -0.9951847267f,
+    -0.9987954562f,
+};
+
+alignas(32) constexpr float kRealFftTwiddlesIm[64] = {
+    0.0000000000f, -0.0490676743f, -0.0980171403f, -0.1467304745f,
+    -0.1950903220f, -0.2429801799f, -0.2902846773f, -0.3368898534f,
+    -0.3826834324f, -0.4275550934f, -0.4713967368f, -0.5141027442f,
+    -0.5555702330f, -0.5956993045f, -0.6343932842f, -0.6715589548f,
+    -0.7071067812f, -0.7409511254f, -0.7730104534f, -0.8032075315f,
+    -0.8314696123f, -0.8577286100f, -0.8819212643f, -0.9039892931f,
+    -0.9238795325f, -0.9415440652f, -0.9569403357f, -0.9700312532f,
+    -0.9807852804f, -0.9891765100f, -0.9951847267f, -0.9987954562f,
+    -1.0000000000f, -0.9987954562f, -0.9951847267f, -0.9891765100f,
+    -0.9807852804f, -0.9700312532f, -0.9569403357f, -0.9415440652f,
+    -0.9238795325f, -0.9039892931f, -0.8819212643f, -0.8577286100f,
+    -0.8314696123f, -0.8032075315f, -0.7730104534f, -0.7409511254f,
+    -0.7071067812f, -0.6715589548f, -0.6343932842f, -0.5956993045f,
+    -0.5555702330f, -0.5141027442f, -0.4713967368f, -0.4275550934f,
+    -0.3826834324f, -0.3368898534f, -0.2902846773f, -0.2429801799f,
+    -0.1950903220f, -0.1467304745f, -0.0980171403f, -0.0490676743f,
+};
+
+constexpr float kSqrtHalf = 0.70710678118654752f;
+
+// Computes the 8 point DFT over the eight vectors of a complex valued signal in
+// split format, independently for each lane.
+__attribute__((target("avx2,fma")))
+inline void Dft8(__m256* re, __m256* im) {
+  const __m256 sqrt_half = _mm256_set1_ps(kSqrtHalf);
+
+  // Butterflies between the first and second half of the inputs.
+  const __m256 a0_re = _mm256_add_ps(re[0], re[4]);
+  const __m256 a0_im = _mm256_add_ps(im[0], im[4]);
+  const __m256 a1_re = _mm256_add_ps(re[1], re[5]);
+  const __m256 a1_im = _mm256_add_ps(im[1], im[5]);
+  const __m256 a2_re = _mm256_add_ps(re[2], re[6]);
+  const __m256 a2_im = _mm256_add_ps(im[2], im[6]);
+  const __m256 a3_re = _mm256_add_ps(re[3], re[7]);
+  const __m256 a3_im = _mm256_add_ps(im[3], im[7]);
+  const __m256 b0_re = _mm256_sub_ps(re[0], re[4]);
+  const __m256 b0_im = _mm256_sub_ps(im[0], im[4]);
+  const __m256 b1_re = _mm256_sub_ps(re[1], re[5]);
+  const __m256 b1_im = _mm256_sub_ps(im[1], im[5]);
+  const __m256 b2_re = _mm256_sub_ps(re[2], re[6]);
+  const __m256 b2_im = _mm256_sub_ps(im[2], im[6]);
+  const __m256 b3_re = _mm256_sub_ps(re[3], re[7]);
+  const __m256 b3_im = _mm256_sub_ps(im[3], im[7]);
+
+  // 4 point DFT of the sums, producing the even outputs.
+  const __m256 c0_re = _mm256_add_ps(a0_re, a2_re);
+  const __m256 c0_im = _mm256_add_ps(a0_im, a2_im);
+  const __m256 c1_re = _mm256_add_ps(a1_re, a3_re);
+  const __m256 c1_im = _mm256_add_ps(a1_im, a3_im);
+  const __m256 c2_re = _mm256_sub_ps(a0_re, a2_re);
+  const __m256 c2_im = _mm256_sub_ps(a0_im, a2_im);
+  const __m256 c3_re = _mm256_sub_ps(a1_re, a3_re);
+  const __m256 c3_im = _mm256_sub_ps(a1_im, a3_im);
+  re[0] = _mm256_add_ps(c0_re, c1_re);
+  im[0] = _mm256_add_ps(c0_im, c1_im);
+  re[4] = _mm256_sub_ps(c0_re, c1_re);
+  im[4] = _mm256_sub_ps(c0_im, c1_im);
+  re[2] = _mm256_add_ps(c2_re, c3_im);
+  im[2] = _mm256_sub_ps(c2_im, c3_re);
+  re[6] = _mm256_sub_ps(c2_re, c3_im);
+  im[6] = _mm256_add_ps(c2_im, c3_re);
+
+  // Multiply the differences by exp(-j*2*pi*n/8) and compute their 4 point DFT,
+  // producing the odd outputs. The multiplication of the third difference by
+  // -j is folded into the butterflies.
+  const __m256 d1_re = _mm256_mul_ps(_mm256_add_ps(b1_re, b1_im), sqrt_half);
+  const __m256 d1_im = _mm256_mul_ps(_mm256_sub_ps(b1_im, b1_re), sqrt_half);
+  const __m256 d3_re = _mm256_mul_ps(_mm256_sub_ps(b3_im, b3_re), sqrt_half);
+  const __m256 d3_im_neg =
+      _mm256_mul_ps(_mm256_add_ps(b3_re, b3_im), sqrt_half);
+  const __m256 e0_re = _mm256_add_ps(b0_re, b2_im);
+  const __m256 e0_im = _mm256_sub_ps(b0_im, b2_re);
+  const __m256 e2_re = _mm256_sub_ps(b0_re, b2_im);
+  const __m256 e2_im = _mm256_add_ps(b0_im, b2_re);
+  const __m256 e1_re = _mm256_add_ps(d1_re, d3_re);
+  const __m256 e1_im = _mm256_sub_ps(d1_im, d3_im_neg);
+  const __m256 e3_re = _mm256_sub_ps(d1_re, d3_re);
+  const __m256 e3_im = _mm256_add_ps(d1_im, d3_im_neg);
+  re[1] = _mm256_add_ps(e0_re, e1_re);
+  im[1] = _mm256_add_ps(e0_im, e1_im);
+  re[5] = _mm256_sub_ps(e0_re, e1_re);
+  im[5] = _mm256_sub_ps(e0_im, e1_im);
+  re[3] = _mm256_add_ps(e2_re, e3_im);
+  im[3] = _mm256_sub_ps(e2_im, e3_re);
+  re[7] = _mm256_sub_ps(e2_re, e3_im);
+  im[7] = _mm256_add_ps(e2_im, e3_re);
+}
+
+// Transposes the 8x8 matrix formed by the eight vectors.
+__attribute__((target("avx2,fma")))
+inline void Transpose8x8(__m256* v) {
+  const __m256 t0 = _mm256_unpacklo_ps(v[0], v[1]);
+  const __m256 t1 = _mm256_unpackhi_ps(v[0], v[1]);
+  const __m256 t2 = _mm256_unpacklo_ps(v[2], v[3]);
+  const __m256 t3 = _mm256_unpackhi_ps(v[2], v[3]);
+  const __m256 t4 = _mm256_unpacklo_ps(v[4], v[5]);
+  const __m256 t5 = _mm256_unpackhi_ps(v[4], v[5]);
+  const __m256 t6 = _mm256_unpacklo_ps(v[6], v[7]);
+  const __m256 t7 = _mm256_unpackhi_ps(v[6], v[7]);
+  const __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+  v[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+  v[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+  v[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+  v[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+  v[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+  v[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+  v[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+  v[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+
+// Computes the 64 point DFT of the signal z[8 * r + c], stored in lane c of
+// vector r, in place. The output Z[8 * r + c] is stored in the same manner.
+__attribute__((target("avx2,fma")))
+inline void Dft64(__m256* re, __m256* im) {
+  // Compute the DFTs over the rows, yielding the vectors of the frequency
+  // index k1 with the column c in the lanes.
+  Dft8(re, im);
+  for (int k1 = 1; k1 < 8; ++k1) {
+    const __m256 w_re = _mm256_load_ps(kDft64TwiddlesRe[k1]);
+    const __m256 w_im = _mm256_load_ps(kDft64TwiddlesIm[k1]);
+    const __m256 x_re = re[k1];
+    re[k1] = _mm256_fmsub_ps(x_re, w_re, _mm256_mul_ps(im[k1], w_im));
+    im[k1] = _mm256_fmadd_ps(x_re, w_im, _mm256_mul_ps(im[k1], w_re));
+  }
+
+  // Compute the DFTs over the columns, yielding Z[k1 + 8 * k2] in lane k1 of
+  // vector k2.
+  Transpose8x8(re);
+  Transpose8x8(im);
+  Dft8(re, im);
+}
+
+// Reverses the order of the eight values starting at `v`.
+__attribute__((target("avx2,fma")))
+inline __m256 LoadReversed(const float* v) {
+  return _mm256_permutevar8x32_ps(_mm256_loadu_ps(v),
+                                  _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+}  // namespace
+
+// Computes the windowed Fft of the concatenation of x_old and x (AVX2 variant).
+__attribute__((target("avx2,fma")))
+void PaddedFft_Avx2(ArrayView<const float> x,
+                    ArrayView<const float> x_old,
+                    ArrayView<const float> window,
+                    FftData* X) {
+  RTC_DCHECK_EQ(kFftLengthBy2, x.size());
+  RTC_DCHECK(x_old.empty() || x_old.size() == kFftLengthBy2);
+  RTC_DCHECK(window.empty() || window.size() == x_old.size() + x.size());
+
+  // Form the complex valued signal of the even and odd samples.
+  __m256 z_re[8];
+  __m256 z_im[8];
+  for (int r = 0; r < 8; ++r) {
+    if (r < 4 && x_old.empty()) {
+      z_re[r] = z_im[r] = _mm256_setzero_ps();
+      continue;
+    }
+    const int n = r < 4 ? 16 * r : 16 * (r - 4);
+    const float* x_r = r < 4 ? &x_old[n] : &x[n];
+    __m256 lo = _mm256_loadu_ps(x_r);
+    __m256 hi = _mm256_loadu_ps(x_r + 8);
+    if (!window.empty()) {
+      const float* window_r = &window[r < 4 ? n : x_old.size() + n];
+      lo = _mm256_mul_ps(lo, _mm256_loadu_ps(window_r));
+      hi = _mm256_mul_ps(hi, _mm256_loadu_ps(window_r + 8));
+    }
+    const __m256 even = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 odd = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+    z_re[r] = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even),
+                                                     _MM_SHUFFLE(3, 1, 2, 0)));
+    z_im[r] = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odd),
+                                                     _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+
+  Dft64(z_re, z_im);
+
+  // Store the spectrum, with Z[64] = Z[0], to allow reading Z[64 - k].
+  alignas(32) float Z_re[kFftLengthBy2 + 8];
+  alignas(32) float Z_im[kFftLengthBy2 + 8];
+  for (int j = 0; j < 8; ++j) {
+    _mm256_store_ps(&Z_re[8 * j], z_re[j]);
+    _mm256_store_ps(&Z_im[8 * j], z_im[j]);
+  }
+  Z_re[kFftLengthBy2] = Z_re[0];
+  Z_im[kFftLengthBy2] = Z_im[0];
+
+  // Separate the spectra of the even and odd samples, E and O, using Z[k] and
+  // conj(Z[64 - k]), and combine them into the spectrum of the full signal as
+  // X[k] = E[k] + exp(-j*2*pi*k/128) * O[k]. The imaginary part is stored with
+  // the opposite sign to match the convention of the FftData type.
+  const __m256 half = _mm256_set1_ps(0.5f);
+  for (int j = 0; j < 8; ++j) {
+    const __m256 a_re = z_re[j];
+    const __m256 a_im = z_im[j];
+    const __m256 b_re = LoadReversed(&Z_re[kFftLengthBy2 - 7 - 8 * j]);
+    const __m256 b_im = LoadReversed(&Z_im[kFftLengthBy2 - 7 - 8 * j]);
+    const __m256 e_re = _mm256_mul_ps(_mm256_add_ps(a_re, b_re), half);
+    const __m256 e_im_neg = _mm256_mul_ps(_mm256_sub_ps(b_im, a_im), half);
+    const __m256 o_re = _mm256_mul_ps(_mm256_add_ps(a_im, b_im), half);
+    const __m256 o_im_neg = _mm256_mul_ps(_mm256_sub_ps(a_re, b_re), half);
+    const __m256 w_re = _mm256_load_ps(&kRealFftTwiddlesRe[8 * j]);
+    const __m256 w_im = _mm256_load_ps(&kRealFftTwiddlesIm[8 * j]);
+    __m256 X_re = _mm256_fmadd_ps(w_re, o_re, e_re);
+    X_re = _mm256_fmadd_ps(w_im, o_im_neg, X_re);
+    __m256 X_im = _mm256_fmadd_ps(w_re, o_im_neg, e_im_neg);
+    X_im = _mm256_fnmadd_ps(w_im, o_re, X_im);
+    _mm256_storeu_ps(&X->re[8 * j], X_re);
+    _mm256_storeu_ps(&X->im[8 * j], X_im);
+  }
+  X->re[kFftLengthBy2] = Z_re[0] - Z_im[0];
+  X->im[0] = X->im[kFftLengthBy2] = 0.f;
+}
+
+// Computes the inverse Fft (AVX2 variant).
+__attribute__((target("avx2,fma")))
+void Ifft_Avx2(const FftData& X, ArrayView<float> x) {
+  RTC_DCHECK_EQ(kFftLength, x.size());
+
+  // Form the spectrum of the complex valued signal with the even output
+  // samples as real part and the odd output samples as imaginary part, from
+  // X[k] and conj(X[64 - k]). The imaginary parts of the DC and Nyquist bins
+  // are ignored, and the scaling matches that of the Ooura FFT.
+  const __m256 half = _mm256_set1_ps(0.5f);
+  __m256 z_re[8];
+  __m256 z_im[8];
+  for (int j = 0; j < 8; ++j) {
+    const __m256 a_re = _mm256_loadu_ps(&X.re[8 * j]);
+    __m256 a_im = _mm256_loadu_ps(&X.im[8 * j]);
+    const __m256 b_re = LoadReversed(&X.re[kFftLengthBy2 - 7 - 8 * j]);
+    __m256 b_im = LoadReversed(&X.im[kFftLengthBy2 - 7 - 8 * j]);
+    if (j == 0) {
+      a_im = _mm256_blend_ps(a_im, _mm256_setzero_ps(), 1);
+      b_im = _mm256_blend_ps(b_im, _mm256_setzero_ps(), 1);
+    }
+    const __m256 p_re = _mm256_add_ps(a_re, b_re);
+    const __m256 p_im = _mm256_sub_ps(a_im, b_im);
+    const __m256 d_re = _mm256_sub_ps(a_re, b_re);
+    const __m256 d_im = _mm256_add_ps(a_im, b_im);
+    const __m256 w_re = _mm256_load_ps(&kRealFftTwiddlesRe[8 * j]);
+    const __m256 w_im = _mm256_load_ps(&kRealFftTwiddlesIm[8 * j]);
+    const __m256 q_re = _mm256_fmsub_ps(d_re, w_re, _mm256_mul_ps(d_im, w_im));
+    const __m256 q_im = _mm256_fmadd_ps(d_re, w_im, _mm256_mul_ps(d_im, w_re));
+    z_re[j] = _mm256_mul_ps(_mm256_sub_ps(p_re, q_im), half);
+    z_im[j] = _mm256_mul_ps(_mm256_add_ps(p_im, q_re), half);
+  }
+
+  Dft64(z_re, z_im);
+
+  // Interleave the even and odd output samples.
+  for (int j = 0; j < 8; ++j) {
+    const __m256 lo = _mm256_unpacklo_ps(z_re[j], z_im[j]);
+    const __m256 hi = _mm256_unpackhi_ps(z_re[j], z_im[j]);
+    _mm256_storeu_ps(&x[16 * j], _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(&x[16 * j + 8], _mm256_permute2f128_ps(lo, hi, 0x31));
+  }
+}
+
+}  // namespace aec3
+}  // namespace webrtc
+#endif
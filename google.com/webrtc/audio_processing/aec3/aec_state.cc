@@ -330,6 +330,26 @@ void AecState::Update(
                         subtractor_output[0].e2_refined);
 }
 
+void AecState::SaveState(StateWriter* writer) const {
+  initial_state_.SaveState(writer);
+  filter_quality_state_.SaveState(writer);
+  writer->WriteUint32(strong_not_saturated_render_blocks_);
+  writer->WriteUint32(blocks_with_active_render_);
+  erl_estimator_.SaveState(writer);
+  erle_estimator_.SaveState(writer);
+  filter_analyzer_.SaveState(writer);
+}
+
+void AecState::LoadState(StateReader* reader) {
+  initial_state_.LoadState(reader);
+  filter_quality_state_.LoadState(reader);
+  strong_not_saturated_render_blocks_ = reader->ReadUint32();
+  blocks_with_active_render_ = reader->ReadUint32();
+  erl_estimator_.LoadState(reader);
+  erle_estimator_.LoadState(reader);
+  filter_analyzer_.LoadState(reader);
+}
+
 AecState::InitialState::InitialState(const EchoCanceller3Config& config)
     : conservative_initial_phase_(config.filter.conservative_initial_phase),
       initial_state_seconds_(config.filter.initial_state_seconds) {
@@ -358,6 +378,17 @@ void AecState::InitialState::InitialState::Update(bool active_render,
   transition_triggered_ = !initial_state_ && prev_initial_state;
 }
 
+void AecState::InitialState::SaveState(StateWriter* writer) const {
+  writer->WriteBool(initial_state_);
+  writer->WriteUint32(strong_not_saturated_render_blocks_);
+}
+
+void AecState::InitialState::LoadState(StateReader* reader) {
+  initial_state_ = reader->ReadBool();
+  strong_not_saturated_render_blocks_ = reader->ReadUint32();
+  transition_triggered_ = false;
+}
+
 AecState::FilterDelay::FilterDelay(const EchoCanceller3Config& config,
                                    size_t num_capture_channels)
     : delay_headroom_blocks_(config.delay.delay_headroom_samples / kBlockSize),
@@ -408,6 +439,18 @@ void AecState::FilteringQualityAnalyzer::Reset() {
   filter_update_blocks_since_reset_ = 0;
 }
 
+void AecState::FilteringQualityAnalyzer::SaveState(StateWriter* writer) const {
+  writer->WriteUint32(filter_update_blocks_since_reset_);
+  writer->WriteUint32(filter_update_blocks_since_start_);
+  writer->WriteBool(convergence_seen_);
+}
+
+void AecState::FilteringQualityAnalyzer::LoadState(StateReader* reader) {
+  filter_update_blocks_since_reset_ = reader->ReadUint32();
+  filter_update_blocks_since_start_ = reader->ReadUint32();
+  convergence_seen_ = reader->ReadBool();
+}
+
 void AecState::FilteringQualityAnalyzer::Update(
     bool active_render,
     bool transparent_mode,
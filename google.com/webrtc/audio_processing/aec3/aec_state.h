@@ -34,6 +34,7 @@
 #include "audio_processing/aec3/subtractor_output.h"
 #include "audio_processing/aec3/subtractor_output_analyzer.h"
 #include "audio_processing/aec3/transparent_mode.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 
@@ -137,6 +138,16 @@ class AecState {
     return initial_state_.TransitionTriggered();
   }
 
+  // Returns whether the initial state is active.
+  bool InitialStateActive() const {
+    return initial_state_.InitialStateActive();
+  }
+
+  // Saves and restores the convergence counters, the ERL and ERLE estimates
+  // and the filter analysis.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
   // Updates the aec state.
   // TODO(bugs.webrtc.org/10913): Compute multi-channel ERL.
   void Update(
@@ -155,6 +166,12 @@ class AecState {
     return filter_analyzer_.FilterLengthBlocks();
   }
 
+  // Returns the number of filter blocks that hold the significant part of the
+  // echo path, if it has been measured.
+  std::optional<int> EchoPathLengthBlocks() const {
+    return filter_analyzer_.EchoPathLengthBlocks();
+  }
+
  private:
   static std::atomic<int> instance_count_;
   std::unique_ptr<ApmDataDumper> data_dumper_;
@@ -181,6 +198,9 @@ class AecState {
     // Returns that the transition from the initial state has was started.
     bool TransitionTriggered() const { return transition_triggered_; }
 
+    void SaveState(StateWriter* writer) const;
+    void LoadState(StateReader* reader);
+
    private:
     const bool conservative_initial_phase_;
     const float initial_state_seconds_;
@@ -249,6 +269,9 @@ class AecState {
     // Resets the state of the analyzer.
     void Reset();
 
+    void SaveState(StateWriter* writer) const;
+    void LoadState(StateReader* reader);
+
     // Updates the analysis based on new data.
     void Update(bool active_render,
                 bool transparent_mode,
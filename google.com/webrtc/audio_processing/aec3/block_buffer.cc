@@ -16,7 +16,11 @@ namespace webrtc {
 
 BlockBuffer::BlockBuffer(size_t size, size_t num_bands, size_t num_channels)
     : size(static_cast<int>(size)),
-      buffer(size, Block(num_bands, num_channels)) {}
+      buffer(owned_buffer_),
+      owned_buffer_(size, Block(num_bands, num_channels)) {}
+
+BlockBuffer::BlockBuffer(std::vector<Block>* shared_buffer)
+    : size(static_cast<int>(shared_buffer->size())), buffer(*shared_buffer) {}
 
 BlockBuffer::~BlockBuffer() = default;
 
@@ -24,6 +24,11 @@ namespace webrtc {
 // together with the read and write indices.
 struct BlockBuffer {
   BlockBuffer(size_t size, size_t num_bands, size_t num_channels);
+  // Creates a buffer with its own read and write indices over blocks owned
+  // elsewhere, which must outlive it.
+  explicit BlockBuffer(std::vector<Block>* shared_buffer);
+  BlockBuffer(const BlockBuffer&) = delete;
+  BlockBuffer& operator=(const BlockBuffer&) = delete;
   ~BlockBuffer();
 
   int IncIndex(int index) const {
@@ -50,9 +55,12 @@ struct BlockBuffer {
   void DecReadIndex() { read = DecIndex(read); }
 
   const int size;
-  std::vector<Block> buffer;
+  std::vector<Block>& buffer;
   int write = 0;
   int read = 0;
+
+ private:
+  std::vector<Block> owned_buffer_;
 };
 
 }  // namespace webrtc
@@ -26,6 +26,7 @@
 #include "audio_processing/aec3/echo_remover.h"
 #include "audio_processing/aec3/render_delay_buffer.h"
 #include "audio_processing/aec3/render_delay_controller.h"
+#include "audio_processing/aec3/render_drift_compensator.h"
 #include "audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -63,7 +64,16 @@ class BlockProcessorImpl final : public BlockProcessor {
   void SetAudioBufferDelay(int delay_ms) override;
   void SetCaptureOutputUsage(bool capture_output_used) override;
 
+  void SaveState(StateWriter* writer) const override;
+  void LoadState(StateReader* reader) override;
+
  private:
+  // Aligns the render buffer to the delay restored by LoadState().
+  void ApplyRestoredDelay();
+
+  // Inserts a render block, after any drift compensation, into the buffer.
+  void InsertRender(const Block& block);
+
   static std::atomic<int> instance_count_;
   std::unique_ptr<ApmDataDumper> data_dumper_;
   const EchoCanceller3Config config_;
@@ -73,10 +83,13 @@ class BlockProcessorImpl final : public BlockProcessor {
   std::unique_ptr<RenderDelayBuffer> render_buffer_;
   std::unique_ptr<RenderDelayController> delay_controller_;
   std::unique_ptr<EchoRemover> echo_remover_;
+  std::unique_ptr<RenderDriftCompensator> drift_compensator_;
   BlockProcessorMetrics metrics_;
   RenderDelayBuffer::BufferingEvent render_event_;
   size_t capture_call_counter_ = 0;
   std::optional<DelayEstimate> estimated_delay_;
+  bool restored_delay_pending_ = false;
+  size_t restored_delay_hold_blocks_ = 0;
 };
 
 std::atomic<int> BlockProcessorImpl::instance_count_(0);
@@ -84,7 +97,7 @@ std::atomic<int> BlockProcessorImpl::instance_count_(0);
 BlockProcessorImpl::BlockProcessorImpl(
     const EchoCanceller3Config& config,
     int sample_rate_hz,
-    size_t /* num_render_channels */,
+    size_t num_render_channels,
     size_t /* num_capture_channels */,
     std::unique_ptr<RenderDelayBuffer> render_buffer,
     std::unique_ptr<RenderDelayController> delay_controller,
@@ -97,6 +110,11 @@ BlockProcessorImpl::BlockProcessorImpl(
       echo_remover_(std::move(echo_remover)),
       render_event_(RenderDelayBuffer::BufferingEvent::kNone) {
   RTC_DCHECK(ValidFullBandRate(sample_rate_hz_));
+  // The drift is measured by the delay estimator.
+  if (config_.delay.compensate_clock_drift && delay_controller_) {
+    drift_compensator_ = std::make_unique<RenderDriftCompensator>(
+        NumBandsForRate(sample_rate_hz_), num_render_channels);
+  }
 }
 
 BlockProcessorImpl::~BlockProcessorImpl() = default;
@@ -120,8 +138,11 @@ void BlockProcessorImpl::ProcessCapture(bool echo_path_gain_change,
     if (!capture_properly_started_) {
       capture_properly_started_ = true;
       render_buffer_->Reset();
-      if (delay_controller_)
+      if (restored_delay_pending_) {
+        ApplyRestoredDelay();
+      } else if (delay_controller_) {
         delay_controller_->Reset(true);
+      }
     }
   } else {
     // If no render data has yet arrived, do not process the capture signal.
@@ -149,10 +170,19 @@ void BlockProcessorImpl::ProcessCapture(bool echo_path_gain_change,
   // capture block.
   RenderDelayBuffer::BufferingEvent buffer_event =
       render_buffer_->PrepareCaptureProcessing();
-  // Reset the delay controller at render buffer underrun.
+  // Reset the delay controller at render buffer underrun. Underruns are
+  // expected while the buffers settle after capture starts, so a restored delay
+  // is re-applied instead of being discarded during that period.
   if (buffer_event == RenderDelayBuffer::BufferingEvent::kRenderUnderrun) {
-    if (delay_controller_)
+    if (restored_delay_hold_blocks_ > 0 && estimated_delay_ &&
+        delay_controller_) {
+      render_buffer_->AlignFromDelay(estimated_delay_->delay);
+    } else if (delay_controller_) {
       delay_controller_->Reset(false);
+    }
+  }
+  if (restored_delay_hold_blocks_ > 0) {
+    --restored_delay_hold_blocks_;
   }
 
   data_dumper_->DumpWav("aec3_processblock_capture_input2",
@@ -183,6 +213,15 @@ void BlockProcessorImpl::ProcessCapture(bool echo_path_gain_change,
 
     echo_path_variability.clock_drift = delay_controller_->HasClockdrift();
 
+    if (drift_compensator_) {
+      std::optional<float> drift = delay_controller_->TakeClockdriftRate();
+      if (drift && drift_compensator_->AddDrift(*drift)) {
+        RTC_LOG(LS_INFO) << "Render clock drift compensation set to "
+                         << drift_compensator_->drift() << " at block "
+                         << capture_call_counter_;
+      }
+    }
+
   } else {
     render_buffer_->AlignFromExternalDelay();
   }
@@ -193,6 +232,7 @@ void BlockProcessorImpl::ProcessCapture(bool echo_path_gain_change,
         echo_path_variability, capture_signal_saturation, estimated_delay_,
         render_buffer_->GetRenderBuffer(), linear_output, capture_block);
   }
+  render_buffer_->FinishCaptureProcessing();
 
   // Update the metrics.
   metrics_.UpdateCapture(false);
@@ -205,6 +245,15 @@ void BlockProcessorImpl::BufferRender(const Block& block) {
   data_dumper_->DumpWav("aec3_processblock_render_input",
                         block.View(/*band=*/0, /*channel=*/0), 16000, 1);
 
+  if (drift_compensator_) {
+    drift_compensator_->Process(
+        block, [this](const Block& compensated) { InsertRender(compensated); });
+  } else {
+    InsertRender(block);
+  }
+}
+
+void BlockProcessorImpl::InsertRender(const Block& block) {
   render_event_ = render_buffer_->Insert(block);
 
   metrics_.UpdateRender(render_event_ !=
@@ -234,6 +283,50 @@ void BlockProcessorImpl::SetCaptureOutputUsage(bool capture_output_used) {
   echo_remover_->SetCaptureOutputUsage(capture_output_used);
 }
 
+void BlockProcessorImpl::SaveState(StateWriter* writer) const {
+  writer->WriteBool(delay_controller_ != nullptr);
+  if (delay_controller_) {
+    delay_controller_->SaveState(writer);
+  }
+  writer->WriteBool(estimated_delay_.has_value());
+  writer->WriteUint32(estimated_delay_ ? estimated_delay_->delay : 0);
+  echo_remover_->SaveState(writer);
+}
+
+void BlockProcessorImpl::LoadState(StateReader* reader) {
+  const bool has_delay_controller = reader->ReadBool();
+  if (has_delay_controller != (delay_controller_ != nullptr)) {
+    reader->Invalidate();
+    return;
+  }
+  if (delay_controller_) {
+    delay_controller_->LoadState(reader);
+  }
+  const bool has_delay = reader->ReadBool();
+  const size_t delay_blocks = reader->ReadUint32();
+  estimated_delay_ = std::nullopt;
+  if (has_delay) {
+    estimated_delay_ =
+        DelayEstimate(DelayEstimate::Quality::kRefined, delay_blocks);
+  }
+  echo_remover_->LoadState(reader);
+
+  // Before capture has properly started the render buffer is reset once
+  // render data arrives, so the delay is applied then instead.
+  restored_delay_pending_ = true;
+  if (capture_properly_started_) {
+    ApplyRestoredDelay();
+  }
+}
+
+void BlockProcessorImpl::ApplyRestoredDelay() {
+  restored_delay_pending_ = false;
+  if (estimated_delay_ && delay_controller_) {
+    render_buffer_->AlignFromDelay(estimated_delay_->delay);
+    restored_delay_hold_blocks_ = kNumBlocksPerSecond;
+  }
+}
+
 }  // namespace
 
 std::unique_ptr<BlockProcessor> BlockProcessor::Create(
@@ -23,6 +23,7 @@
 #include "audio_processing/aec3/echo_remover.h"
 #include "audio_processing/aec3/render_delay_buffer.h"
 #include "audio_processing/aec3/render_delay_controller.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 
@@ -35,7 +36,7 @@ class BlockProcessor {
       int sample_rate_hz,
       size_t num_render_channels,
       size_t num_capture_channels);
-  // Only used for testing purposes.
+  // As above, but with a given render buffer.
   static std::unique_ptr<BlockProcessor> Create(
       const Environment& env,
       const EchoCanceller3Config& config,
@@ -78,6 +79,12 @@ class BlockProcessor {
   // resulting output is anyway not used, for instance when the endpoint is
   // muted.
   virtual void SetCaptureOutputUsage(bool capture_output_used) = 0;
+
+  // Saves and restores the adaptive state: the render delay and the echo
+  // remover state. A restored delay is applied without signaling an echo path
+  // change, so that the restored filters are kept.
+  virtual void SaveState(StateWriter* writer) const = 0;
+  virtual void LoadState(StateReader* reader) = 0;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio_processing/aec3/channel_worker_pool.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+ChannelWorkerPool::ChannelWorkerPool(int num_threads) {
+  RTC_DCHECK_GE(num_threads, 0);
+  workers_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+    Worker* worker = workers_.back().get();
+    // A late worker stalls the capture thread, so they share its urgency.
+    worker->thread = PlatformThread::SpawnJoinable(
+        [this, worker] { WorkerLoop(worker); }, "aec3_channel_worker",
+        ThreadAttributes().SetPriority(ThreadPriority::kHigh));
+  }
+}
+
+ChannelWorkerPool::~ChannelWorkerPool() {
+  quit_.store(true, std::memory_order_relaxed);
+  for (auto& worker : workers_) {
+    worker->wake.Set();
+    worker->thread.Finalize();
+  }
+}
+
+void ChannelWorkerPool::Run(size_t num_channels,
+                            FunctionView<void(size_t)> task) {
+  const int num_woken = static_cast<int>(
+      std::min(workers_.size(), num_channels > 0 ? num_channels - 1 : 0));
+  if (num_woken == 0) {
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      task(ch);
+    }
+    return;
+  }
+
+  // The events order these writes before the reads of the woken workers.
+  task_ = task;
+  num_channels_ = num_channels;
+  next_channel_.store(0, std::memory_order_relaxed);
+  busy_workers_.store(num_woken, std::memory_order_relaxed);
+  for (int i = 0; i < num_woken; ++i) {
+    workers_[i]->wake.Set();
+  }
+
+  RunTasks();
+
+  // The workers may still be looking for channels after the last one is
+  // done, so the task must stay valid until they have all finished.
+  done_.Wait(Event::kForever, Event::kForever);
+  task_ = FunctionView<void(size_t)>();
+}
+
+void ChannelWorkerPool::WorkerLoop(Worker* worker) {
+  while (true) {
+    worker->wake.Wait(Event::kForever, Event::kForever);
+    if (quit_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    RunTasks();
+    if (busy_workers_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      done_.Set();
+    }
+  }
+}
+
+void ChannelWorkerPool::RunTasks() {
+  for (size_t ch = next_channel_.fetch_add(1, std::memory_order_relaxed);
+       ch < num_channels_;
+       ch = next_channel_.fetch_add(1, std::memory_order_relaxed)) {
+    task_(ch);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_CHANNEL_WORKER_POOL_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_CHANNEL_WORKER_POOL_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "api/function_view.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+
+namespace webrtc {
+
+// Persistent threads that run the per capture channel work of one echo
+// canceller in parallel with the capture thread. Each channel is processed by
+// exactly one thread, so work that only touches the state of its own channel
+// gives the same result as when the channels are processed in order.
+class ChannelWorkerPool {
+ public:
+  // Starts `num_threads` threads besides the capture thread.
+  explicit ChannelWorkerPool(int num_threads);
+  ~ChannelWorkerPool();
+
+  ChannelWorkerPool(const ChannelWorkerPool&) = delete;
+  ChannelWorkerPool& operator=(const ChannelWorkerPool&) = delete;
+
+  // Calls `task(ch)` once for each channel `ch` below `num_channels`, on the
+  // calling thread and the pool threads, and returns when all calls have
+  // returned. Not reentrant.
+  void Run(size_t num_channels, FunctionView<void(size_t)> task);
+
+ private:
+  struct Worker {
+    Event wake;
+    PlatformThread thread;
+  };
+
+  void WorkerLoop(Worker* worker);
+  void RunTasks();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  Event done_;
+  std::atomic<bool> quit_{false};
+  // The work of the ongoing Run(), set before the workers are woken.
+  FunctionView<void(size_t)> task_;
+  size_t num_channels_ = 0;
+  std::atomic<size_t> next_channel_{0};
+  std::atomic<int> busy_workers_{0};
+};
+
+// Calls `task(ch)` for each channel, on `pool` when it is non-null and else
+// in channel order on the calling thread.
+inline void ForEachChannel(ChannelWorkerPool* pool,
+                           size_t num_channels,
+                           FunctionView<void(size_t)> task) {
+  if (pool) {
+    pool->Run(num_channels, task);
+    return;
+  }
+  for (size_t ch = 0; ch < num_channels; ++ch) {
+    task(ch);
+  }
+}
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_CHANNEL_WORKER_POOL_H_
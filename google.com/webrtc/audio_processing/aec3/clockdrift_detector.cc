@@ -14,6 +14,7 @@ namespace webrtc {
 ClockdriftDetector::ClockdriftDetector()
     : level_(Level::kNone), stability_counter_(0) {
   delay_history_.fill(0);
+  change_blocks_.fill(0);
 }
 
 ClockdriftDetector::~ClockdriftDetector() = default;
@@ -53,9 +54,29 @@ void ClockdriftDetector::Update(int delay_estimate) {
     level_ = Level::kProbable;
   }
 
+  // The verified patterns span three steps of the delay, taken since the first
+  // estimate of the oldest delay in the history.
+  if ((drift_up || drift_down) && change_blocks_[2] >= rate_start_block_ &&
+      block_counter_ > change_blocks_[2]) {
+    drift_rate_ =
+        (drift_up ? 3.f : -3.f) / (block_counter_ - change_blocks_[2]);
+  }
+
   // Shift delay history one step.
   delay_history_[2] = delay_history_[1];
   delay_history_[1] = delay_history_[0];
   delay_history_[0] = delay_estimate;
+  change_blocks_[2] = change_blocks_[1];
+  change_blocks_[1] = change_blocks_[0];
+  change_blocks_[0] = block_counter_;
+}
+
+std::optional<float> ClockdriftDetector::TakeDriftRate() {
+  std::optional<float> drift_rate = drift_rate_;
+  drift_rate_ = std::nullopt;
+  if (drift_rate) {
+    rate_start_block_ = block_counter_;
+  }
+  return drift_rate;
 }
 }  // namespace webrtc
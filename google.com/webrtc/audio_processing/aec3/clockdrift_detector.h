@@ -14,6 +14,7 @@
 #include <stddef.h>
 
 #include <array>
+#include <optional>
 
 namespace webrtc {
 
@@ -30,10 +31,26 @@ class ClockdriftDetector {
   void Update(int delay_estimate);
   Level ClockdriftLevel() const { return level_; }
 
+  // Advances the time base of the drift rate estimate. Called once per capture
+  // block, also for the blocks that give no delay estimate to Update().
+  void IncreaseBlockCounter() { ++block_counter_; }
+
+  // Returns the rate at which the delay estimate has drifted, in delay
+  // estimate units per block and positive when the delay grows, if a drift has
+  // been verified since the last call. The steps seen before the call are not
+  // used for later rates, so that a compensation of the returned rate is only
+  // followed by the residual drift.
+  std::optional<float> TakeDriftRate();
+
  private:
   std::array<int, 3> delay_history_;
+  // The blocks at which the values in `delay_history_` were first estimated.
+  std::array<size_t, 3> change_blocks_;
   Level level_;
   size_t stability_counter_;
+  size_t block_counter_ = 0;
+  size_t rate_start_block_ = 0;
+  std::optional<float> drift_rate_;
 };
 }  // namespace webrtc
 
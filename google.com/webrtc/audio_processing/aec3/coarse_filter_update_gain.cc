@@ -100,4 +100,14 @@ void CoarseFilterUpdateGain::UpdateCurrentConfig() {
   RTC_DCHECK_LE(0, config_change_counter_);
 }
 
+void CoarseFilterUpdateGain::SaveState(StateWriter* writer) const {
+  writer->WriteUint32(poor_signal_excitation_counter_);
+  writer->WriteUint32(call_counter_);
+}
+
+void CoarseFilterUpdateGain::LoadState(StateReader* reader) {
+  poor_signal_excitation_counter_ = reader->ReadUint32();
+  call_counter_ = reader->ReadUint32();
+}
+
 }  // namespace webrtc
@@ -19,6 +19,7 @@
 #include "audio_processing/aec3/aec3_common.h"
 #include "audio_processing/aec3/fft_data.h"
 #include "audio_processing/aec3/render_signal_analyzer.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 
@@ -54,6 +55,10 @@ class CoarseFilterUpdateGain {
     }
   }
 
+  // Saves and restores the adaptation state.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
  private:
   EchoCanceller3Config::Filter::CoarseConfiguration current_config_;
   EchoCanceller3Config::Filter::CoarseConfiguration target_config_;
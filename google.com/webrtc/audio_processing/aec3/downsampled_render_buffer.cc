@@ -16,10 +16,15 @@ namespace webrtc {
 
 DownsampledRenderBuffer::DownsampledRenderBuffer(size_t downsampled_buffer_size)
     : size(static_cast<int>(downsampled_buffer_size)),
-      buffer(downsampled_buffer_size, 0.f) {
+      buffer(owned_buffer_),
+      owned_buffer_(downsampled_buffer_size, 0.f) {
   std::fill(buffer.begin(), buffer.end(), 0.f);
 }
 
+DownsampledRenderBuffer::DownsampledRenderBuffer(
+    std::vector<float>* shared_buffer)
+    : size(static_cast<int>(shared_buffer->size())), buffer(*shared_buffer) {}
+
 DownsampledRenderBuffer::~DownsampledRenderBuffer() = default;
 
 }  // namespace webrtc
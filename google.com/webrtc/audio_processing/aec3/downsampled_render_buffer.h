@@ -22,6 +22,11 @@ namespace webrtc {
 // Holds the circular buffer of the downsampled render data.
 struct DownsampledRenderBuffer {
   explicit DownsampledRenderBuffer(size_t downsampled_buffer_size);
+  // Creates a buffer with its own read and write indices over samples owned
+  // elsewhere, which must outlive it.
+  explicit DownsampledRenderBuffer(std::vector<float>* shared_buffer);
+  DownsampledRenderBuffer(const DownsampledRenderBuffer&) = delete;
+  DownsampledRenderBuffer& operator=(const DownsampledRenderBuffer&) = delete;
   ~DownsampledRenderBuffer();
 
   int IncIndex(int index) const {
@@ -48,9 +53,12 @@ struct DownsampledRenderBuffer {
   void DecReadIndex() { read = DecIndex(read); }
 
   const int size;
-  std::vector<float> buffer;
+  std::vector<float>& buffer;
   int write = 0;
   int read = 0;
+
+ private:
+  std::vector<float> owned_buffer_;
 };
 
 }  // namespace webrtc
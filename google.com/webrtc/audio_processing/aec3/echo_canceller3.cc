@@ -32,6 +32,7 @@
 #include "audio_processing/aec3/frame_blocker.h"
 #include "audio_processing/high_pass_filter.h"
 #include "audio_processing/logging/apm_data_dumper.h"
+#include "audio_processing/utility/state_serializer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/logging.h"
@@ -751,6 +752,22 @@ EchoCanceller3::EchoCanceller3(
     int sample_rate_hz,
     size_t num_render_channels,
     size_t num_capture_channels)
+    : EchoCanceller3(env,
+                     config,
+                     multichannel_config,
+                     sample_rate_hz,
+                     num_render_channels,
+                     num_capture_channels,
+                     /*shared_render_analysis=*/nullptr) {}
+
+EchoCanceller3::EchoCanceller3(
+    const Environment& env,
+    const EchoCanceller3Config& config,
+    const std::optional<EchoCanceller3Config>& multichannel_config,
+    int sample_rate_hz,
+    size_t num_render_channels,
+    size_t num_capture_channels,
+    std::shared_ptr<SharedRenderAnalysis> shared_render_analysis)
     : env_(env),
       data_dumper_(new ApmDataDumper(instance_count_.fetch_add(1) + 1)),
       config_(AdjustConfig(config, env.field_trials())),
@@ -758,6 +775,7 @@ EchoCanceller3::EchoCanceller3(
       num_bands_(NumBandsForRate(sample_rate_hz_)),
       num_render_input_channels_(num_render_channels),
       num_capture_channels_(num_capture_channels),
+      shared_render_analysis_(std::move(shared_render_analysis)),
       config_selector_(config_,
                        multichannel_config,
                        num_render_input_channels_),
@@ -841,9 +859,17 @@ void EchoCanceller3::Initialize() {
   render_blocker_.reset(
       new FrameBlocker(num_bands_, num_render_channels_to_aec_));
 
+  // A drift compensated render signal is specific to this echo canceller, so
+  // its analysis cannot be shared.
+  const EchoCanceller3Config& active_config = config_selector_.active_config();
   block_processor_ = BlockProcessor::Create(
-      env_, config_selector_.active_config(), sample_rate_hz_,
-      num_render_channels_to_aec_, num_capture_channels_);
+      env_, active_config, sample_rate_hz_, num_render_channels_to_aec_,
+      num_capture_channels_,
+      std::unique_ptr<RenderDelayBuffer>(RenderDelayBuffer::Create(
+          active_config, sample_rate_hz_, num_render_channels_to_aec_,
+          active_config.delay.compensate_clock_drift
+              ? nullptr
+              : shared_render_analysis_.get())));
 
   render_sub_frame_view_ = std::vector<std::vector<ArrayView<float>>>(
       num_bands_, std::vector<ArrayView<float>>(num_render_channels_to_aec_));
@@ -959,6 +985,60 @@ bool EchoCanceller3::ActiveProcessing() const {
   return true;
 }
 
+void EchoCanceller3::SaveStateHeader(StateWriter* writer) const {
+  const EchoCanceller3Config& config = config_selector_.active_config();
+  writer->WriteUint32(sample_rate_hz_);
+  writer->WriteUint32(num_render_channels_to_aec_);
+  writer->WriteUint32(num_capture_channels_);
+  writer->WriteUint32(config.filter.refined.length_blocks);
+  writer->WriteUint32(config.filter.coarse.length_blocks);
+  writer->WriteUint32(config.erle.num_sections);
+}
+
+bool EchoCanceller3::SaveState(std::vector<uint8_t>* state) const {
+  RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
+  RTC_DCHECK(state);
+  StateWriter writer(state);
+  SaveStateHeader(&writer);
+  block_processor_->SaveState(&writer);
+  return true;
+}
+
+bool EchoCanceller3::LoadState(ArrayView<const uint8_t> state) {
+  RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
+  // The layout is fully determined by the header, so a state is compatible
+  // exactly when the header and the size match those of this instance.
+  std::vector<uint8_t> current;
+  SaveState(&current);
+  std::vector<uint8_t> header;
+  StateWriter header_writer(&header);
+  SaveStateHeader(&header_writer);
+  if (state.size() != current.size() || state.size() < header.size() ||
+      !std::equal(header.begin(), header.end(), state.begin())) {
+    return false;
+  }
+
+  // Loading stops at the first value that does not fit, with the values
+  // before it already in place. The state is therefore first loaded into a
+  // scratch block processor, so that a rejected state leaves this one as it
+  // was.
+  const EchoCanceller3Config& active_config = config_selector_.active_config();
+  std::unique_ptr<BlockProcessor> scratch = BlockProcessor::Create(
+      env_, active_config, sample_rate_hz_, num_render_channels_to_aec_,
+      num_capture_channels_);
+  StateReader scratch_reader(state.subview(header.size()));
+  scratch->LoadState(&scratch_reader);
+  if (!scratch_reader.ok() || scratch_reader.remaining() != 0) {
+    return false;
+  }
+
+  StateReader reader(state.subview(header.size()));
+  block_processor_->LoadState(&reader);
+  RTC_DCHECK(reader.ok());
+  RTC_DCHECK_EQ(reader.remaining(), 0);
+  return reader.ok();
+}
+
 void EchoCanceller3::SetBlockProcessorForTesting(
     std::unique_ptr<BlockProcessor> block_processor) {
   RTC_DCHECK_RUNS_SERIALIZED(&capture_race_checker_);
@@ -30,6 +30,7 @@
 #include "audio_processing/aec3/config_selector.h"
 #include "audio_processing/aec3/frame_blocker.h"
 #include "audio_processing/aec3/multi_channel_content_detector.h"
+#include "audio_processing/aec3/shared_render_analysis.h"
 #include "audio_processing/audio_buffer.h"
 #include "audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
@@ -97,6 +98,16 @@ class EchoCanceller3 : public EchoControl {
                  int sample_rate_hz,
                  size_t num_render_channels,
                  size_t num_capture_channels);
+  // As above, but shares the render analysis with the other echo cancellers
+  // using `shared_render_analysis`. They must all be fed the same render
+  // signal.
+  EchoCanceller3(const Environment& env,
+                 const EchoCanceller3Config& config,
+                 const std::optional<EchoCanceller3Config>& multichannel_config,
+                 int sample_rate_hz,
+                 size_t num_render_channels,
+                 size_t num_capture_channels,
+                 std::shared_ptr<SharedRenderAnalysis> shared_render_analysis);
 
   ~EchoCanceller3() override;
 
@@ -130,6 +141,9 @@ class EchoCanceller3 : public EchoControl {
 
   bool ActiveProcessing() const override;
 
+  bool SaveState(std::vector<uint8_t>* state) const override;
+  bool LoadState(ArrayView<const uint8_t> state) override;
+
   // Signals whether an external detector has detected echo leakage from the
   // echo canceller.
   // Note that in the case echo leakage has been flagged, it should be unflagged
@@ -169,6 +183,9 @@ class EchoCanceller3 : public EchoControl {
     return config_selector_.active_config();
   }
 
+  // Writes the parameters that a saved state must match to be loadable.
+  void SaveStateHeader(StateWriter* writer) const;
+
   // Empties the render SwapQueue.
   void EmptyRenderQueue();
 
@@ -195,6 +212,7 @@ class EchoCanceller3 : public EchoControl {
   const size_t num_render_input_channels_;
   size_t num_render_channels_to_aec_;
   const size_t num_capture_channels_;
+  const std::shared_ptr<SharedRenderAnalysis> shared_render_analysis_;
   ConfigSelector config_selector_;
   MultiChannelContentDetector multichannel_content_detector_;
   std::unique_ptr<BlockFramer> linear_output_framer_
@@ -45,6 +45,17 @@ EchoPathDelayEstimator::EchoPathDelayEstimator(
           config.delay.delay_estimate_smoothing_delay_found,
           config.delay.delay_candidate_detection_threshold,
           config.delay.detect_pre_echo),
+      phat_correlator_(
+          config.delay.estimator ==
+                  EchoCanceller3Config::Delay::Estimator::kFftCorrelation
+              ? std::make_unique<PhatCorrelator>(
+                    data_dumper_,
+                    sub_block_size_,
+                    matched_filter_.GetMaxFilterLag(),
+                    config.delay.down_sampling_factor == 8
+                        ? config.render_levels.poor_excitation_render_limit_ds8
+                        : config.render_levels.poor_excitation_render_limit)
+              : nullptr),
       matched_filter_lag_aggregator_(data_dumper_,
                                      matched_filter_.GetMaxFilterLag(),
                                      config.delay) {
@@ -71,14 +82,20 @@ std::optional<DelayEstimate> EchoPathDelayEstimator::EstimateDelay(
   data_dumper_->DumpWav("aec3_capture_decimator_output",
                         downsampled_capture.size(), downsampled_capture.data(),
                         16000 / down_sampling_factor_, 1);
-  matched_filter_.Update(render_buffer, downsampled_capture,
-                         matched_filter_lag_aggregator_.ReliableDelayFound());
+  if (phat_correlator_) {
+    phat_correlator_->Update(render_buffer, downsampled_capture);
+  } else {
+    matched_filter_.Update(render_buffer, downsampled_capture,
+                           matched_filter_lag_aggregator_.ReliableDelayFound());
+  }
 
   std::optional<DelayEstimate> aggregated_matched_filter_lag =
       matched_filter_lag_aggregator_.Aggregate(
-          matched_filter_.GetBestLagEstimate());
+          phat_correlator_ ? phat_correlator_->GetBestLagEstimate()
+                           : matched_filter_.GetBestLagEstimate());
 
   // Run clockdrift detection.
+  clockdrift_detector_.IncreaseBlockCounter();
   if (aggregated_matched_filter_lag &&
       (*aggregated_matched_filter_lag).quality ==
           DelayEstimate::Quality::kRefined)
@@ -115,12 +132,24 @@ std::optional<DelayEstimate> EchoPathDelayEstimator::EstimateDelay(
   return aggregated_matched_filter_lag;
 }
 
+std::optional<float> EchoPathDelayEstimator::TakeClockdriftRate() {
+  std::optional<float> rate = clockdrift_detector_.TakeDriftRate();
+  if (rate) {
+    // The detector counts down-sampled samples of delay per block.
+    *rate *= static_cast<float>(down_sampling_factor_) / kBlockSize;
+  }
+  return rate;
+}
+
 void EchoPathDelayEstimator::Reset(bool reset_lag_aggregator,
                                    bool reset_delay_confidence) {
   if (reset_lag_aggregator) {
     matched_filter_lag_aggregator_.Reset(reset_delay_confidence);
   }
   matched_filter_.Reset(/*full_reset=*/reset_lag_aggregator);
+  if (phat_correlator_) {
+    phat_correlator_->Reset(/*full_reset=*/reset_lag_aggregator);
+  }
   old_aggregated_lag_ = std::nullopt;
   consistent_estimate_counter_ = 0;
 }
@@ -13,6 +13,7 @@
 
 #include <stddef.h>
 
+#include <memory>
 #include <optional>
 
 #include "api/array_view.h"
@@ -23,6 +24,7 @@
 #include "audio_processing/aec3/delay_estimate.h"
 #include "audio_processing/aec3/matched_filter.h"
 #include "audio_processing/aec3/matched_filter_lag_aggregator.h"
+#include "audio_processing/aec3/phat_correlator.h"
 
 namespace webrtc {
 
@@ -52,8 +54,12 @@ class EchoPathDelayEstimator {
 
   // Log delay estimator properties.
   void LogDelayEstimationProperties(int sample_rate_hz, size_t shift) const {
-    matched_filter_.LogFilterProperties(sample_rate_hz, shift,
-                                        down_sampling_factor_);
+    if (phat_correlator_) {
+      phat_correlator_->LogProperties(shift, down_sampling_factor_);
+    } else {
+      matched_filter_.LogFilterProperties(sample_rate_hz, shift,
+                                          down_sampling_factor_);
+    }
   }
 
   // Returns the level of detected clockdrift.
@@ -61,6 +67,11 @@ class EchoPathDelayEstimator {
     return clockdrift_detector_.ClockdriftLevel();
   }
 
+  // Returns the rate at which the delay has drifted, in samples per sample and
+  // positive when the delay grows, if a drift has been verified since the last
+  // call.
+  std::optional<float> TakeClockdriftRate();
+
  private:
   ApmDataDumper* const data_dumper_;
   const size_t down_sampling_factor_;
@@ -68,6 +79,9 @@ class EchoPathDelayEstimator {
   AlignmentMixer capture_mixer_;
   Decimator capture_decimator_;
   MatchedFilter matched_filter_;
+  // Replaces `matched_filter_` for estimating the lag when the FFT correlation
+  // estimator is configured.
+  std::unique_ptr<PhatCorrelator> phat_correlator_;
   MatchedFilterLagAggregator matched_filter_lag_aggregator_;
   std::optional<DelayEstimate> old_aggregated_lag_;
   size_t consistent_estimate_counter_ = 0;
@@ -23,6 +23,7 @@
 #include "audio_processing/aec3/aec3_common.h"
 #include "audio_processing/aec3/aec3_fft.h"
 #include "audio_processing/aec3/aec_state.h"
+#include "audio_processing/aec3/channel_worker_pool.h"
 #include "audio_processing/aec3/comfort_noise_generator.h"
 #include "audio_processing/aec3/echo_path_variability.h"
 #include "audio_processing/aec3/echo_remover_metrics.h"
@@ -51,6 +52,12 @@ namespace {
 // stack using a fixed maximum value.
 constexpr size_t kMaxNumChannelsOnStack = 2;
 
+// Number of blocks beyond the length of the linear filters that the render
+// signal must have been inactive for before the echo removal becomes idle. It
+// covers the decay of the reverberation that is modeled beyond the filters
+// and errors in the alignment of the render signal.
+constexpr size_t kIdleHangoverBlocks = 100;
+
 // Chooses the number of channels to store on the heap when that is required due
 // to the number of capture channels being larger than the pre-defined number
 // of channels to store on the stack.
@@ -137,6 +144,9 @@ class EchoRemoverImpl final : public EchoRemover {
     capture_output_used_ = capture_output_used;
   }
 
+  void SaveState(StateWriter* writer) const override;
+  void LoadState(StateReader* reader) override;
+
  private:
   // Selects which of the coarse and refined linear filter outputs that is most
   // appropriate to pass to the suppressor and forms the linear filter output by
@@ -144,6 +154,10 @@ class EchoRemoverImpl final : public EchoRemover {
   void FormLinearFilterOutput(const SubtractorOutput& subtractor_output,
                               ArrayView<float> output);
 
+  // Processes a block of capture while the echo removal is idle, in the same
+  // way as it would be processed without any echo.
+  void ProcessIdleCapture(Block* linear_output, Block* capture);
+
   static std::atomic<int> instance_count_;
   const EchoCanceller3Config config_;
   const Aec3Fft fft_;
@@ -153,6 +167,10 @@ class EchoRemoverImpl final : public EchoRemover {
   const size_t num_render_channels_;
   const size_t num_capture_channels_;
   const bool use_coarse_filter_output_;
+  const bool idle_during_inactive_render_;
+  const size_t inactive_render_blocks_for_idle_;
+  // Null unless the capture channels are processed in parallel.
+  const std::unique_ptr<ChannelWorkerPool> channel_workers_;
   Subtractor subtractor_;
   SuppressionGain suppression_gain_;
   ComfortNoiseGenerator cng_;
@@ -198,20 +216,36 @@ EchoRemoverImpl::EchoRemoverImpl(const Environment& env,
       num_capture_channels_(num_capture_channels),
       use_coarse_filter_output_(
           config_.filter.enable_coarse_filter_output_usage),
+      idle_during_inactive_render_(
+          config_.echo_removal_control.idle_during_inactive_render),
+      inactive_render_blocks_for_idle_(
+          std::max(config_.filter.refined.length_blocks,
+                   config_.filter.coarse.length_blocks) +
+          kIdleHangoverBlocks),
+      channel_workers_(
+          config_.multi_channel.num_worker_threads > 0 &&
+                  num_capture_channels_ > 1
+              ? std::make_unique<ChannelWorkerPool>(
+                    std::min(config_.multi_channel.num_worker_threads,
+                             static_cast<int>(num_capture_channels_) - 1))
+              : nullptr),
       subtractor_(env,
                   config,
                   num_render_channels_,
                   num_capture_channels_,
                   data_dumper_.get(),
-                  optimization_),
+                  optimization_,
+                  channel_workers_.get()),
       suppression_gain_(config_,
                         optimization_,
                         sample_rate_hz,
-                        num_capture_channels),
+                        num_capture_channels,
+                        channel_workers_.get()),
       cng_(config_, optimization_, num_capture_channels_),
       suppression_filter_(optimization_,
                           sample_rate_hz_,
-                          num_capture_channels_),
+                          num_capture_channels_,
+                          channel_workers_.get()),
       render_signal_analyzer_(config_),
       residual_echo_estimator_(env, config_, num_render_channels),
       aec_state_(env, config_, num_capture_channels_),
@@ -233,11 +267,28 @@ EchoRemoverImpl::EchoRemoverImpl(const Environment& env,
 
 EchoRemoverImpl::~EchoRemoverImpl() = default;
 
+void EchoRemoverImpl::SaveState(StateWriter* writer) const {
+  aec_state_.SaveState(writer);
+  subtractor_.SaveState(writer);
+}
+
+void EchoRemoverImpl::LoadState(StateReader* reader) {
+  // The subtractor picks its step sizes from whether the initial state is
+  // still active, so the AEC state is restored first.
+  aec_state_.LoadState(reader);
+  subtractor_.LoadState(reader, aec_state_.InitialStateActive());
+}
+
 void EchoRemoverImpl::GetMetrics(EchoControl::Metrics* metrics) const {
   // Echo return loss (ERL) is inverted to go from gain to attenuation.
   metrics->echo_return_loss = -10.0 * std::log10(aec_state_.ErlTimeDomain());
   metrics->echo_return_loss_enhancement =
       Log2TodB(aec_state_.FullBandErleLog2());
+  if (config_.filter.use_linear_filter) {
+    metrics->linear_filter_length_ms =
+        static_cast<int>(subtractor_.FilterLengthBlocks()) * 1000 /
+        kNumBlocksPerSecond;
+  }
 }
 
 void EchoRemoverImpl::ProcessCapture(
@@ -369,19 +420,33 @@ void EchoRemoverImpl::ProcessCapture(
     suppression_gain_.SetInitialState(false);
   }
 
+  // When the render signal has been inactive for long enough for any echo to
+  // have decayed, there is no echo to remove and the adaptation of the linear
+  // filters and the suppressor is paused.
+  if (idle_during_inactive_render_ &&
+      !echo_path_variability.AudioPathChanged() &&
+      render_signal_analyzer_.InactiveRenderBlocks() >
+          inactive_render_blocks_for_idle_) {
+    ProcessIdleCapture(linear_output, y);
+    return;
+  }
+
   // Perform linear echo cancellation.
   subtractor_.Process(*render_buffer, *y, render_signal_analyzer_, aec_state_,
                       subtractor_output);
 
-  // Compute spectra.
+  // Compute spectra. The choice of linear filter output carries over from one
+  // channel to the next, so it is made in channel order.
   for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
     FormLinearFilterOutput(subtractor_output[ch], e[ch]);
+  }
+  ForEachChannel(channel_workers_.get(), num_capture_channels_, [&](size_t ch) {
     WindowedPaddedFft(fft_, y->View(/*band=*/0, ch), y_old_[ch], &Y[ch]);
     WindowedPaddedFft(fft_, e[ch], e_old_[ch], &E[ch]);
     LinearEchoPower(E[ch], Y[ch], &S2_linear[ch]);
     Y[ch].Spectrum(optimization_, Y2[ch]);
     E[ch].Spectrum(optimization_, E2[ch]);
-  }
+  });
 
   // Optionally return the linear filter output.
   if (linear_output) {
@@ -478,6 +543,28 @@ void EchoRemoverImpl::ProcessCapture(
                         aec_state_.SaturatedCapture() ? 1 : 0);
 }
 
+void EchoRemoverImpl::ProcessIdleCapture(Block* linear_output,
+                                          Block* capture) {
+  // Without echo, the linear filter output is the capture signal.
+  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+    auto y = capture->View(/*band=*/0, ch);
+    std::copy(y.begin(), y.end(), e_old_[ch].begin());
+    if (linear_output) {
+      std::copy(y.begin(), y.end(), linear_output->begin(/*band=*/0, ch));
+    }
+  }
+
+  // The suppressor applies unity gain without comfort noise when there is no
+  // echo, which is a plain delay that is cheaply formed in the time domain.
+  if (capture_output_used_) {
+    suppression_filter_.ApplyUnityGain(y_old_, capture);
+  }
+  y_old_ = e_old_;
+
+  data_dumper_->DumpRaw("aec3_output",
+                        capture->View(/*band=*/0, /*channel=*/0));
+}
+
 void EchoRemoverImpl::FormLinearFilterOutput(
     const SubtractorOutput& subtractor_output,
     ArrayView<float> output) {
@@ -22,6 +22,7 @@
 #include "audio_processing/aec3/delay_estimate.h"
 #include "audio_processing/aec3/echo_path_variability.h"
 #include "audio_processing/aec3/render_buffer.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 
@@ -58,6 +59,11 @@ class EchoRemover {
   // resulting output is anyway not used, for instance when the endpoint is
   // muted.
   virtual void SetCaptureOutputUsage(bool capture_output_used) = 0;
+
+  // Saves and restores the adaptive state: the linear filters and the
+  // convergence, ERL and ERLE estimates.
+  virtual void SaveState(StateWriter* writer) const = 0;
+  virtual void LoadState(StateReader* reader) = 0;
 };
 
 }  // namespace webrtc
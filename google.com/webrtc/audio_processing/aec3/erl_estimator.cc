@@ -142,4 +142,24 @@ void ErlEstimator::Update(
                          : std::min(kMaxErl, 2.f * erl_time_domain_);
 }
 
+void ErlEstimator::SaveState(StateWriter* writer) const {
+  writer->WriteFloats(erl_);
+  for (int hold_counter : hold_counters_) {
+    writer->WriteInt32(hold_counter);
+  }
+  writer->WriteFloat(erl_time_domain_);
+  writer->WriteInt32(hold_counter_time_domain_);
+  writer->WriteUint32(blocks_since_reset_);
+}
+
+void ErlEstimator::LoadState(StateReader* reader) {
+  reader->ReadFloats(erl_);
+  for (int& hold_counter : hold_counters_) {
+    hold_counter = reader->ReadInt32();
+  }
+  erl_time_domain_ = reader->ReadFloat();
+  hold_counter_time_domain_ = reader->ReadInt32();
+  blocks_since_reset_ = reader->ReadUint32();
+}
+
 }  // namespace webrtc
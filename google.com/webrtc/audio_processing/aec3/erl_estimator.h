@@ -18,6 +18,7 @@
 
 #include "api/array_view.h"
 #include "audio_processing/aec3/aec3_common.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 
@@ -43,6 +44,10 @@ class ErlEstimator {
   const std::array<float, kFftLengthBy2Plus1>& Erl() const { return erl_; }
   float ErlTimeDomain() const { return erl_time_domain_; }
 
+  // Saves and restores the estimates.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
  private:
   const size_t startup_phase_length_blocks__;
   std::array<float, kFftLengthBy2Plus1> erl_;
@@ -85,4 +85,22 @@ void ErleEstimator::Dump(
   }
 }
 
+void ErleEstimator::SaveState(StateWriter* writer) const {
+  writer->WriteUint32(blocks_since_reset_);
+  fullband_erle_estimator_.SaveState(writer);
+  subband_erle_estimator_.SaveState(writer);
+  if (signal_dependent_erle_estimator_) {
+    signal_dependent_erle_estimator_->SaveState(writer);
+  }
+}
+
+void ErleEstimator::LoadState(StateReader* reader) {
+  blocks_since_reset_ = reader->ReadUint32();
+  fullband_erle_estimator_.LoadState(reader);
+  subband_erle_estimator_.LoadState(reader);
+  if (signal_dependent_erle_estimator_) {
+    signal_dependent_erle_estimator_->LoadState(reader);
+  }
+}
+
 }  // namespace webrtc
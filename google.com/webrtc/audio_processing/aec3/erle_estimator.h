@@ -26,6 +26,7 @@
 #include "audio_processing/aec3/signal_dependent_erle_estimator.h"
 #include "audio_processing/aec3/subband_erle_estimator.h"
 #include "audio_processing/logging/apm_data_dumper.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 
@@ -95,6 +96,10 @@ class ErleEstimator {
 
   void Dump(const std::unique_ptr<ApmDataDumper>& data_dumper) const;
 
+  // Saves and restores the estimates.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
  private:
   const size_t startup_phase_length_blocks_;
   FullBandErleEstimator fullband_erle_estimator_;
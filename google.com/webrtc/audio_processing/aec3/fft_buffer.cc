@@ -14,7 +14,8 @@ namespace webrtc {
 
 FftBuffer::FftBuffer(size_t size, size_t num_channels)
     : size(static_cast<int>(size)),
-      buffer(size, std::vector<FftData>(num_channels)) {
+      buffer(owned_buffer_),
+      owned_buffer_(size, std::vector<FftData>(num_channels)) {
   for (auto& block : buffer) {
     for (auto& channel_fft_data : block) {
       channel_fft_data.Clear();
@@ -22,6 +23,10 @@ FftBuffer::FftBuffer(size_t size, size_t num_channels)
   }
 }
 
+FftBuffer::FftBuffer(std::vector<std::vector<FftData>>* shared_buffer)
+    : size(static_cast<int>(shared_buffer->size())),
+      buffer(*shared_buffer) {}
+
 FftBuffer::~FftBuffer() = default;
 
 }  // namespace webrtc
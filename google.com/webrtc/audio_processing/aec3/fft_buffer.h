@@ -24,6 +24,11 @@ namespace webrtc {
 // read and write indices.
 struct FftBuffer {
   FftBuffer(size_t size, size_t num_channels);
+  // Creates a buffer with its own read and write indices over FFTs owned
+  // elsewhere, which must outlive it.
+  explicit FftBuffer(std::vector<std::vector<FftData>>* shared_buffer);
+  FftBuffer(const FftBuffer&) = delete;
+  FftBuffer& operator=(const FftBuffer&) = delete;
   ~FftBuffer();
 
   int IncIndex(int index) const {
@@ -50,9 +55,12 @@ struct FftBuffer {
   void DecReadIndex() { read = DecIndex(read); }
 
   const int size;
-  std::vector<std::vector<FftData>> buffer;
+  std::vector<std::vector<FftData>>& buffer;
   int write = 0;
   int read = 0;
+
+ private:
+  std::vector<std::vector<FftData>> owned_buffer_;
 };
 
 }  // namespace webrtc
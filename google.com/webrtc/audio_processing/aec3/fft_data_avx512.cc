@@ -0,0 +1,34 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#if defined(__i386__) || defined(_M_IX86) || defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+
+#include "api/array_view.h"
+#include "audio_processing/aec3/fft_data.h"
+
+namespace webrtc {
+
+// Computes the power spectrum of the data.
+__attribute__((target("avx512f")))
+void FftData::SpectrumAVX512(ArrayView<float> power_spectrum) const {
+  RTC_DCHECK_EQ(kFftLengthBy2Plus1, power_spectrum.size());
+  for (size_t k = 0; k < kFftLengthBy2; k += 16) {
+    const __m512 r = _mm512_loadu_ps(&re[k]);
+    const __m512 i = _mm512_loadu_ps(&im[k]);
+    const __m512 ii = _mm512_mul_ps(i, i);
+    _mm512_storeu_ps(&power_spectrum[k], _mm512_fmadd_ps(r, r, ii));
+  }
+  power_spectrum[kFftLengthBy2] = re[kFftLengthBy2] * re[kFftLengthBy2] +
+                                  im[kFftLengthBy2] * im[kFftLengthBy2];
+}
+
+}  // namespace webrtc
+#endif
@@ -24,6 +24,10 @@
 namespace webrtc {
 namespace {
 
+// Energy relative to the strongest block of the filter below which the blocks
+// at the end of the filter are not considered to be part of the echo path.
+constexpr float kEchoPathTailThreshold = 1e-4f;
+
 size_t FindPeakIndex(ArrayView<const float> filter_time_domain,
                      size_t peak_index_in,
                      size_t start_sample,
@@ -51,10 +55,10 @@ FilterAnalyzer::FilterAnalyzer(const EchoCanceller3Config& config,
     : data_dumper_(new ApmDataDumper(instance_count_.fetch_add(1) + 1)),
       bounded_erl_(config.ep_strength.bounded_erl),
       default_gain_(config.ep_strength.default_gain),
+      max_filter_size_(
+          GetTimeDomainLength(config.filter.refined.length_blocks)),
       h_highpass_(num_capture_channels,
-                  std::vector<float>(
-                      GetTimeDomainLength(config.filter.refined.length_blocks),
-                      0.f)),
+                  std::vector<float>(max_filter_size_, 0.f)),
       filter_analysis_states_(num_capture_channels,
                               FilterAnalysisState(config)),
       filter_delays_blocks_(num_capture_channels, 0) {
@@ -70,6 +74,7 @@ void FilterAnalyzer::Reset() {
     state.Reset(default_gain_);
   }
   std::fill(filter_delays_blocks_.begin(), filter_delays_blocks_.end(), 0);
+  echo_path_length_blocks_ = std::nullopt;
 }
 
 void FilterAnalyzer::Update(
@@ -85,6 +90,9 @@ void FilterAnalyzer::Update(
   ++blocks_since_reset_;
   SetRegionToAnalyze(filters_time_domain[0].size());
   AnalyzeRegion(filters_time_domain, render_buffer);
+  if (region_.end_sample_ == filters_time_domain[0].size() - 1) {
+    UpdateEchoPathLength(filters_time_domain[0].size());
+  }
 
   // Aggregate the results for all capture channels.
   auto& st_ch0 = filter_analysis_states_[0];
@@ -101,6 +109,62 @@ void FilterAnalyzer::Update(
   }
 }
 
+void FilterAnalyzer::SaveState(StateWriter* writer) const {
+  writer->WriteUint32(blocks_since_reset_);
+  writer->WriteUint32(region_.start_sample_);
+  writer->WriteUint32(region_.end_sample_);
+  writer->WriteInt32(min_filter_delay_blocks_);
+  for (size_t ch = 0; ch < h_highpass_.size(); ++ch) {
+    // The filter is trimmed to its current size, so it is padded to the
+    // maximum size to keep the layout fixed.
+    writer->WriteUint32(h_highpass_[ch].size());
+    writer->WriteFloats(h_highpass_[ch]);
+    for (size_t k = h_highpass_[ch].size(); k < max_filter_size_; ++k) {
+      writer->WriteFloat(0.f);
+    }
+    writer->WriteInt32(filter_delays_blocks_[ch]);
+
+    const FilterAnalysisState& st_ch = filter_analysis_states_[ch];
+    writer->WriteFloat(st_ch.gain);
+    writer->WriteUint32(st_ch.peak_index);
+    writer->WriteInt32(st_ch.filter_length_blocks);
+    writer->WriteBool(st_ch.consistent_estimate);
+    st_ch.consistent_filter_detector.SaveState(writer);
+  }
+}
+
+void FilterAnalyzer::LoadState(StateReader* reader) {
+  blocks_since_reset_ = reader->ReadUint32();
+  region_.start_sample_ = reader->ReadUint32();
+  region_.end_sample_ = reader->ReadUint32();
+  min_filter_delay_blocks_ = reader->ReadInt32();
+  for (size_t ch = 0; ch < h_highpass_.size(); ++ch) {
+    const size_t filter_size = reader->ReadUint32();
+    if (filter_size == 0 || filter_size > max_filter_size_ ||
+        region_.end_sample_ >= filter_size) {
+      reader->Invalidate();
+      return;
+    }
+    h_highpass_[ch].resize(filter_size);
+    reader->ReadFloats(h_highpass_[ch]);
+    for (size_t k = filter_size; k < max_filter_size_; ++k) {
+      reader->ReadFloat();
+    }
+    filter_delays_blocks_[ch] = reader->ReadInt32();
+
+    FilterAnalysisState& st_ch = filter_analysis_states_[ch];
+    st_ch.gain = reader->ReadFloat();
+    st_ch.peak_index = std::min<size_t>(reader->ReadUint32(), filter_size - 1);
+    st_ch.filter_length_blocks = reader->ReadInt32();
+    st_ch.consistent_estimate = reader->ReadBool();
+    st_ch.consistent_filter_detector.LoadState(reader);
+    std::fill(st_ch.block_energies.begin(), st_ch.block_energies.end(), 0.f);
+  }
+  // The block energies are not stored, so the echo path length is estimated
+  // anew once the restored filters have been analyzed.
+  echo_path_length_blocks_ = std::nullopt;
+}
+
 void FilterAnalyzer::AnalyzeRegion(
     ArrayView<const std::vector<float>> filters_time_domain,
     const RenderBuffer& render_buffer) {
@@ -124,6 +188,16 @@ void FilterAnalyzer::AnalyzeRegion(
                       region_.end_sample_);
     filter_delays_blocks_[ch] = st_ch.peak_index >> kBlockSizeLog2;
     UpdateFilterGain(h_highpass_[ch], &st_ch);
+
+    // Accumulate the energy of each block of the filter over the region.
+    for (size_t k = region_.start_sample_; k <= region_.end_sample_; ++k) {
+      float& block_energy = st_ch.block_energies[k >> kBlockSizeLog2];
+      if ((k & (kBlockSize - 1)) == 0) {
+        block_energy = 0.f;
+      }
+      block_energy += h_highpass_[ch][k] * h_highpass_[ch][k];
+    }
+
     st_ch.filter_length_blocks =
         filters_time_domain[ch].size() * kOneByBlockSize;
 
@@ -153,6 +227,25 @@ void FilterAnalyzer::UpdateFilterGain(ArrayView<const float> filter_time_domain,
   }
 }
 
+void FilterAnalyzer::UpdateEchoPathLength(size_t filter_size) {
+  const size_t num_blocks = filter_size >> kBlockSizeLog2;
+  int length_blocks = 0;
+  for (const auto& st_ch : filter_analysis_states_) {
+    RTC_DCHECK_LE(num_blocks, st_ch.block_energies.size());
+    ArrayView<const float> energies(st_ch.block_energies.data(), num_blocks);
+    const float threshold =
+        kEchoPathTailThreshold *
+        *std::max_element(energies.begin(), energies.end());
+    size_t length_ch = num_blocks;
+    while (length_ch > 0 && energies[length_ch - 1] <= threshold) {
+      --length_ch;
+    }
+    length_blocks = std::max(length_blocks, static_cast<int>(length_ch));
+  }
+  echo_path_length_blocks_ = length_blocks;
+  data_dumper_->DumpRaw("aec3_echo_path_length_blocks", length_blocks);
+}
+
 void FilterAnalyzer::PreProcessFilters(
     ArrayView<const std::vector<float>> filters_time_domain) {
   for (size_t ch = 0; ch < filters_time_domain.size(); ++ch) {
@@ -218,6 +311,27 @@ void FilterAnalyzer::ConsistentFilterDetector::Reset() {
   consistent_delay_reference_ = -10;
 }
 
+void FilterAnalyzer::ConsistentFilterDetector::SaveState(
+    StateWriter* writer) const {
+  writer->WriteBool(significant_peak_);
+  writer->WriteFloat(filter_floor_accum_);
+  writer->WriteFloat(filter_secondary_peak_);
+  writer->WriteUint32(filter_floor_low_limit_);
+  writer->WriteUint32(filter_floor_high_limit_);
+  writer->WriteUint32(consistent_estimate_counter_);
+  writer->WriteInt32(consistent_delay_reference_);
+}
+
+void FilterAnalyzer::ConsistentFilterDetector::LoadState(StateReader* reader) {
+  significant_peak_ = reader->ReadBool();
+  filter_floor_accum_ = reader->ReadFloat();
+  filter_secondary_peak_ = reader->ReadFloat();
+  filter_floor_low_limit_ = reader->ReadUint32();
+  filter_floor_high_limit_ = reader->ReadUint32();
+  consistent_estimate_counter_ = reader->ReadUint32();
+  consistent_delay_reference_ = reader->ReadInt32();
+}
+
 bool FilterAnalyzer::ConsistentFilterDetector::Detect(
     ArrayView<const float> filter_to_analyze,
     const FilterRegion& region,
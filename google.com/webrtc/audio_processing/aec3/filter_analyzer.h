@@ -16,12 +16,14 @@
 #include <array>
 #include <atomic>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "api/array_view.h"
 #include "api/audio/echo_canceller3_config.h"
 #include "audio_processing/aec3/aec3_common.h"
 #include "audio_processing/aec3/block.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 
@@ -60,11 +62,24 @@ class FilterAnalyzer {
     return filter_analysis_states_[0].filter_length_blocks;
   }
 
+  // Returns the number of blocks, counted from the start of the filters, that
+  // hold the significant part of the impulse responses, once all filters have
+  // been analyzed in full since the last reset. When the impulse responses do
+  // not decay within the filters, this is the filter length.
+  std::optional<int> EchoPathLengthBlocks() const {
+    return echo_path_length_blocks_;
+  }
+
   // Returns the preprocessed filter.
   ArrayView<const std::vector<float>> GetAdjustedFilters() const {
     return h_highpass_;
   }
 
+  // Saves and restores the analysis, so that a restored filter does not have
+  // to be swept through again before its delay and gain are known.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
   // Public for testing purposes only.
   void SetRegionToAnalyze(size_t filter_size);
 
@@ -76,6 +91,7 @@ class FilterAnalyzer {
 
   void UpdateFilterGain(ArrayView<const float> filters_time_domain,
                         FilterAnalysisState* st);
+  void UpdateEchoPathLength(size_t filter_size);
   void PreProcessFilters(
       ArrayView<const std::vector<float>> filters_time_domain);
 
@@ -97,6 +113,8 @@ class FilterAnalyzer {
                 const Block& x_block,
                 size_t peak_index,
                 int delay_blocks);
+    void SaveState(StateWriter* writer) const;
+    void LoadState(StateReader* reader);
 
    private:
     bool significant_peak_;
@@ -112,6 +130,7 @@ class FilterAnalyzer {
   struct FilterAnalysisState {
     explicit FilterAnalysisState(const EchoCanceller3Config& config)
         : filter_length_blocks(config.filter.refined_initial.length_blocks),
+          block_energies(config.filter.refined.length_blocks, 0.f),
           consistent_filter_detector(config) {
       Reset(config.ep_strength.default_gain);
     }
@@ -119,12 +138,15 @@ class FilterAnalyzer {
     void Reset(float default_gain) {
       peak_index = 0;
       gain = default_gain;
+      std::fill(block_energies.begin(), block_energies.end(), 0.f);
       consistent_filter_detector.Reset();
     }
 
     float gain;
     size_t peak_index;
     int filter_length_blocks;
+    // Energy of each block of the preprocessed filter.
+    std::vector<float> block_energies;
     bool consistent_estimate = false;
     ConsistentFilterDetector consistent_filter_detector;
   };
@@ -133,6 +155,7 @@ class FilterAnalyzer {
   std::unique_ptr<ApmDataDumper> data_dumper_;
   const bool bounded_erl_;
   const float default_gain_;
+  const size_t max_filter_size_;
   std::vector<std::vector<float>> h_highpass_;
 
   size_t blocks_since_reset_ = 0;
@@ -142,6 +165,7 @@ class FilterAnalyzer {
   std::vector<int> filter_delays_blocks_;
 
   int min_filter_delay_blocks_ = 0;
+  std::optional<int> echo_path_length_blocks_;
 };
 
 }  // namespace webrtc
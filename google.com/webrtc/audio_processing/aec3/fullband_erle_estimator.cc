@@ -188,4 +188,45 @@ void FullBandErleEstimator::ErleInstantaneous::UpdateQualityEstimate() {
   }
 }
 
+void FullBandErleEstimator::SaveState(StateWriter* writer) const {
+  for (size_t ch = 0; ch < instantaneous_erle_.size(); ++ch) {
+    writer->WriteInt32(hold_counters_instantaneous_erle_[ch]);
+    writer->WriteFloat(erle_time_domain_log2_[ch]);
+    instantaneous_erle_[ch].SaveState(writer);
+  }
+}
+
+void FullBandErleEstimator::LoadState(StateReader* reader) {
+  for (size_t ch = 0; ch < instantaneous_erle_.size(); ++ch) {
+    hold_counters_instantaneous_erle_[ch] = reader->ReadInt32();
+    erle_time_domain_log2_[ch] = reader->ReadFloat();
+    instantaneous_erle_[ch].LoadState(reader);
+  }
+  UpdateQualityEstimates();
+}
+
+void FullBandErleEstimator::ErleInstantaneous::SaveState(
+    StateWriter* writer) const {
+  writer->WriteBool(erle_log2_.has_value());
+  writer->WriteFloat(erle_log2_.value_or(0.f));
+  writer->WriteFloat(inst_quality_estimate_);
+  writer->WriteFloat(max_erle_log2_);
+  writer->WriteFloat(min_erle_log2_);
+  writer->WriteFloat(Y2_acum_);
+  writer->WriteFloat(E2_acum_);
+  writer->WriteInt32(num_points_);
+}
+
+void FullBandErleEstimator::ErleInstantaneous::LoadState(StateReader* reader) {
+  const bool has_erle = reader->ReadBool();
+  const float erle_log2 = reader->ReadFloat();
+  erle_log2_ = has_erle ? std::optional<float>(erle_log2) : std::nullopt;
+  inst_quality_estimate_ = reader->ReadFloat();
+  max_erle_log2_ = reader->ReadFloat();
+  min_erle_log2_ = reader->ReadFloat();
+  Y2_acum_ = reader->ReadFloat();
+  E2_acum_ = reader->ReadFloat();
+  num_points_ = reader->ReadInt32();
+}
+
 }  // namespace webrtc
@@ -18,6 +18,7 @@
 #include "api/array_view.h"
 #include "api/audio/echo_canceller3_config.h"
 #include "audio_processing/aec3/aec3_common.h"
+#include "audio_processing/utility/state_serializer.h"
 #include "audio_processing/logging/apm_data_dumper.h"
 
 namespace webrtc {
@@ -55,6 +56,10 @@ class FullBandErleEstimator {
 
   void Dump(const std::unique_ptr<ApmDataDumper>& data_dumper) const;
 
+  // Saves and restores the estimates.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
  private:
   void UpdateQualityEstimates();
 
@@ -89,6 +94,8 @@ class FullBandErleEstimator {
       return std::nullopt;
     }
     void Dump(const std::unique_ptr<ApmDataDumper>& data_dumper) const;
+    void SaveState(StateWriter* writer) const;
+    void LoadState(StateReader* reader);
 
    private:
     void UpdateMaxMin();
@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <initializer_list>
+#include <numeric>
 #include <optional>
 
 #include "api/array_view.h"
@@ -57,6 +58,21 @@ void UpdateAccumulatedError(
   }
 }
 
+// Returns the energy of the `length` render samples from `start_index` on,
+// wrapping around the end of the circular buffer `x`.
+float RenderEnergy(const webrtc::ArrayView<const float> x,
+                   size_t start_index,
+                   size_t length) {
+  RTC_DCHECK_LE(length, x.size());
+  const size_t first_length = std::min(length, x.size() - start_index);
+  const auto sum_of_squares = [](float a, float b) { return a + b * b; };
+  float energy = std::accumulate(x.begin() + start_index,
+                                 x.begin() + start_index + first_length, 0.f,
+                                 sum_of_squares);
+  return std::accumulate(x.begin(), x.begin() + (length - first_length),
+                         energy, sum_of_squares);
+}
+
 size_t ComputePreEchoLag(const webrtc::ArrayView<const float> accumulated_error,
                          size_t lag,
                          size_t alignment_shift_winner) {
@@ -667,6 +683,21 @@ void MatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
   const float x2_sum_threshold =
       filters_[0].size() * excitation_limit_ * excitation_limit_;
 
+  // The filters span the render samples from the read position on. When their
+  // total energy is below the threshold, so is the energy under each filter,
+  // none of them adapts and there is no lag estimate, so the filtering is
+  // skipped. This is the case while the render signal is inactive. The energy
+  // is halved against rounding differences with the filter cores.
+  const size_t render_span = (filters_.size() - 1) * filter_intra_lag_shift_ +
+                             sub_block_size_ + filters_[0].size() - 1;
+  if (render_span <= render_buffer.buffer.size() &&
+      RenderEnergy(render_buffer.buffer, render_buffer.read, render_span) <=
+          0.5f * x2_sum_threshold) {
+    winner_lag_ = std::nullopt;
+    reported_lag_estimate_ = std::nullopt;
+    return;
+  }
+
   // Compute anchor for the matched filter error.
   float error_sum_anchor = 0.0f;
   for (size_t k = 0; k < y.size(); ++k) {
@@ -705,6 +736,12 @@ void MatchedFilter::Update(const DownsampledRenderBuffer& render_buffer,
             filters_[n], &filters_updated, &error_sum, compute_pre_echo,
             instantaneous_accumulated_error_, scratch_memory_);
         break;
+      case Aec3Optimization::kAvx512:
+        aec3::MatchedFilterCore_AVX512(
+            x_start_index, x2_sum_threshold, smoothing, render_buffer.buffer, y,
+            filters_[n], &filters_updated, &error_sum, compute_pre_echo,
+            instantaneous_accumulated_error_, scratch_memory_);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon:
@@ -73,6 +73,19 @@ void MatchedFilterCore_AVX2(size_t x_start_index,
                             ArrayView<float> accumulated_error,
                             ArrayView<float> scratch_memory);
 
+// Filter core for the matched filter that is optimized for AVX-512.
+void MatchedFilterCore_AVX512(size_t x_start_index,
+                              float x2_sum_threshold,
+                              float smoothing,
+                              ArrayView<const float> x,
+                              ArrayView<const float> y,
+                              ArrayView<float> h,
+                              bool* filters_updated,
+                              float* error_sum,
+                              bool compute_accumulated_error,
+                              ArrayView<float> accumulated_error,
+                              ArrayView<float> scratch_memory);
+
 #endif
 
 // Filter core for the matched filter.
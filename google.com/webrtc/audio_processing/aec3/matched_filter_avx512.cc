@@ -0,0 +1,262 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#if defined(__i386__) || defined(_M_IX86) || defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstddef>
+
+#include "api/array_view.h"
+#include "audio_processing/aec3/matched_filter.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace aec3 {
+
+namespace {
+
+// Returns the mask selecting the `size` first of 16 values.
+__attribute__((target("avx512f")))
+inline __mmask16 TailMask(int size) {
+  return static_cast<__mmask16>((1u << size) - 1);
+}
+
+// Returns the sums of the four groups of four consecutive values in `a`.
+__attribute__((target("avx512f")))
+inline __m128 SumGroupsOfFour(__m512 a) {
+  // Sum within each 128 bit lane, leaving the sum in all of its elements, and
+  // gather the first element of each lane.
+  a = _mm512_add_ps(a, _mm512_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+  a = _mm512_add_ps(a, _mm512_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+  const __m512i first_in_lanes =
+      _mm512_set_epi32(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 12, 8, 4, 0);
+  return _mm512_castps512_ps128(_mm512_permutexvar_ps(first_in_lanes, a));
+}
+
+}  // namespace
+
+__attribute__((target("avx512f")))
+void MatchedFilterCore_AccumulatedError_AVX512(
+    size_t x_start_index,
+    float x2_sum_threshold,
+    float smoothing,
+    ArrayView<const float> x,
+    ArrayView<const float> y,
+    ArrayView<float> h,
+    bool* filters_updated,
+    float* error_sum,
+    ArrayView<float> accumulated_error,
+    ArrayView<float> scratch_memory) {
+  const int h_size = static_cast<int>(h.size());
+  const int x_size = static_cast<int>(x.size());
+  RTC_DCHECK_EQ(0, h_size % 16);
+  std::fill(accumulated_error.begin(), accumulated_error.end(), 0.0f);
+
+  // Process for all samples in the sub-block.
+  for (size_t i = 0; i < y.size(); ++i) {
+    // Apply the matched filter as filter * x, and compute x * x.
+    RTC_DCHECK_GT(x_size, x_start_index);
+    const int chunk1 =
+        std::min(h_size, static_cast<int>(x_size - x_start_index));
+    if (chunk1 != h_size) {
+      const int chunk2 = h_size - chunk1;
+      std::copy(x.begin() + x_start_index, x.end(), scratch_memory.begin());
+      std::copy(x.begin(), x.begin() + chunk2, scratch_memory.begin() + chunk1);
+    }
+    const float* x_p =
+        chunk1 != h_size ? scratch_memory.data() : &x[x_start_index];
+    const float* h_p = &h[0];
+    float* a_p = &accumulated_error[0];
+    __m512 x2_sum_512 = _mm512_setzero_ps();
+    const __m128 y_128 = _mm_set1_ps(y[i]);
+    // The filter output after each group of four taps, broadcast from the last
+    // group.
+    __m128 s_acum_128 = _mm_setzero_ps();
+    const int limit_by_16 = h_size >> 4;
+    for (int k = limit_by_16; k > 0; --k, h_p += 16, x_p += 16, a_p += 4) {
+      const __m512 x_k = _mm512_loadu_ps(x_p);
+      const __m512 h_k = _mm512_loadu_ps(h_p);
+      // Compute and accumulate x * x, and the filter output after each of the
+      // four groups of four taps as a prefix sum of the group sums.
+      x2_sum_512 = _mm512_fmadd_ps(x_k, x_k, x2_sum_512);
+      __m128 s_128 = SumGroupsOfFour(_mm512_mul_ps(h_k, x_k));
+      s_128 = _mm_add_ps(
+          s_128, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(s_128), 4)));
+      s_128 = _mm_add_ps(
+          s_128, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(s_128), 8)));
+      s_128 = _mm_add_ps(s_128, s_acum_128);
+      s_acum_128 = _mm_shuffle_ps(s_128, s_128, _MM_SHUFFLE(3, 3, 3, 3));
+
+      const __m128 e_128 = _mm_sub_ps(s_128, y_128);
+      __m128 acum_error = _mm_loadu_ps(a_p);
+      acum_error = _mm_add_ps(_mm_mul_ps(e_128, e_128), acum_error);
+      _mm_storeu_ps(a_p, acum_error);
+    }
+    const float x2_sum = _mm512_reduce_add_ps(x2_sum_512);
+
+    // Compute the matched filter error.
+    float e = y[i] - _mm_cvtss_f32(s_acum_128);
+    const bool saturation = y[i] >= 32000.f || y[i] <= -32000.f;
+    (*error_sum) += e * e;
+
+    // Update the matched filter estimate in an NLMS manner.
+    if (x2_sum > x2_sum_threshold && !saturation) {
+      RTC_DCHECK_LT(0.f, x2_sum);
+      const float alpha = smoothing * e / x2_sum;
+      const __m512 alpha_512 = _mm512_set1_ps(alpha);
+
+      // filter = filter + smoothing * (y - filter * x) * x / x * x.
+      float* h_p2 = &h[0];
+      const float* x_p2 =
+          chunk1 != h_size ? scratch_memory.data() : &x[x_start_index];
+      for (int k = limit_by_16; k > 0; --k, h_p2 += 16, x_p2 += 16) {
+        __m512 h_k = _mm512_loadu_ps(h_p2);
+        const __m512 x_k = _mm512_loadu_ps(x_p2);
+        // Compute h = h + alpha * x.
+        h_k = _mm512_fmadd_ps(x_k, alpha_512, h_k);
+        _mm512_storeu_ps(h_p2, h_k);
+      }
+      *filters_updated = true;
+    }
+
+    x_start_index = x_start_index > 0 ? x_start_index - 1 : x_size - 1;
+  }
+}
+
+__attribute__((target("avx512f")))
+void MatchedFilterCore_AVX512(size_t x_start_index,
+                              float x2_sum_threshold,
+                              float smoothing,
+                              ArrayView<const float> x,
+                              ArrayView<const float> y,
+                              ArrayView<float> h,
+                              bool* filters_updated,
+                              float* error_sum,
+                              bool compute_accumulated_error,
+                              ArrayView<float> accumulated_error,
+                              ArrayView<float> scratch_memory) {
+  if (compute_accumulated_error) {
+    return MatchedFilterCore_AccumulatedError_AVX512(
+        x_start_index, x2_sum_threshold, smoothing, x, y, h, filters_updated,
+        error_sum, accumulated_error, scratch_memory);
+  }
+  const int h_size = static_cast<int>(h.size());
+  const int x_size = static_cast<int>(x.size());
+  RTC_DCHECK_EQ(0, h_size % 8);
+
+  // Process for all samples in the sub-block.
+  for (size_t i = 0; i < y.size(); ++i) {
+    // Apply the matched filter as filter * x, and compute x * x.
+
+    RTC_DCHECK_GT(x_size, x_start_index);
+    const float* x_p = &x[x_start_index];
+    const float* h_p = &h[0];
+
+    // Initialize values for the accumulation.
+    __m512 s_512 = _mm512_setzero_ps();
+    __m512 s_512_16 = _mm512_setzero_ps();
+    __m512 x2_sum_512 = _mm512_setzero_ps();
+    __m512 x2_sum_512_16 = _mm512_setzero_ps();
+
+    // Compute loop chunk sizes until, and after, the wraparound of the circular
+    // buffer for x.
+    const int chunk1 =
+        std::min(h_size, static_cast<int>(x_size - x_start_index));
+
+    // Perform the loop in two chunks.
+    const int chunk2 = h_size - chunk1;
+    for (int limit : {chunk1, chunk2}) {
+      // Perform 512 bit vector operations.
+      const int limit_by_32 = limit >> 5;
+      for (int k = limit_by_32; k > 0; --k, h_p += 32, x_p += 32) {
+        const __m512 x_k = _mm512_loadu_ps(x_p);
+        const __m512 h_k = _mm512_loadu_ps(h_p);
+        const __m512 x_k_16 = _mm512_loadu_ps(x_p + 16);
+        const __m512 h_k_16 = _mm512_loadu_ps(h_p + 16);
+        // Compute and accumulate x * x and h * x.
+        x2_sum_512 = _mm512_fmadd_ps(x_k, x_k, x2_sum_512);
+        x2_sum_512_16 = _mm512_fmadd_ps(x_k_16, x_k_16, x2_sum_512_16);
+        s_512 = _mm512_fmadd_ps(h_k, x_k, s_512);
+        s_512_16 = _mm512_fmadd_ps(h_k_16, x_k_16, s_512_16);
+      }
+
+      // Perform masked vector operations for any remaining items.
+      for (int remaining = limit - limit_by_32 * 32; remaining > 0;) {
+        const int num_items = std::min(remaining, 16);
+        const __mmask16 mask = TailMask(num_items);
+        const __m512 x_k = _mm512_maskz_loadu_ps(mask, x_p);
+        const __m512 h_k = _mm512_maskz_loadu_ps(mask, h_p);
+        x2_sum_512 = _mm512_fmadd_ps(x_k, x_k, x2_sum_512);
+        s_512 = _mm512_fmadd_ps(h_k, x_k, s_512);
+        remaining -= num_items;
+        h_p += num_items;
+        x_p += num_items;
+      }
+
+      x_p = &x[0];
+    }
+
+    // Sum components together.
+    const float x2_sum =
+        _mm512_reduce_add_ps(_mm512_add_ps(x2_sum_512, x2_sum_512_16));
+    const float s = _mm512_reduce_add_ps(_mm512_add_ps(s_512, s_512_16));
+
+    // Compute the matched filter error.
+    float e = y[i] - s;
+    const bool saturation = y[i] >= 32000.f || y[i] <= -32000.f;
+    (*error_sum) += e * e;
+
+    // Update the matched filter estimate in an NLMS manner.
+    if (x2_sum > x2_sum_threshold && !saturation) {
+      RTC_DCHECK_LT(0.f, x2_sum);
+      const float alpha = smoothing * e / x2_sum;
+      const __m512 alpha_512 = _mm512_set1_ps(alpha);
+
+      // filter = filter + smoothing * (y - filter * x) * x / x * x.
+      float* h_p2 = &h[0];
+      x_p = &x[x_start_index];
+
+      // Perform the loop in two chunks.
+      for (int limit : {chunk1, chunk2}) {
+        // Perform 512 bit vector operations.
+        const int limit_by_16 = limit >> 4;
+        for (int k = limit_by_16; k > 0; --k, h_p2 += 16, x_p += 16) {
+          __m512 h_k = _mm512_loadu_ps(h_p2);
+          const __m512 x_k = _mm512_loadu_ps(x_p);
+          // Compute h = h + alpha * x.
+          h_k = _mm512_fmadd_ps(x_k, alpha_512, h_k);
+          _mm512_storeu_ps(h_p2, h_k);
+        }
+
+        // Perform a masked vector operation for any remaining items.
+        const int remaining = limit - limit_by_16 * 16;
+        if (remaining > 0) {
+          const __mmask16 mask = TailMask(remaining);
+          __m512 h_k = _mm512_maskz_loadu_ps(mask, h_p2);
+          const __m512 x_k = _mm512_maskz_loadu_ps(mask, x_p);
+          h_k = _mm512_fmadd_ps(x_k, alpha_512, h_k);
+          _mm512_mask_storeu_ps(h_p2, mask, h_k);
+          h_p2 += remaining;
+        }
+
+        x_p = &x[0];
+      }
+
+      *filters_updated = true;
+    }
+
+    x_start_index = x_start_index > 0 ? x_start_index - 1 : x_size - 1;
+  }
+}
+
+}  // namespace aec3
+}  // namespace webrtc
+#endif
@@ -0,0 +1,219 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio_processing/aec3/phat_correlator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "audio_processing/aec3/downsampled_render_buffer.h"
+#include "audio_processing/logging/apm_data_dumper.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace {
+
+// Smoothing of the whitened cross-spectrum over hops.
+constexpr float kCrossSpectrumSmoothing = 0.5f;
+// Regularization of the phase transform relative to the mean cross-spectrum
+// magnitude. It keeps bins without render or capture content from
+// contributing noise with the same weight as those with content.
+constexpr float kPhatRegularization = 0.05f;
+// Minimum ratio between the correlation peak and the mean correlation
+// magnitude over the lag range for the peak to be reliable.
+constexpr float kPeakToMeanThreshold = 10.f;
+
+size_t RoundUpToMultiple(size_t value, size_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+// Returns the smallest power of two FFT size that gives a hop of at least half
+// of `history_size`. PFFFT requires real FFT sizes of at least 32.
+size_t ComputeFftSize(size_t history_size) {
+  const size_t min_size = history_size + history_size / 2;
+  size_t fft_size = 32;
+  while (fft_size < min_size) {
+    fft_size *= 2;
+  }
+  return fft_size;
+}
+
+}  // namespace
+
+PhatCorrelator::PhatCorrelator(ApmDataDumper* data_dumper,
+                               size_t sub_block_size,
+                               size_t max_lag,
+                               float excitation_limit)
+    : data_dumper_(data_dumper),
+      sub_block_size_(sub_block_size),
+      max_lag_(max_lag),
+      history_size_(RoundUpToMultiple(max_lag + 1, sub_block_size)),
+      fft_size_(ComputeFftSize(history_size_)),
+      hop_size_(fft_size_ - history_size_),
+      excitation_limit_(excitation_limit),
+      fft_(fft_size_, Pffft::FftType::kReal),
+      render_(fft_size_, 0.f),
+      capture_(hop_size_, 0.f),
+      time_buffer_(fft_.CreateBuffer()),
+      render_spectrum_(fft_.CreateBuffer()),
+      capture_spectrum_(fft_.CreateBuffer()),
+      cross_spectrum_(fft_.CreateBuffer()),
+      smoothed_cross_spectrum_(fft_size_, 0.f) {
+  RTC_DCHECK(data_dumper);
+  RTC_DCHECK_LT(0, sub_block_size_);
+  RTC_DCHECK_EQ(0, hop_size_ % sub_block_size_);
+  RTC_DCHECK(Pffft::IsValidFftSize(fft_size_, Pffft::FftType::kReal));
+}
+
+PhatCorrelator::~PhatCorrelator() = default;
+
+void PhatCorrelator::Reset(bool full_reset) {
+  // The smoothed cross-spectrum is kept on soft resets as it follows changes
+  // in the echo path within a few hops.
+  if (full_reset) {
+    std::fill(render_.begin(), render_.end(), 0.f);
+    std::fill(smoothed_cross_spectrum_.begin(), smoothed_cross_spectrum_.end(),
+              0.f);
+    hop_fill_ = 0;
+    lag_estimate_ = std::nullopt;
+  }
+}
+
+void PhatCorrelator::Update(const DownsampledRenderBuffer& render_buffer,
+                            ArrayView<const float> capture) {
+  RTC_DCHECK_EQ(sub_block_size_, capture.size());
+  RTC_DCHECK_LT(hop_fill_, hop_size_);
+
+  // The render buffer is stored in reverse time order, with the sample
+  // aligned with the last capture sample at the read index.
+  float* render = &render_[history_size_ + hop_fill_];
+  size_t x_index =
+      (render_buffer.read + sub_block_size_ - 1) % render_buffer.buffer.size();
+  for (size_t k = 0; k < sub_block_size_; ++k) {
+    render[k] = render_buffer.buffer[x_index];
+    x_index = x_index > 0 ? x_index - 1 : render_buffer.buffer.size() - 1;
+  }
+  std::copy(capture.begin(), capture.end(), capture_.begin() + hop_fill_);
+
+  hop_fill_ += sub_block_size_;
+  if (hop_fill_ == hop_size_) {
+    ProcessHop();
+    hop_fill_ = 0;
+  }
+}
+
+void PhatCorrelator::ProcessHop() {
+  // Only use hops where the render signal is strong enough to produce echo.
+  const float render_energy = std::inner_product(
+      render_.begin() + history_size_, render_.end(),
+      render_.begin() + history_size_, 0.f);
+  const float capture_energy = std::inner_product(
+      capture_.begin(), capture_.end(), capture_.begin(), 0.f);
+  const bool excited =
+      render_energy > hop_size_ * excitation_limit_ * excitation_limit_ &&
+      capture_energy > 0.f;
+
+  lag_estimate_ = std::nullopt;
+  if (excited) {
+    ArrayView<float> time = time_buffer_->GetView();
+    std::copy(render_.begin(), render_.end(), time.begin());
+    fft_.ForwardTransform(*time_buffer_, render_spectrum_.get(),
+                          /*ordered=*/true);
+    std::copy(capture_.begin(), capture_.end(), time.begin());
+    std::fill(time.begin() + hop_size_, time.end(), 0.f);
+    fft_.ForwardTransform(*time_buffer_, capture_spectrum_.get(),
+                          /*ordered=*/true);
+
+    // Cross-spectrum conj(Y) * X, whose inverse transform at index m is the
+    // correlation between the capture hop and the render signal m samples
+    // into `render_`, i.e. at lag history_size_ - m. In the ordered layout,
+    // the DC and Nyquist bins are the two first, real, values.
+    ArrayView<const float> X = render_spectrum_->GetConstView();
+    ArrayView<const float> Y = capture_spectrum_->GetConstView();
+    ArrayView<float> S = cross_spectrum_->GetView();
+    S[0] = Y[0] * X[0];
+    S[1] = Y[1] * X[1];
+    for (size_t k = 2; k < fft_size_; k += 2) {
+      S[k] = Y[k] * X[k] + Y[k + 1] * X[k + 1];
+      S[k + 1] = Y[k] * X[k + 1] - Y[k + 1] * X[k];
+    }
+
+    // Phase transform: whiten the cross-spectrum so that the correlation peak
+    // does not depend on the spectral shape of the signals.
+    float magnitude_sum = std::fabs(S[0]) + std::fabs(S[1]);
+    for (size_t k = 2; k < fft_size_; k += 2) {
+      magnitude_sum += std::sqrt(S[k] * S[k] + S[k + 1] * S[k + 1]);
+    }
+    const float regularization =
+        kPhatRegularization * magnitude_sum / (fft_size_ / 2 + 1);
+    auto smooth = [&](size_t k, float whitened) {
+      smoothed_cross_spectrum_[k] +=
+          (1.f - kCrossSpectrumSmoothing) *
+          (whitened - smoothed_cross_spectrum_[k]);
+    };
+    smooth(0, S[0] / (std::fabs(S[0]) + regularization));
+    smooth(1, S[1] / (std::fabs(S[1]) + regularization));
+    for (size_t k = 2; k < fft_size_; k += 2) {
+      const float magnitude = std::sqrt(S[k] * S[k] + S[k + 1] * S[k + 1]);
+      const float gain = 1.f / (magnitude + regularization);
+      smooth(k, S[k] * gain);
+      smooth(k + 1, S[k + 1] * gain);
+    }
+
+    std::copy(smoothed_cross_spectrum_.begin(), smoothed_cross_spectrum_.end(),
+              S.begin());
+    fft_.BackwardTransform(*cross_spectrum_, time_buffer_.get(),
+                           /*ordered=*/true);
+
+    // Find the correlation peak over the lag range.
+    ArrayView<const float> r = time_buffer_->GetConstView();
+    const size_t first_index = history_size_ - max_lag_;
+    float peak = 0.f;
+    float magnitude_mean = 0.f;
+    size_t peak_index = history_size_;
+    for (size_t m = first_index; m <= history_size_; ++m) {
+      const float magnitude = std::fabs(r[m]);
+      magnitude_mean += magnitude;
+      if (magnitude > peak) {
+        peak = magnitude;
+        peak_index = m;
+      }
+    }
+    magnitude_mean /= max_lag_ + 1;
+
+    if (peak > kPeakToMeanThreshold * magnitude_mean) {
+      const size_t lag = history_size_ - peak_index;
+      lag_estimate_ = MatchedFilter::LagEstimate(lag, /*pre_echo_lag=*/lag);
+    }
+    data_dumper_->DumpRaw("aec3_phat_correlator_peak_to_mean",
+                          magnitude_mean > 0.f ? peak / magnitude_mean : 0.f);
+  }
+  data_dumper_->DumpRaw("aec3_phat_correlator_lag",
+                        lag_estimate_ ? static_cast<int>(lag_estimate_->lag)
+                                      : -1);
+
+  // Keep the render signal preceding the next hop.
+  std::copy(render_.end() - history_size_, render_.end(), render_.begin());
+}
+
+void PhatCorrelator::LogProperties(size_t shift,
+                                   size_t downsampling_factor) const {
+  constexpr int kFsBy1000 = 16;
+  RTC_LOG(LS_VERBOSE) << "PHAT correlator: lags up to "
+                      << (static_cast<int>(max_lag_ * downsampling_factor) -
+                          static_cast<int>(shift)) /
+                             kFsBy1000
+                      << " ms, fft size: " << fft_size_
+                      << ", hop: " << hop_size_ << " samples.";
+}
+
+}  // namespace webrtc
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_PHAT_CORRELATOR_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_PHAT_CORRELATOR_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "api/array_view.h"
+#include "audio_processing/aec3/matched_filter.h"
+#include "audio_processing/utility/pffft_wrapper.h"
+
+namespace webrtc {
+
+class ApmDataDumper;
+struct DownsampledRenderBuffer;
+
+// Estimates the lag between the downsampled render and capture signals with a
+// generalized cross-correlation with phase transform (GCC-PHAT), as an
+// alternative to the time-domain MatchedFilter.
+//
+// The aligned render and capture signals are collected into hops. For every
+// completed hop, the cross-spectrum between the hop of capture and the render
+// signal covering the hop and the full lag range is computed with one FFT
+// each, whitened, smoothed over hops and transformed back into a
+// cross-correlation whose peak gives the lag. Since the hop grows with the lag
+// range, the cost per sample only grows with the logarithm of the range,
+// whereas that of the matched filters grows linearly.
+class PhatCorrelator {
+ public:
+  PhatCorrelator(ApmDataDumper* data_dumper,
+                 size_t sub_block_size,
+                 size_t max_lag,
+                 float excitation_limit);
+
+  PhatCorrelator() = delete;
+  PhatCorrelator(const PhatCorrelator&) = delete;
+  PhatCorrelator& operator=(const PhatCorrelator&) = delete;
+
+  ~PhatCorrelator();
+
+  // Adds the render sub-block aligned with `capture` and the capture
+  // sub-block to the current hop, and updates the lag estimate when the hop is
+  // complete.
+  void Update(const DownsampledRenderBuffer& render_buffer,
+              ArrayView<const float> capture);
+
+  // Resets the correlator. A full reset also discards the collected signals
+  // and the smoothed cross-spectrum.
+  void Reset(bool full_reset);
+
+  // Returns the lag estimate of the last completed hop, if it was reliable.
+  std::optional<const MatchedFilter::LagEstimate> GetBestLagEstimate() const {
+    return lag_estimate_;
+  }
+
+  // Returns the maximum lag that can be estimated.
+  size_t GetMaxLag() const { return max_lag_; }
+
+  // Log correlator properties.
+  void LogProperties(size_t shift, size_t downsampling_factor) const;
+
+ private:
+  void ProcessHop();
+
+  ApmDataDumper* const data_dumper_;
+  const size_t sub_block_size_;
+  const size_t max_lag_;
+  // Number of render samples preceding the hop that are correlated with it.
+  const size_t history_size_;
+  const size_t fft_size_;
+  const size_t hop_size_;
+  const float excitation_limit_;
+  Pffft fft_;
+  // Render signal, in time order: `history_size_` samples preceding the hop
+  // followed by the hop.
+  std::vector<float> render_;
+  // Capture signal of the hop, in time order.
+  std::vector<float> capture_;
+  size_t hop_fill_ = 0;
+  std::unique_ptr<Pffft::FloatBuffer> time_buffer_;
+  std::unique_ptr<Pffft::FloatBuffer> render_spectrum_;
+  std::unique_ptr<Pffft::FloatBuffer> capture_spectrum_;
+  std::unique_ptr<Pffft::FloatBuffer> cross_spectrum_;
+  // Smoothed whitened cross-spectrum, in the ordered layout of Pffft.
+  std::vector<float> smoothed_cross_spectrum_;
+  std::optional<MatchedFilter::LagEstimate> lag_estimate_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_PHAT_CORRELATOR_H_
@@ -170,4 +170,16 @@ void RefinedFilterUpdateGain::UpdateCurrentConfig() {
   RTC_DCHECK_LE(0, config_change_counter_);
 }
 
+void RefinedFilterUpdateGain::SaveState(StateWriter* writer) const {
+  writer->WriteFloats(H_error_);
+  writer->WriteUint32(poor_excitation_counter_);
+  writer->WriteUint32(call_counter_);
+}
+
+void RefinedFilterUpdateGain::LoadState(StateReader* reader) {
+  reader->ReadFloats(H_error_);
+  poor_excitation_counter_ = reader->ReadUint32();
+  call_counter_ = reader->ReadUint32();
+}
+
 }  // namespace webrtc
@@ -20,6 +20,7 @@
 #include "api/array_view.h"
 #include "api/audio/echo_canceller3_config.h"
 #include "audio_processing/aec3/aec3_common.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 
@@ -69,6 +70,10 @@ class RefinedFilterUpdateGain {
     }
   }
 
+  // Saves and restores the adaptation state.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
  private:
   static std::atomic<int> instance_count_;
   std::unique_ptr<ApmDataDumper> data_dumper_;
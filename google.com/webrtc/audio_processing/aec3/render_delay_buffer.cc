@@ -14,7 +14,6 @@
 
 #include <algorithm>
 #include <atomic>
-#include <cmath>
 #include <memory>
 #include <numeric>
 #include <optional>
@@ -23,18 +22,16 @@
 #include "api/array_view.h"
 #include "api/audio/echo_canceller3_config.h"
 #include "audio_processing/aec3/aec3_common.h"
-#include "audio_processing/aec3/aec3_fft.h"
-#include "audio_processing/aec3/alignment_mixer.h"
 #include "audio_processing/aec3/block_buffer.h"
-#include "audio_processing/aec3/decimator.h"
 #include "audio_processing/aec3/downsampled_render_buffer.h"
 #include "audio_processing/aec3/fft_buffer.h"
-#include "audio_processing/aec3/fft_data.h"
 #include "audio_processing/aec3/render_buffer.h"
+#include "audio_processing/aec3/shared_render_analysis.h"
 #include "audio_processing/aec3/spectrum_buffer.h"
 #include "audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
 namespace {
@@ -43,13 +40,17 @@ class RenderDelayBufferImpl final : public RenderDelayBuffer {
  public:
   RenderDelayBufferImpl(const EchoCanceller3Config& config,
                         int sample_rate_hz,
-                        size_t num_render_channels);
+                        size_t num_render_channels,
+                        SharedRenderAnalysis* shared_render_analysis);
   RenderDelayBufferImpl() = delete;
   ~RenderDelayBufferImpl() override;
 
   void Reset() override;
   BufferingEvent Insert(const Block& block) override;
-  BufferingEvent PrepareCaptureProcessing() override;
+  // The read lock of a shared analysis is held from the one to the other.
+  BufferingEvent PrepareCaptureProcessing() override
+      RTC_NO_THREAD_SAFETY_ANALYSIS;
+  void FinishCaptureProcessing() override RTC_NO_THREAD_SAFETY_ANALYSIS;
   void HandleSkippedCaptureProcessing() override;
   bool AlignFromDelay(size_t delay) override;
   void AlignFromExternalDelay() override;
@@ -70,22 +71,20 @@ class RenderDelayBufferImpl final : public RenderDelayBuffer {
  private:
   static std::atomic<int> instance_count_;
   std::unique_ptr<ApmDataDumper> data_dumper_;
-  const Aec3Optimization optimization_;
   const EchoCanceller3Config config_;
-  const float render_linear_amplitude_gain_;
   const LoggingSeverity delay_log_level_;
   size_t down_sampling_factor_;
   const int sub_block_size_;
+  // Owned by this buffer alone unless shared through a SharedRenderAnalysis.
+  const std::shared_ptr<RenderAnalysis> analysis_;
+  // Number of the render block at the write indices, as counted by analysis_.
+  int64_t render_block_number_ = 0;
   BlockBuffer blocks_;
   SpectrumBuffer spectra_;
   FftBuffer ffts_;
   std::optional<size_t> delay_;
   RenderBuffer echo_remover_buffer_;
   DownsampledRenderBuffer low_rate_;
-  AlignmentMixer render_mixer_;
-  Decimator render_decimator_;
-  const Aec3Fft fft_;
-  std::vector<float> render_ds_;
   const int buffer_headroom_;
   bool last_call_was_render_ = false;
   int num_api_calls_in_a_row_ = 0;
@@ -102,7 +101,6 @@ class RenderDelayBufferImpl final : public RenderDelayBuffer {
   int MapDelayToTotalDelay(size_t delay) const;
   int ComputeDelay() const;
   void ApplyTotalDelay(int delay);
-  void InsertBlock(const Block& block, int previous_write);
   bool DetectActiveRender(ArrayView<const float> x) const;
   bool DetectExcessRenderBlocks();
   void IncrementWriteIndices();
@@ -114,36 +112,36 @@ class RenderDelayBufferImpl final : public RenderDelayBuffer {
 
 std::atomic<int> RenderDelayBufferImpl::instance_count_ = 0;
 
-RenderDelayBufferImpl::RenderDelayBufferImpl(const EchoCanceller3Config& config,
-                                             int sample_rate_hz,
-                                             size_t num_render_channels)
+RenderDelayBufferImpl::RenderDelayBufferImpl(
+    const EchoCanceller3Config& config,
+    int sample_rate_hz,
+    size_t num_render_channels,
+    SharedRenderAnalysis* shared_render_analysis)
     : data_dumper_(new ApmDataDumper(instance_count_.fetch_add(1) + 1)),
-      optimization_(DetectOptimization()),
       config_(config),
-      render_linear_amplitude_gain_(
-          std::pow(10.0f, config_.render_levels.render_power_gain_db / 20.f)),
       delay_log_level_(config_.delay.log_warning_on_delay_changes ? LS_WARNING
                                                                   : LS_VERBOSE),
       down_sampling_factor_(config.delay.down_sampling_factor),
       sub_block_size_(static_cast<int>(down_sampling_factor_ > 0
                                            ? kBlockSize / down_sampling_factor_
                                            : kBlockSize)),
-      blocks_(GetRenderDelayBufferSize(down_sampling_factor_,
-                                       config.delay.num_filters,
-                                       config.filter.refined.length_blocks),
-              NumBandsForRate(sample_rate_hz),
-              num_render_channels),
-      spectra_(blocks_.buffer.size(), num_render_channels),
-      ffts_(blocks_.buffer.size(), num_render_channels),
+      analysis_(shared_render_analysis
+                    ? shared_render_analysis->GetAnalysis(
+                          config, sample_rate_hz, num_render_channels)
+                    : std::make_shared<RenderAnalysis>(config,
+                                                       sample_rate_hz,
+                                                       num_render_channels,
+                                                       /*extra_blocks=*/0)),
+      blocks_(analysis_->blocks()),
+      spectra_(analysis_->spectra()),
+      ffts_(analysis_->ffts()),
       delay_(config_.delay.default_delay),
       echo_remover_buffer_(&blocks_, &spectra_, &ffts_),
-      low_rate_(GetDownSampledBufferSize(down_sampling_factor_,
-                                         config.delay.num_filters)),
-      render_mixer_(num_render_channels, config.delay.render_alignment_mixing),
-      render_decimator_(down_sampling_factor_),
-      fft_(),
-      render_ds_(sub_block_size_, 0.f),
-      buffer_headroom_(config.filter.refined.length_blocks) {
+      low_rate_(analysis_->low_rate()),
+      // The extra blocks of a shared analysis may be overwritten by the
+      // buffers ahead of this one, so they do not add to the maximum delay.
+      buffer_headroom_(config.filter.refined.length_blocks +
+                       static_cast<int>(analysis_->extra_blocks())) {
   RTC_DCHECK_EQ(blocks_.buffer.size(), ffts_.buffer.size());
   RTC_DCHECK_EQ(spectra_.buffer.size(), ffts_.buffer.size());
   for (size_t i = 0; i < blocks_.buffer.size(); ++i) {
@@ -151,6 +149,9 @@ RenderDelayBufferImpl::RenderDelayBufferImpl(const EchoCanceller3Config& config,
     RTC_DCHECK_EQ(spectra_.buffer[i].size(), ffts_.buffer[i].size());
   }
 
+  // Start at the latest block of a shared analysis.
+  render_block_number_ =
+      analysis_->GetWriteIndices(&blocks_, &spectra_, &ffts_, &low_rate_);
   Reset();
 }
 
@@ -215,7 +216,6 @@ RenderDelayBuffer::BufferingEvent RenderDelayBufferImpl::Insert(
   }
 
   // Increase the write indices to where the new blocks should be written.
-  const int previous_write = blocks_.write;
   IncrementWriteIndices();
 
   // Allow overrun and do a reset when render overrun occurrs due to more render
@@ -230,8 +230,19 @@ RenderDelayBuffer::BufferingEvent RenderDelayBufferImpl::Insert(
     render_activity_ = render_activity_counter_ >= 20;
   }
 
-  // Insert the new render block into the specified position.
-  InsertBlock(block, previous_write);
+  // Analyze the new render block into the specified position, unless a
+  // buffer sharing the analysis already did. A buffer that has fallen too far
+  // behind the others catches up with them.
+  ++render_block_number_;
+  if (analysis_->Analyze(block, render_block_number_) ==
+      RenderAnalysis::Result::kOutOfSync) {
+    RTC_LOG_V(delay_log_level_)
+        << "Shared render analysis out of sync at render block "
+        << render_call_counter_;
+    render_block_number_ =
+        analysis_->GetWriteIndices(&blocks_, &spectra_, &ffts_, &low_rate_);
+    event = BufferingEvent::kRenderOverrun;
+  }
 
   if (event != BufferingEvent::kNone) {
     Reset();
@@ -250,6 +261,11 @@ RenderDelayBufferImpl::PrepareCaptureProcessing() {
   RenderDelayBuffer::BufferingEvent event = BufferingEvent::kNone;
   ++capture_call_counter_;
 
+  // Keep the buffers sharing the analysis from overwriting the render data
+  // until the capture processing is done with it.
+  const int64_t latest_block_number = analysis_->BeginRead(
+      render_block_number_, &blocks_, &spectra_, &ffts_, &low_rate_);
+
   if (delay_) {
     if (last_call_was_render_) {
       last_call_was_render_ = false;
@@ -265,7 +281,15 @@ RenderDelayBufferImpl::PrepareCaptureProcessing() {
     }
   }
 
-  if (DetectExcessRenderBlocks()) {
+  if (latest_block_number != render_block_number_) {
+    // The buffers ahead of this one have overwritten render data it may read.
+    RTC_LOG_V(delay_log_level_)
+        << "Shared render analysis out of sync at capture block "
+        << capture_call_counter_;
+    render_block_number_ = latest_block_number;
+    Reset();
+    event = BufferingEvent::kRenderOverrun;
+  } else if (DetectExcessRenderBlocks()) {
     // Too many render blocks compared to capture blocks. Risk of delay ending
     // up before the filter used by the delay estimator.
     RTC_LOG_V(delay_log_level_)
@@ -299,6 +323,10 @@ RenderDelayBufferImpl::PrepareCaptureProcessing() {
   return event;
 }
 
+void RenderDelayBufferImpl::FinishCaptureProcessing() {
+  analysis_->EndRead();
+}
+
 // Sets the delay and returns a bool indicating whether the delay was changed.
 bool RenderDelayBufferImpl::AlignFromDelay(size_t delay) {
   RTC_DCHECK(!config_.delay.use_external_delay_estimator);
@@ -378,51 +406,6 @@ void RenderDelayBufferImpl::AlignFromExternalDelay() {
   }
 }
 
-// Inserts a block into the render buffers.
-void RenderDelayBufferImpl::InsertBlock(const Block& block,
-                                        int previous_write) {
-  auto& b = blocks_;
-  auto& lr = low_rate_;
-  auto& ds = render_ds_;
-  auto& f = ffts_;
-  auto& s = spectra_;
-  const size_t num_bands = b.buffer[b.write].NumBands();
-  const size_t num_render_channels = b.buffer[b.write].NumChannels();
-  RTC_DCHECK_EQ(block.NumBands(), num_bands);
-  RTC_DCHECK_EQ(block.NumChannels(), num_render_channels);
-  for (size_t band = 0; band < num_bands; ++band) {
-    for (size_t ch = 0; ch < num_render_channels; ++ch) {
-      std::copy(block.begin(band, ch), block.end(band, ch),
-                b.buffer[b.write].begin(band, ch));
-    }
-  }
-
-  if (render_linear_amplitude_gain_ != 1.f) {
-    for (size_t band = 0; band < num_bands; ++band) {
-      for (size_t ch = 0; ch < num_render_channels; ++ch) {
-        ArrayView<float, kBlockSize> b_view = b.buffer[b.write].View(band, ch);
-        for (float& sample : b_view) {
-          sample *= render_linear_amplitude_gain_;
-        }
-      }
-    }
-  }
-
-  std::array<float, kBlockSize> downmixed_render;
-  render_mixer_.ProduceOutput(b.buffer[b.write], downmixed_render);
-  render_decimator_.Decimate(downmixed_render, ds);
-  data_dumper_->DumpWav("aec3_render_decimator_output", ds.size(), ds.data(),
-                        16000 / down_sampling_factor_, 1);
-  std::copy(ds.rbegin(), ds.rend(), lr.buffer.begin() + lr.write);
-  for (int channel = 0; channel < b.buffer[b.write].NumChannels(); ++channel) {
-    fft_.PaddedFft(b.buffer[b.write].View(/*band=*/0, channel),
-                   b.buffer[previous_write].View(/*band=*/0, channel),
-                   &f.buffer[f.write][channel]);
-    f.buffer[f.write][channel].Spectrum(optimization_,
-                                        s.buffer[s.write][channel]);
-  }
-}
-
 bool RenderDelayBufferImpl::DetectActiveRender(ArrayView<const float> x) const {
   const float x_energy = std::inner_product(x.begin(), x.end(), x.begin(), 0.f);
   return x_energy > (config_.render_levels.active_render_limit *
@@ -499,7 +482,17 @@ bool RenderDelayBufferImpl::RenderUnderrun() {
 RenderDelayBuffer* RenderDelayBuffer::Create(const EchoCanceller3Config& config,
                                              int sample_rate_hz,
                                              size_t num_render_channels) {
-  return new RenderDelayBufferImpl(config, sample_rate_hz, num_render_channels);
+  return new RenderDelayBufferImpl(config, sample_rate_hz, num_render_channels,
+                                   /*shared_render_analysis=*/nullptr);
+}
+
+RenderDelayBuffer* RenderDelayBuffer::Create(
+    const EchoCanceller3Config& config,
+    int sample_rate_hz,
+    size_t num_render_channels,
+    SharedRenderAnalysis* shared_render_analysis) {
+  return new RenderDelayBufferImpl(config, sample_rate_hz, num_render_channels,
+                                   shared_render_analysis);
 }
 
 }  // namespace webrtc
@@ -19,6 +19,7 @@
 #include "audio_processing/aec3/block.h"
 #include "audio_processing/aec3/downsampled_render_buffer.h"
 #include "audio_processing/aec3/render_buffer.h"
+#include "audio_processing/aec3/shared_render_analysis.h"
 
 namespace webrtc {
 
@@ -36,6 +37,13 @@ class RenderDelayBuffer {
   static RenderDelayBuffer* Create(const EchoCanceller3Config& config,
                                    int sample_rate_hz,
                                    size_t num_render_channels);
+  // As above, but shares the render analysis with the other buffers created
+  // from `shared_render_analysis` when it is non-null.
+  static RenderDelayBuffer* Create(
+      const EchoCanceller3Config& config,
+      int sample_rate_hz,
+      size_t num_render_channels,
+      SharedRenderAnalysis* shared_render_analysis);
   virtual ~RenderDelayBuffer() = default;
 
   // Resets the buffer alignment.
@@ -45,9 +53,13 @@ class RenderDelayBuffer {
   virtual BufferingEvent Insert(const Block& block) = 0;
 
   // Updates the buffers one step based on the specified buffer delay. Returns
-  // an enum indicating whether there was a special event that occurred.
+  // an enum indicating whether there was a special event that occurred. The
+  // render data stays in place until FinishCaptureProcessing is called.
   virtual BufferingEvent PrepareCaptureProcessing() = 0;
 
+  // Called when the capture processing is done reading the render data.
+  virtual void FinishCaptureProcessing() = 0;
+
   // Called on capture blocks where PrepareCaptureProcessing is not called.
   virtual void HandleSkippedCaptureProcessing() = 0;
 
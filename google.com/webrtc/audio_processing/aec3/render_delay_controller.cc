@@ -49,6 +49,9 @@ class RenderDelayControllerImpl final : public RenderDelayController {
       size_t render_delay_buffer_delay,
       const Block& capture) override;
   bool HasClockdrift() const override;
+  std::optional<float> TakeClockdriftRate() override;
+  void SaveState(StateWriter* writer) const override;
+  void LoadState(StateReader* reader) override;
 
  private:
   static std::atomic<int> instance_count_;
@@ -172,6 +175,32 @@ bool RenderDelayControllerImpl::HasClockdrift() const {
   return delay_estimator_.Clockdrift() != ClockdriftDetector::Level::kNone;
 }
 
+std::optional<float> RenderDelayControllerImpl::TakeClockdriftRate() {
+  return delay_estimator_.TakeClockdriftRate();
+}
+
+void RenderDelayControllerImpl::SaveState(StateWriter* writer) const {
+  const bool has_delay = delay_samples_ && delay_;
+  writer->WriteBool(has_delay);
+  writer->WriteUint32(has_delay ? delay_samples_->delay : 0);
+  writer->WriteUint32(has_delay ? delay_->delay : 0);
+}
+
+void RenderDelayControllerImpl::LoadState(StateReader* reader) {
+  const bool has_delay = reader->ReadBool();
+  const size_t delay_samples = reader->ReadUint32();
+  const size_t delay_blocks = reader->ReadUint32();
+  if (!has_delay) {
+    Reset(/*reset_delay_confidence=*/true);
+    return;
+  }
+  delay_samples_ =
+      DelayEstimate(DelayEstimate::Quality::kRefined, delay_samples);
+  delay_ = DelayEstimate(DelayEstimate::Quality::kRefined, delay_blocks);
+  last_delay_estimate_quality_ = DelayEstimate::Quality::kRefined;
+  delay_change_counter_ = 0;
+}
+
 }  // namespace
 
 RenderDelayController* RenderDelayController::Create(
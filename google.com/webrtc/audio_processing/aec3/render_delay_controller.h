@@ -20,6 +20,7 @@
 #include "audio_processing/aec3/downsampled_render_buffer.h"
 #include "audio_processing/aec3/render_delay_buffer.h"
 #include "audio_processing/logging/apm_data_dumper.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 
@@ -46,6 +47,16 @@ class RenderDelayController {
 
   // Returns true if clockdrift has been detected.
   virtual bool HasClockdrift() const = 0;
+
+  // Returns the rate at which the delay has drifted, in samples per sample and
+  // positive when the delay grows, if a drift has been verified since the last
+  // call.
+  virtual std::optional<float> TakeClockdriftRate() = 0;
+
+  // Saves and restores the current delay. A restored delay is treated as
+  // refined so that it is kept until the estimator reports a different one.
+  virtual void SaveState(StateWriter* writer) const = 0;
+  virtual void LoadState(StateReader* reader) = 0;
 };
 }  // namespace webrtc
 
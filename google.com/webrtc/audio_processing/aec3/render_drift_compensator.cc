@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio_processing/aec3/render_drift_compensator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "api/array_view.h"
+#include "audio_processing/aec3/aec3_common.h"
+#include "common_audio/resampler/sinc_resampler.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// Resamples one band of one channel. The resampler requests one block of input
+// at a time, and the input is queued until it does.
+class RenderDriftCompensator::ChannelResampler : public SincResamplerCallback {
+ public:
+  ChannelResampler() : resampler_(1.0, kBlockSize, this) {
+    input_.reserve(3 * kBlockSize);
+  }
+
+  void Push(ArrayView<const float, kBlockSize> x) {
+    input_.insert(input_.end(), x.begin(), x.end());
+  }
+
+  void Resample(ArrayView<float, kBlockSize> y) {
+    resampler_.Resample(kBlockSize, y.data());
+  }
+
+  void SetRatio(double io_sample_rate_ratio) {
+    resampler_.SetRatio(io_sample_rate_ratio);
+  }
+
+  size_t NumBufferedSamples() const { return input_.size(); }
+
+  void Run(size_t frames, float* destination) override {
+    RTC_DCHECK_LE(frames, input_.size());
+    const size_t num_copied = std::min(frames, input_.size());
+    std::copy(input_.begin(), input_.begin() + num_copied, destination);
+    std::fill(destination + num_copied, destination + frames, 0.f);
+    input_.erase(input_.begin(), input_.begin() + num_copied);
+  }
+
+ private:
+  SincResampler resampler_;
+  std::vector<float> input_;
+};
+
+RenderDriftCompensator::RenderDriftCompensator(size_t num_bands,
+                                               size_t num_channels)
+    : resamplers_(num_bands),
+      output_(static_cast<int>(num_bands), static_cast<int>(num_channels)) {
+  for (auto& band_resamplers : resamplers_) {
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      band_resamplers.push_back(std::make_unique<ChannelResampler>());
+    }
+  }
+}
+
+RenderDriftCompensator::~RenderDriftCompensator() = default;
+
+void RenderDriftCompensator::Process(const Block& block,
+                                     FunctionView<void(const Block&)> output) {
+  RTC_DCHECK_EQ(block.NumBands(), resamplers_.size());
+  RTC_DCHECK_EQ(block.NumChannels(), resamplers_[0].size());
+  // Even at a unity ratio the resampler low-passes and delays the signal, so
+  // it is only used once there is a drift to compensate.
+  if (!resampling_) {
+    output(block);
+    return;
+  }
+  for (size_t band = 0; band < resamplers_.size(); ++band) {
+    for (size_t ch = 0; ch < resamplers_[band].size(); ++ch) {
+      resamplers_[band][ch]->Push(block.View(band, ch));
+    }
+  }
+
+  // Within kMaxDrift, one block of output never takes more than two blocks of
+  // input. All resamplers are fed and read alike, so checking one suffices.
+  while (resamplers_[0][0]->NumBufferedSamples() >= 2 * kBlockSize) {
+    for (size_t band = 0; band < resamplers_.size(); ++band) {
+      for (size_t ch = 0; ch < resamplers_[band].size(); ++ch) {
+        resamplers_[band][ch]->Resample(output_.View(band, ch));
+      }
+    }
+    output(output_);
+  }
+}
+
+bool RenderDriftCompensator::AddDrift(float drift) {
+  // The render signal is stretched by 1 + drift; the residual drift is
+  // measured on the already stretched signal.
+  const float total_drift = (1.f + drift_) * (1.f + drift) - 1.f;
+  if (std::fabs(total_drift) > kMaxDrift) {
+    return false;
+  }
+  drift_ = total_drift;
+  resampling_ = true;
+  const double io_sample_rate_ratio = 1.0 / (1.0 + drift_);
+  for (auto& band_resamplers : resamplers_) {
+    for (auto& resampler : band_resamplers) {
+      resampler->SetRatio(io_sample_rate_ratio);
+    }
+  }
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_RENDER_DRIFT_COMPENSATOR_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_RENDER_DRIFT_COMPENSATOR_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "api/function_view.h"
+#include "audio_processing/aec3/block.h"
+
+namespace webrtc {
+
+// Resamples the render signal to the clock of the capture signal. When the
+// render and capture devices run on different clocks, the echo path delay
+// drifts with the rate difference, and the delay estimator and the linear
+// filters have to realign every time the drift has added up to a delay step.
+// The compensator stretches the render signal by the measured drift so that
+// the delay stays put. As the delay is measured on the compensated render
+// signal, each measured drift is a residual that adds to the compensation.
+//
+// Until the first drift is added the render blocks pass through unchanged.
+// From then on the resampling delays the render signal by about two blocks.
+class RenderDriftCompensator {
+ public:
+  // Largest drift, in samples per sample, that is compensated.
+  static constexpr float kMaxDrift = 0.005f;
+
+  RenderDriftCompensator(size_t num_bands, size_t num_channels);
+  ~RenderDriftCompensator();
+
+  RenderDriftCompensator(const RenderDriftCompensator&) = delete;
+  RenderDriftCompensator& operator=(const RenderDriftCompensator&) = delete;
+
+  // Resamples `block` and calls `output` for each compensated block that is
+  // then complete. That is `block` itself until a drift has been added. After
+  // that it is one block per call, except for zero or two when the
+  // compensation has added up to a block, and for two missing blocks while the
+  // resampler fills up after the first drift.
+  void Process(const Block& block, FunctionView<void(const Block&)> output);
+
+  // Adds `drift`, the residual rate in samples per sample at which the delay
+  // grows, to the compensation. Returns false, leaving the compensation
+  // unchanged, if the total would exceed kMaxDrift.
+  bool AddDrift(float drift);
+
+  // Returns the compensated drift in samples per sample.
+  float drift() const { return drift_; }
+
+ private:
+  class ChannelResampler;
+
+  std::vector<std::vector<std::unique_ptr<ChannelResampler>>> resamplers_;
+  Block output_;
+  float drift_ = 0.f;
+  bool resampling_ = false;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_RENDER_DRIFT_COMPENSATOR_H_
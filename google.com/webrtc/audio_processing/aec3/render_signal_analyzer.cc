@@ -13,6 +13,7 @@
 #include <math.h>
 
 #include <algorithm>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -115,10 +116,28 @@ void IdentifyStrongNarrowBandComponent(const RenderBuffer& render_buffer,
   }
 }
 
+// Returns true if the most recent render block is active in any channel.
+bool DetectActiveRender(const RenderBuffer& render_buffer,
+                        float active_render_energy) {
+  const Block& x_latest = render_buffer.GetBlock(0);
+  for (int ch = 0; ch < x_latest.NumChannels(); ++ch) {
+    const float render_energy = std::inner_product(
+        x_latest.begin(/*band=*/0, ch), x_latest.end(/*band=*/0, ch),
+        x_latest.begin(/*band=*/0, ch), 0.f);
+    if (render_energy > active_render_energy) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace
 
 RenderSignalAnalyzer::RenderSignalAnalyzer(const EchoCanceller3Config& config)
-    : strong_peak_freeze_duration_(config.filter.refined.length_blocks) {
+    : strong_peak_freeze_duration_(config.filter.refined.length_blocks),
+      active_render_energy_(config.render_levels.active_render_limit *
+                            config.render_levels.active_render_limit *
+                            kFftLengthBy2) {
   narrow_band_counters_.fill(0);
 }
 RenderSignalAnalyzer::~RenderSignalAnalyzer() = default;
@@ -133,6 +152,12 @@ void RenderSignalAnalyzer::Update(
   // Identify the presence of a strong narrow band.
   IdentifyStrongNarrowBandComponent(render_buffer, strong_peak_freeze_duration_,
                                     &narrow_peak_band_, &narrow_peak_counter_);
+
+  // Track for how long the render signal has been inactive.
+  inactive_render_blocks_ =
+      DetectActiveRender(render_buffer, active_render_energy_)
+          ? 0
+          : inactive_render_blocks_ + 1;
 }
 
 void RenderSignalAnalyzer::MaskRegionsAroundNarrowBands(
@@ -50,8 +50,14 @@ class RenderSignalAnalyzer {
 
   std::optional<int> NarrowPeakBand() const { return narrow_peak_band_; }
 
+  // Returns the number of consecutive blocks, up to the most recent one, for
+  // which the render signal has been inactive.
+  size_t InactiveRenderBlocks() const { return inactive_render_blocks_; }
+
  private:
   const int strong_peak_freeze_duration_;
+  const float active_render_energy_;
+  size_t inactive_render_blocks_ = 0;
   std::array<size_t, kFftLengthBy2 - 1> narrow_band_counters_;
   std::optional<int> narrow_peak_band_;
   size_t narrow_peak_counter_;
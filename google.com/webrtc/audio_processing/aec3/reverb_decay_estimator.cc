@@ -85,7 +85,8 @@ float BlockEnergyAverage(ArrayView<const float> h, int block_index) {
 }  // namespace
 
 ReverbDecayEstimator::ReverbDecayEstimator(const EchoCanceller3Config& config)
-    : filter_length_blocks_(config.filter.refined.length_blocks),
+    : max_filter_length_blocks_(config.filter.refined.length_blocks),
+      filter_length_blocks_(max_filter_length_blocks_),
       filter_length_coefficients_(GetTimeDomainLength(filter_length_blocks_)),
       use_adaptive_echo_decay_(config.ep_strength.default_len < 0.f),
       early_reverb_estimator_(config.filter.refined.length_blocks -
@@ -112,11 +113,23 @@ void ReverbDecayEstimator::Update(ArrayView<const float> filter,
     return;
   }
 
+  // The subtractor shortens the filter to the echo path, so the analysis
+  // follows its current length and restarts when the length changes.
+  if (filter_size != filter_length_coefficients_) {
+    RTC_DCHECK_EQ(0, filter_size % kFftLengthBy2);
+    const int filter_length_blocks = filter_size / kFftLengthBy2;
+    if (filter_length_blocks > kEarlyReverbMinSizeBlocks &&
+        filter_length_blocks <= max_filter_length_blocks_) {
+      filter_length_blocks_ = filter_length_blocks;
+      filter_length_coefficients_ = filter_size;
+    }
+    ResetDecayEstimation();
+    return;
+  }
+
   bool estimation_feasible =
       filter_delay_blocks <=
       filter_length_blocks_ - kEarlyReverbMinSizeBlocks - 1;
-  estimation_feasible =
-      estimation_feasible && filter_size == filter_length_coefficients_;
   estimation_feasible = estimation_feasible && filter_delay_blocks > 0;
   estimation_feasible = estimation_feasible && usable_linear_filter;
 
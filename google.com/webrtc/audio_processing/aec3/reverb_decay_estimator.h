@@ -98,8 +98,9 @@ class ReverbDecayEstimator {
     int n_sections_ = 0;
   };
 
-  const int filter_length_blocks_;
-  const int filter_length_coefficients_;
+  const int max_filter_length_blocks_;
+  int filter_length_blocks_;
+  int filter_length_coefficients_;
   const bool use_adaptive_echo_decay_;
   LateReverbLinearRegressor late_reverb_decay_estimator_;
   EarlyReverbLengthEstimator early_reverb_estimator_;
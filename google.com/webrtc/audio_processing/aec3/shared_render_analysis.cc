@@ -0,0 +1,226 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio_processing/aec3/shared_render_analysis.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "api/array_view.h"
+#include "api/audio/echo_canceller3_config.h"
+#include "audio_processing/aec3/aec3_common.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+bool SameMixing(const EchoCanceller3Config::Delay::AlignmentMixing& a,
+                const EchoCanceller3Config::Delay::AlignmentMixing& b) {
+  return a.downmix == b.downmix &&
+         a.adaptive_selection == b.adaptive_selection &&
+         a.activity_power_threshold == b.activity_power_threshold &&
+         a.prefer_first_two_channels == b.prefer_first_two_channels;
+}
+
+}  // namespace
+
+std::atomic<int> RenderAnalysis::instance_count_ = 0;
+
+RenderAnalysis::RenderAnalysis(const EchoCanceller3Config& config,
+                               int sample_rate_hz,
+                               size_t num_render_channels,
+                               size_t extra_blocks)
+    : data_dumper_(new ApmDataDumper(instance_count_.fetch_add(1) + 1)),
+      optimization_(DetectOptimization()),
+      config_(config),
+      sample_rate_hz_(sample_rate_hz),
+      num_render_channels_(num_render_channels),
+      extra_blocks_(extra_blocks),
+      render_linear_amplitude_gain_(
+          std::pow(10.0f, config_.render_levels.render_power_gain_db / 20.f)),
+      down_sampling_factor_(config.delay.down_sampling_factor),
+      sub_block_size_(static_cast<int>(down_sampling_factor_ > 0
+                                           ? kBlockSize / down_sampling_factor_
+                                           : kBlockSize)),
+      fft_(),
+      blocks_(GetRenderDelayBufferSize(down_sampling_factor_,
+                                       config.delay.num_filters,
+                                       config.filter.refined.length_blocks) +
+                  extra_blocks,
+              NumBandsForRate(sample_rate_hz),
+              num_render_channels),
+      spectra_(blocks_.buffer.size(), num_render_channels),
+      ffts_(blocks_.buffer.size(), num_render_channels),
+      low_rate_(GetDownSampledBufferSize(down_sampling_factor_,
+                                         config.delay.num_filters) +
+                extra_blocks * sub_block_size_),
+      render_mixer_(num_render_channels, config.delay.render_alignment_mixing),
+      render_decimator_(down_sampling_factor_),
+      render_ds_(sub_block_size_, 0.f) {
+  RTC_DCHECK_EQ(blocks_.buffer.size(), ffts_.buffer.size());
+  RTC_DCHECK_EQ(spectra_.buffer.size(), ffts_.buffer.size());
+}
+
+RenderAnalysis::~RenderAnalysis() = default;
+
+bool RenderAnalysis::Matches(const EchoCanceller3Config& config,
+                             int sample_rate_hz,
+                             size_t num_render_channels) const {
+  return sample_rate_hz == sample_rate_hz_ &&
+         num_render_channels == num_render_channels_ &&
+         config.delay.down_sampling_factor == down_sampling_factor_ &&
+         config.delay.num_filters == config_.delay.num_filters &&
+         config.filter.refined.length_blocks ==
+             config_.filter.refined.length_blocks &&
+         config.render_levels.render_power_gain_db ==
+             config_.render_levels.render_power_gain_db &&
+         SameMixing(config.delay.render_alignment_mixing,
+                    config_.delay.render_alignment_mixing);
+}
+
+RenderAnalysis::Result RenderAnalysis::Analyze(const Block& block,
+                                               int64_t block_number) {
+  absl::MutexLock lock(mutex_);
+  if (block_number <= num_analyzed_blocks_) {
+    // The blocks analyzed since have overwritten the oldest ones, which must
+    // not be among those the caller still reads.
+    return num_analyzed_blocks_ - block_number <=
+                   static_cast<int64_t>(extra_blocks_)
+               ? Result::kAlreadyAnalyzed
+               : Result::kOutOfSync;
+  }
+  if (block_number != num_analyzed_blocks_ + 1) {
+    return Result::kOutOfSync;
+  }
+
+  // Increase the write indices to where the new block should be written.
+  const int previous_write = blocks_.write;
+  low_rate_.UpdateWriteIndex(-sub_block_size_);
+  blocks_.IncWriteIndex();
+  spectra_.DecWriteIndex();
+  ffts_.DecWriteIndex();
+
+  auto& b = blocks_;
+  auto& lr = low_rate_;
+  auto& ds = render_ds_;
+  auto& f = ffts_;
+  auto& s = spectra_;
+  const size_t num_bands = b.buffer[b.write].NumBands();
+  RTC_DCHECK_EQ(block.NumBands(), num_bands);
+  RTC_DCHECK_EQ(block.NumChannels(), num_render_channels_);
+  for (size_t band = 0; band < num_bands; ++band) {
+    for (size_t ch = 0; ch < num_render_channels_; ++ch) {
+      std::copy(block.begin(band, ch), block.end(band, ch),
+                b.buffer[b.write].begin(band, ch));
+    }
+  }
+
+  if (render_linear_amplitude_gain_ != 1.f) {
+    for (size_t band = 0; band < num_bands; ++band) {
+      for (size_t ch = 0; ch < num_render_channels_; ++ch) {
+        ArrayView<float, kBlockSize> b_view = b.buffer[b.write].View(band, ch);
+        for (float& sample : b_view) {
+          sample *= render_linear_amplitude_gain_;
+        }
+      }
+    }
+  }
+
+  std::array<float, kBlockSize> downmixed_render;
+  render_mixer_.ProduceOutput(b.buffer[b.write], downmixed_render);
+  render_decimator_.Decimate(downmixed_render, ds);
+  data_dumper_->DumpWav("aec3_render_decimator_output", ds.size(), ds.data(),
+                        16000 / down_sampling_factor_, 1);
+  std::copy(ds.rbegin(), ds.rend(), lr.buffer.begin() + lr.write);
+  for (int channel = 0; channel < b.buffer[b.write].NumChannels(); ++channel) {
+    fft_.PaddedFft(b.buffer[b.write].View(/*band=*/0, channel),
+                   b.buffer[previous_write].View(/*band=*/0, channel),
+                   &f.buffer[f.write][channel]);
+    f.buffer[f.write][channel].Spectrum(optimization_,
+                                        s.buffer[s.write][channel]);
+  }
+
+  num_analyzed_blocks_ = block_number;
+  return Result::kAnalyzed;
+}
+
+int64_t RenderAnalysis::GetWriteIndices(BlockBuffer* blocks,
+                                        SpectrumBuffer* spectra,
+                                        FftBuffer* ffts,
+                                        DownsampledRenderBuffer* low_rate) {
+  absl::ReaderMutexLock lock(mutex_);
+  return SetWriteIndices(blocks, spectra, ffts, low_rate);
+}
+
+int64_t RenderAnalysis::BeginRead(int64_t block_number,
+                                  BlockBuffer* blocks,
+                                  SpectrumBuffer* spectra,
+                                  FftBuffer* ffts,
+                                  DownsampledRenderBuffer* low_rate) {
+  mutex_.lock_shared();
+  RTC_DCHECK_LE(block_number, num_analyzed_blocks_);
+  // The buffers hold extra_blocks_ blocks more than a reader needs, so one
+  // that far behind the latest block still finds all of its data.
+  if (num_analyzed_blocks_ - block_number <=
+      static_cast<int64_t>(extra_blocks_)) {
+    return block_number;
+  }
+  return SetWriteIndices(blocks, spectra, ffts, low_rate);
+}
+
+void RenderAnalysis::EndRead() {
+  mutex_.unlock_shared();
+}
+
+int64_t RenderAnalysis::SetWriteIndices(BlockBuffer* blocks,
+                                        SpectrumBuffer* spectra,
+                                        FftBuffer* ffts,
+                                        DownsampledRenderBuffer* low_rate) {
+  blocks->write = blocks_.write;
+  spectra->write = spectra_.write;
+  ffts->write = ffts_.write;
+  low_rate->write = low_rate_.write;
+  return num_analyzed_blocks_;
+}
+
+SharedRenderAnalysis::SharedRenderAnalysis() = default;
+
+SharedRenderAnalysis::~SharedRenderAnalysis() = default;
+
+std::shared_ptr<RenderAnalysis> SharedRenderAnalysis::GetAnalysis(
+    const EchoCanceller3Config& config,
+    int sample_rate_hz,
+    size_t num_render_channels) {
+  MutexLock lock(&mutex_);
+  analyses_.erase(
+      std::remove_if(analyses_.begin(), analyses_.end(),
+                     [](const std::weak_ptr<RenderAnalysis>& analysis) {
+                       return analysis.expired();
+                     }),
+      analyses_.end());
+  for (const std::weak_ptr<RenderAnalysis>& weak_analysis : analyses_) {
+    std::shared_ptr<RenderAnalysis> analysis = weak_analysis.lock();
+    if (analysis &&
+        analysis->Matches(config, sample_rate_hz, num_render_channels)) {
+      return analysis;
+    }
+  }
+  auto analysis = std::make_shared<RenderAnalysis>(
+      config, sample_rate_hz, num_render_channels, kSharedRenderMaxSkewBlocks);
+  analyses_.push_back(analysis);
+  return analysis;
+}
+
+}  // namespace webrtc
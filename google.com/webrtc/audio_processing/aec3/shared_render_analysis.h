@@ -0,0 +1,170 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_SHARED_RENDER_ANALYSIS_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_SHARED_RENDER_ANALYSIS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "api/audio/echo_canceller3_config.h"
+#include "audio_processing/aec3/aec3_common.h"
+#include "audio_processing/aec3/aec3_fft.h"
+#include "audio_processing/aec3/alignment_mixer.h"
+#include "audio_processing/aec3/block.h"
+#include "audio_processing/aec3/block_buffer.h"
+#include "audio_processing/aec3/decimator.h"
+#include "audio_processing/aec3/downsampled_render_buffer.h"
+#include "audio_processing/aec3/fft_buffer.h"
+#include "audio_processing/aec3/spectrum_buffer.h"
+#include "audio_processing/logging/apm_data_dumper.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Number of render blocks that the echo cancellers sharing a render analysis
+// may be apart. The shared buffers are this much longer than the private ones.
+constexpr size_t kSharedRenderMaxSkewBlocks = 16;
+
+// Analyzes the render blocks for a RenderDelayBuffer: applies the render gain,
+// decimates the downmixed signal for the delay estimator and computes the FFTs
+// and spectra for the echo remover. The results are stored in circular buffers
+// that each RenderDelayBuffer reads through its own indices, so that several
+// of them can share one analysis. Analyze() waits for the RenderDelayBuffers
+// reading the buffers between BeginRead() and EndRead() to finish.
+class RenderAnalysis {
+ public:
+  enum class Result { kAnalyzed, kAlreadyAnalyzed, kOutOfSync };
+
+  // `extra_blocks` lengthens the buffers beyond what the config requires.
+  RenderAnalysis(const EchoCanceller3Config& config,
+                 int sample_rate_hz,
+                 size_t num_render_channels,
+                 size_t extra_blocks);
+  ~RenderAnalysis();
+
+  RenderAnalysis(const RenderAnalysis&) = delete;
+  RenderAnalysis& operator=(const RenderAnalysis&) = delete;
+
+  // Returns whether the analysis is the one a RenderDelayBuffer with these
+  // parameters would compute.
+  bool Matches(const EchoCanceller3Config& config,
+               int sample_rate_hz,
+               size_t num_render_channels) const;
+
+  // Analyzes `block` as render block number `block_number`, counted from 1,
+  // unless that block has already been analyzed. Returns kOutOfSync without
+  // doing anything if `block_number` is too far behind the latest analyzed
+  // block for its results to still be in the buffers.
+  Result Analyze(const Block& block, int64_t block_number);
+
+  // Returns how many blocks longer than the config requires the buffers are.
+  size_t extra_blocks() const { return extra_blocks_; }
+
+  // Sets the write indices to the position of the latest analyzed block and
+  // returns its number.
+  int64_t GetWriteIndices(BlockBuffer* blocks,
+                          SpectrumBuffer* spectra,
+                          FftBuffer* ffts,
+                          DownsampledRenderBuffer* low_rate);
+
+  // Keeps Analyze() from overwriting the stored data until EndRead(), for a
+  // reader whose write indices are at render block `block_number`. Returns
+  // `block_number` if the data that reader may read is still in place.
+  // Otherwise the blocks analyzed since have overwritten some of it: sets the
+  // write indices as GetWriteIndices() does and returns the latest number.
+  int64_t BeginRead(int64_t block_number,
+                    BlockBuffer* blocks,
+                    SpectrumBuffer* spectra,
+                    FftBuffer* ffts,
+                    DownsampledRenderBuffer* low_rate)
+      RTC_SHARED_LOCK_FUNCTION(mutex_);
+  void EndRead() RTC_UNLOCK_FUNCTION(mutex_);
+
+  // The stored data, to create buffers with their own indices from.
+  std::vector<Block>* blocks() { return &blocks_.buffer; }
+  std::vector<std::vector<std::array<float, kFftLengthBy2Plus1>>>* spectra() {
+    return &spectra_.buffer;
+  }
+  std::vector<std::vector<FftData>>* ffts() { return &ffts_.buffer; }
+  std::vector<float>* low_rate() { return &low_rate_.buffer; }
+
+ private:
+  static std::atomic<int> instance_count_;
+  std::unique_ptr<ApmDataDumper> data_dumper_;
+  const Aec3Optimization optimization_;
+  const EchoCanceller3Config config_;
+  const int sample_rate_hz_;
+  const size_t num_render_channels_;
+  const size_t extra_blocks_;
+  const float render_linear_amplitude_gain_;
+  const size_t down_sampling_factor_;
+  const int sub_block_size_;
+  const Aec3Fft fft_;
+  // Held exclusively while analyzing and shared while reading.
+  absl::Mutex mutex_;
+  BlockBuffer blocks_;
+  SpectrumBuffer spectra_;
+  FftBuffer ffts_;
+  DownsampledRenderBuffer low_rate_;
+  AlignmentMixer render_mixer_ RTC_GUARDED_BY(mutex_);
+  Decimator render_decimator_ RTC_GUARDED_BY(mutex_);
+  std::vector<float> render_ds_ RTC_GUARDED_BY(mutex_);
+  int64_t num_analyzed_blocks_ RTC_GUARDED_BY(mutex_) = 0;
+
+  int64_t SetWriteIndices(BlockBuffer* blocks,
+                          SpectrumBuffer* spectra,
+                          FftBuffer* ffts,
+                          DownsampledRenderBuffer* low_rate)
+      RTC_SHARED_LOCKS_REQUIRED(mutex_);
+};
+
+// Render analysis shared by echo cancellers that are fed the same render
+// signal, for instance one per microphone beam of a conference room device.
+// The first of them to buffer a render block analyzes it; the others only
+// advance their indices. This saves all but one copy of the render
+// decimation, FFTs and spectra, and of the buffers holding them.
+//
+// The echo cancellers may run on different threads, but must stay within
+// kSharedRenderMaxSkewBlocks render blocks of each other. One that falls
+// further behind, when buffering render or when starting to process capture,
+// catches up and resets its delay alignment, as on a render overrun. Echo
+// cancellers whose render configuration (buffer sizes, render gain and
+// mixing, channels, rate) differ get separate analyses.
+class SharedRenderAnalysis {
+ public:
+  SharedRenderAnalysis();
+  ~SharedRenderAnalysis();
+
+  SharedRenderAnalysis(const SharedRenderAnalysis&) = delete;
+  SharedRenderAnalysis& operator=(const SharedRenderAnalysis&) = delete;
+
+  // Returns the analysis for a RenderDelayBuffer with these parameters,
+  // creating it if no live RenderDelayBuffer uses a matching one.
+  std::shared_ptr<RenderAnalysis> GetAnalysis(
+      const EchoCanceller3Config& config,
+      int sample_rate_hz,
+      size_t num_render_channels);
+
+ private:
+  Mutex mutex_;
+  std::vector<std::weak_ptr<RenderAnalysis>> analyses_ RTC_GUARDED_BY(mutex_);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_SHARED_RENDER_ANALYSIS_H_
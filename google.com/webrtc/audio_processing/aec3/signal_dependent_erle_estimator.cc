@@ -413,4 +413,24 @@ void SignalDependentErleEstimator::ComputeActiveFilterSections() {
     }
   }
 }
+void SignalDependentErleEstimator::SaveState(StateWriter* writer) const {
+  for (size_t ch = 0; ch < erle_.size(); ++ch) {
+    writer->WriteFloats(erle_[ch]);
+    writer->WriteFloats(erle_onset_compensated_[ch]);
+    for (const auto& correction_factors : correction_factors_[ch]) {
+      writer->WriteFloats(correction_factors);
+    }
+  }
+}
+
+void SignalDependentErleEstimator::LoadState(StateReader* reader) {
+  for (size_t ch = 0; ch < erle_.size(); ++ch) {
+    reader->ReadFloats(erle_[ch]);
+    reader->ReadFloats(erle_onset_compensated_[ch]);
+    for (auto& correction_factors : correction_factors_[ch]) {
+      reader->ReadFloats(correction_factors);
+    }
+  }
+}
+
 }  // namespace webrtc
@@ -17,6 +17,7 @@
 #include "api/array_view.h"
 #include "api/audio/echo_canceller3_config.h"
 #include "audio_processing/aec3/aec3_common.h"
+#include "audio_processing/utility/state_serializer.h"
 #include "audio_processing/aec3/render_buffer.h"
 #include "audio_processing/logging/apm_data_dumper.h"
 
@@ -59,6 +60,10 @@ class SignalDependentErleEstimator {
 
   void Dump(const std::unique_ptr<ApmDataDumper>& data_dumper) const;
 
+  // Saves and restores the estimates and correction factors.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
   static constexpr size_t kSubbands = 6;
 
  private:
@@ -16,8 +16,10 @@ namespace webrtc {
 
 SpectrumBuffer::SpectrumBuffer(size_t size, size_t num_channels)
     : size(static_cast<int>(size)),
-      buffer(size,
-             std::vector<std::array<float, kFftLengthBy2Plus1>>(num_channels)) {
+      buffer(owned_buffer_),
+      owned_buffer_(
+          size,
+          std::vector<std::array<float, kFftLengthBy2Plus1>>(num_channels)) {
   for (auto& channel : buffer) {
     for (auto& c : channel) {
       std::fill(c.begin(), c.end(), 0.f);
@@ -25,6 +27,11 @@ SpectrumBuffer::SpectrumBuffer(size_t size, size_t num_channels)
   }
 }
 
+SpectrumBuffer::SpectrumBuffer(
+    std::vector<std::vector<std::array<float, kFftLengthBy2Plus1>>>*
+        shared_buffer)
+    : size(static_cast<int>(shared_buffer->size())), buffer(*shared_buffer) {}
+
 SpectrumBuffer::~SpectrumBuffer() = default;
 
 }  // namespace webrtc
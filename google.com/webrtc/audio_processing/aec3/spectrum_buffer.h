@@ -25,6 +25,13 @@ namespace webrtc {
 // together with the read and write indices.
 struct SpectrumBuffer {
   SpectrumBuffer(size_t size, size_t num_channels);
+  // Creates a buffer with its own read and write indices over spectra owned
+  // elsewhere, which must outlive it.
+  explicit SpectrumBuffer(
+      std::vector<std::vector<std::array<float, kFftLengthBy2Plus1>>>*
+          shared_buffer);
+  SpectrumBuffer(const SpectrumBuffer&) = delete;
+  SpectrumBuffer& operator=(const SpectrumBuffer&) = delete;
   ~SpectrumBuffer();
 
   int IncIndex(int index) const {
@@ -52,9 +59,13 @@ struct SpectrumBuffer {
   void DecReadIndex() { read = DecIndex(read); }
 
   const int size;
-  std::vector<std::vector<std::array<float, kFftLengthBy2Plus1>>> buffer;
+  std::vector<std::vector<std::array<float, kFftLengthBy2Plus1>>>& buffer;
   int write = 0;
   int read = 0;
+
+ private:
+  std::vector<std::vector<std::array<float, kFftLengthBy2Plus1>>>
+      owned_buffer_;
 };
 
 }  // namespace webrtc
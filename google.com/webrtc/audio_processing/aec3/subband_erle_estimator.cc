@@ -250,4 +250,31 @@ void SubbandErleEstimator::UpdateAccumulatedSpectra(
   }
 }
 
+void SubbandErleEstimator::SaveState(StateWriter* writer) const {
+  for (size_t ch = 0; ch < erle_.size(); ++ch) {
+    writer->WriteFloats(erle_[ch]);
+    writer->WriteFloats(erle_onset_compensated_[ch]);
+    writer->WriteFloats(erle_unbounded_[ch]);
+    writer->WriteFloats(erle_during_onsets_[ch]);
+    for (size_t k = 0; k < kFftLengthBy2Plus1; ++k) {
+      writer->WriteBool(coming_onset_[ch][k]);
+      writer->WriteInt32(hold_counters_[ch][k]);
+    }
+  }
+}
+
+void SubbandErleEstimator::LoadState(StateReader* reader) {
+  for (size_t ch = 0; ch < erle_.size(); ++ch) {
+    reader->ReadFloats(erle_[ch]);
+    reader->ReadFloats(erle_onset_compensated_[ch]);
+    reader->ReadFloats(erle_unbounded_[ch]);
+    reader->ReadFloats(erle_during_onsets_[ch]);
+    for (size_t k = 0; k < kFftLengthBy2Plus1; ++k) {
+      coming_onset_[ch][k] = reader->ReadBool();
+      hold_counters_[ch][k] = reader->ReadInt32();
+    }
+  }
+  ResetAccumulatedSpectra();
+}
+
 }  // namespace webrtc
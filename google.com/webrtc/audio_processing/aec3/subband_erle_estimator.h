@@ -21,6 +21,7 @@
 #include "api/audio/echo_canceller3_config.h"
 #include "api/environment/environment.h"
 #include "audio_processing/aec3/aec3_common.h"
+#include "audio_processing/utility/state_serializer.h"
 #include "audio_processing/logging/apm_data_dumper.h"
 
 namespace webrtc {
@@ -62,6 +63,10 @@ class SubbandErleEstimator {
 
   void Dump(const std::unique_ptr<ApmDataDumper>& data_dumper) const;
 
+  // Saves and restores the estimates.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
  private:
   struct AccumulatedSpectra {
     explicit AccumulatedSpectra(size_t num_capture_channels)
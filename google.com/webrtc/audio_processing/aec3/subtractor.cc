@@ -11,6 +11,7 @@
 #include "audio_processing/aec3/subtractor.h"
 
 #include <algorithm>
+#include <optional>
 #include <utility>
 
 #include "api/array_view.h"
@@ -61,6 +62,15 @@ void ScaleFilterOutput(ArrayView<const float> y,
   }
 }
 
+// Number of blocks beyond the measured echo path length that the filters are
+// kept to allow the echo path to grow, and the minimum adapted length. The
+// reverb decay estimator needs the first 3 blocks and a 6 block section.
+constexpr size_t kAdaptiveLengthMarginBlocks = 3;
+constexpr size_t kMinAdaptiveLengthBlocks = 9;
+// Minimum reduction of the filter length for the filters to be shortened, to
+// avoid toggling between lengths.
+constexpr size_t kAdaptiveLengthHysteresisBlocks = 2;
+
 }  // namespace
 
 Subtractor::Subtractor(const Environment& env,
@@ -68,12 +78,14 @@ Subtractor::Subtractor(const Environment& env,
                        size_t num_render_channels,
                        size_t num_capture_channels,
                        ApmDataDumper* data_dumper,
-                       Aec3Optimization optimization)
+                       Aec3Optimization optimization,
+                       ChannelWorkerPool* channel_workers)
     : fft_(),
       data_dumper_(data_dumper),
       optimization_(optimization),
       config_(config),
       num_capture_channels_(num_capture_channels),
+      channel_workers_(channel_workers),
       use_coarse_filter_reset_hangover_(
           UseCoarseFilterResetHangover(env.field_trials())),
       refined_filters_(num_capture_channels_),
@@ -153,6 +165,7 @@ void Subtractor::HandleEchoPathChange(
       coarse_filter_[ch]->SetSizePartitions(
           config_.filter.coarse_initial.length_blocks, true);
     }
+    adapted_length_blocks_ = std::nullopt;
   };
 
   if (echo_path_variability.delay_change !=
@@ -176,6 +189,115 @@ void Subtractor::ExitInitialState() {
     coarse_filter_[ch]->SetSizePartitions(config_.filter.coarse.length_blocks,
                                           false);
   }
+  adapted_length_blocks_ = std::nullopt;
+}
+
+void Subtractor::AdaptFilterLengths(const AecState& aec_state) {
+  // The filter lengths of the initial state are left as configured.
+  if (aec_state.InitialStateActive()) {
+    return;
+  }
+
+  const size_t max_length_blocks = config_.filter.refined.length_blocks;
+  size_t length_blocks = max_length_blocks;
+  const std::optional<int> echo_path_length_blocks =
+      aec_state.EchoPathLengthBlocks();
+  if (aec_state.UsableLinearEstimate() && echo_path_length_blocks) {
+    length_blocks = std::clamp(
+        static_cast<size_t>(*echo_path_length_blocks) +
+            kAdaptiveLengthMarginBlocks,
+        std::min(kMinAdaptiveLengthBlocks, max_length_blocks),
+        max_length_blocks);
+  }
+
+  // Lengthen the filters at once, as echo beyond them is not cancelled, while
+  // shortening them gradually.
+  const size_t current_length_blocks =
+      adapted_length_blocks_.value_or(max_length_blocks);
+  if (length_blocks > current_length_blocks) {
+    SetFilterLengths(length_blocks, /*immediate_effect=*/true);
+  } else if (length_blocks + kAdaptiveLengthHysteresisBlocks <=
+             current_length_blocks) {
+    SetFilterLengths(length_blocks, /*immediate_effect=*/false);
+  } else {
+    return;
+  }
+
+  adapted_length_blocks_ = length_blocks < max_length_blocks
+                               ? std::optional<size_t>(length_blocks)
+                               : std::nullopt;
+}
+
+void Subtractor::SetFilterLengths(size_t length_blocks, bool immediate_effect) {
+  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+    refined_filters_[ch]->SetSizePartitions(
+        std::min(length_blocks, config_.filter.refined.length_blocks),
+        immediate_effect);
+    coarse_filter_[ch]->SetSizePartitions(
+        std::min(length_blocks, config_.filter.coarse.length_blocks),
+        immediate_effect);
+  }
+}
+
+size_t Subtractor::MaxImpulseResponseSize() const {
+  return GetTimeDomainLength(
+      std::max(config_.filter.refined_initial.length_blocks,
+               config_.filter.refined.length_blocks));
+}
+
+void Subtractor::SaveState(StateWriter* writer) const {
+  const size_t max_impulse_response_size = MaxImpulseResponseSize();
+  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+    refined_filters_[ch]->SaveState(writer);
+    coarse_filter_[ch]->SaveState(writer);
+    refined_gains_[ch]->SaveState(writer);
+    coarse_gains_[ch]->SaveState(writer);
+    // The impulse response is trimmed to the current filter size, so it is
+    // padded to the maximum size to keep the layout fixed.
+    const std::vector<float>& impulse_response = refined_impulse_responses_[ch];
+    writer->WriteUint32(impulse_response.size());
+    writer->WriteFloats(impulse_response);
+    for (size_t k = impulse_response.size(); k < max_impulse_response_size;
+         ++k) {
+      writer->WriteFloat(0.f);
+    }
+  }
+}
+
+void Subtractor::LoadState(StateReader* reader, bool initial_state) {
+  const size_t max_impulse_response_size = MaxImpulseResponseSize();
+  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+    refined_gains_[ch]->SetConfig(initial_state
+                                      ? config_.filter.refined_initial
+                                      : config_.filter.refined,
+                                  true);
+    coarse_gains_[ch]->SetConfig(
+        initial_state ? config_.filter.coarse_initial : config_.filter.coarse,
+        true);
+    refined_filters_[ch]->LoadState(reader);
+    coarse_filter_[ch]->LoadState(reader);
+    refined_gains_[ch]->LoadState(reader);
+    coarse_gains_[ch]->LoadState(reader);
+    std::vector<float>& impulse_response = refined_impulse_responses_[ch];
+    const size_t impulse_response_size = reader->ReadUint32();
+    if (impulse_response_size > max_impulse_response_size) {
+      reader->Invalidate();
+      return;
+    }
+    impulse_response.resize(impulse_response_size);
+    reader->ReadFloats(impulse_response);
+    for (size_t k = impulse_response_size; k < max_impulse_response_size;
+         ++k) {
+      reader->ReadFloat();
+    }
+    poor_coarse_filter_counters_[ch] = 0;
+    coarse_filter_reset_hangover_[ch] = 0;
+  }
+  const size_t length_blocks = refined_filters_[0]->SizePartitions();
+  adapted_length_blocks_ =
+      !initial_state && length_blocks < config_.filter.refined.length_blocks
+          ? std::optional<size_t>(length_blocks)
+          : std::nullopt;
 }
 
 void Subtractor::Process(const RenderBuffer& render_buffer,
@@ -185,6 +307,10 @@ void Subtractor::Process(const RenderBuffer& render_buffer,
                          ArrayView<SubtractorOutput> outputs) {
   RTC_DCHECK_EQ(num_capture_channels_, capture.NumChannels());
 
+  if (config_.filter.adaptive_length) {
+    AdaptFilterLengths(aec_state);
+  }
+
   // Compute the render powers.
   const bool same_filter_sizes = refined_filters_[0]->SizePartitions() ==
                                  coarse_filter_[0]->SizePartitions();
@@ -205,8 +331,9 @@ void Subtractor::Process(const RenderBuffer& render_buffer,
                                &X2_coarse);
   }
 
-  // Process all capture channels
-  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+  // Process all capture channels. Each only touches its own filters, gains
+  // and output.
+  ForEachChannel(channel_workers_, num_capture_channels_, [&](size_t ch) {
     SubtractorOutput& output = outputs[ch];
     ArrayView<const float> y = capture.View(/*band=*/0, ch);
     FftData& E_refined = output.E_refined;
@@ -324,7 +451,7 @@ void Subtractor::Process(const RenderBuffer& render_buffer,
       data_dumper_->DumpWav("aec3_coarse_filter_output", kBlockSize,
                             &e_coarse[0], 16000, 1);
     }
-  }
+  });
 }
 
 void Subtractor::FilterMisadjustmentEstimator::Update(
@@ -15,6 +15,7 @@
 #include <stddef.h>
 
 #include <array>
+#include <optional>
 #include <vector>
 
 #include "api/array_view.h"
@@ -25,6 +26,7 @@
 #include "audio_processing/aec3/aec3_fft.h"
 #include "audio_processing/aec3/aec_state.h"
 #include "audio_processing/aec3/block.h"
+#include "audio_processing/aec3/channel_worker_pool.h"
 #include "audio_processing/aec3/coarse_filter_update_gain.h"
 #include "audio_processing/aec3/echo_path_variability.h"
 #include "audio_processing/aec3/refined_filter_update_gain.h"
@@ -44,12 +46,14 @@ class Subtractor {
              size_t num_render_channels,
              size_t num_capture_channels,
              ApmDataDumper* data_dumper,
-             Aec3Optimization optimization);
+             Aec3Optimization optimization,
+             ChannelWorkerPool* channel_workers = nullptr);
   ~Subtractor();
   Subtractor(const Subtractor&) = delete;
   Subtractor& operator=(const Subtractor&) = delete;
 
-  // Performs the echo subtraction.
+  // Performs the echo subtraction, of the capture channels in parallel when
+  // constructed with a ChannelWorkerPool.
   void Process(const RenderBuffer& render_buffer,
                const Block& capture,
                const RenderSignalAnalyzer& render_signal_analyzer,
@@ -61,6 +65,17 @@ class Subtractor {
   // Exits the initial state.
   void ExitInitialState();
 
+  // Returns the current length of the refined filters.
+  size_t FilterLengthBlocks() const {
+    return refined_filters_[0]->SizePartitions();
+  }
+
+  // Saves and restores the adaptive filters and their adaptation state.
+  // `initial_state` selects the filter configurations to continue with, as
+  // ExitInitialState() would.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader, bool initial_state);
+
   // Returns the block-wise frequency responses for the refined adaptive
   // filters.
   const std::vector<std::vector<std::array<float, kFftLengthBy2Plus1>>>&
@@ -96,6 +111,17 @@ class Subtractor {
   }
 
  private:
+  // Length of the refined impulse responses for the longest filter.
+  size_t MaxImpulseResponseSize() const;
+
+  // Shortens the filters to the measured echo path length while the linear
+  // estimate is usable, and restores them when the echo path grows longer or
+  // the estimate becomes unusable.
+  void AdaptFilterLengths(const AecState& aec_state);
+
+  // Sets the length of all filters, bounded by their configured lengths.
+  void SetFilterLengths(size_t length_blocks, bool immediate_effect);
+
   class FilterMisadjustmentEstimator {
    public:
     FilterMisadjustmentEstimator() = default;
@@ -132,6 +158,7 @@ class Subtractor {
   const Aec3Optimization optimization_;
   const EchoCanceller3Config config_;
   const size_t num_capture_channels_;
+  ChannelWorkerPool* const channel_workers_;
   const bool use_coarse_filter_reset_hangover_;
 
   std::vector<std::unique_ptr<AdaptiveFirFilter>> refined_filters_;
@@ -145,6 +172,9 @@ class Subtractor {
       refined_frequency_responses_;
   std::vector<std::vector<float>> refined_impulse_responses_;
   std::vector<std::vector<float>> coarse_impulse_responses_;
+  // Length that the filters have been adapted to, if they are shorter than
+  // configured.
+  std::optional<size_t> adapted_length_blocks_;
 };
 
 }  // namespace webrtc
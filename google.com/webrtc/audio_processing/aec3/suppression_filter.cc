@@ -62,10 +62,12 @@ const float kSqrtHanning[kFftLength] = {
 
 SuppressionFilter::SuppressionFilter(Aec3Optimization optimization,
                                      int sample_rate_hz,
-                                     size_t num_capture_channels)
+                                     size_t num_capture_channels,
+                                     ChannelWorkerPool* channel_workers)
     : optimization_(optimization),
       sample_rate_hz_(sample_rate_hz),
       num_capture_channels_(num_capture_channels),
+      channel_workers_(channel_workers),
       fft_(),
       e_output_old_(NumBandsForRate(sample_rate_hz_),
                     std::vector<std::array<float, kFftLengthBy2>>(
@@ -100,7 +102,7 @@ void SuppressionFilter::ApplyGain(
   const float high_bands_noise_scaling =
       0.4f * std::sqrt(1.f - high_bands_gain * high_bands_gain);
 
-  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+  ForEachChannel(channel_workers_, num_capture_channels_, [&](size_t ch) {
     FftData E;
 
     // Analysis filterbank.
@@ -167,6 +169,48 @@ void SuppressionFilter::ApplyGain(
       }
     }
 
+    // Clamp output of all bands.
+    for (int b = 0; b < e->NumBands(); ++b) {
+      auto e_band = e->View(b, ch);
+      for (size_t i = 0; i < kFftLengthBy2; ++i) {
+        e_band[i] = SafeClamp(e_band[i], -32768.f, 32767.f);
+      }
+    }
+  });
+}
+
+void SuppressionFilter::ApplyUnityGain(
+    ArrayView<const std::array<float, kFftLengthBy2>> e_lowest_band_old,
+    Block* e) {
+  RTC_DCHECK(e);
+  RTC_DCHECK_EQ(e->NumBands(), NumBandsForRate(sample_rate_hz_));
+  RTC_DCHECK_EQ(e_lowest_band_old.size(), num_capture_channels_);
+
+  constexpr float kIfftNormalization = 2.f / kFftLength;
+  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+    auto e0 = e->View(/*band=*/0, ch);
+    float* e0_old = e_output_old_[0][ch].data();
+
+    // With unity gain, the first half of the synthesis filterbank output is
+    // the analysis window applied twice to the previous block, and its second
+    // half is the analysis window applied to the current block, scaled as the
+    // inverse transform in ApplyGain().
+    for (size_t i = 0; i < kFftLengthBy2; ++i) {
+      const float e0_i = e0[i];
+      e0[i] = e0_old[i] * kSqrtHanning[kFftLengthBy2 + i] * kIfftNormalization +
+              e_lowest_band_old[ch][i] * kSqrtHanning[i] * kSqrtHanning[i];
+      e0_old[i] = e0_i * kSqrtHanning[kFftLengthBy2 + i] / kIfftNormalization;
+    }
+
+    // Delay upper bands to match the delay of the filter bank.
+    for (int b = 1; b < e->NumBands(); ++b) {
+      auto e_band = e->View(b, ch);
+      float* e_band_old = e_output_old_[b][ch].data();
+      for (size_t i = 0; i < kFftLengthBy2; ++i) {
+        std::swap(e_band[i], e_band_old[i]);
+      }
+    }
+
     // Clamp output of all bands.
     for (int b = 0; b < e->NumBands(); ++b) {
       auto e_band = e->View(b, ch);
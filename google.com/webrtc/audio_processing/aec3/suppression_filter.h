@@ -17,6 +17,7 @@
 #include "audio_processing/aec3/aec3_common.h"
 #include "audio_processing/aec3/aec3_fft.h"
 #include "audio_processing/aec3/block.h"
+#include "audio_processing/aec3/channel_worker_pool.h"
 #include "audio_processing/aec3/fft_data.h"
 
 namespace webrtc {
@@ -25,7 +26,8 @@ class SuppressionFilter {
  public:
   SuppressionFilter(Aec3Optimization optimization,
                     int sample_rate_hz,
-                    size_t num_capture_channels_);
+                    size_t num_capture_channels_,
+                    ChannelWorkerPool* channel_workers = nullptr);
   ~SuppressionFilter();
 
   SuppressionFilter(const SuppressionFilter&) = delete;
@@ -38,10 +40,21 @@ class SuppressionFilter {
                  ArrayView<const FftData> E_lowest_band,
                  Block* e);
 
+  // Passes `e` through with the same delay as ApplyGain() but without any
+  // suppression or comfort noise, which does not require any transforms. The
+  // filter bank memory is kept up to date so that ApplyGain() and
+  // ApplyUnityGain() can be interchanged between blocks without
+  // discontinuities. `e_lowest_band_old` is the lowest band of the previous
+  // block.
+  void ApplyUnityGain(
+      ArrayView<const std::array<float, kFftLengthBy2>> e_lowest_band_old,
+      Block* e);
+
  private:
   const Aec3Optimization optimization_;
   const int sample_rate_hz_;
   const size_t num_capture_channels_;
+  ChannelWorkerPool* const channel_workers_;
   const Aec3Fft fft_;
   std::vector<std::vector<std::array<float, kFftLengthBy2>>> e_output_old_;
 };
@@ -274,8 +274,9 @@ void SuppressionGain::LowerBandGain(
   std::array<float, kFftLengthBy2Plus1> max_gain;
   GetMaxGain(max_gain);
 
-  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
-    std::array<float, kFftLengthBy2Plus1> G;
+  // The channel gains are computed independently and then combined.
+  ForEachChannel(channel_workers_, num_capture_channels_, [&](size_t ch) {
+    std::array<float, kFftLengthBy2Plus1>& G = channel_gains_[ch];
     std::array<float, kFftLengthBy2Plus1> nearend;
     nearend_smoothers_[ch].Average(suppressor_input[ch], nearend);
 
@@ -290,15 +291,19 @@ void SuppressionGain::LowerBandGain(
     GainToNoAudibleEcho(nearend, weighted_residual_echo, comfort_noise[0], &G);
 
     // Clamp gains.
-    for (size_t k = 0; k < gain->size(); ++k) {
+    for (size_t k = 0; k < G.size(); ++k) {
       G[k] = std::max(std::min(G[k], max_gain[k]), min_gain[k]);
-      (*gain)[k] = std::min((*gain)[k], G[k]);
     }
 
     // Store data required for the gain computation of the next block.
     std::copy(nearend.begin(), nearend.end(), last_nearend_[ch].begin());
     std::copy(weighted_residual_echo.begin(), weighted_residual_echo.end(),
               last_echo_[ch].begin());
+  });
+  for (const auto& G : channel_gains_) {
+    for (size_t k = 0; k < gain->size(); ++k) {
+      (*gain)[k] = std::min((*gain)[k], G[k]);
+    }
   }
 
   LimitLowFrequencyGains(gain);
@@ -320,15 +325,18 @@ void SuppressionGain::LowerBandGain(
 SuppressionGain::SuppressionGain(const EchoCanceller3Config& config,
                                  Aec3Optimization optimization,
                                  int /* sample_rate_hz */,
-                                 size_t num_capture_channels)
+                                 size_t num_capture_channels,
+                                 ChannelWorkerPool* channel_workers)
     : data_dumper_(new ApmDataDumper(instance_count_.fetch_add(1) + 1)),
       optimization_(optimization),
       config_(config),
       num_capture_channels_(num_capture_channels),
+      channel_workers_(channel_workers),
       state_change_duration_blocks_(
           static_cast<int>(config_.filter.config_change_duration_blocks)),
       last_nearend_(num_capture_channels_, {0}),
       last_echo_(num_capture_channels_, {0}),
+      channel_gains_(num_capture_channels_),
       nearend_smoothers_(
           num_capture_channels_,
           aec3::MovingAverage(kFftLengthBy2Plus1,
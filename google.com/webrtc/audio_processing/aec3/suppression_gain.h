@@ -21,6 +21,7 @@
 #include "api/audio/echo_canceller3_config.h"
 #include "audio_processing/aec3/aec3_common.h"
 #include "audio_processing/aec3/aec_state.h"
+#include "audio_processing/aec3/channel_worker_pool.h"
 #include "audio_processing/aec3/fft_data.h"
 #include "audio_processing/aec3/moving_average.h"
 #include "audio_processing/aec3/nearend_detector.h"
@@ -34,7 +35,8 @@ class SuppressionGain {
   SuppressionGain(const EchoCanceller3Config& config,
                   Aec3Optimization optimization,
                   int sample_rate_hz,
-                  size_t num_capture_channels);
+                  size_t num_capture_channels,
+                  ChannelWorkerPool* channel_workers = nullptr);
   ~SuppressionGain();
 
   SuppressionGain(const SuppressionGain&) = delete;
@@ -122,10 +124,12 @@ class SuppressionGain {
   const Aec3Optimization optimization_;
   const EchoCanceller3Config config_;
   const size_t num_capture_channels_;
+  ChannelWorkerPool* const channel_workers_;
   const int state_change_duration_blocks_;
   std::array<float, kFftLengthBy2Plus1> last_gain_;
   std::vector<std::array<float, kFftLengthBy2Plus1>> last_nearend_;
   std::vector<std::array<float, kFftLengthBy2Plus1>> last_echo_;
+  std::vector<std::array<float, kFftLengthBy2Plus1>> channel_gains_;
   LowNoiseRenderDetector low_render_detector_;
   bool initial_state_ = true;
   int initial_state_change_counter_ = 0;
@@ -41,6 +41,7 @@ class VectorMath {
 
   // Elementwise square root.
   void SqrtAVX2(ArrayView<float> x);
+  void SqrtAVX512(ArrayView<float> x);
   void Sqrt(ArrayView<float> x) {
     switch (optimization_) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
@@ -62,6 +63,9 @@ class VectorMath {
       case Aec3Optimization::kAvx2:
         SqrtAVX2(x);
         break;
+      case Aec3Optimization::kAvx512:
+        SqrtAVX512(x);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon: {
@@ -117,6 +121,9 @@ class VectorMath {
   void MultiplyAVX2(ArrayView<const float> x,
                     ArrayView<const float> y,
                     ArrayView<float> z);
+  void MultiplyAVX512(ArrayView<const float> x,
+                      ArrayView<const float> y,
+                      ArrayView<float> z);
   void Multiply(ArrayView<const float> x,
                 ArrayView<const float> y,
                 ArrayView<float> z) {
@@ -143,6 +150,9 @@ class VectorMath {
       case Aec3Optimization::kAvx2:
         MultiplyAVX2(x, y, z);
         break;
+      case Aec3Optimization::kAvx512:
+        MultiplyAVX512(x, y, z);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon: {
@@ -170,6 +180,7 @@ class VectorMath {
 
   // Elementwise vector accumulation z += x.
   void AccumulateAVX2(ArrayView<const float> x, ArrayView<float> z);
+  void AccumulateAVX512(ArrayView<const float> x, ArrayView<float> z);
   void Accumulate(ArrayView<const float> x, ArrayView<float> z) {
     RTC_DCHECK_EQ(z.size(), x.size());
     switch (optimization_) {
@@ -193,6 +204,9 @@ class VectorMath {
       case Aec3Optimization::kAvx2:
         AccumulateAVX2(x, z);
         break;
+      case Aec3Optimization::kAvx512:
+        AccumulateAVX512(x, z);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon: {
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#if defined(__i386__) || defined(_M_IX86) || defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+
+#include "api/array_view.h"
+#include "audio_processing/aec3/vector_math.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace aec3 {
+
+namespace {
+
+// Returns the mask selecting the `size` first of 16 values.
+__attribute__((target("avx512f")))
+inline __mmask16 TailMask(int size) {
+  return static_cast<__mmask16>((1u << size) - 1);
+}
+
+}  // namespace
+
+// Elementwise square root. The values after the last full vector are processed
+// with masked vector operations.
+__attribute__((target("avx512f")))
+void VectorMath::SqrtAVX512(ArrayView<float> x) {
+  const int x_size = static_cast<int>(x.size());
+  const int vector_limit = x_size >> 4;
+
+  int j = 0;
+  for (; j < vector_limit * 16; j += 16) {
+    const __m512 g = _mm512_loadu_ps(&x[j]);
+    _mm512_storeu_ps(&x[j], _mm512_sqrt_ps(g));
+  }
+
+  if (j < x_size) {
+    const __mmask16 mask = TailMask(x_size - j);
+    const __m512 g = _mm512_maskz_loadu_ps(mask, &x[j]);
+    _mm512_mask_storeu_ps(&x[j], mask, _mm512_sqrt_ps(g));
+  }
+}
+
+// Elementwise vector multiplication z = x * y.
+__attribute__((target("avx512f")))
+void VectorMath::MultiplyAVX512(ArrayView<const float> x,
+                                ArrayView<const float> y,
+                                ArrayView<float> z) {
+  RTC_DCHECK_EQ(z.size(), x.size());
+  RTC_DCHECK_EQ(z.size(), y.size());
+  const int x_size = static_cast<int>(x.size());
+  const int vector_limit = x_size >> 4;
+
+  int j = 0;
+  for (; j < vector_limit * 16; j += 16) {
+    const __m512 x_j = _mm512_loadu_ps(&x[j]);
+    const __m512 y_j = _mm512_loadu_ps(&y[j]);
+    _mm512_storeu_ps(&z[j], _mm512_mul_ps(x_j, y_j));
+  }
+
+  if (j < x_size) {
+    const __mmask16 mask = TailMask(x_size - j);
+    const __m512 x_j = _mm512_maskz_loadu_ps(mask, &x[j]);
+    const __m512 y_j = _mm512_maskz_loadu_ps(mask, &y[j]);
+    _mm512_mask_storeu_ps(&z[j], mask, _mm512_mul_ps(x_j, y_j));
+  }
+}
+
+// Elementwise vector accumulation z += x.
+__attribute__((target("avx512f")))
+void VectorMath::AccumulateAVX512(ArrayView<const float> x,
+                                  ArrayView<float> z) {
+  RTC_DCHECK_EQ(z.size(), x.size());
+  const int x_size = static_cast<int>(x.size());
+  const int vector_limit = x_size >> 4;
+
+  int j = 0;
+  for (; j < vector_limit * 16; j += 16) {
+    const __m512 x_j = _mm512_loadu_ps(&x[j]);
+    const __m512 z_j = _mm512_loadu_ps(&z[j]);
+    _mm512_storeu_ps(&z[j], _mm512_add_ps(x_j, z_j));
+  }
+
+  if (j < x_size) {
+    const __mmask16 mask = TailMask(x_size - j);
+    const __m512 x_j = _mm512_maskz_loadu_ps(mask, &x[j]);
+    const __m512 z_j = _mm512_maskz_loadu_ps(mask, &z[j]);
+    _mm512_mask_storeu_ps(&z[j], mask, _mm512_add_ps(x_j, z_j));
+  }
+}
+
+}  // namespace aec3
+}  // namespace webrtc
+#endif
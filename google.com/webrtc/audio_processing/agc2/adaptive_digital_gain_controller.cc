@@ -213,4 +213,15 @@ void AdaptiveDigitalGainController::Process(const FrameInfo& info,
   }
 }
 
+void AdaptiveDigitalGainController::SaveState(StateWriter* writer) const {
+  writer->WriteFloat(last_gain_db_);
+  writer->WriteInt32(frames_to_gain_increase_allowed_);
+}
+
+void AdaptiveDigitalGainController::LoadState(StateReader* reader) {
+  last_gain_db_ = reader->ReadFloat();
+  frames_to_gain_increase_allowed_ = reader->ReadInt32();
+  gain_applier_.SetGainFactor(DbToRatio(last_gain_db_));
+}
+
 }  // namespace webrtc
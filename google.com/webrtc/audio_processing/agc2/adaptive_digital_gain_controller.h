@@ -16,6 +16,7 @@
 #include "api/audio/audio_processing.h"
 #include "api/audio/audio_view.h"
 #include "audio_processing/agc2/gain_applier.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 
@@ -48,6 +49,10 @@ class AdaptiveDigitalGainController {
   // `frame`. Supports any sample rate supported by APM.
   void Process(const FrameInfo& info, DeinterleavedView<float> frame);
 
+  // Saves and restores the applied gain and the gain increase hold-off.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
  private:
   ApmDataDumper* const apm_data_dumper_;
   GainApplier gain_applier_;
@@ -142,6 +142,29 @@ void SpeechLevelEstimator::Reset() {
   num_adjacent_speech_frames_ = 0;
 }
 
+void SpeechLevelEstimator::SaveState(StateWriter* writer) const {
+  for (const LevelEstimatorState* state :
+       {&preliminary_state_, &reliable_state_}) {
+    writer->WriteInt32(state->time_to_confidence_ms);
+    writer->WriteFloat(state->level_dbfs.numerator);
+    writer->WriteFloat(state->level_dbfs.denominator);
+  }
+  writer->WriteFloat(level_dbfs_);
+  writer->WriteBool(is_confident_);
+  writer->WriteInt32(num_adjacent_speech_frames_);
+}
+
+void SpeechLevelEstimator::LoadState(StateReader* reader) {
+  for (LevelEstimatorState* state : {&preliminary_state_, &reliable_state_}) {
+    state->time_to_confidence_ms = reader->ReadInt32();
+    state->level_dbfs.numerator = reader->ReadFloat();
+    state->level_dbfs.denominator = reader->ReadFloat();
+  }
+  level_dbfs_ = reader->ReadFloat();
+  is_confident_ = reader->ReadBool();
+  num_adjacent_speech_frames_ = reader->ReadInt32();
+}
+
 void SpeechLevelEstimator::ResetLevelEstimatorState(
     LevelEstimatorState& state) const {
   state.time_to_confidence_ms = kLevelEstimatorTimeToConfidenceMs;
@@ -17,6 +17,7 @@
 
 #include "api/audio/audio_processing.h"
 #include "audio_processing/agc2/agc2_common.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 class ApmDataDumper;
@@ -42,6 +43,10 @@ class SpeechLevelEstimator {
 
   void Reset();
 
+  // Saves and restores the level estimate and its confidence.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
  private:
   // Part of the level estimator state used for check-pointing and restore ops.
   struct LevelEstimatorState {
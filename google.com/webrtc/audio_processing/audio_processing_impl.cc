@@ -31,6 +31,7 @@
 #include "audio_processing/audio_buffer.h"
 #include "audio_processing/include/audio_frame_view.h"
 #include "audio_processing/logging/apm_data_dumper.h"
+#include "audio_processing/utility/state_serializer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/time_utils.h"
@@ -50,6 +51,17 @@ namespace webrtc {
 
 namespace {
 
+// Identifies a saved adaptive state ("APMS" in little-endian order) and its
+// layout version.
+constexpr uint32_t kAdaptiveStateMagic = 0x534D5041;
+constexpr uint32_t kAdaptiveStateVersion = 1;
+
+// Tags of the sections in a saved adaptive state.
+enum class AdaptiveStateSection : uint8_t {
+  kEchoController = 1,
+  kGainController2 = 2,
+};
+
 bool SampleRateSupportsMultiBand(int sample_rate_hz) {
   return sample_rate_hz == AudioProcessing::kSampleRate32kHz ||
          sample_rate_hz == AudioProcessing::kSampleRate48kHz;
@@ -418,7 +430,8 @@ AudioProcessingImpl::AudioProcessingImpl(const Environment& env)
                           /*render_pre_processor=*/nullptr,
                           /*echo_control_factory=*/nullptr,
                           /*echo_detector=*/nullptr,
-                          /*capture_analyzer=*/nullptr) {}
+                          /*capture_analyzer=*/nullptr,
+                          /*echo_canceller3_factory=*/nullptr) {}
 
 std::atomic<int> AudioProcessingImpl::instance_count_(0);
 
@@ -429,7 +442,8 @@ AudioProcessingImpl::AudioProcessingImpl(
     std::unique_ptr<CustomProcessing> render_pre_processor,
     std::unique_ptr<EchoControlFactory> echo_control_factory,
     scoped_refptr<EchoDetector> echo_detector,
-    std::unique_ptr<CustomAudioAnalyzer> capture_analyzer)
+    std::unique_ptr<CustomAudioAnalyzer> capture_analyzer,
+    std::unique_ptr<EchoControlFactory> echo_canceller3_factory)
     : env_(env),
       data_dumper_(new ApmDataDumper(instance_count_.fetch_add(1) + 1)),
       use_setup_specific_default_aec3_config_(
@@ -439,6 +453,7 @@ AudioProcessingImpl::AudioProcessingImpl(
       capture_runtime_settings_enqueuer_(&capture_runtime_settings_),
       render_runtime_settings_enqueuer_(&render_runtime_settings_),
       echo_control_factory_(std::move(echo_control_factory)),
+      echo_canceller3_factory_(std::move(echo_canceller3_factory)),
       config_(config),
       submodule_states_(!!capture_post_processor,
                         !!render_pre_processor,
@@ -1221,6 +1236,7 @@ int AudioProcessingImpl::ProcessStream(const int16_t* const src,
 }
 
 int AudioProcessingImpl::ProcessCaptureStreamLocked() {
+  capture_timer_.BeginFrame();
   EmptyQueuedRenderAudioLocked();
   HandleCaptureRuntimeSettings();
   DenormalDisabler denormal_disabler;
@@ -1241,6 +1257,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   if (submodules_.high_pass_filter &&
       config_.high_pass_filter.apply_in_full_band &&
       !constants_.enforce_split_band_hpf) {
+    ProcessingTimer::Scope timing(&capture_timer_, kHighPassFilterStage);
     submodules_.high_pass_filter->Process(capture_buffer,
                                           /*use_split_band_data=*/false);
   }
@@ -1298,6 +1315,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
          capture_.prev_playout_volume >= 0);
     capture_.prev_playout_volume = capture_.playout_volume;
 
+    ProcessingTimer::Scope timing(&capture_timer_, kEchoControllerStage);
     submodules_.echo_controller->AnalyzeCapture(capture_buffer);
   }
 
@@ -1310,6 +1328,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
     // Expect the volume to be available if the input controller is enabled.
     RTC_DCHECK(capture_.applied_input_volume.has_value());
     if (capture_.applied_input_volume.has_value()) {
+      ProcessingTimer::Scope timing(&capture_timer_, kGainController2Stage);
       submodules_.gain_controller2->Analyze(*capture_.applied_input_volume,
                                             *capture_buffer);
     }
@@ -1318,6 +1337,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   if (submodule_states_.CaptureMultiBandSubModulesActive() &&
       SampleRateSupportsMultiBand(
           capture_nonlocked_.capture_processing_format.sample_rate_hz())) {
+    ProcessingTimer::Scope timing(&capture_timer_, kCaptureBandSplitStage);
     capture_buffer->SplitIntoFrequencyBands();
   }
 
@@ -1334,6 +1354,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   if (submodules_.high_pass_filter &&
       (!config_.high_pass_filter.apply_in_full_band ||
        constants_.enforce_split_band_hpf)) {
+    ProcessingTimer::Scope timing(&capture_timer_, kHighPassFilterStage);
     submodules_.high_pass_filter->Process(capture_buffer,
                                           /*use_split_band_data=*/true);
   }
@@ -1346,6 +1367,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   if ((!config_.noise_suppression.analyze_linear_aec_output_when_available ||
        !linear_aec_buffer || submodules_.echo_control_mobile) &&
       submodules_.noise_suppressor) {
+    ProcessingTimer::Scope timing(&capture_timer_, kNoiseSuppressorStage);
     submodules_.noise_suppressor->Analyze(*capture_buffer);
   }
 
@@ -1357,6 +1379,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
     }
 
     if (submodules_.noise_suppressor) {
+      ProcessingTimer::Scope timing(&capture_timer_, kNoiseSuppressorStage);
       submodules_.noise_suppressor->Process(capture_buffer);
     }
 
@@ -1370,16 +1393,19 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
         submodules_.echo_controller->SetAudioBufferDelay(stream_delay_ms());
       }
 
+      ProcessingTimer::Scope timing(&capture_timer_, kEchoControllerStage);
       submodules_.echo_controller->ProcessCapture(
           capture_buffer, linear_aec_buffer, capture_.echo_path_gain_change);
     }
 
     if (config_.noise_suppression.analyze_linear_aec_output_when_available &&
         linear_aec_buffer && submodules_.noise_suppressor) {
+      ProcessingTimer::Scope timing(&capture_timer_, kNoiseSuppressorStage);
       submodules_.noise_suppressor->Analyze(*linear_aec_buffer);
     }
 
     if (submodules_.noise_suppressor) {
+      ProcessingTimer::Scope timing(&capture_timer_, kNoiseSuppressorStage);
       submodules_.noise_suppressor->Process(capture_buffer);
     }
   }
@@ -1403,6 +1429,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   if (submodule_states_.CaptureMultiBandProcessingPresent() &&
       SampleRateSupportsMultiBand(
           capture_nonlocked_.capture_processing_format.sample_rate_hz())) {
+    ProcessingTimer::Scope timing(&capture_timer_, kCaptureBandSplitStage);
     capture_buffer->MergeFrequencyBands();
   }
 
@@ -1431,6 +1458,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
     if (submodules_.gain_controller2) {
       // TODO(bugs.webrtc.org/7494): Let AGC2 detect applied input volume
       // changes.
+      ProcessingTimer::Scope timing(&capture_timer_, kGainController2Stage);
       submodules_.gain_controller2->Process(
           /*speech_probability=*/std::nullopt,
           capture_.applied_input_volume_changed, capture_buffer);
@@ -1468,6 +1496,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
     capture_.stats.echo_return_loss_enhancement =
         ec_metrics.echo_return_loss_enhancement;
     capture_.stats.delay_ms = ec_metrics.delay_ms;
+    capture_.stats.linear_filter_length_ms =
+        ec_metrics.linear_filter_length_ms;
   }
 
   // Pass stats for reporting.
@@ -1513,6 +1543,21 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
                         capture_.recommended_input_volume.value_or(
                             kUnspecifiedDataDumpInputVolume));
 
+  // The timings are reported along with the stats of the next frame.
+  if (capture_timer_.EndFrame()) {
+    capture_.stats.capture_processing_time = capture_timer_.FrameTiming();
+    capture_.stats.capture_band_split_time =
+        capture_timer_.StageTimingOf(kCaptureBandSplitStage);
+    capture_.stats.high_pass_filter_time =
+        capture_timer_.StageTimingOf(kHighPassFilterStage);
+    capture_.stats.echo_controller_time =
+        capture_timer_.StageTimingOf(kEchoControllerStage);
+    capture_.stats.noise_suppressor_time =
+        capture_timer_.StageTimingOf(kNoiseSuppressorStage);
+    capture_.stats.gain_controller2_time =
+        capture_timer_.StageTimingOf(kGainController2Stage);
+  }
+
   return kNoError;
 }
 
@@ -1597,6 +1642,7 @@ int AudioProcessingImpl::ProcessReverseStream(const int16_t* const src,
 int AudioProcessingImpl::ProcessRenderStreamLocked() {
   AudioBuffer* render_buffer = render_.render_audio.get();  // For brevity.
 
+  render_timer_.BeginFrame();
   HandleRenderRuntimeSettings();
   DenormalDisabler denormal_disabler;
 
@@ -1609,6 +1655,7 @@ int AudioProcessingImpl::ProcessRenderStreamLocked() {
   if (submodule_states_.RenderMultiBandSubModulesActive() &&
       SampleRateSupportsMultiBand(
           formats_.render_processing_format.sample_rate_hz())) {
+    ProcessingTimer::Scope timing(&render_timer_, kRenderBandSplitStage);
     render_buffer->SplitIntoFrequencyBands();
   }
 
@@ -1618,15 +1665,27 @@ int AudioProcessingImpl::ProcessRenderStreamLocked() {
 
   // TODO(peah): Perform the queuing inside QueueRenderAudiuo().
   if (submodules_.echo_controller) {
+    ProcessingTimer::Scope timing(&render_timer_, kRenderAnalysisStage);
     submodules_.echo_controller->AnalyzeRender(render_buffer);
   }
 
   if (submodule_states_.RenderMultiBandProcessingActive() &&
       SampleRateSupportsMultiBand(
           formats_.render_processing_format.sample_rate_hz())) {
+    ProcessingTimer::Scope timing(&render_timer_, kRenderBandSplitStage);
     render_buffer->MergeFrequencyBands();
   }
 
+  if (render_timer_.EndFrame()) {
+    AudioProcessingStats render_timings;
+    render_timings.render_processing_time = render_timer_.FrameTiming();
+    render_timings.render_band_split_time =
+        render_timer_.StageTimingOf(kRenderBandSplitStage);
+    render_timings.render_analysis_time =
+        render_timer_.StageTimingOf(kRenderAnalysisStage);
+    stats_reporter_.UpdateRenderTimings(render_timings);
+  }
+
   return kNoError;
 }
 
@@ -1763,6 +1822,110 @@ AudioProcessing::Config AudioProcessingImpl::GetConfig() const {
   return config_;
 }
 
+bool AudioProcessingImpl::SaveAdaptiveState(std::vector<uint8_t>* state) {
+  RTC_DCHECK(state);
+  MutexLock lock_render(&mutex_render_);
+  MutexLock lock_capture(&mutex_capture_);
+  state->clear();
+  StateWriter writer(state);
+  writer.WriteUint32(kAdaptiveStateMagic);
+  writer.WriteUint32(kAdaptiveStateVersion);
+
+  // Each section is a tag, the payload size and the payload.
+  auto write_section = [&](AdaptiveStateSection tag, auto write_payload) {
+    writer.WriteUint8(static_cast<uint8_t>(tag));
+    const size_t size_offset = writer.size();
+    writer.WriteUint32(0);
+    const bool written = write_payload();
+    writer.PatchUint32(size_offset, writer.size() - size_offset - 4);
+    return written;
+  };
+
+  if (submodules_.echo_controller &&
+      !write_section(AdaptiveStateSection::kEchoController, [&] {
+        return submodules_.echo_controller->SaveState(state);
+      })) {
+    state->clear();
+    return false;
+  }
+  if (submodules_.gain_controller2) {
+    write_section(AdaptiveStateSection::kGainController2, [&] {
+      submodules_.gain_controller2->SaveState(&writer);
+      return true;
+    });
+  }
+  return true;
+}
+
+bool AudioProcessingImpl::LoadAdaptiveState(ArrayView<const uint8_t> state) {
+  MutexLock lock_render(&mutex_render_);
+  MutexLock lock_capture(&mutex_capture_);
+  StateReader reader(state);
+  if (reader.ReadUint32() != kAdaptiveStateMagic ||
+      reader.ReadUint32() != kAdaptiveStateVersion) {
+    return false;
+  }
+
+  std::optional<ArrayView<const uint8_t>> echo_controller_state;
+  std::optional<ArrayView<const uint8_t>> gain_controller2_state;
+  while (reader.ok() && reader.remaining() > 0) {
+    const uint8_t tag = reader.ReadUint8();
+    const uint32_t size = reader.ReadUint32();
+    if (!reader.ok() || size > reader.remaining()) {
+      return false;
+    }
+    const ArrayView<const uint8_t> payload =
+        state.subview(state.size() - reader.remaining(), size);
+    reader.ReadSection(size);
+    switch (static_cast<AdaptiveStateSection>(tag)) {
+      case AdaptiveStateSection::kEchoController:
+        echo_controller_state = payload;
+        break;
+      case AdaptiveStateSection::kGainController2:
+        gain_controller2_state = payload;
+        break;
+      default:
+        return false;
+    }
+  }
+
+  // The state must cover exactly the adaptive submodules that are active.
+  if (!reader.ok() ||
+      echo_controller_state.has_value() !=
+          (submodules_.echo_controller != nullptr) ||
+      gain_controller2_state.has_value() !=
+          (submodules_.gain_controller2 != nullptr)) {
+    return false;
+  }
+
+  // AGC2 is checked by loading its state into a scratch instance with the
+  // same configuration before anything is modified, as the echo controller
+  // keeps a state it has accepted.
+  if (gain_controller2_state) {
+    GainController2 scratch(env_, config_.gain_controller2,
+                            InputVolumeController::Config{},
+                            proc_fullband_sample_rate_hz(),
+                            num_output_channels(), /*use_internal_vad=*/true);
+    StateReader scratch_reader(*gain_controller2_state);
+    scratch.LoadState(&scratch_reader);
+    if (!scratch_reader.ok() || scratch_reader.remaining() != 0) {
+      return false;
+    }
+  }
+
+  // The echo controller validates its state before modifying itself.
+  if (echo_controller_state &&
+      !submodules_.echo_controller->LoadState(*echo_controller_state)) {
+    return false;
+  }
+  if (gain_controller2_state) {
+    StateReader gain_controller2_reader(*gain_controller2_state);
+    submodules_.gain_controller2->LoadState(&gain_controller2_reader);
+    RTC_DCHECK(gain_controller2_reader.ok());
+  }
+  return true;
+}
+
 bool AudioProcessingImpl::UpdateActiveSubmoduleStates() {
   return submodule_states_.Update(
       config_.high_pass_filter.enabled, !!submodules_.echo_control_mobile,
@@ -1810,6 +1973,11 @@ void AudioProcessingImpl::InitializeEchoController() {
           env_, proc_sample_rate_hz(), num_reverse_channels(),
           num_proc_channels());
       RTC_DCHECK(submodules_.echo_controller);
+    } else if (echo_canceller3_factory_) {
+      submodules_.echo_controller = echo_canceller3_factory_->Create(
+          env_, proc_sample_rate_hz(), num_reverse_channels(),
+          num_proc_channels());
+      RTC_DCHECK(submodules_.echo_controller);
     } else {
       EchoCanceller3Config config;
       std::optional<EchoCanceller3Config> multichannel_config;
@@ -2069,26 +2237,27 @@ AudioProcessingImpl::ApmRenderState::ApmRenderState() = default;
 
 AudioProcessingImpl::ApmRenderState::~ApmRenderState() = default;
 
-AudioProcessingImpl::ApmStatsReporter::ApmStatsReporter()
-    : stats_message_queue_(1) {}
+AudioProcessingImpl::ApmStatsReporter::ApmStatsReporter() = default;
 
 AudioProcessingImpl::ApmStatsReporter::~ApmStatsReporter() = default;
 
 AudioProcessingStats AudioProcessingImpl::ApmStatsReporter::GetStatistics() {
-  MutexLock lock_stats(&mutex_stats_);
-  bool new_stats_available = stats_message_queue_.Remove(&cached_stats_);
-  // If the message queue is full, return the cached stats.
-  static_cast<void>(new_stats_available);
-
-  return cached_stats_;
+  AudioProcessingStats stats = capture_stats_.Load();
+  const AudioProcessingStats render_timings = render_timings_.Load();
+  stats.render_processing_time = render_timings.render_processing_time;
+  stats.render_band_split_time = render_timings.render_band_split_time;
+  stats.render_analysis_time = render_timings.render_analysis_time;
+  return stats;
 }
 
 void AudioProcessingImpl::ApmStatsReporter::UpdateStatistics(
     const AudioProcessingStats& new_stats) {
-  AudioProcessingStats stats_to_queue = new_stats;
-  bool stats_message_passed = stats_message_queue_.Insert(&stats_to_queue);
-  // If the message queue is full, discard the new stats.
-  static_cast<void>(stats_message_passed);
+  capture_stats_.Store(new_stats);
+}
+
+void AudioProcessingImpl::ApmStatsReporter::UpdateRenderTimings(
+    const AudioProcessingStats& render_timings) {
+  render_timings_.Store(render_timings);
 }
 
 }  // namespace webrtc
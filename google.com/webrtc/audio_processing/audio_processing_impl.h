@@ -40,9 +40,11 @@
 #include "audio_processing/high_pass_filter.h"
 #include "audio_processing/include/audio_frame_proxies.h"
 #include "audio_processing/ns/noise_suppressor.h"
+#include "audio_processing/processing_timer.h"
 #include "audio_processing/render_queue_item_verifier.h"
 #include "audio_processing/rms_level.h"
 #include "rtc_base/gtest_prod_util.h"
+#include "rtc_base/seqlock.h"
 #include "rtc_base/swap_queue.h"
 #include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/thread_annotations.h"
@@ -67,7 +69,9 @@ class AudioProcessingImpl : public AudioProcessing {
                       std::unique_ptr<CustomProcessing> render_pre_processor,
                       std::unique_ptr<EchoControlFactory> echo_control_factory,
                       scoped_refptr<EchoDetector> echo_detector,
-                      std::unique_ptr<CustomAudioAnalyzer> capture_analyzer);
+                      std::unique_ptr<CustomAudioAnalyzer> capture_analyzer,
+                      std::unique_ptr<EchoControlFactory>
+                          echo_canceller3_factory);
   ~AudioProcessingImpl() override;
   int Initialize() override;
   int Initialize(const ProcessingConfig& processing_config) override;
@@ -130,6 +134,9 @@ class AudioProcessingImpl : public AudioProcessing {
 
   AudioProcessing::Config GetConfig() const override;
 
+  bool SaveAdaptiveState(std::vector<uint8_t>* state) override;
+  bool LoadAdaptiveState(ArrayView<const uint8_t> state) override;
+
  protected:
   // Overridden in a mock.
   virtual void InitializeLocked()
@@ -180,6 +187,9 @@ class AudioProcessingImpl : public AudioProcessing {
 
   // EchoControl factory.
   const std::unique_ptr<EchoControlFactory> echo_control_factory_;
+  // Factory for the built-in echo canceller, replacing its default
+  // configurations when set.
+  const std::unique_ptr<EchoControlFactory> echo_canceller3_factory_;
 
   class SubmoduleStates {
    public:
@@ -423,7 +433,8 @@ class AudioProcessingImpl : public AudioProcessing {
   } render_ RTC_GUARDED_BY(mutex_render_);
 
   // Class for statistics reporting. The class is thread-safe and no lock is
-  // needed when accessing it.
+  // needed when accessing it. The statistics are published through seqlocks,
+  // so readers never block the capture or render threads.
   class ApmStatsReporter {
    public:
     ApmStatsReporter();
@@ -432,13 +443,16 @@ class AudioProcessingImpl : public AudioProcessing {
     // Returns the most recently reported statistics.
     AudioProcessingStats GetStatistics();
 
-    // Update the cached statistics.
+    // Update the cached statistics. Only called on the capture thread.
     void UpdateStatistics(const AudioProcessingStats& new_stats);
 
+    // Update the render timings, which are produced on the render thread and
+    // merged into the statistics returned by GetStatistics().
+    void UpdateRenderTimings(const AudioProcessingStats& render_timings);
+
    private:
-    Mutex mutex_stats_;
-    AudioProcessingStats cached_stats_ RTC_GUARDED_BY(mutex_stats_);
-    SwapQueue<AudioProcessingStats> stats_message_queue_;
+    SeqLock<AudioProcessingStats> capture_stats_;
+    SeqLock<AudioProcessingStats> render_timings_;
   } stats_reporter_;
 
   std::vector<int16_t> aecm_render_queue_buffer_ RTC_GUARDED_BY(mutex_render_);
@@ -459,6 +473,25 @@ class AudioProcessingImpl : public AudioProcessing {
   RmsLevel capture_output_rms_ RTC_GUARDED_BY(mutex_capture_);
   int capture_rms_interval_counter_ RTC_GUARDED_BY(mutex_capture_) = 0;
 
+  // Stages timed by the capture and render processing timers.
+  enum CaptureTimingStage : size_t {
+    kCaptureBandSplitStage,
+    kHighPassFilterStage,
+    kEchoControllerStage,
+    kNoiseSuppressorStage,
+    kGainController2Stage,
+    kNumCaptureTimingStages
+  };
+  enum RenderTimingStage : size_t {
+    kRenderBandSplitStage,
+    kRenderAnalysisStage,
+    kNumRenderTimingStages
+  };
+  ProcessingTimer capture_timer_ RTC_GUARDED_BY(mutex_capture_) =
+      ProcessingTimer(kNumCaptureTimingStages);
+  ProcessingTimer render_timer_ RTC_GUARDED_BY(mutex_render_) =
+      ProcessingTimer(kNumRenderTimingStages);
+
   InputVolumeStatsReporter applied_input_volume_stats_reporter_
       RTC_GUARDED_BY(mutex_capture_);
   InputVolumeStatsReporter recommended_input_volume_stats_reporter_
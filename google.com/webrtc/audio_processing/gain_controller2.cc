@@ -286,4 +286,32 @@ bool GainController2::Validate(
          adaptive.max_output_noise_level_dbfs <= 0.0f;
 }
 
+void GainController2::SaveState(StateWriter* writer) const {
+  writer->WriteBool(speech_level_estimator_ != nullptr);
+  if (speech_level_estimator_) {
+    speech_level_estimator_->SaveState(writer);
+  }
+  writer->WriteBool(adaptive_digital_controller_ != nullptr);
+  if (adaptive_digital_controller_) {
+    adaptive_digital_controller_->SaveState(writer);
+  }
+}
+
+void GainController2::LoadState(StateReader* reader) {
+  if (reader->ReadBool() != (speech_level_estimator_ != nullptr)) {
+    reader->Invalidate();
+    return;
+  }
+  if (speech_level_estimator_) {
+    speech_level_estimator_->LoadState(reader);
+  }
+  if (reader->ReadBool() != (adaptive_digital_controller_ != nullptr)) {
+    reader->Invalidate();
+    return;
+  }
+  if (adaptive_digital_controller_) {
+    adaptive_digital_controller_->LoadState(reader);
+  }
+}
+
 }  // namespace webrtc
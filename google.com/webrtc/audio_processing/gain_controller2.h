@@ -27,6 +27,7 @@
 #include "audio_processing/agc2/speech_level_estimator.h"
 #include "audio_processing/agc2/vad_wrapper.h"
 #include "audio_processing/logging/apm_data_dumper.h"
+#include "audio_processing/utility/state_serializer.h"
 
 namespace webrtc {
 
@@ -77,6 +78,12 @@ class GainController2 {
 
   static bool Validate(const AudioProcessing::Config::GainController2& config);
 
+  // Saves and restores the adaptive digital gain state: the speech level
+  // estimate and the applied gain. The input volume controller, the noise
+  // estimator and the saturation protector start over after a restore.
+  void SaveState(StateWriter* writer) const;
+  void LoadState(StateReader* reader);
+
   AvailableCpuFeatures GetCpuFeatures() const { return cpu_features_; }
 
   std::optional<int> recommended_input_volume() const {
@@ -13,6 +13,7 @@
 #include <math.h>
 #include <stdint.h>
 
+#include "audio_processing/ns/fast_math_simd.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -80,4 +81,64 @@ void ExpApproximationSignFlip(ArrayView<const float> x, ArrayView<float> y) {
   }
 }
 
+void LogApproximation(NsOptimization optimization,
+                      ArrayView<const float> x,
+                      ArrayView<float> y) {
+  RTC_DCHECK_EQ(x.size(), y.size());
+  const size_t size = x.size();
+  size_t k = 0;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case NsOptimization::kSse2:
+      for (; k + 4 <= size; k += 4) {
+        _mm_storeu_ps(&y[k],
+                      ns_simd::LogApproximationSse2(_mm_loadu_ps(&x[k])));
+      }
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case NsOptimization::kNeon:
+      for (; k + 4 <= size; k += 4) {
+        vst1q_f32(&y[k], ns_simd::LogApproximationNeon(vld1q_f32(&x[k])));
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+  for (; k < size; ++k) {
+    y[k] = LogApproximation(x[k]);
+  }
+}
+
+void ExpApproximation(NsOptimization optimization,
+                      ArrayView<const float> x,
+                      ArrayView<float> y) {
+  RTC_DCHECK_EQ(x.size(), y.size());
+  const size_t size = x.size();
+  size_t k = 0;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case NsOptimization::kSse2:
+      for (; k + 4 <= size; k += 4) {
+        _mm_storeu_ps(&y[k],
+                      ns_simd::ExpApproximationSse2(_mm_loadu_ps(&x[k])));
+      }
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case NsOptimization::kNeon:
+      for (; k + 4 <= size; k += 4) {
+        vst1q_f32(&y[k], ns_simd::ExpApproximationNeon(vld1q_f32(&x[k])));
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+  for (; k < size; ++k) {
+    y[k] = ExpApproximation(x[k]);
+  }
+}
+
 }  // namespace webrtc
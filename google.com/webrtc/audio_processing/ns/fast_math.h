@@ -12,6 +12,7 @@
 #define MODULES_AUDIO_PROCESSING_NS_FAST_MATH_H_
 
 #include "api/array_view.h"
+#include "audio_processing/ns/ns_common.h"
 
 namespace webrtc {
 
@@ -32,6 +33,18 @@ float PowApproximation(float x, float p);
 float ExpApproximation(float x);
 void ExpApproximation(ArrayView<const float> x, ArrayView<float> y);
 void ExpApproximationSignFlip(ArrayView<const float> x, ArrayView<float> y);
+
+// Versions of the array approximations that use SIMD when `optimization`
+// allows. The SIMD log matches the scalar one to within float rounding, while
+// the SIMD exp computes 2^x with a polynomial instead of powf and matches the
+// scalar one to within 2e-7 relative (see fast_math_simd.h).
+void LogApproximation(NsOptimization optimization,
+                      ArrayView<const float> x,
+                      ArrayView<float> y);
+void ExpApproximation(NsOptimization optimization,
+                      ArrayView<const float> x,
+                      ArrayView<float> y);
+
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_NS_FAST_MATH_H_
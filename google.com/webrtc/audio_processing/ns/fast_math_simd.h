@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_NS_FAST_MATH_SIMD_H_
+#define MODULES_AUDIO_PROCESSING_NS_FAST_MATH_SIMD_H_
+
+// Defines WEBRTC_ARCH_X86_FAMILY, used below.
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
+// Vector versions of LogApproximation and ExpApproximation in fast_math.h, for
+// use inside the SIMD kernels of the noise suppressor.
+//
+// The log uses the same exponent extraction as the scalar version and matches
+// it up to the rounding of the final scaling. The scalar exp calls powf for
+// the 2^x step, which is replaced here by range reduction and a degree 6
+// polynomial with a relative error below 2e-7 on [-126, 127]. Results outside
+// that range saturate instead of becoming 0 or infinity.
+
+namespace webrtc {
+namespace ns_simd {
+
+// log(2).
+constexpr float kLogOf2 = 0.69314718056f;
+// 1/2^23, turns the bit pattern of a float into its biased log2.
+constexpr float kOneBy2Pow23 = 1.1920929e-7f;
+// Removes the exponent bias and aligns the mantissa approximation.
+constexpr float kLog2Bias = 126.942695f;
+// log10(e).
+constexpr float kLog10Ofe = 0.4342944819f;
+// The scalar approximation of log2(10) that ExpApproximation uses.
+constexpr float kFastLog2Of10 = 3.30730438f;
+// Range of the exponent for which 2^x is a normal float.
+constexpr float kMinPow2Exponent = -126.f;
+constexpr float kMaxPow2Exponent = 127.f;
+// Minimax coefficients of (2^x - 1) / x on [-0.5, 0.5], highest order first.
+constexpr float kPow2Coefficients[6] = {
+    1.535336188319500e-4f, 1.339887440266574e-3f, 9.618437357674640e-3f,
+    5.550332471162809e-2f, 2.402264791363012e-1f, 6.931472028550421e-1f};
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+// Sum of the elements.
+inline float SumSse2(__m128 x) {
+  x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+  x = _mm_add_ss(x, _mm_shuffle_ps(x, x, 1));
+  return _mm_cvtss_f32(x);
+}
+
+inline __m128 LogApproximationSse2(__m128 x) {
+  __m128 y = _mm_cvtepi32_ps(_mm_castps_si128(x));
+  y = _mm_mul_ps(y, _mm_set1_ps(kOneBy2Pow23));
+  y = _mm_sub_ps(y, _mm_set1_ps(kLog2Bias));
+  return _mm_mul_ps(y, _mm_set1_ps(kLogOf2));
+}
+
+inline __m128 Pow2ApproximationSse2(__m128 p) {
+  p = _mm_max_ps(_mm_min_ps(p, _mm_set1_ps(kMaxPow2Exponent)),
+                 _mm_set1_ps(kMinPow2Exponent));
+  // Rounds to the nearest integer, leaving a fraction in [-0.5, 0.5].
+  const __m128i n = _mm_cvtps_epi32(p);
+  const __m128 f = _mm_sub_ps(p, _mm_cvtepi32_ps(n));
+  __m128 y = _mm_set1_ps(kPow2Coefficients[0]);
+  for (int k = 1; k < 6; ++k) {
+    y = _mm_add_ps(_mm_mul_ps(y, f), _mm_set1_ps(kPow2Coefficients[k]));
+  }
+  y = _mm_add_ps(_mm_mul_ps(y, f), _mm_set1_ps(1.f));
+  const __m128i scale =
+      _mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23);
+  return _mm_mul_ps(y, _mm_castsi128_ps(scale));
+}
+
+inline __m128 ExpApproximationSse2(__m128 x) {
+  const __m128 p = _mm_mul_ps(_mm_mul_ps(x, _mm_set1_ps(kLog10Ofe)),
+                              _mm_set1_ps(kFastLog2Of10));
+  return Pow2ApproximationSse2(p);
+}
+
+#endif  // WEBRTC_ARCH_X86_FAMILY
+
+#if defined(WEBRTC_HAS_NEON)
+
+// Elementwise x / y. ARMv7 has no vector division, so there it is computed
+// from a reciprocal estimate refined by two Newton-Raphson steps, which is
+// accurate to about 1 ulp.
+inline float32x4_t DivideNeon(float32x4_t x, float32x4_t y) {
+#if defined(WEBRTC_ARCH_ARM64)
+  return vdivq_f32(x, y);
+#else
+  float32x4_t reciprocal = vrecpeq_f32(y);
+  reciprocal = vmulq_f32(vrecpsq_f32(y, reciprocal), reciprocal);
+  reciprocal = vmulq_f32(vrecpsq_f32(y, reciprocal), reciprocal);
+  return vmulq_f32(x, reciprocal);
+#endif
+}
+
+// Sum of the elements.
+inline float SumNeon(float32x4_t x) {
+#if defined(WEBRTC_ARCH_ARM64)
+  return vaddvq_f32(x);
+#else
+  const float32x2_t sum = vadd_f32(vget_low_f32(x), vget_high_f32(x));
+  return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#endif
+}
+
+inline float32x4_t LogApproximationNeon(float32x4_t x) {
+  float32x4_t y = vcvtq_f32_s32(vreinterpretq_s32_f32(x));
+  y = vmulq_n_f32(y, kOneBy2Pow23);
+  y = vsubq_f32(y, vdupq_n_f32(kLog2Bias));
+  return vmulq_n_f32(y, kLogOf2);
+}
+
+inline float32x4_t Pow2ApproximationNeon(float32x4_t p) {
+  p = vmaxq_f32(vminq_f32(p, vdupq_n_f32(kMaxPow2Exponent)),
+                vdupq_n_f32(kMinPow2Exponent));
+  // Rounds to the nearest integer by flooring p + 0.5, leaving a fraction in
+  // [-0.5, 0.5]. The conversion truncates, so negative values are adjusted.
+  const float32x4_t p_half = vaddq_f32(p, vdupq_n_f32(0.5f));
+  int32x4_t n = vcvtq_s32_f32(p_half);
+  const uint32x4_t too_large = vcgtq_f32(vcvtq_f32_s32(n), p_half);
+  n = vaddq_s32(n, vreinterpretq_s32_u32(too_large));
+  const float32x4_t f = vsubq_f32(p, vcvtq_f32_s32(n));
+  float32x4_t y = vdupq_n_f32(kPow2Coefficients[0]);
+  for (int k = 1; k < 6; ++k) {
+    y = vmlaq_f32(vdupq_n_f32(kPow2Coefficients[k]), y, f);
+  }
+  y = vmlaq_f32(vdupq_n_f32(1.f), y, f);
+  const int32x4_t scale = vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23);
+  return vmulq_f32(y, vreinterpretq_f32_s32(scale));
+}
+
+inline float32x4_t ExpApproximationNeon(float32x4_t x) {
+  const float32x4_t p = vmulq_n_f32(vmulq_n_f32(x, kLog10Ofe), kFastLog2Of10);
+  return Pow2ApproximationNeon(p);
+}
+
+#endif  // WEBRTC_HAS_NEON
+
+}  // namespace ns_simd
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_NS_FAST_MATH_SIMD_H_
@@ -49,8 +49,10 @@ constexpr std::array<float, 129> log_table = {
 
 }  // namespace
 
-NoiseEstimator::NoiseEstimator(const SuppressionParams& suppression_params)
-    : suppression_params_(suppression_params) {
+NoiseEstimator::NoiseEstimator(const SuppressionParams& suppression_params,
+                               NsOptimization optimization)
+    : suppression_params_(suppression_params),
+      quantile_noise_estimator_(optimization) {
   noise_spectrum_.fill(0.f);
   prev_noise_spectrum_.fill(0.f);
   conservative_noise_spectrum_.fill(0.f);
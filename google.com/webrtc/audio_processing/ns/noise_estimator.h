@@ -24,7 +24,8 @@ namespace webrtc {
 // signal.
 class NoiseEstimator {
  public:
-  explicit NoiseEstimator(const SuppressionParams& suppression_params);
+  NoiseEstimator(const SuppressionParams& suppression_params,
+                 NsOptimization optimization);
 
   // Prepare the estimator for analysis of a new frame.
   void PrepareAnalysis();
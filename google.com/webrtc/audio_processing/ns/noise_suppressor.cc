@@ -17,7 +17,16 @@
 #include <algorithm>
 
 #include "audio_processing/ns/fast_math.h"
+#include "audio_processing/utility/pffft_wrapper.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 
 namespace webrtc {
 
@@ -144,21 +153,101 @@ float ComputeEnergyOfExtendedFrame(
   return energy;
 }
 
-// Computes the magnitude spectrum based on an FFT output.
-void ComputeMagnitudeSpectrum(
-    ArrayView<const float, kFftSize> real,
-    ArrayView<const float, kFftSize> imag,
-    ArrayView<float, kFftSizeBy2Plus1> signal_spectrum) {
-  signal_spectrum[0] = fabsf(real[0]) + 1.f;
-  signal_spectrum[kFftSizeBy2Plus1 - 1] =
-      fabsf(real[kFftSizeBy2Plus1 - 1]) + 1.f;
-
-  for (size_t i = 1; i < kFftSizeBy2Plus1 - 1; ++i) {
-    signal_spectrum[i] =
+// Returns the bins of channel `ch` in spectra stored one channel after the
+// other.
+ArrayView<float, kFftSizeBy2Plus1> ChannelBins(std::vector<float>& spectra,
+                                               size_t ch) {
+  return ArrayView<float, kFftSizeBy2Plus1>(&spectra[ch * kFftSizeBy2Plus1],
+                                            kFftSizeBy2Plus1);
+}
+
+// Computes the magnitude spectra of all channels, in a single pass over the
+// spectra. The FFT sets the imaginary parts of the DC and Nyquist bins to zero,
+// so these bins need no special treatment.
+void ComputeMagnitudeSpectra(NsOptimization optimization,
+                             ArrayView<const float> real,
+                             ArrayView<const float> imag,
+                             ArrayView<float> signal_spectra) {
+  RTC_DCHECK_EQ(real.size(), imag.size());
+  RTC_DCHECK_EQ(real.size(), signal_spectra.size());
+  size_t i = 0;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case NsOptimization::kSse2: {
+      const __m128 one = _mm_set1_ps(1.f);
+      for (; i + 4 <= real.size(); i += 4) {
+        const __m128 re = _mm_loadu_ps(&real[i]);
+        const __m128 im = _mm_loadu_ps(&imag[i]);
+        const __m128 power =
+            _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+        _mm_storeu_ps(&signal_spectra[i], _mm_add_ps(_mm_sqrt_ps(power), one));
+      }
+      break;
+    }
+#endif
+#if defined(WEBRTC_HAS_NEON) && defined(WEBRTC_ARCH_ARM64)
+    case NsOptimization::kNeon: {
+      const float32x4_t one = vdupq_n_f32(1.f);
+      for (; i + 4 <= real.size(); i += 4) {
+        const float32x4_t re = vld1q_f32(&real[i]);
+        const float32x4_t im = vld1q_f32(&imag[i]);
+        const float32x4_t power =
+            vaddq_f32(vmulq_f32(re, re), vmulq_f32(im, im));
+        vst1q_f32(&signal_spectra[i], vaddq_f32(vsqrtq_f32(power), one));
+      }
+      break;
+    }
+#endif
+    default:
+      break;
+  }
+
+  for (; i < real.size(); ++i) {
+    signal_spectra[i] =
         SqrtFastApproximation(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
   }
 }
 
+// Applies `filter` to the spectra of all channels.
+void ApplyFilter(NsOptimization optimization,
+                 ArrayView<const float, kFftSizeBy2Plus1> filter,
+                 std::vector<float>& real,
+                 std::vector<float>& imag) {
+  const size_t num_channels = real.size() / kFftSizeBy2Plus1;
+  for (size_t ch = 0; ch < num_channels; ++ch) {
+    ArrayView<float, kFftSizeBy2Plus1> real_ch = ChannelBins(real, ch);
+    ArrayView<float, kFftSizeBy2Plus1> imag_ch = ChannelBins(imag, ch);
+    size_t i = 0;
+    switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      case NsOptimization::kSse2:
+        for (; i + 4 <= kFftSizeBy2Plus1; i += 4) {
+          const __m128 g = _mm_loadu_ps(&filter[i]);
+          _mm_storeu_ps(&real_ch[i], _mm_mul_ps(_mm_loadu_ps(&real_ch[i]), g));
+          _mm_storeu_ps(&imag_ch[i], _mm_mul_ps(_mm_loadu_ps(&imag_ch[i]), g));
+        }
+        break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+      case NsOptimization::kNeon:
+        for (; i + 4 <= kFftSizeBy2Plus1; i += 4) {
+          const float32x4_t g = vld1q_f32(&filter[i]);
+          vst1q_f32(&real_ch[i], vmulq_f32(vld1q_f32(&real_ch[i]), g));
+          vst1q_f32(&imag_ch[i], vmulq_f32(vld1q_f32(&imag_ch[i]), g));
+        }
+        break;
+#endif
+      default:
+        break;
+    }
+
+    for (; i < kFftSizeBy2Plus1; ++i) {
+      real_ch[i] *= filter[i];
+      imag_ch[i] *= filter[i];
+    }
+  }
+}
+
 // Compute prior and post SNR.
 void ComputeSnr(ArrayView<const float, kFftSizeBy2Plus1> filter,
                 ArrayView<const float> prev_signal_spectrum,
@@ -236,13 +325,23 @@ float ComputeUpperBandsGain(
   return std::min(std::max(gain, minimum_attenuating_gain), 1.f);
 }
 
+// Selects pffft unless the plain C code is requested, or pffft is built without
+// its SIMD code, in which case it is not faster than Ooura.
+NrFft::Backend SelectFftBackend(NsOptimization optimization) {
+  return optimization != NsOptimization::kNone && Pffft::IsSimdEnabled()
+             ? NrFft::Backend::kPffft
+             : NrFft::Backend::kOoura;
+}
+
 }  // namespace
 
 NoiseSuppressor::ChannelState::ChannelState(
     const SuppressionParams& suppression_params,
+    NsOptimization optimization,
     size_t num_bands)
-    : wiener_filter(suppression_params),
-      noise_estimator(suppression_params),
+    : speech_probability_estimator(optimization),
+      wiener_filter(suppression_params, optimization),
+      noise_estimator(suppression_params, optimization),
       process_delay_memory(num_bands > 1 ? num_bands - 1 : 0) {
   analyze_analysis_memory.fill(0.f);
   prev_analysis_signal_spectrum.fill(1.f);
@@ -256,17 +355,31 @@ NoiseSuppressor::ChannelState::ChannelState(
 NoiseSuppressor::NoiseSuppressor(const NsConfig& config,
                                  size_t sample_rate_hz,
                                  size_t num_channels)
+    : NoiseSuppressor(config,
+                      sample_rate_hz,
+                      num_channels,
+                      DetectNsOptimization()) {}
+
+NoiseSuppressor::NoiseSuppressor(const NsConfig& config,
+                                 size_t sample_rate_hz,
+                                 size_t num_channels,
+                                 NsOptimization optimization)
     : num_bands_(NumBandsForRate(sample_rate_hz)),
       num_channels_(num_channels),
       suppression_params_(config.target_level),
-      filter_bank_states_heap_(NumChannelsOnHeap(num_channels_)),
+      optimization_(optimization),
+      fft_(SelectFftBackend(optimization)),
+      real_(num_channels_ * kFftSizeBy2Plus1),
+      imag_(num_channels_ * kFftSizeBy2Plus1),
+      signal_spectra_(num_channels_ * kFftSizeBy2Plus1),
+      extended_frames_(num_channels_),
       upper_band_gains_heap_(NumChannelsOnHeap(num_channels_)),
       energies_before_filtering_heap_(NumChannelsOnHeap(num_channels_)),
       gain_adjustments_heap_(NumChannelsOnHeap(num_channels_)),
       channels_(num_channels_) {
   for (size_t ch = 0; ch < num_channels_; ++ch) {
-    channels_[ch] =
-        std::make_unique<ChannelState>(suppression_params_, num_bands_);
+    channels_[ch] = std::make_unique<ChannelState>(suppression_params_,
+                                                   optimization_, num_bands_);
   }
 }
 
@@ -280,7 +393,30 @@ void NoiseSuppressor::AggregateWienerFilters(
     ArrayView<const float, kFftSizeBy2Plus1> filter_ch =
         channels_[ch]->wiener_filter.get_filter();
 
-    for (size_t k = 0; k < kFftSizeBy2Plus1; ++k) {
+    size_t k = 0;
+    switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      // _mm_min_ps(a, b) returns b unless a < b, as std::min(b, a) does.
+      case NsOptimization::kSse2:
+        for (; k + 4 <= kFftSizeBy2Plus1; k += 4) {
+          _mm_storeu_ps(&filter[k], _mm_min_ps(_mm_loadu_ps(&filter_ch[k]),
+                                               _mm_loadu_ps(&filter[k])));
+        }
+        break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+      case NsOptimization::kNeon:
+        for (; k + 4 <= kFftSizeBy2Plus1; k += 4) {
+          vst1q_f32(&filter[k],
+                    vminq_f32(vld1q_f32(&filter[k]), vld1q_f32(&filter_ch[k])));
+        }
+        break;
+#endif
+      default:
+        break;
+    }
+
+    for (; k < kFftSizeBy2Plus1; ++k) {
       filter[k] = std::min(filter[k], filter_ch[k]);
     }
   }
@@ -322,24 +458,30 @@ void NoiseSuppressor::Analyze(const AudioBuffer& audio) {
     num_analyzed_frames_ = 0;
   }
 
-  // Analyze all channels.
+  // Transform all channels.
   for (size_t ch = 0; ch < num_channels_; ++ch) {
-    std::unique_ptr<ChannelState>& ch_p = channels_[ch];
     ArrayView<const float, kNsFrameSize> y_band0(
         &audio.split_bands_const(ch)[0][0], kNsFrameSize);
 
     // Form an extended frame and apply analysis filter bank windowing.
-    std::array<float, kFftSize> extended_frame;
-    FormExtendedFrame(y_band0, ch_p->analyze_analysis_memory, extended_frame);
-    ApplyFilterBankWindow(extended_frame);
+    FormExtendedFrame(y_band0, channels_[ch]->analyze_analysis_memory,
+                      extended_frames_[ch]);
+    ApplyFilterBankWindow(extended_frames_[ch]);
 
-    // Compute the magnitude spectrum.
-    std::array<float, kFftSize> real;
-    std::array<float, kFftSize> imag;
-    fft_.Fft(extended_frame, real, imag);
+    fft_.Fft(extended_frames_[ch], ChannelBins(real_, ch),
+             ChannelBins(imag_, ch));
+  }
 
-    std::array<float, kFftSizeBy2Plus1> signal_spectrum;
-    ComputeMagnitudeSpectrum(real, imag, signal_spectrum);
+  // Compute the magnitude spectra.
+  ComputeMagnitudeSpectra(optimization_, real_, imag_, signal_spectra_);
+
+  // Analyze all channels.
+  for (size_t ch = 0; ch < num_channels_; ++ch) {
+    std::unique_ptr<ChannelState>& ch_p = channels_[ch];
+    ArrayView<const float, kFftSizeBy2Plus1> real = ChannelBins(real_, ch);
+    ArrayView<const float, kFftSizeBy2Plus1> imag = ChannelBins(imag_, ch);
+    ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum =
+        ChannelBins(signal_spectra_, ch);
 
     // Compute energies.
     float signal_energy = 0.f;
@@ -382,9 +524,6 @@ void NoiseSuppressor::Analyze(const AudioBuffer& audio) {
 
 void NoiseSuppressor::Process(AudioBuffer* audio) {
   // Select the space for storing data during the processing.
-  std::array<FilterBankState, kMaxNumChannelsOnStack> filter_bank_states_stack;
-  ArrayView<FilterBankState> filter_bank_states(filter_bank_states_stack.data(),
-                                                num_channels_);
   std::array<float, kMaxNumChannelsOnStack> upper_band_gains_stack;
   ArrayView<float> upper_band_gains(upper_band_gains_stack.data(),
                                     num_channels_);
@@ -397,8 +536,6 @@ void NoiseSuppressor::Process(AudioBuffer* audio) {
   if (NumChannelsOnHeap(num_channels_) > 0) {
     // If the stack-allocated space is too small, use the heap for storing the
     // data.
-    filter_bank_states = ArrayView<FilterBankState>(
-        filter_bank_states_heap_.data(), num_channels_);
     upper_band_gains =
         ArrayView<float>(upper_band_gains_heap_.data(), num_channels_);
     energies_before_filtering =
@@ -407,27 +544,31 @@ void NoiseSuppressor::Process(AudioBuffer* audio) {
         ArrayView<float>(gain_adjustments_heap_.data(), num_channels_);
   }
 
-  // Compute the suppression filters for all channels.
+  // Perform filter bank analysis for all channels.
   for (size_t ch = 0; ch < num_channels_; ++ch) {
     // Form an extended frame and apply analysis filter bank windowing.
     ArrayView<float, kNsFrameSize> y_band0(&audio->split_bands(ch)[0][0],
                                            kNsFrameSize);
 
     FormExtendedFrame(y_band0, channels_[ch]->process_analysis_memory,
-                      filter_bank_states[ch].extended_frame);
+                      extended_frames_[ch]);
 
-    ApplyFilterBankWindow(filter_bank_states[ch].extended_frame);
+    ApplyFilterBankWindow(extended_frames_[ch]);
 
     energies_before_filtering[ch] =
-        ComputeEnergyOfExtendedFrame(filter_bank_states[ch].extended_frame);
+        ComputeEnergyOfExtendedFrame(extended_frames_[ch]);
 
-    // Perform filter bank analysis and compute the magnitude spectrum.
-    fft_.Fft(filter_bank_states[ch].extended_frame, filter_bank_states[ch].real,
-             filter_bank_states[ch].imag);
+    fft_.Fft(extended_frames_[ch], ChannelBins(real_, ch),
+             ChannelBins(imag_, ch));
+  }
 
-    std::array<float, kFftSizeBy2Plus1> signal_spectrum;
-    ComputeMagnitudeSpectrum(filter_bank_states[ch].real,
-                             filter_bank_states[ch].imag, signal_spectrum);
+  // Compute the magnitude spectra.
+  ComputeMagnitudeSpectra(optimization_, real_, imag_, signal_spectra_);
+
+  // Compute the suppression filters for all channels.
+  for (size_t ch = 0; ch < num_channels_; ++ch) {
+    ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum =
+        ChannelBins(signal_spectra_, ch);
 
     // Compute the frequency domain gain filter for noise attenuation.
     channels_[ch]->wiener_filter.Update(
@@ -464,26 +605,21 @@ void NoiseSuppressor::Process(AudioBuffer* audio) {
     AggregateWienerFilters(filter_data);
   }
 
-  for (size_t ch = 0; ch < num_channels_; ++ch) {
-    // Apply the filter to the lower band.
-    for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
-      filter_bank_states[ch].real[i] *= filter[i];
-      filter_bank_states[ch].imag[i] *= filter[i];
-    }
-  }
+  // Apply the filter to the lower band of all channels.
+  ApplyFilter(optimization_, filter, real_, imag_);
 
   // Perform filter bank synthesis
   for (size_t ch = 0; ch < num_channels_; ++ch) {
-    fft_.Ifft(filter_bank_states[ch].real, filter_bank_states[ch].imag,
-              filter_bank_states[ch].extended_frame);
+    fft_.Ifft(ChannelBins(real_, ch), ChannelBins(imag_, ch),
+              extended_frames_[ch]);
   }
 
   for (size_t ch = 0; ch < num_channels_; ++ch) {
     const float energy_after_filtering =
-        ComputeEnergyOfExtendedFrame(filter_bank_states[ch].extended_frame);
+        ComputeEnergyOfExtendedFrame(extended_frames_[ch]);
 
     // Apply synthesis window.
-    ApplyFilterBankWindow(filter_bank_states[ch].extended_frame);
+    ApplyFilterBankWindow(extended_frames_[ch]);
 
     // Compute the adjustment of the noise attenuation filter based on the
     // effect of the attenuation.
@@ -502,8 +638,8 @@ void NoiseSuppressor::Process(AudioBuffer* audio) {
   }
   for (size_t ch = 0; ch < num_channels_; ++ch) {
     for (size_t i = 0; i < kFftSize; ++i) {
-      filter_bank_states[ch].extended_frame[i] =
-          gain_adjustment * filter_bank_states[ch].extended_frame[i];
+      extended_frames_[ch][i] =
+          gain_adjustment * extended_frames_[ch][i];
     }
   }
 
@@ -511,7 +647,7 @@ void NoiseSuppressor::Process(AudioBuffer* audio) {
   for (size_t ch = 0; ch < num_channels_; ++ch) {
     ArrayView<float, kNsFrameSize> y_band0(&audio->split_bands(ch)[0][0],
                                            kNsFrameSize);
-    OverlapAndAdd(filter_bank_states[ch].extended_frame,
+    OverlapAndAdd(extended_frames_[ch],
                   channels_[ch]->process_synthesis_memory, y_band0);
   }
 
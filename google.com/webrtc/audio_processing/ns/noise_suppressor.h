@@ -11,6 +11,7 @@
 #ifndef MODULES_AUDIO_PROCESSING_NS_NOISE_SUPPRESSOR_H_
 #define MODULES_AUDIO_PROCESSING_NS_NOISE_SUPPRESSOR_H_
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -31,6 +32,12 @@ class NoiseSuppressor {
   NoiseSuppressor(const NsConfig& config,
                   size_t sample_rate_hz,
                   size_t num_channels);
+  // Uses the per-bin kernels selected by `optimization` instead of the
+  // detected ones. With kNone, the FFT is also computed by plain C code.
+  NoiseSuppressor(const NsConfig& config,
+                  size_t sample_rate_hz,
+                  size_t num_channels,
+                  NsOptimization optimization);
   NoiseSuppressor(const NoiseSuppressor&) = delete;
   NoiseSuppressor& operator=(const NoiseSuppressor&) = delete;
 
@@ -53,12 +60,15 @@ class NoiseSuppressor {
   const size_t num_bands_;
   const size_t num_channels_;
   const SuppressionParams suppression_params_;
+  const NsOptimization optimization_;
   int32_t num_analyzed_frames_ = -1;
   NrFft fft_;
   bool capture_output_used_ = true;
 
   struct ChannelState {
-    ChannelState(const SuppressionParams& suppression_params, size_t num_bands);
+    ChannelState(const SuppressionParams& suppression_params,
+                 NsOptimization optimization,
+                 size_t num_bands);
 
     SpeechProbabilityEstimator speech_probability_estimator;
     WienerFilter wiener_filter;
@@ -70,13 +80,13 @@ class NoiseSuppressor {
     std::vector<std::array<float, kOverlapSize>> process_delay_memory;
   };
 
-  struct FilterBankState {
-    std::array<float, kFftSize> real;
-    std::array<float, kFftSize> imag;
-    std::array<float, kFftSize> extended_frame;
-  };
-
-  std::vector<FilterBankState> filter_bank_states_heap_;
+  // The spectra and magnitude spectra of all channels, stored one channel
+  // after the other, so that the passes over all channels run over contiguous
+  // memory.
+  std::vector<float> real_;
+  std::vector<float> imag_;
+  std::vector<float> signal_spectra_;
+  std::vector<std::array<float, kFftSize>> extended_frames_;
   std::vector<float> upper_band_gains_heap_;
   std::vector<float> energies_before_filtering_heap_;
   std::vector<float> gain_adjustments_heap_;
@@ -0,0 +1,31 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio_processing/ns/ns_common.h"
+
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+
+NsOptimization DetectNsOptimization() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (GetCPUInfo(kSSE2) != 0) {
+    return NsOptimization::kSse2;
+  }
+#endif
+
+  // The NEON paths have not been built and checked against the plain code on
+  // an ARM target yet, so they are only reachable by asking for kNeon
+  // explicitly, as the kernel checks do.
+  return NsOptimization::kNone;
+}
+
+}  // namespace webrtc
@@ -29,6 +29,11 @@ constexpr float kBinSizeLrt = 0.1f;
 constexpr float kBinSizeSpecFlat = 0.05f;
 constexpr float kBinSizeSpecDiff = 0.1f;
 
+enum class NsOptimization { kNone, kSse2, kNeon };
+
+// Detects what kind of optimizations to use for the per-bin computations.
+NsOptimization DetectNsOptimization();
+
 }  // namespace webrtc
 
 #endif  // MODULES_AUDIO_PROCESSING_NS_NS_COMMON_H_
@@ -10,11 +10,26 @@
 
 #include "audio_processing/ns/ns_fft.h"
 
+#include <algorithm>
+#include <memory>
+
 #include "common_audio/third_party/ooura/fft_size_256/fft4g.h"
+#include "rtc_base/checks.h"
 
 namespace webrtc {
 
-NrFft::NrFft() : bit_reversal_state_(kFftSize / 2), tables_(kFftSize / 2) {
+NrFft::NrFft()
+    : NrFft(Pffft::IsSimdEnabled() ? Backend::kPffft : Backend::kOoura) {}
+
+NrFft::NrFft(Backend backend) : backend_(backend) {
+  if (backend_ == Backend::kPffft) {
+    pffft_ = std::make_unique<Pffft>(kFftSize, Pffft::FftType::kReal);
+    pffft_buffer_ = pffft_->CreateBuffer();
+    return;
+  }
+
+  bit_reversal_state_.resize(kFftSize / 2);
+  tables_.resize(kFftSize / 2);
   // Initialize WebRtc_rdt (setting (bit_reversal_state_[0] to 0 triggers
   // initialization)
   bit_reversal_state_[0] = 0.f;
@@ -24,9 +39,32 @@ NrFft::NrFft() : bit_reversal_state_(kFftSize / 2), tables_(kFftSize / 2) {
               tables_.data());
 }
 
+NrFft::~NrFft() = default;
+
 void NrFft::Fft(ArrayView<float, kFftSize> time_data,
-                ArrayView<float, kFftSize> real,
-                ArrayView<float, kFftSize> imag) {
+                ArrayView<float, kFftSizeBy2Plus1> real,
+                ArrayView<float, kFftSizeBy2Plus1> imag) {
+  if (backend_ == Backend::kPffft) {
+    // The ordered pffft output has the same layout as the Ooura output, but
+    // the opposite sign of the imaginary parts.
+    ArrayView<float> data = pffft_buffer_->GetView();
+    std::copy(time_data.begin(), time_data.end(), data.begin());
+    pffft_->ForwardTransform(*pffft_buffer_, pffft_buffer_.get(),
+                             /*ordered=*/true);
+
+    imag[0] = 0;
+    real[0] = data[0];
+
+    imag[kFftSizeBy2Plus1 - 1] = 0;
+    real[kFftSizeBy2Plus1 - 1] = data[1];
+
+    for (size_t i = 1; i < kFftSizeBy2Plus1 - 1; ++i) {
+      real[i] = data[2 * i];
+      imag[i] = -data[2 * i + 1];
+    }
+    return;
+  }
+
   WebRtc_rdft(kFftSize, 1, time_data.data(), bit_reversal_state_.data(),
               tables_.data());
 
@@ -45,6 +83,23 @@ void NrFft::Fft(ArrayView<float, kFftSize> time_data,
 void NrFft::Ifft(ArrayView<const float> real,
                  ArrayView<const float> imag,
                  ArrayView<float> time_data) {
+  RTC_DCHECK_EQ(kFftSize, time_data.size());
+  if (backend_ == Backend::kPffft) {
+    // Scale the spectrum, as pffft leaves the inverse with a gain of kFftSize.
+    constexpr float kScaling = 1.f / kFftSize;
+    ArrayView<float> data = pffft_buffer_->GetView();
+    data[0] = real[0] * kScaling;
+    data[1] = real[kFftSizeBy2Plus1 - 1] * kScaling;
+    for (size_t i = 1; i < kFftSizeBy2Plus1 - 1; ++i) {
+      data[2 * i] = real[i] * kScaling;
+      data[2 * i + 1] = -imag[i] * kScaling;
+    }
+    pffft_->BackwardTransform(*pffft_buffer_, pffft_buffer_.get(),
+                              /*ordered=*/true);
+    std::copy(data.begin(), data.end(), time_data.begin());
+    return;
+  }
+
   time_data[0] = real[0];
   time_data[1] = real[kFftSizeBy2Plus1 - 1];
   for (size_t i = 1; i < kFftSizeBy2Plus1 - 1; ++i) {
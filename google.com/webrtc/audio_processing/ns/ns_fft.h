@@ -11,24 +11,34 @@
 #ifndef MODULES_AUDIO_PROCESSING_NS_NS_FFT_H_
 #define MODULES_AUDIO_PROCESSING_NS_NS_FFT_H_
 
+#include <memory>
 #include <vector>
 
 #include "api/array_view.h"
 #include "audio_processing/ns/ns_common.h"
+#include "audio_processing/utility/pffft_wrapper.h"
 
 namespace webrtc {
 
 // Wrapper class providing 256 point FFT functionality.
 class NrFft {
  public:
+  // The FFT implementations. Both produce the same spectrum and scaling, up to
+  // rounding.
+  enum class Backend { kOoura, kPffft };
+
+  // Uses pffft when it is built with SIMD support, and else Ooura.
   NrFft();
+  explicit NrFft(Backend backend);
   NrFft(const NrFft&) = delete;
   NrFft& operator=(const NrFft&) = delete;
+  ~NrFft();
 
-  // Transforms the signal from time to frequency domain.
+  // Transforms the signal from time to frequency domain. Note that the Ooura
+  // backend uses `time_data` as scratch buffer.
   void Fft(ArrayView<float, kFftSize> time_data,
-           ArrayView<float, kFftSize> real,
-           ArrayView<float, kFftSize> imag);
+           ArrayView<float, kFftSizeBy2Plus1> real,
+           ArrayView<float, kFftSizeBy2Plus1> imag);
 
   // Transforms the signal from frequency to time domain.
   void Ifft(ArrayView<const float> real,
@@ -36,8 +46,11 @@ class NrFft {
             ArrayView<float> time_data);
 
  private:
+  const Backend backend_;
   std::vector<size_t> bit_reversal_state_;
   std::vector<float> tables_;
+  std::unique_ptr<Pffft> pffft_;
+  std::unique_ptr<Pffft::FloatBuffer> pffft_buffer_;
 };
 
 }  // namespace webrtc
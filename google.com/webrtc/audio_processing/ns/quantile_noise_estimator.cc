@@ -16,7 +16,8 @@
 
 namespace webrtc {
 
-QuantileNoiseEstimator::QuantileNoiseEstimator() {
+QuantileNoiseEstimator::QuantileNoiseEstimator(NsOptimization optimization)
+    : optimization_(optimization) {
   quantile_.fill(0.f);
   density_.fill(0.3f);
   log_quantile_.fill(8.f);
@@ -31,7 +32,7 @@ void QuantileNoiseEstimator::Estimate(
     ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum,
     ArrayView<float, kFftSizeBy2Plus1> noise_spectrum) {
   std::array<float, kFftSizeBy2Plus1> log_spectrum;
-  LogApproximation(signal_spectrum, log_spectrum);
+  LogApproximation(optimization_, signal_spectrum, log_spectrum);
 
   int quantile_index_to_return = -1;
   // Loop over simultaneous estimates.
@@ -77,6 +78,7 @@ void QuantileNoiseEstimator::Estimate(
 
   if (quantile_index_to_return >= 0) {
     ExpApproximation(
+        optimization_,
         ArrayView<const float>(&log_quantile_[quantile_index_to_return],
                                kFftSizeBy2Plus1),
         quantile_);
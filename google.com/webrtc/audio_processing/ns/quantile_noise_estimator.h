@@ -25,7 +25,7 @@ constexpr int kSimult = 3;
 // For quantile noise estimation.
 class QuantileNoiseEstimator {
  public:
-  QuantileNoiseEstimator();
+  explicit QuantileNoiseEstimator(NsOptimization optimization);
   QuantileNoiseEstimator(const QuantileNoiseEstimator&) = delete;
   QuantileNoiseEstimator& operator=(const QuantileNoiseEstimator&) = delete;
 
@@ -34,6 +34,7 @@ class QuantileNoiseEstimator {
                 ArrayView<float, kFftSizeBy2Plus1> noise_spectrum);
 
  private:
+  const NsOptimization optimization_;
   std::array<float, kSimult * kFftSizeBy2Plus1> density_;
   std::array<float, kSimult * kFftSizeBy2Plus1> log_quantile_;
   std::array<float, kFftSizeBy2Plus1> quantile_;
@@ -11,6 +11,9 @@
 #include "audio_processing/ns/signal_model_estimator.h"
 
 #include "audio_processing/ns/fast_math.h"
+#include "audio_processing/ns/fast_math_simd.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
 
 namespace webrtc {
 
@@ -18,16 +21,15 @@ namespace {
 
 constexpr float kOneByFftSizeBy2Plus1 = 1.f / kFftSizeBy2Plus1;
 
-// Computes the difference measure between input spectrum and a template/learned
-// noise spectrum.
-float ComputeSpectralDiff(
+// Computes the unnormalized covariance and variances of the signal spectrum
+// and a template/learned noise spectrum.
+void ComputeSpectralMoments(
     ArrayView<const float, kFftSizeBy2Plus1> conservative_noise_spectrum,
     ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum,
-    float signal_spectral_sum,
-    float diff_normalization) {
-  // spectral_diff = var(signal_spectrum) - cov(signal_spectrum, magnAvgPause)^2
-  // / var(magnAvgPause)
-
+    float signal_average,
+    float* covariance,
+    float* noise_variance,
+    float* signal_variance) {
   // Compute average quantities.
   float noise_average = 0.f;
   for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
@@ -35,18 +37,299 @@ float ComputeSpectralDiff(
     noise_average += conservative_noise_spectrum[i];
   }
   noise_average = noise_average * kOneByFftSizeBy2Plus1;
-  float signal_average = signal_spectral_sum * kOneByFftSizeBy2Plus1;
 
   // Compute variance and covariance quantities.
-  float covariance = 0.f;
-  float noise_variance = 0.f;
-  float signal_variance = 0.f;
+  *covariance = 0.f;
+  *noise_variance = 0.f;
+  *signal_variance = 0.f;
   for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
     float signal_diff = signal_spectrum[i] - signal_average;
     float noise_diff = conservative_noise_spectrum[i] - noise_average;
-    covariance += signal_diff * noise_diff;
-    noise_variance += noise_diff * noise_diff;
-    signal_variance += signal_diff * signal_diff;
+    *covariance += signal_diff * noise_diff;
+    *noise_variance += noise_diff * noise_diff;
+    *signal_variance += signal_diff * signal_diff;
+  }
+}
+
+// Returns the sum of the log spectrum from bin 1, and whether any of those
+// bins is zero.
+float ComputeLogSpectrumSum(
+    ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum,
+    bool* contains_zero) {
+  for (size_t i = 1; i < kFftSizeBy2Plus1; ++i) {
+    if (signal_spectrum[i] == 0.f) {
+      *contains_zero = true;
+      return 0.f;
+    }
+  }
+
+  *contains_zero = false;
+  float sum = 0.f;
+  for (size_t i = 1; i < kFftSizeBy2Plus1; ++i) {
+    sum += LogApproximation(signal_spectrum[i]);
+  }
+  return sum;
+}
+
+// Updates the time-smoothed log LRT factors and returns their sum.
+float UpdateSpectralLrt(ArrayView<const float, kFftSizeBy2Plus1> prior_snr,
+                        ArrayView<const float, kFftSizeBy2Plus1> post_snr,
+                        ArrayView<float, kFftSizeBy2Plus1> avg_log_lrt) {
+  for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
+    float tmp1 = 1.f + 2.f * prior_snr[i];
+    float tmp2 = 2.f * prior_snr[i] / (tmp1 + 0.0001f);
+    float bessel_tmp = (post_snr[i] + 1.f) * tmp2;
+    avg_log_lrt[i] +=
+        .5f * (bessel_tmp - LogApproximation(tmp1) - avg_log_lrt[i]);
+  }
+
+  float log_lrt_time_avg_k_sum = 0.f;
+  for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
+    log_lrt_time_avg_k_sum += avg_log_lrt[i];
+  }
+  return log_lrt_time_avg_k_sum;
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void ComputeSpectralMoments_SSE2(
+    ArrayView<const float, kFftSizeBy2Plus1> conservative_noise_spectrum,
+    ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum,
+    float signal_average,
+    float* covariance,
+    float* noise_variance,
+    float* signal_variance) {
+  constexpr size_t kNumVectorized = kFftSizeBy2Plus1 & ~size_t{3};
+
+  __m128 noise_sum = _mm_setzero_ps();
+  for (size_t i = 0; i < kNumVectorized; i += 4) {
+    noise_sum =
+        _mm_add_ps(noise_sum, _mm_loadu_ps(&conservative_noise_spectrum[i]));
+  }
+  float noise_average = ns_simd::SumSse2(noise_sum);
+  for (size_t i = kNumVectorized; i < kFftSizeBy2Plus1; ++i) {
+    noise_average += conservative_noise_spectrum[i];
+  }
+  noise_average = noise_average * kOneByFftSizeBy2Plus1;
+
+  const __m128 signal_average_4 = _mm_set1_ps(signal_average);
+  const __m128 noise_average_4 = _mm_set1_ps(noise_average);
+  __m128 covariance_4 = _mm_setzero_ps();
+  __m128 noise_variance_4 = _mm_setzero_ps();
+  __m128 signal_variance_4 = _mm_setzero_ps();
+  for (size_t i = 0; i < kNumVectorized; i += 4) {
+    const __m128 signal_diff =
+        _mm_sub_ps(_mm_loadu_ps(&signal_spectrum[i]), signal_average_4);
+    const __m128 noise_diff = _mm_sub_ps(
+        _mm_loadu_ps(&conservative_noise_spectrum[i]), noise_average_4);
+    covariance_4 =
+        _mm_add_ps(covariance_4, _mm_mul_ps(signal_diff, noise_diff));
+    noise_variance_4 =
+        _mm_add_ps(noise_variance_4, _mm_mul_ps(noise_diff, noise_diff));
+    signal_variance_4 =
+        _mm_add_ps(signal_variance_4, _mm_mul_ps(signal_diff, signal_diff));
+  }
+  *covariance = ns_simd::SumSse2(covariance_4);
+  *noise_variance = ns_simd::SumSse2(noise_variance_4);
+  *signal_variance = ns_simd::SumSse2(signal_variance_4);
+  for (size_t i = kNumVectorized; i < kFftSizeBy2Plus1; ++i) {
+    float signal_diff = signal_spectrum[i] - signal_average;
+    float noise_diff = conservative_noise_spectrum[i] - noise_average;
+    *covariance += signal_diff * noise_diff;
+    *noise_variance += noise_diff * noise_diff;
+    *signal_variance += signal_diff * signal_diff;
+  }
+}
+
+float ComputeLogSpectrumSum_SSE2(
+    ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum,
+    bool* contains_zero) {
+  // Bins 1 to kFftSizeBy2Plus1 - 1 fill whole vectors.
+  static_assert((kFftSizeBy2Plus1 - 1) % 4 == 0, "");
+  const __m128 zero = _mm_setzero_ps();
+  __m128 zero_mask = _mm_setzero_ps();
+  __m128 sum = _mm_setzero_ps();
+  for (size_t i = 1; i < kFftSizeBy2Plus1; i += 4) {
+    const __m128 x = _mm_loadu_ps(&signal_spectrum[i]);
+    zero_mask = _mm_or_ps(zero_mask, _mm_cmpeq_ps(x, zero));
+    sum = _mm_add_ps(sum, ns_simd::LogApproximationSse2(x));
+  }
+  *contains_zero = _mm_movemask_ps(zero_mask) != 0;
+  return *contains_zero ? 0.f : ns_simd::SumSse2(sum);
+}
+
+float UpdateSpectralLrt_SSE2(ArrayView<const float, kFftSizeBy2Plus1> prior_snr,
+                             ArrayView<const float, kFftSizeBy2Plus1> post_snr,
+                             ArrayView<float, kFftSizeBy2Plus1> avg_log_lrt) {
+  constexpr size_t kNumVectorized = kFftSizeBy2Plus1 & ~size_t{3};
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 two = _mm_set1_ps(2.f);
+  const __m128 half = _mm_set1_ps(.5f);
+  const __m128 regularization = _mm_set1_ps(0.0001f);
+
+  __m128 sum = _mm_setzero_ps();
+  for (size_t i = 0; i < kNumVectorized; i += 4) {
+    const __m128 prior_snr_2 = _mm_mul_ps(two, _mm_loadu_ps(&prior_snr[i]));
+    const __m128 tmp1 = _mm_add_ps(one, prior_snr_2);
+    const __m128 tmp2 =
+        _mm_div_ps(prior_snr_2, _mm_add_ps(tmp1, regularization));
+    const __m128 bessel_tmp =
+        _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&post_snr[i]), one), tmp2);
+    __m128 lrt = _mm_loadu_ps(&avg_log_lrt[i]);
+    const __m128 update = _mm_sub_ps(
+        _mm_sub_ps(bessel_tmp, ns_simd::LogApproximationSse2(tmp1)), lrt);
+    lrt = _mm_add_ps(lrt, _mm_mul_ps(half, update));
+    _mm_storeu_ps(&avg_log_lrt[i], lrt);
+    sum = _mm_add_ps(sum, lrt);
+  }
+
+  float log_lrt_time_avg_k_sum = ns_simd::SumSse2(sum);
+  for (size_t i = kNumVectorized; i < kFftSizeBy2Plus1; ++i) {
+    float tmp1 = 1.f + 2.f * prior_snr[i];
+    float tmp2 = 2.f * prior_snr[i] / (tmp1 + 0.0001f);
+    float bessel_tmp = (post_snr[i] + 1.f) * tmp2;
+    avg_log_lrt[i] +=
+        .5f * (bessel_tmp - LogApproximation(tmp1) - avg_log_lrt[i]);
+    log_lrt_time_avg_k_sum += avg_log_lrt[i];
+  }
+  return log_lrt_time_avg_k_sum;
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+void ComputeSpectralMoments_NEON(
+    ArrayView<const float, kFftSizeBy2Plus1> conservative_noise_spectrum,
+    ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum,
+    float signal_average,
+    float* covariance,
+    float* noise_variance,
+    float* signal_variance) {
+  constexpr size_t kNumVectorized = kFftSizeBy2Plus1 & ~size_t{3};
+
+  float32x4_t noise_sum = vdupq_n_f32(0.f);
+  for (size_t i = 0; i < kNumVectorized; i += 4) {
+    noise_sum =
+        vaddq_f32(noise_sum, vld1q_f32(&conservative_noise_spectrum[i]));
+  }
+  float noise_average = ns_simd::SumNeon(noise_sum);
+  for (size_t i = kNumVectorized; i < kFftSizeBy2Plus1; ++i) {
+    noise_average += conservative_noise_spectrum[i];
+  }
+  noise_average = noise_average * kOneByFftSizeBy2Plus1;
+
+  const float32x4_t signal_average_4 = vdupq_n_f32(signal_average);
+  const float32x4_t noise_average_4 = vdupq_n_f32(noise_average);
+  float32x4_t covariance_4 = vdupq_n_f32(0.f);
+  float32x4_t noise_variance_4 = vdupq_n_f32(0.f);
+  float32x4_t signal_variance_4 = vdupq_n_f32(0.f);
+  for (size_t i = 0; i < kNumVectorized; i += 4) {
+    const float32x4_t signal_diff =
+        vsubq_f32(vld1q_f32(&signal_spectrum[i]), signal_average_4);
+    const float32x4_t noise_diff =
+        vsubq_f32(vld1q_f32(&conservative_noise_spectrum[i]), noise_average_4);
+    covariance_4 = vmlaq_f32(covariance_4, signal_diff, noise_diff);
+    noise_variance_4 = vmlaq_f32(noise_variance_4, noise_diff, noise_diff);
+    signal_variance_4 = vmlaq_f32(signal_variance_4, signal_diff, signal_diff);
+  }
+  *covariance = ns_simd::SumNeon(covariance_4);
+  *noise_variance = ns_simd::SumNeon(noise_variance_4);
+  *signal_variance = ns_simd::SumNeon(signal_variance_4);
+  for (size_t i = kNumVectorized; i < kFftSizeBy2Plus1; ++i) {
+    float signal_diff = signal_spectrum[i] - signal_average;
+    float noise_diff = conservative_noise_spectrum[i] - noise_average;
+    *covariance += signal_diff * noise_diff;
+    *noise_variance += noise_diff * noise_diff;
+    *signal_variance += signal_diff * signal_diff;
+  }
+}
+
+float ComputeLogSpectrumSum_NEON(
+    ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum,
+    bool* contains_zero) {
+  // Bins 1 to kFftSizeBy2Plus1 - 1 fill whole vectors.
+  static_assert((kFftSizeBy2Plus1 - 1) % 4 == 0, "");
+  uint32x4_t zero_mask = vdupq_n_u32(0);
+  float32x4_t sum = vdupq_n_f32(0.f);
+  for (size_t i = 1; i < kFftSizeBy2Plus1; i += 4) {
+    const float32x4_t x = vld1q_f32(&signal_spectrum[i]);
+    zero_mask = vorrq_u32(zero_mask, vceqq_f32(x, vdupq_n_f32(0.f)));
+    sum = vaddq_f32(sum, ns_simd::LogApproximationNeon(x));
+  }
+  const uint32x2_t zero_mask_2 =
+      vorr_u32(vget_low_u32(zero_mask), vget_high_u32(zero_mask));
+  *contains_zero = (vget_lane_u32(zero_mask_2, 0) |
+                    vget_lane_u32(zero_mask_2, 1)) != 0;
+  return *contains_zero ? 0.f : ns_simd::SumNeon(sum);
+}
+
+float UpdateSpectralLrt_NEON(ArrayView<const float, kFftSizeBy2Plus1> prior_snr,
+                             ArrayView<const float, kFftSizeBy2Plus1> post_snr,
+                             ArrayView<float, kFftSizeBy2Plus1> avg_log_lrt) {
+  constexpr size_t kNumVectorized = kFftSizeBy2Plus1 & ~size_t{3};
+  const float32x4_t one = vdupq_n_f32(1.f);
+  const float32x4_t regularization = vdupq_n_f32(0.0001f);
+
+  float32x4_t sum = vdupq_n_f32(0.f);
+  for (size_t i = 0; i < kNumVectorized; i += 4) {
+    const float32x4_t prior_snr_2 = vmulq_n_f32(vld1q_f32(&prior_snr[i]), 2.f);
+    const float32x4_t tmp1 = vaddq_f32(one, prior_snr_2);
+    const float32x4_t tmp2 =
+        ns_simd::DivideNeon(prior_snr_2, vaddq_f32(tmp1, regularization));
+    const float32x4_t bessel_tmp =
+        vmulq_f32(vaddq_f32(vld1q_f32(&post_snr[i]), one), tmp2);
+    float32x4_t lrt = vld1q_f32(&avg_log_lrt[i]);
+    const float32x4_t update = vsubq_f32(
+        vsubq_f32(bessel_tmp, ns_simd::LogApproximationNeon(tmp1)), lrt);
+    lrt = vmlaq_n_f32(lrt, update, .5f);
+    vst1q_f32(&avg_log_lrt[i], lrt);
+    sum = vaddq_f32(sum, lrt);
+  }
+
+  float log_lrt_time_avg_k_sum = ns_simd::SumNeon(sum);
+  for (size_t i = kNumVectorized; i < kFftSizeBy2Plus1; ++i) {
+    float tmp1 = 1.f + 2.f * prior_snr[i];
+    float tmp2 = 2.f * prior_snr[i] / (tmp1 + 0.0001f);
+    float bessel_tmp = (post_snr[i] + 1.f) * tmp2;
+    avg_log_lrt[i] +=
+        .5f * (bessel_tmp - LogApproximation(tmp1) - avg_log_lrt[i]);
+    log_lrt_time_avg_k_sum += avg_log_lrt[i];
+  }
+  return log_lrt_time_avg_k_sum;
+}
+#endif
+
+// Computes the difference measure between input spectrum and a template/learned
+// noise spectrum.
+float ComputeSpectralDiff(
+    NsOptimization optimization,
+    ArrayView<const float, kFftSizeBy2Plus1> conservative_noise_spectrum,
+    ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum,
+    float signal_spectral_sum,
+    float diff_normalization) {
+  // spectral_diff = var(signal_spectrum) - cov(signal_spectrum, magnAvgPause)^2
+  // / var(magnAvgPause)
+  float signal_average = signal_spectral_sum * kOneByFftSizeBy2Plus1;
+  float covariance;
+  float noise_variance;
+  float signal_variance;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case NsOptimization::kSse2:
+      ComputeSpectralMoments_SSE2(conservative_noise_spectrum, signal_spectrum,
+                                  signal_average, &covariance, &noise_variance,
+                                  &signal_variance);
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case NsOptimization::kNeon:
+      ComputeSpectralMoments_NEON(conservative_noise_spectrum, signal_spectrum,
+                                  signal_average, &covariance, &noise_variance,
+                                  &signal_variance);
+      break;
+#endif
+    default:
+      ComputeSpectralMoments(conservative_noise_spectrum, signal_spectrum,
+                             signal_average, &covariance, &noise_variance,
+                             &signal_variance);
   }
   covariance *= kOneByFftSizeBy2Plus1;
   noise_variance *= kOneByFftSizeBy2Plus1;
@@ -61,6 +344,7 @@ float ComputeSpectralDiff(
 
 // Updates the spectral flatness based on the input spectrum.
 void UpdateSpectralFlatness(
+    NsOptimization optimization,
     ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum,
     float signal_spectral_sum,
     float* spectral_flatness) {
@@ -69,16 +353,28 @@ void UpdateSpectralFlatness(
   // Compute log of ratio of the geometric to arithmetic mean (handle the log(0)
   // separately).
   constexpr float kAveraging = 0.3f;
-  float avg_spect_flatness_num = 0.f;
-  for (size_t i = 1; i < kFftSizeBy2Plus1; ++i) {
-    if (signal_spectrum[i] == 0.f) {
-      *spectral_flatness -= kAveraging * (*spectral_flatness);
-      return;
-    }
+  bool contains_zero;
+  float avg_spect_flatness_num;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case NsOptimization::kSse2:
+      avg_spect_flatness_num =
+          ComputeLogSpectrumSum_SSE2(signal_spectrum, &contains_zero);
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case NsOptimization::kNeon:
+      avg_spect_flatness_num =
+          ComputeLogSpectrumSum_NEON(signal_spectrum, &contains_zero);
+      break;
+#endif
+    default:
+      avg_spect_flatness_num =
+          ComputeLogSpectrumSum(signal_spectrum, &contains_zero);
   }
-
-  for (size_t i = 1; i < kFftSizeBy2Plus1; ++i) {
-    avg_spect_flatness_num += LogApproximation(signal_spectrum[i]);
+  if (contains_zero) {
+    *spectral_flatness -= kAveraging * (*spectral_flatness);
+    return;
   }
 
   float avg_spect_flatness_denom = signal_spectral_sum - signal_spectrum[0];
@@ -94,31 +390,38 @@ void UpdateSpectralFlatness(
 }
 
 // Updates the log LRT measures.
-void UpdateSpectralLrt(ArrayView<const float, kFftSizeBy2Plus1> prior_snr,
+void UpdateSpectralLrt(NsOptimization optimization,
+                       ArrayView<const float, kFftSizeBy2Plus1> prior_snr,
                        ArrayView<const float, kFftSizeBy2Plus1> post_snr,
                        ArrayView<float, kFftSizeBy2Plus1> avg_log_lrt,
                        float* lrt) {
   RTC_DCHECK(lrt);
 
-  for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
-    float tmp1 = 1.f + 2.f * prior_snr[i];
-    float tmp2 = 2.f * prior_snr[i] / (tmp1 + 0.0001f);
-    float bessel_tmp = (post_snr[i] + 1.f) * tmp2;
-    avg_log_lrt[i] +=
-        .5f * (bessel_tmp - LogApproximation(tmp1) - avg_log_lrt[i]);
-  }
-
-  float log_lrt_time_avg_k_sum = 0.f;
-  for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
-    log_lrt_time_avg_k_sum += avg_log_lrt[i];
+  float log_lrt_time_avg_k_sum;
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case NsOptimization::kSse2:
+      log_lrt_time_avg_k_sum =
+          UpdateSpectralLrt_SSE2(prior_snr, post_snr, avg_log_lrt);
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case NsOptimization::kNeon:
+      log_lrt_time_avg_k_sum =
+          UpdateSpectralLrt_NEON(prior_snr, post_snr, avg_log_lrt);
+      break;
+#endif
+    default:
+      log_lrt_time_avg_k_sum =
+          UpdateSpectralLrt(prior_snr, post_snr, avg_log_lrt);
   }
   *lrt = log_lrt_time_avg_k_sum * kOneByFftSizeBy2Plus1;
 }
 
 }  // namespace
 
-SignalModelEstimator::SignalModelEstimator()
-    : prior_model_estimator_(kLtrFeatureThr) {}
+SignalModelEstimator::SignalModelEstimator(NsOptimization optimization)
+    : optimization_(optimization), prior_model_estimator_(kLtrFeatureThr) {}
 
 void SignalModelEstimator::AdjustNormalization(int32_t num_analyzed_frames,
                                                float signal_energy) {
@@ -136,13 +439,14 @@ void SignalModelEstimator::Update(
     float signal_spectral_sum,
     float signal_energy) {
   // Compute spectral flatness on input spectrum.
-  UpdateSpectralFlatness(signal_spectrum, signal_spectral_sum,
+  UpdateSpectralFlatness(optimization_, signal_spectrum, signal_spectral_sum,
                          &features_.spectral_flatness);
 
   // Compute difference of input spectrum with learned/estimated noise spectrum.
   float spectral_diff =
-      ComputeSpectralDiff(conservative_noise_spectrum, signal_spectrum,
-                          signal_spectral_sum, diff_normalization_);
+      ComputeSpectralDiff(optimization_, conservative_noise_spectrum,
+                          signal_spectrum, signal_spectral_sum,
+                          diff_normalization_);
   // Compute time-avg update of difference feature.
   features_.spectral_diff += 0.3f * (spectral_diff - features_.spectral_diff);
 
@@ -169,7 +473,8 @@ void SignalModelEstimator::Update(
   }
 
   // Compute the LRT.
-  UpdateSpectralLrt(prior_snr, post_snr, features_.avg_log_lrt, &features_.lrt);
+  UpdateSpectralLrt(optimization_, prior_snr, post_snr, features_.avg_log_lrt,
+                    &features_.lrt);
 }
 
 }  // namespace webrtc
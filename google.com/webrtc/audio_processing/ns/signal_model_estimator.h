@@ -11,6 +11,8 @@
 #ifndef MODULES_AUDIO_PROCESSING_NS_SIGNAL_MODEL_ESTIMATOR_H_
 #define MODULES_AUDIO_PROCESSING_NS_SIGNAL_MODEL_ESTIMATOR_H_
 
+#include <stdint.h>
+
 #include <array>
 
 #include "api/array_view.h"
@@ -24,7 +26,7 @@ namespace webrtc {
 
 class SignalModelEstimator {
  public:
-  SignalModelEstimator();
+  explicit SignalModelEstimator(NsOptimization optimization);
   SignalModelEstimator(const SignalModelEstimator&) = delete;
   SignalModelEstimator& operator=(const SignalModelEstimator&) = delete;
 
@@ -45,6 +47,7 @@ class SignalModelEstimator {
   const SignalModel& get_model() { return features_; }
 
  private:
+  const NsOptimization optimization_;
   float diff_normalization_ = 0.f;
   float signal_energy_sum_ = 0.f;
   Histograms histograms_;
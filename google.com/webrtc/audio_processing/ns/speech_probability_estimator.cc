@@ -15,11 +15,62 @@
 #include <algorithm>
 
 #include "audio_processing/ns/fast_math.h"
+#include "audio_processing/ns/fast_math_simd.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
 
 namespace webrtc {
 
-SpeechProbabilityEstimator::SpeechProbabilityEstimator() {
+namespace {
+
+constexpr size_t kNumVectorized = kFftSizeBy2Plus1 & ~size_t{3};
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void ComputeSpeechProbability_SSE2(
+    float gain_prior,
+    ArrayView<const float, kFftSizeBy2Plus1> avg_log_lrt,
+    ArrayView<float, kFftSizeBy2Plus1> speech_probability) {
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 minus_one = _mm_set1_ps(-1.f);
+  const __m128 gain_prior_4 = _mm_set1_ps(gain_prior);
+  for (size_t i = 0; i < kNumVectorized; i += 4) {
+    const __m128 inv_lrt = ns_simd::ExpApproximationSse2(
+        _mm_mul_ps(_mm_loadu_ps(&avg_log_lrt[i]), minus_one));
+    const __m128 denominator =
+        _mm_add_ps(one, _mm_mul_ps(gain_prior_4, inv_lrt));
+    _mm_storeu_ps(&speech_probability[i], _mm_div_ps(one, denominator));
+  }
+  for (size_t i = kNumVectorized; i < kFftSizeBy2Plus1; ++i) {
+    speech_probability[i] =
+        1.f / (1.f + gain_prior * ExpApproximation(-avg_log_lrt[i]));
+  }
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+void ComputeSpeechProbability_NEON(
+    float gain_prior,
+    ArrayView<const float, kFftSizeBy2Plus1> avg_log_lrt,
+    ArrayView<float, kFftSizeBy2Plus1> speech_probability) {
+  const float32x4_t one = vdupq_n_f32(1.f);
+  for (size_t i = 0; i < kNumVectorized; i += 4) {
+    const float32x4_t inv_lrt =
+        ns_simd::ExpApproximationNeon(vnegq_f32(vld1q_f32(&avg_log_lrt[i])));
+    vst1q_f32(&speech_probability[i],
+              ns_simd::DivideNeon(one, vmlaq_n_f32(one, inv_lrt, gain_prior)));
+  }
+  for (size_t i = kNumVectorized; i < kFftSizeBy2Plus1; ++i) {
+    speech_probability[i] =
+        1.f / (1.f + gain_prior * ExpApproximation(-avg_log_lrt[i]));
+  }
+}
+#endif
+
+}  // namespace
+
+SpeechProbabilityEstimator::SpeechProbabilityEstimator(
+    NsOptimization optimization)
+    : optimization_(optimization), signal_model_estimator_(optimization) {
   speech_probability_.fill(0.f);
 }
 
@@ -94,6 +145,23 @@ void SpeechProbabilityEstimator::Update(
   float gain_prior =
       (1.f - prior_speech_prob_) / (prior_speech_prob_ + 0.0001f);
 
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case NsOptimization::kSse2:
+      ComputeSpeechProbability_SSE2(gain_prior, model.avg_log_lrt,
+                                    speech_probability_);
+      return;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case NsOptimization::kNeon:
+      ComputeSpeechProbability_NEON(gain_prior, model.avg_log_lrt,
+                                    speech_probability_);
+      return;
+#endif
+    default:
+      break;
+  }
+
   std::array<float, kFftSizeBy2Plus1> inv_lrt;
   ExpApproximationSignFlip(model.avg_log_lrt, inv_lrt);
   for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
@@ -11,6 +11,8 @@
 #ifndef MODULES_AUDIO_PROCESSING_NS_SPEECH_PROBABILITY_ESTIMATOR_H_
 #define MODULES_AUDIO_PROCESSING_NS_SPEECH_PROBABILITY_ESTIMATOR_H_
 
+#include <stdint.h>
+
 #include <array>
 
 #include "api/array_view.h"
@@ -22,7 +24,7 @@ namespace webrtc {
 // Class for estimating the probability of speech.
 class SpeechProbabilityEstimator {
  public:
-  SpeechProbabilityEstimator();
+  explicit SpeechProbabilityEstimator(NsOptimization optimization);
   SpeechProbabilityEstimator(const SpeechProbabilityEstimator&) = delete;
   SpeechProbabilityEstimator& operator=(const SpeechProbabilityEstimator&) =
       delete;
@@ -41,6 +43,7 @@ class SpeechProbabilityEstimator {
   ArrayView<const float> get_probability() { return speech_probability_; }
 
  private:
+  const NsOptimization optimization_;
   SignalModelEstimator signal_model_estimator_;
   float prior_speech_prob_ = .5f;
   std::array<float, kFftSizeBy2Plus1> speech_probability_;
@@ -17,12 +17,15 @@
 #include <algorithm>
 
 #include "audio_processing/ns/fast_math.h"
+#include "audio_processing/ns/fast_math_simd.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/system/arch.h"
 
 namespace webrtc {
 
-WienerFilter::WienerFilter(const SuppressionParams& suppression_params)
-    : suppression_params_(suppression_params) {
+WienerFilter::WienerFilter(const SuppressionParams& suppression_params,
+                           NsOptimization optimization)
+    : suppression_params_(suppression_params), optimization_(optimization) {
   filter_.fill(1.f);
   initial_spectral_estimate_.fill(0.f);
   spectrum_prev_process_.fill(0.f);
@@ -34,7 +37,25 @@ void WienerFilter::Update(
     ArrayView<const float, kFftSizeBy2Plus1> prev_noise_spectrum,
     ArrayView<const float, kFftSizeBy2Plus1> parametric_noise_spectrum,
     ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum) {
-  for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
+  size_t num_vectorized = 0;
+  switch (optimization_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case NsOptimization::kSse2:
+      num_vectorized = UpdateDirectedDecisionSse2(
+          noise_spectrum, prev_noise_spectrum, signal_spectrum);
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case NsOptimization::kNeon:
+      num_vectorized = UpdateDirectedDecisionNeon(
+          noise_spectrum, prev_noise_spectrum, signal_spectrum);
+      break;
+#endif
+    default:
+      break;
+  }
+
+  for (size_t i = num_vectorized; i < kFftSizeBy2Plus1; ++i) {
     // Previous estimate based on previous frame with gain filter.
     float prev_tsa = spectrum_prev_process_[i] /
                      (prev_noise_spectrum[i] + 0.0001f) * filter_[i];
@@ -81,6 +102,93 @@ void WienerFilter::Update(
             spectrum_prev_process_.begin());
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+size_t WienerFilter::UpdateDirectedDecisionSse2(
+    ArrayView<const float, kFftSizeBy2Plus1> noise_spectrum,
+    ArrayView<const float, kFftSizeBy2Plus1> prev_noise_spectrum,
+    ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum) {
+  const __m128 regularization = _mm_set1_ps(0.0001f);
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 prev_weight = _mm_set1_ps(0.98f);
+  const __m128 current_weight = _mm_set1_ps(1.f - 0.98f);
+  const __m128 over_subtraction_factor =
+      _mm_set1_ps(suppression_params_.over_subtraction_factor);
+  const __m128 minimum_attenuating_gain =
+      _mm_set1_ps(suppression_params_.minimum_attenuating_gain);
+
+  size_t i = 0;
+  for (; i + 4 <= kFftSizeBy2Plus1; i += 4) {
+    const __m128 noise = _mm_loadu_ps(&noise_spectrum[i]);
+    const __m128 signal = _mm_loadu_ps(&signal_spectrum[i]);
+    __m128 filter = _mm_loadu_ps(&filter_[i]);
+
+    // Previous estimate based on previous frame with gain filter.
+    const __m128 prev_tsa = _mm_mul_ps(
+        _mm_div_ps(_mm_loadu_ps(&spectrum_prev_process_[i]),
+                   _mm_add_ps(_mm_loadu_ps(&prev_noise_spectrum[i]),
+                              regularization)),
+        filter);
+
+    // Current estimate, zero where the signal is below the noise.
+    __m128 current_tsa = _mm_sub_ps(
+        _mm_div_ps(signal, _mm_add_ps(noise, regularization)), one);
+    current_tsa = _mm_and_ps(_mm_cmpgt_ps(signal, noise), current_tsa);
+
+    const __m128 snr_prior =
+        _mm_add_ps(_mm_mul_ps(prev_weight, prev_tsa),
+                   _mm_mul_ps(current_weight, current_tsa));
+    filter =
+        _mm_div_ps(snr_prior, _mm_add_ps(over_subtraction_factor, snr_prior));
+    filter = _mm_max_ps(_mm_min_ps(filter, one), minimum_attenuating_gain);
+    _mm_storeu_ps(&filter_[i], filter);
+  }
+  return i;
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+size_t WienerFilter::UpdateDirectedDecisionNeon(
+    ArrayView<const float, kFftSizeBy2Plus1> noise_spectrum,
+    ArrayView<const float, kFftSizeBy2Plus1> prev_noise_spectrum,
+    ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum) {
+  const float32x4_t regularization = vdupq_n_f32(0.0001f);
+  const float32x4_t one = vdupq_n_f32(1.f);
+  const float32x4_t over_subtraction_factor =
+      vdupq_n_f32(suppression_params_.over_subtraction_factor);
+  const float32x4_t minimum_attenuating_gain =
+      vdupq_n_f32(suppression_params_.minimum_attenuating_gain);
+
+  size_t i = 0;
+  for (; i + 4 <= kFftSizeBy2Plus1; i += 4) {
+    const float32x4_t noise = vld1q_f32(&noise_spectrum[i]);
+    const float32x4_t signal = vld1q_f32(&signal_spectrum[i]);
+    float32x4_t filter = vld1q_f32(&filter_[i]);
+
+    // Previous estimate based on previous frame with gain filter.
+    const float32x4_t prev_tsa =
+        vmulq_f32(ns_simd::DivideNeon(
+                      vld1q_f32(&spectrum_prev_process_[i]),
+                      vaddq_f32(vld1q_f32(&prev_noise_spectrum[i]),
+                                regularization)),
+                  filter);
+
+    // Current estimate, zero where the signal is below the noise.
+    float32x4_t current_tsa = vsubq_f32(
+        ns_simd::DivideNeon(signal, vaddq_f32(noise, regularization)), one);
+    current_tsa = vreinterpretq_f32_u32(vandq_u32(
+        vcgtq_f32(signal, noise), vreinterpretq_u32_f32(current_tsa)));
+
+    const float32x4_t snr_prior = vaddq_f32(
+        vmulq_n_f32(prev_tsa, 0.98f), vmulq_n_f32(current_tsa, 1.f - 0.98f));
+    filter = ns_simd::DivideNeon(snr_prior,
+                                 vaddq_f32(over_subtraction_factor, snr_prior));
+    filter = vmaxq_f32(vminq_f32(filter, one), minimum_attenuating_gain);
+    vst1q_f32(&filter_[i], filter);
+  }
+  return i;
+}
+#endif
+
 float WienerFilter::ComputeOverallScalingFactor(
     int32_t num_analyzed_frames,
     float prior_speech_probability,
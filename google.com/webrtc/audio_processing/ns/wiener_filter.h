@@ -11,6 +11,8 @@
 #ifndef MODULES_AUDIO_PROCESSING_NS_WIENER_FILTER_H_
 #define MODULES_AUDIO_PROCESSING_NS_WIENER_FILTER_H_
 
+#include <stddef.h>
+
 #include <array>
 
 #include "api/array_view.h"
@@ -22,7 +24,8 @@ namespace webrtc {
 // Estimates a Wiener-filter based frequency domain noise reduction filter.
 class WienerFilter {
  public:
-  explicit WienerFilter(const SuppressionParams& suppression_params);
+  WienerFilter(const SuppressionParams& suppression_params,
+               NsOptimization optimization);
   WienerFilter(const WienerFilter&) = delete;
   WienerFilter& operator=(const WienerFilter&) = delete;
 
@@ -46,7 +49,19 @@ class WienerFilter {
   }
 
  private:
+  // Computes the directed decision filter for the bins up to the largest
+  // multiple of the vector width and returns the number of bins computed.
+  size_t UpdateDirectedDecisionSse2(
+      ArrayView<const float, kFftSizeBy2Plus1> noise_spectrum,
+      ArrayView<const float, kFftSizeBy2Plus1> prev_noise_spectrum,
+      ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum);
+  size_t UpdateDirectedDecisionNeon(
+      ArrayView<const float, kFftSizeBy2Plus1> noise_spectrum,
+      ArrayView<const float, kFftSizeBy2Plus1> prev_noise_spectrum,
+      ArrayView<const float, kFftSizeBy2Plus1> signal_spectrum);
+
   const SuppressionParams& suppression_params_;
+  const NsOptimization optimization_;
   std::array<float, kFftSizeBy2Plus1> spectrum_prev_process_;
   std::array<float, kFftSizeBy2Plus1> initial_spectral_estimate_;
   std::array<float, kFftSizeBy2Plus1> filter_;
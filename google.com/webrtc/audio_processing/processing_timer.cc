@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio_processing/processing_timer.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+ProcessingTimer::Scope::Scope(ProcessingTimer* timer, size_t stage)
+    : timer_(timer), stage_(stage), start_ns_(TimeNanos()) {}
+
+ProcessingTimer::Scope::~Scope() {
+  timer_->AddToStage(stage_, TimeNanos() - start_ns_);
+}
+
+ProcessingTimer::Window::Window() {
+  samples_ns.reserve(kWindowFrames);
+}
+
+ProcessingTimer::Window::~Window() = default;
+
+bool ProcessingTimer::Window::Add(int64_t sample_ns) {
+  samples_ns.push_back(sample_ns);
+  if (samples_ns.size() < kWindowFrames) {
+    return false;
+  }
+
+  StageTiming timing;
+  int64_t sum_ns = 0;
+  for (int64_t s : samples_ns) {
+    sum_ns += s;
+  }
+  timing.mean_ns = sum_ns / static_cast<int64_t>(samples_ns.size());
+  timing.min_ns = *std::min_element(samples_ns.begin(), samples_ns.end());
+  // The sample at the 99th percentile, rounding the rank upwards.
+  const size_t p99_index = (samples_ns.size() * 99 + 99) / 100 - 1;
+  std::nth_element(samples_ns.begin(), samples_ns.begin() + p99_index,
+                   samples_ns.end());
+  timing.p99_ns = samples_ns[p99_index];
+  summary = timing;
+  samples_ns.clear();
+  return true;
+}
+
+ProcessingTimer::ProcessingTimer(size_t num_stages) : stages_(num_stages) {}
+
+ProcessingTimer::~ProcessingTimer() = default;
+
+void ProcessingTimer::BeginFrame() {
+  for (Window& stage : stages_) {
+    stage.frame_ns = 0;
+    stage.active_in_frame = false;
+  }
+  frame_start_ns_ = TimeNanos();
+  frame_begun_ = true;
+}
+
+bool ProcessingTimer::EndFrame() {
+  RTC_DCHECK(frame_begun_);
+  if (!frame_begun_) {
+    return false;
+  }
+  frame_begun_ = false;
+
+  bool summary_changed = frame_.Add(TimeNanos() - frame_start_ns_);
+  for (Window& stage : stages_) {
+    if (stage.active_in_frame) {
+      summary_changed = stage.Add(stage.frame_ns) || summary_changed;
+    }
+  }
+  return summary_changed;
+}
+
+void ProcessingTimer::AddToStage(size_t stage, int64_t elapsed_ns) {
+  RTC_DCHECK_LT(stage, stages_.size());
+  stages_[stage].frame_ns += elapsed_ns;
+  stages_[stage].active_in_frame = true;
+}
+
+}  // namespace webrtc
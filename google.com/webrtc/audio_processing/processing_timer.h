@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_PROCESSING_TIMER_H_
+#define MODULES_AUDIO_PROCESSING_PROCESSING_TIMER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <optional>
+#include <vector>
+
+#include "api/audio/audio_processing_statistics.h"
+
+namespace webrtc {
+
+// Measures the time spent per frame in the stages of a processing path and
+// summarizes it as min/mean/p99 over windows of `kWindowFrames` frames.
+//
+// A frame is delimited by BeginFrame() and EndFrame(); the time of each stage
+// is accumulated by Scope objects in between. A stage only gets a sample for
+// the frames in which it ran, so the summary of a stage describes the cost of
+// the stage when it is active. Frames that are begun but never ended, e.g. on
+// an early error return, are discarded.
+class ProcessingTimer {
+ public:
+  using StageTiming = AudioProcessingStats::StageTiming;
+
+  // One second of 10 ms frames.
+  static constexpr size_t kWindowFrames = 100;
+
+  // Adds the time from its construction to its destruction to `stage` in the
+  // current frame.
+  class Scope {
+   public:
+    Scope(ProcessingTimer* timer, size_t stage);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    ProcessingTimer* const timer_;
+    const size_t stage_;
+    const int64_t start_ns_;
+  };
+
+  explicit ProcessingTimer(size_t num_stages);
+  ~ProcessingTimer();
+  ProcessingTimer(const ProcessingTimer&) = delete;
+  ProcessingTimer& operator=(const ProcessingTimer&) = delete;
+
+  void BeginFrame();
+  // Commits the current frame. Returns true if this completed the window of
+  // the whole frame or of any stage, i.e. if any summary changed.
+  bool EndFrame();
+
+  // Summary of the whole frames in the last completed window.
+  std::optional<StageTiming> FrameTiming() const {
+    return frame_.summary;
+  }
+  // Summary of `stage` in its last completed window.
+  std::optional<StageTiming> StageTimingOf(size_t stage) const {
+    return stages_[stage].summary;
+  }
+
+ private:
+  struct Window {
+    Window();
+    ~Window();
+    // Adds a sample and returns true if it completed the window.
+    bool Add(int64_t sample_ns);
+
+    std::vector<int64_t> samples_ns;
+    std::optional<StageTiming> summary;
+    // Time accumulated within the current frame.
+    int64_t frame_ns = 0;
+    bool active_in_frame = false;
+  };
+
+  void AddToStage(size_t stage, int64_t elapsed_ns);
+
+  std::vector<Window> stages_;
+  Window frame_;
+  int64_t frame_start_ns_ = 0;
+  bool frame_begun_ = false;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_PROCESSING_TIMER_H_
@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio_processing/utility/state_serializer.h"
+
+#include <string.h>
+
+#include <cmath>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+uint32_t FloatToBits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float BitsToFloat(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+StateWriter::StateWriter(std::vector<uint8_t>* buffer) : buffer_(buffer) {
+  RTC_DCHECK(buffer_);
+}
+
+void StateWriter::WriteUint8(uint8_t value) {
+  buffer_->push_back(value);
+}
+
+void StateWriter::WriteUint32(uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    buffer_->push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void StateWriter::WriteFloat(float value) {
+  WriteUint32(FloatToBits(value));
+}
+
+void StateWriter::WriteFloats(ArrayView<const float> values) {
+  buffer_->reserve(buffer_->size() + values.size() * sizeof(uint32_t));
+  for (float value : values) {
+    WriteFloat(value);
+  }
+}
+
+void StateWriter::PatchUint32(size_t offset, uint32_t value) {
+  RTC_DCHECK_LE(offset + sizeof(uint32_t), buffer_->size());
+  for (int k = 0; k < 4; ++k) {
+    (*buffer_)[offset + k] = static_cast<uint8_t>(value >> (8 * k));
+  }
+}
+
+StateReader::StateReader(ArrayView<const uint8_t> data) : data_(data) {}
+
+bool StateReader::Consume(size_t size) {
+  if (!ok_ || remaining() < size) {
+    ok_ = false;
+    return false;
+  }
+  position_ += size;
+  return true;
+}
+
+uint8_t StateReader::ReadUint8() {
+  if (!Consume(1)) {
+    return 0;
+  }
+  return data_[position_ - 1];
+}
+
+uint32_t StateReader::ReadUint32() {
+  if (!Consume(4)) {
+    return 0;
+  }
+  const uint8_t* bytes = &data_[position_ - 4];
+  return static_cast<uint32_t>(bytes[0]) |
+         (static_cast<uint32_t>(bytes[1]) << 8) |
+         (static_cast<uint32_t>(bytes[2]) << 16) |
+         (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+float StateReader::ReadFloat() {
+  const float value = BitsToFloat(ReadUint32());
+  if (!std::isfinite(value)) {
+    ok_ = false;
+    return 0.f;
+  }
+  return value;
+}
+
+void StateReader::ReadFloats(ArrayView<float> values) {
+  for (float& value : values) {
+    value = ReadFloat();
+  }
+}
+
+StateReader StateReader::ReadSection(size_t size) {
+  const size_t start = position_;
+  if (!Consume(size)) {
+    return StateReader(ArrayView<const uint8_t>());
+  }
+  return StateReader(data_.subview(start, size));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_UTILITY_STATE_SERIALIZER_H_
+#define MODULES_AUDIO_PROCESSING_UTILITY_STATE_SERIALIZER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "api/array_view.h"
+
+namespace webrtc {
+
+// Appends values to a byte buffer in a fixed little-endian layout, so that
+// adaptive state saved on one machine can be restored on another.
+class StateWriter {
+ public:
+  explicit StateWriter(std::vector<uint8_t>* buffer);
+
+  void WriteUint8(uint8_t value);
+  void WriteUint32(uint32_t value);
+  void WriteInt32(int32_t value) { WriteUint32(static_cast<uint32_t>(value)); }
+  void WriteBool(bool value) { WriteUint8(value ? 1 : 0); }
+  void WriteFloat(float value);
+  void WriteFloats(ArrayView<const float> values);
+
+  // Number of bytes in the buffer.
+  size_t size() const { return buffer_->size(); }
+
+  // Overwrites a previously written 32-bit value at `offset`, used to fill in
+  // lengths once the data they cover has been written.
+  void PatchUint32(size_t offset, uint32_t value);
+
+ private:
+  std::vector<uint8_t>* const buffer_;
+};
+
+// Reads values written by StateWriter. Reading past the end or a float that is
+// not finite yields zeros and marks the reader as failed instead of crashing,
+// so that truncated or corrupted input is detected by checking ok() once at
+// the end.
+class StateReader {
+ public:
+  explicit StateReader(ArrayView<const uint8_t> data);
+
+  uint8_t ReadUint8();
+  uint32_t ReadUint32();
+  int32_t ReadInt32() { return static_cast<int32_t>(ReadUint32()); }
+  bool ReadBool() { return ReadUint8() != 0; }
+  float ReadFloat();
+  void ReadFloats(ArrayView<float> values);
+
+  // Returns a reader over the next `size` bytes and skips past them.
+  StateReader ReadSection(size_t size);
+
+  // Marks the reader as failed, for input that is well-formed but does not
+  // match the object it is loaded into.
+  void Invalidate() { ok_ = false; }
+
+  bool ok() const { return ok_; }
+  size_t remaining() const { return data_.size() - position_; }
+
+ private:
+  bool Consume(size_t size);
+
+  const ArrayView<const uint8_t> data_;
+  size_t position_ = 0;
+  bool ok_ = true;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_UTILITY_STATE_SERIALIZER_H_
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2026 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_SEQLOCK_H_
+#define RTC_BASE_SEQLOCK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <thread>
+#include <type_traits>
+
+namespace webrtc {
+
+// Holds a value of type T that a single writer publishes with Store() and any
+// number of readers copy with Load(), without locks. The writer never waits
+// for the readers: a reader that overlaps a Store() discards its copy and
+// retries, so readers only wait for the duration of a Store().
+//
+// T must be trivially copyable. The value is kept as an array of atomic words
+// so that concurrent accesses are not data races.
+template <typename T>
+class SeqLock {
+ public:
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SeqLock requires a trivially copyable type");
+
+  SeqLock() : SeqLock(T()) {}
+  explicit SeqLock(const T& value) { Store(value); }
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  // Publishes `value`. Only one thread at a time may call Store().
+  void Store(const T& value) {
+    uint64_t words[kNumWords] = {};
+    memcpy(words, &value, sizeof(T));
+
+    const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t k = 0; k < kNumWords; ++k) {
+      words_[k].store(words[k], std::memory_order_relaxed);
+    }
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  // Returns the most recently published value.
+  T Load() const {
+    uint64_t words[kNumWords];
+    for (;;) {
+      const uint32_t before = sequence_.load(std::memory_order_acquire);
+      if ((before & 1) == 0) {
+        for (size_t k = 0; k < kNumWords; ++k) {
+          words[k] = words_[k].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == before) {
+          break;
+        }
+      }
+      std::this_thread::yield();
+    }
+
+    T value;
+    memcpy(&value, words, sizeof(T));
+    return value;
+  }
+
+ private:
+  static constexpr size_t kNumWords =
+      (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  // Odd while a Store() is in progress.
+  std::atomic<uint32_t> sequence_{0};
+  std::atomic<uint64_t> words_[kNumWords];
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_SEQLOCK_H_
@@ -15,8 +15,9 @@
 
 namespace webrtc {
 
-// List of features in x86.
-typedef enum { kSSE2, kSSE3, kAVX2, kFMA3 } CPUFeature;
+// List of features in x86. kAVX512 denotes the AVX-512 Foundation
+// instructions.
+typedef enum { kSSE2, kSSE3, kAVX2, kFMA3, kAVX512 } CPUFeature;
 
 // List of features in ARM.
 enum {
@@ -27,7 +27,7 @@ int GetCPUInfoNoASM(CPUFeature feature) {
 
 #if defined(WEBRTC_ARCH_X86_FAMILY)
 
-#if defined(WEBRTC_ENABLE_AVX2)
+#if defined(WEBRTC_ENABLE_AVX2) || defined(WEBRTC_ENABLE_AVX512)
 // xgetbv returns the value of an Intel Extended Control Register (XCR).
 // Currently only XCR0 is defined by Intel so `xcr` should always be zero.
 static uint64_t xgetbv(uint32_t xcr) {
@@ -40,7 +40,7 @@ static uint64_t xgetbv(uint32_t xcr) {
   return (static_cast<uint64_t>(edx) << 32) | eax;
 #endif  // _MSC_VER
 }
-#endif  // WEBRTC_ENABLE_AVX2
+#endif  // WEBRTC_ENABLE_AVX2 || WEBRTC_ENABLE_AVX512
 
 #ifndef _MSC_VER
 // Intrinsic for "cpuid".
@@ -101,6 +101,25 @@ int GetCPUInfo(CPUFeature feature) {
            (cpu_info7[1] & 0x00000100) != 0 /* BMI2 */;
   }
 #endif  // WEBRTC_ENABLE_AVX2
+#if defined(WEBRTC_ENABLE_AVX512)
+  if (feature == kAVX512) {
+    int cpu_info7[4];
+    __cpuid(cpu_info7, 0);
+    int num_ids = cpu_info7[0];
+    if (num_ids < 7) {
+      return 0;
+    }
+    __cpuid(cpu_info7, 7);
+
+    // AVX-512 instructions can be used when, in addition to the AVX
+    // requirements, the kernel saves the opmask registers and the upper halves
+    // of the ZMM registers on context switches.
+    return (cpu_info[2] & 0x10000000) != 0 /* AVX */ &&
+           (cpu_info[2] & 0x08000000) != 0 /* OSXSAVE */ &&
+           (xgetbv(0) & 0x000000e6) == 0xe6 /* ZMM state enabled by kernel */ &&
+           (cpu_info7[1] & 0x00010000) != 0 /* AVX512F */;
+  }
+#endif  // WEBRTC_ENABLE_AVX512
   if (feature == kFMA3) {
     return 0 != (cpu_info[2] & 0x00001000);
   }
@@ -11,4 +11,5 @@ package source
 // #cgo linux CXXFLAGS: -DWEBRTC_LINUX -DWEBRTC_POSIX
 // #cgo android CXXFLAGS: -DWEBRTC_LINUX -DWEBRTC_ANDROID -DWEBRTC_POSIX
 // #cgo windows CXXFLAGS: -DWEBRTC_WIN
+// #cgo amd64 386 CXXFLAGS: -DWEBRTC_ENABLE_AVX2 -DWEBRTC_ENABLE_AVX512
 import "C"
@@ -0,0 +1,432 @@
+// interleave.cpp - Scalar and vectorized interleave/deinterleave kernels
+
+#include <interleave.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <google.com/webrtc/rtc_base/system/arch.h>
+#include <google.com/webrtc/system_wrappers/include/cpu_features_wrapper.h>
+
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <immintrin.h>
+#endif
+
+namespace apm {
+
+    namespace {
+
+        constexpr float kS16ToFloat = 1.f / 32768.f;
+        constexpr float kFloatToS16 = 32768.f;
+
+        inline int16_t floatToS16(float v) {
+            v *= kFloatToS16;
+            v = std::min(v, 32767.f);
+            v = std::max(v, -32768.f);
+            return static_cast<int16_t>(v + std::copysign(0.5f, v));
+        }
+
+// Generic strided loops, used for any channel count and for the tails left
+// over by the vectorized kernels. Frames are walked in the outer loop so the
+// interleaved side is accessed sequentially.
+        template<typename S, typename D, typename Convert>
+        void deinterleaveScalar(const S *src, D *const *dst, int num_channels, int begin, int end,
+                                Convert convert) {
+            for (int i = begin; i < end; ++i) {
+                const S *frame = src + i * num_channels;
+                for (int ch = 0; ch < num_channels; ++ch) {
+                    dst[ch][i] = convert(frame[ch]);
+                }
+            }
+        }
+
+        template<typename S, typename D, typename Convert>
+        void interleaveScalar(const S *const *src, D *dst, int num_channels, int begin, int end,
+                              Convert convert) {
+            for (int i = begin; i < end; ++i) {
+                D *frame = dst + i * num_channels;
+                for (int ch = 0; ch < num_channels; ++ch) {
+                    frame[ch] = convert(src[ch][i]);
+                }
+            }
+        }
+
+        inline float copyFloat(float v) { return v; }
+
+        inline float s16ToFloat(int16_t v) { return v * kS16ToFloat; }
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+// Stereo kernels return the number of frames handled; the caller finishes the
+// remainder with the scalar loops.
+        int deinterleaveStereoSse2(const float *src, float *left, float *right, int num_frames) {
+            int i = 0;
+            for (; i + 4 <= num_frames; i += 4) {
+                const __m128 a = _mm_loadu_ps(src + 2 * i);
+                const __m128 b = _mm_loadu_ps(src + 2 * i + 4);
+                _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+                _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+            return i;
+        }
+
+        int interleaveStereoSse2(const float *left, const float *right, float *dst, int num_frames) {
+            int i = 0;
+            for (; i + 4 <= num_frames; i += 4) {
+                const __m128 l = _mm_loadu_ps(left + i);
+                const __m128 r = _mm_loadu_ps(right + i);
+                _mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(l, r));
+                _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(l, r));
+            }
+            return i;
+        }
+
+        __attribute__((target("avx2")))
+        int deinterleaveStereoAvx2(const float *src, float *left, float *right, int num_frames) {
+            int i = 0;
+            for (; i + 8 <= num_frames; i += 8) {
+                const __m256 a = _mm256_loadu_ps(src + 2 * i);
+                const __m256 b = _mm256_loadu_ps(src + 2 * i + 8);
+                // Per 128-bit lane: [L0 L1 L4 L5 | L2 L3 L6 L7], then fix lane order.
+                const __m256 l = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m256 r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                _mm256_storeu_ps(left + i, _mm256_castpd_ps(
+                        _mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0))));
+                _mm256_storeu_ps(right + i, _mm256_castpd_ps(
+                        _mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0))));
+            }
+            return i;
+        }
+
+        __attribute__((target("avx2")))
+        int interleaveStereoAvx2(const float *left, const float *right, float *dst, int num_frames) {
+            int i = 0;
+            for (; i + 8 <= num_frames; i += 8) {
+                const __m256 l = _mm256_loadu_ps(left + i);
+                const __m256 r = _mm256_loadu_ps(right + i);
+                const __m256 lo = _mm256_unpacklo_ps(l, r);
+                const __m256 hi = _mm256_unpackhi_ps(l, r);
+                _mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+                _mm256_storeu_ps(dst + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+            }
+            return i;
+        }
+
+        inline __m128 s16x4ToFloat(__m128i v) {
+            return _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(kS16ToFloat));
+        }
+
+        inline __m128i floatToS32x4(__m128 v) {
+            v = _mm_mul_ps(v, _mm_set1_ps(kFloatToS16));
+            v = _mm_min_ps(v, _mm_set1_ps(32767.f));
+            v = _mm_max_ps(v, _mm_set1_ps(-32768.f));
+            // Round half away from zero: add copysign(0.5, v), then truncate.
+            const __m128 sign = _mm_and_ps(v, _mm_set1_ps(-0.f));
+            return _mm_cvttps_epi32(_mm_add_ps(v, _mm_or_ps(sign, _mm_set1_ps(0.5f))));
+        }
+
+        int deinterleaveS16MonoSse2(const int16_t *src, float *dst, int num_frames) {
+            int i = 0;
+            for (; i + 8 <= num_frames; i += 8) {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                _mm_storeu_ps(dst + i, s16x4ToFloat(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16)));
+                _mm_storeu_ps(dst + i + 4, s16x4ToFloat(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16)));
+            }
+            return i;
+        }
+
+        int deinterleaveS16StereoSse2(const int16_t *src, float *left, float *right, int num_frames) {
+            int i = 0;
+            for (; i + 4 <= num_frames; i += 4) {
+                // Each 32-bit lane holds one L/R pair; sign-extend each half.
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * i));
+                _mm_storeu_ps(left + i, s16x4ToFloat(_mm_srai_epi32(_mm_slli_epi32(x, 16), 16)));
+                _mm_storeu_ps(right + i, s16x4ToFloat(_mm_srai_epi32(x, 16)));
+            }
+            return i;
+        }
+
+        int interleaveS16MonoSse2(const float *src, int16_t *dst, int num_frames) {
+            int i = 0;
+            for (; i + 8 <= num_frames; i += 8) {
+                const __m128i a = floatToS32x4(_mm_loadu_ps(src + i));
+                const __m128i b = floatToS32x4(_mm_loadu_ps(src + i + 4));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi32(a, b));
+            }
+            return i;
+        }
+
+        int interleaveS16StereoSse2(const float *left, const float *right, int16_t *dst, int num_frames) {
+            int i = 0;
+            for (; i + 8 <= num_frames; i += 8) {
+                const __m128i l = _mm_packs_epi32(floatToS32x4(_mm_loadu_ps(left + i)),
+                                                  floatToS32x4(_mm_loadu_ps(left + i + 4)));
+                const __m128i r = _mm_packs_epi32(floatToS32x4(_mm_loadu_ps(right + i)),
+                                                  floatToS32x4(_mm_loadu_ps(right + i + 4)));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i), _mm_unpacklo_epi16(l, r));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i + 8), _mm_unpackhi_epi16(l, r));
+            }
+            return i;
+        }
+
+#endif // WEBRTC_ARCH_X86_FAMILY
+
+#if defined(WEBRTC_HAS_NEON)
+
+        int deinterleaveStereoNeon(const float *src, float *left, float *right, int num_frames) {
+            int i = 0;
+            for (; i + 4 <= num_frames; i += 4) {
+                const float32x4x2_t v = vld2q_f32(src + 2 * i);
+                vst1q_f32(left + i, v.val[0]);
+                vst1q_f32(right + i, v.val[1]);
+            }
+            return i;
+        }
+
+        int interleaveStereoNeon(const float *left, const float *right, float *dst, int num_frames) {
+            int i = 0;
+            for (; i + 4 <= num_frames; i += 4) {
+                float32x4x2_t v;
+                v.val[0] = vld1q_f32(left + i);
+                v.val[1] = vld1q_f32(right + i);
+                vst2q_f32(dst + 2 * i, v);
+            }
+            return i;
+        }
+
+        inline void s16x8ToFloat(int16x8_t v, float *dst) {
+            vst1q_f32(dst, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), kS16ToFloat));
+            vst1q_f32(dst + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), kS16ToFloat));
+        }
+
+        inline int16x4_t floatToS16x4(float32x4_t v) {
+            v = vmulq_n_f32(v, kFloatToS16);
+            v = vminq_f32(v, vdupq_n_f32(32767.f));
+            v = vmaxq_f32(v, vdupq_n_f32(-32768.f));
+            // Round half away from zero: add copysign(0.5, v), then truncate.
+            const uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x80000000u));
+            const float32x4_t half = vreinterpretq_f32_u32(vorrq_u32(sign, vreinterpretq_u32_f32(vdupq_n_f32(0.5f))));
+            return vqmovn_s32(vcvtq_s32_f32(vaddq_f32(v, half)));
+        }
+
+        int deinterleaveS16MonoNeon(const int16_t *src, float *dst, int num_frames) {
+            int i = 0;
+            for (; i + 8 <= num_frames; i += 8) {
+                s16x8ToFloat(vld1q_s16(src + i), dst + i);
+            }
+            return i;
+        }
+
+        int deinterleaveS16StereoNeon(const int16_t *src, float *left, float *right, int num_frames) {
+            int i = 0;
+            for (; i + 8 <= num_frames; i += 8) {
+                const int16x8x2_t v = vld2q_s16(src + 2 * i);
+                s16x8ToFloat(v.val[0], left + i);
+                s16x8ToFloat(v.val[1], right + i);
+            }
+            return i;
+        }
+
+        int interleaveS16MonoNeon(const float *src, int16_t *dst, int num_frames) {
+            int i = 0;
+            for (; i + 8 <= num_frames; i += 8) {
+                vst1q_s16(dst + i, vcombine_s16(floatToS16x4(vld1q_f32(src + i)),
+                                                floatToS16x4(vld1q_f32(src + i + 4))));
+            }
+            return i;
+        }
+
+        int interleaveS16StereoNeon(const float *left, const float *right, int16_t *dst, int num_frames) {
+            int i = 0;
+            for (; i + 8 <= num_frames; i += 8) {
+                int16x8x2_t v;
+                v.val[0] = vcombine_s16(floatToS16x4(vld1q_f32(left + i)), floatToS16x4(vld1q_f32(left + i + 4)));
+                v.val[1] = vcombine_s16(floatToS16x4(vld1q_f32(right + i)), floatToS16x4(vld1q_f32(right + i + 4)));
+                vst2q_s16(dst + 2 * i, v);
+            }
+            return i;
+        }
+
+#endif // WEBRTC_HAS_NEON
+
+// Compile-time channel count fast paths. kNumChannels == 0 selects the
+// generic runtime-strided loop.
+        template<int kNumChannels>
+        void deinterleaveFloat(InterleaveOptimization optimization, const float *src, float *const *dst,
+                               int num_channels, int num_frames) {
+            if (kNumChannels == 1) {
+                std::memcpy(dst[0], src, num_frames * sizeof(float));
+                return;
+            }
+            int done = 0;
+            if (kNumChannels == 2) {
+                switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+                    case InterleaveOptimization::kAvx2:
+                        done = deinterleaveStereoAvx2(src, dst[0], dst[1], num_frames);
+                        break;
+                    case InterleaveOptimization::kSse2:
+                        done = deinterleaveStereoSse2(src, dst[0], dst[1], num_frames);
+                        break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+                    case InterleaveOptimization::kNeon:
+                        done = deinterleaveStereoNeon(src, dst[0], dst[1], num_frames);
+                        break;
+#endif
+                    default:
+                        break;
+                }
+            }
+            deinterleaveScalar(src, dst, kNumChannels ? kNumChannels : num_channels, done, num_frames, copyFloat);
+        }
+
+        template<int kNumChannels>
+        void interleaveFloat(InterleaveOptimization optimization, const float *const *src, float *dst,
+                             int num_channels, int num_frames) {
+            if (kNumChannels == 1) {
+                std::memcpy(dst, src[0], num_frames * sizeof(float));
+                return;
+            }
+            int done = 0;
+            if (kNumChannels == 2) {
+                switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+                    case InterleaveOptimization::kAvx2:
+                        done = interleaveStereoAvx2(src[0], src[1], dst, num_frames);
+                        break;
+                    case InterleaveOptimization::kSse2:
+                        done = interleaveStereoSse2(src[0], src[1], dst, num_frames);
+                        break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+                    case InterleaveOptimization::kNeon:
+                        done = interleaveStereoNeon(src[0], src[1], dst, num_frames);
+                        break;
+#endif
+                    default:
+                        break;
+                }
+            }
+            interleaveScalar(src, dst, kNumChannels ? kNumChannels : num_channels, done, num_frames, copyFloat);
+        }
+
+        template<int kNumChannels>
+        void deinterleaveS16(InterleaveOptimization optimization, const int16_t *src, float *const *dst,
+                             int num_channels, int num_frames) {
+            int done = 0;
+            switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+                case InterleaveOptimization::kAvx2:
+                case InterleaveOptimization::kSse2:
+                    if (kNumChannels == 1) done = deinterleaveS16MonoSse2(src, dst[0], num_frames);
+                    if (kNumChannels == 2) done = deinterleaveS16StereoSse2(src, dst[0], dst[1], num_frames);
+                    break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+                case InterleaveOptimization::kNeon:
+                    if (kNumChannels == 1) done = deinterleaveS16MonoNeon(src, dst[0], num_frames);
+                    if (kNumChannels == 2) done = deinterleaveS16StereoNeon(src, dst[0], dst[1], num_frames);
+                    break;
+#endif
+                default:
+                    break;
+            }
+            deinterleaveScalar(src, dst, kNumChannels ? kNumChannels : num_channels, done, num_frames, s16ToFloat);
+        }
+
+        template<int kNumChannels>
+        void interleaveS16(InterleaveOptimization optimization, const float *const *src, int16_t *dst,
+                           int num_channels, int num_frames) {
+            int done = 0;
+            switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+                case InterleaveOptimization::kAvx2:
+                case InterleaveOptimization::kSse2:
+                    if (kNumChannels == 1) done = interleaveS16MonoSse2(src[0], dst, num_frames);
+                    if (kNumChannels == 2) done = interleaveS16StereoSse2(src[0], src[1], dst, num_frames);
+                    break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+                case InterleaveOptimization::kNeon:
+                    if (kNumChannels == 1) done = interleaveS16MonoNeon(src[0], dst, num_frames);
+                    if (kNumChannels == 2) done = interleaveS16StereoNeon(src[0], src[1], dst, num_frames);
+                    break;
+#endif
+                default:
+                    break;
+            }
+            interleaveScalar(src, dst, kNumChannels ? kNumChannels : num_channels, done, num_frames, floatToS16);
+        }
+
+    } // anonymous namespace
+
+    InterleaveOptimization DetectInterleaveOptimization() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+        if (webrtc::GetCPUInfo(webrtc::kAVX2) != 0) {
+            return InterleaveOptimization::kAvx2;
+        } else if (webrtc::GetCPUInfo(webrtc::kSSE2) != 0) {
+            return InterleaveOptimization::kSse2;
+        }
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+        return InterleaveOptimization::kNeon;
+#else
+        return InterleaveOptimization::kNone;
+#endif
+    }
+
+    void Deinterleave(InterleaveOptimization optimization, const float *src, float *const *dst,
+                      int num_channels, int num_frames) {
+        switch (num_channels) {
+            case 1:
+                return deinterleaveFloat<1>(optimization, src, dst, num_channels, num_frames);
+            case 2:
+                return deinterleaveFloat<2>(optimization, src, dst, num_channels, num_frames);
+            default:
+                return deinterleaveFloat<0>(optimization, src, dst, num_channels, num_frames);
+        }
+    }
+
+    void Interleave(InterleaveOptimization optimization, const float *const *src, float *dst,
+                    int num_channels, int num_frames) {
+        switch (num_channels) {
+            case 1:
+                return interleaveFloat<1>(optimization, src, dst, num_channels, num_frames);
+            case 2:
+                return interleaveFloat<2>(optimization, src, dst, num_channels, num_frames);
+            default:
+                return interleaveFloat<0>(optimization, src, dst, num_channels, num_frames);
+        }
+    }
+
+    void DeinterleaveS16ToFloat(InterleaveOptimization optimization, const int16_t *src, float *const *dst,
+                                int num_channels, int num_frames) {
+        switch (num_channels) {
+            case 1:
+                return deinterleaveS16<1>(optimization, src, dst, num_channels, num_frames);
+            case 2:
+                return deinterleaveS16<2>(optimization, src, dst, num_channels, num_frames);
+            default:
+                return deinterleaveS16<0>(optimization, src, dst, num_channels, num_frames);
+        }
+    }
+
+    void InterleaveFloatToS16(InterleaveOptimization optimization, const float *const *src, int16_t *dst,
+                              int num_channels, int num_frames) {
+        switch (num_channels) {
+            case 1:
+                return interleaveS16<1>(optimization, src, dst, num_channels, num_frames);
+            case 2:
+                return interleaveS16<2>(optimization, src, dst, num_channels, num_frames);
+            default:
+                return interleaveS16<0>(optimization, src, dst, num_channels, num_frames);
+        }
+    }
+
+} // namespace apm
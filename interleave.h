@@ -0,0 +1,41 @@
+// interleave.h - Interleave/deinterleave kernels used by the C bridge
+//
+// The bridge stages interleaved caller buffers into per-channel buffers for
+// WebRTC and back once per frame and direction. Mono and stereo, the common
+// cases, get dedicated kernels; the vectorized variant is picked once at
+// runtime from the CPU features.
+
+#ifndef APM_INTERLEAVE_H
+#define APM_INTERLEAVE_H
+
+#include <stdint.h>
+
+namespace apm {
+
+    enum class InterleaveOptimization {
+        kNone, kSse2, kAvx2, kNeon
+    };
+
+    // Detects the best kernel set supported by the running CPU.
+    InterleaveOptimization DetectInterleaveOptimization();
+
+    // Splits num_frames interleaved frames from src into num_channels buffers.
+    void Deinterleave(InterleaveOptimization optimization, const float *src, float *const *dst,
+                      int num_channels, int num_frames);
+
+    // Merges num_channels buffers into num_frames interleaved frames in dst.
+    void Interleave(InterleaveOptimization optimization, const float *const *src, float *dst,
+                    int num_channels, int num_frames);
+
+    // Fused variants for int16 frames, converting between int16 and float in
+    // [-1, 1]. Float to int16 clamps and rounds half away from zero, like
+    // webrtc::FloatToS16.
+    void DeinterleaveS16ToFloat(InterleaveOptimization optimization, const int16_t *src, float *const *dst,
+                                int num_channels, int num_frames);
+
+    void InterleaveFloatToS16(InterleaveOptimization optimization, const float *const *src, int16_t *dst,
+                              int num_channels, int num_frames);
+
+} // namespace apm
+
+#endif // APM_INTERLEAVE_H
@@ -0,0 +1,446 @@
+// aec3.cpp - Checks of the AEC3 SIMD kernels against the plain C++ versions
+
+#include <kerneltest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <google.com/webrtc/api/array_view.h>
+#include <google.com/webrtc/audio_processing/aec3/adaptive_fir_filter.h>
+#include <google.com/webrtc/audio_processing/aec3/adaptive_fir_filter_erl.h>
+#include <google.com/webrtc/audio_processing/aec3/aec3_common.h>
+#include <google.com/webrtc/audio_processing/aec3/block_buffer.h>
+#include <google.com/webrtc/audio_processing/aec3/fft_buffer.h>
+#include <google.com/webrtc/audio_processing/aec3/fft_data.h>
+#include <google.com/webrtc/audio_processing/aec3/matched_filter.h>
+#include <google.com/webrtc/audio_processing/aec3/render_buffer.h>
+#include <google.com/webrtc/audio_processing/aec3/spectrum_buffer.h>
+#include <google.com/webrtc/audio_processing/aec3/vector_math.h>
+#include <google.com/webrtc/rtc_base/random.h>
+#include <google.com/webrtc/rtc_base/system/arch.h>
+#include <google.com/webrtc/system_wrappers/include/cpu_features_wrapper.h>
+
+namespace {
+
+    using webrtc::Aec3Optimization;
+    using webrtc::ArrayView;
+    using webrtc::FftData;
+    using webrtc::kFftLengthBy2Plus1;
+
+    using Partitions = std::vector<std::vector<FftData>>;
+    using Spectra = std::vector<std::array<float, kFftLengthBy2Plus1>>;
+
+    bool available(Aec3Optimization optimization) {
+        switch (optimization) {
+            case Aec3Optimization::kNone:
+                return true;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+            case Aec3Optimization::kSse2:
+                return webrtc::GetCPUInfo(webrtc::kSSE2) != 0;
+            case Aec3Optimization::kAvx2:
+                return webrtc::GetCPUInfo(webrtc::kAVX2) != 0;
+            case Aec3Optimization::kAvx512:
+                return webrtc::GetCPUInfo(webrtc::kAVX512) != 0 && webrtc::GetCPUInfo(webrtc::kAVX2) != 0;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+            case Aec3Optimization::kNeon:
+                return true;
+#endif
+            default:
+                return false;
+        }
+    }
+
+// Tracks the largest difference between reference and tested outputs, and
+// the largest reference output to scale it by.
+    class ErrorMeter {
+    public:
+        void Add(float reference, float tested) {
+            max_difference_ = std::max(max_difference_, std::fabs(double(reference) - tested));
+            max_reference_ = std::max(max_reference_, std::fabs(double(reference)));
+        }
+
+        void Add(ArrayView<const float> reference, ArrayView<const float> tested) {
+            for (size_t k = 0; k < reference.size(); ++k) {
+                Add(reference[k], tested[k]);
+            }
+        }
+
+        void Add(const FftData &reference, const FftData &tested) {
+            Add(reference.re, tested.re);
+            Add(reference.im, tested.im);
+        }
+
+        // Makes the result fail any tolerance.
+        void Mismatch() { mismatch_ = true; }
+
+        double Relative() const {
+            if (mismatch_) {
+                return 1.0;
+            }
+            return max_reference_ > 0 ? max_difference_ / max_reference_ : max_difference_;
+        }
+
+    private:
+        double max_difference_ = 0;
+        double max_reference_ = 0;
+        bool mismatch_ = false;
+    };
+
+    void randomize(webrtc::Random &random, ArrayView<float> x, float scale) {
+        for (float &v : x) {
+            v = scale * (random.Rand<float>() - 0.5f);
+        }
+    }
+
+    void randomize(webrtc::Random &random, FftData *X) {
+        randomize(random, X->re, 1.f);
+        randomize(random, X->im, 1.f);
+        X->im[0] = X->im[webrtc::kFftLengthBy2] = 0.f;
+    }
+
+    Partitions randomPartitions(webrtc::Random &random, int num_partitions, int num_channels) {
+        Partitions H(num_partitions, std::vector<FftData>(num_channels));
+        for (auto &H_p : H) {
+            for (auto &H_p_ch : H_p) {
+                randomize(random, &H_p_ch);
+            }
+        }
+        return H;
+    }
+
+// A render buffer holding random FFTs, a few slots longer than the filter and
+// read from near its end, so that the kernels have to wrap around.
+    class RandomRenderBuffer {
+    public:
+        RandomRenderBuffer(webrtc::Random &random, int num_partitions, int num_channels)
+                : blocks_(num_partitions + 3, 1, num_channels),
+                  spectra_(num_partitions + 3, num_channels),
+                  ffts_(num_partitions + 3, num_channels),
+                  render_buffer_(&blocks_, &spectra_, &ffts_) {
+            for (auto &slot : ffts_.buffer) {
+                for (auto &X : slot) {
+                    randomize(random, &X);
+                }
+            }
+            blocks_.read = spectra_.read = ffts_.read = ffts_.size - 2;
+        }
+
+        const webrtc::RenderBuffer &Get() const { return render_buffer_; }
+
+    private:
+        webrtc::BlockBuffer blocks_;
+        webrtc::SpectrumBuffer spectra_;
+        webrtc::FftBuffer ffts_;
+        webrtc::RenderBuffer render_buffer_;
+    };
+
+    void applyFilter(Aec3Optimization optimization, const webrtc::RenderBuffer &render_buffer,
+                     size_t num_partitions, const Partitions &H, FftData *S) {
+        switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+            case Aec3Optimization::kSse2:
+                webrtc::aec3::ApplyFilter_Sse2(render_buffer, num_partitions, H, S);
+                return;
+            case Aec3Optimization::kAvx2:
+                webrtc::aec3::ApplyFilter_Avx2(render_buffer, num_partitions, H, S);
+                return;
+            case Aec3Optimization::kAvx512:
+                webrtc::aec3::ApplyFilter_Avx512(render_buffer, num_partitions, H, S);
+                return;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+            case Aec3Optimization::kNeon:
+                webrtc::aec3::ApplyFilter_Neon(render_buffer, num_partitions, H, S);
+                return;
+#endif
+            default:
+                webrtc::aec3::ApplyFilter(render_buffer, num_partitions, H, S);
+        }
+    }
+
+    void adaptPartitions(Aec3Optimization optimization, const webrtc::RenderBuffer &render_buffer,
+                         const FftData &G, size_t num_partitions, Partitions *H) {
+        switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+            case Aec3Optimization::kSse2:
+                webrtc::aec3::AdaptPartitions_Sse2(render_buffer, G, num_partitions, H);
+                return;
+            case Aec3Optimization::kAvx2:
+                webrtc::aec3::AdaptPartitions_Avx2(render_buffer, G, num_partitions, H);
+                return;
+            case Aec3Optimization::kAvx512:
+                webrtc::aec3::AdaptPartitions_Avx512(render_buffer, G, num_partitions, H);
+                return;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+            case Aec3Optimization::kNeon:
+                webrtc::aec3::AdaptPartitions_Neon(render_buffer, G, num_partitions, H);
+                return;
+#endif
+            default:
+                webrtc::aec3::AdaptPartitions(render_buffer, G, num_partitions, H);
+        }
+    }
+
+    void computeFrequencyResponse(Aec3Optimization optimization, size_t num_partitions, const Partitions &H,
+                                  Spectra *H2) {
+        switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+            case Aec3Optimization::kSse2:
+                webrtc::aec3::ComputeFrequencyResponse_Sse2(num_partitions, H, H2);
+                return;
+            case Aec3Optimization::kAvx2:
+                webrtc::aec3::ComputeFrequencyResponse_Avx2(num_partitions, H, H2);
+                return;
+            case Aec3Optimization::kAvx512:
+                webrtc::aec3::ComputeFrequencyResponse_Avx512(num_partitions, H, H2);
+                return;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+            case Aec3Optimization::kNeon:
+                webrtc::aec3::ComputeFrequencyResponse_Neon(num_partitions, H, H2);
+                return;
+#endif
+            default:
+                webrtc::aec3::ComputeFrequencyResponse(num_partitions, H, H2);
+        }
+    }
+
+    void matchedFilterCore(Aec3Optimization optimization, size_t x_start_index, float x2_sum_threshold,
+                           float smoothing, ArrayView<const float> x, ArrayView<const float> y,
+                           ArrayView<float> h, bool *filters_updated, float *error_sum,
+                           bool compute_accumulated_error, ArrayView<float> accumulated_error,
+                           ArrayView<float> scratch_memory) {
+        switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+            case Aec3Optimization::kSse2:
+                webrtc::aec3::MatchedFilterCore_SSE2(x_start_index, x2_sum_threshold, smoothing, x, y, h,
+                                                     filters_updated, error_sum, compute_accumulated_error,
+                                                     accumulated_error, scratch_memory);
+                return;
+            case Aec3Optimization::kAvx2:
+                webrtc::aec3::MatchedFilterCore_AVX2(x_start_index, x2_sum_threshold, smoothing, x, y, h,
+                                                     filters_updated, error_sum, compute_accumulated_error,
+                                                     accumulated_error, scratch_memory);
+                return;
+            case Aec3Optimization::kAvx512:
+                webrtc::aec3::MatchedFilterCore_AVX512(x_start_index, x2_sum_threshold, smoothing, x, y, h,
+                                                       filters_updated, error_sum, compute_accumulated_error,
+                                                       accumulated_error, scratch_memory);
+                return;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+            case Aec3Optimization::kNeon:
+                webrtc::aec3::MatchedFilterCore_NEON(x_start_index, x2_sum_threshold, smoothing, x, y, h,
+                                                     filters_updated, error_sum, compute_accumulated_error,
+                                                     accumulated_error, scratch_memory);
+                return;
+#endif
+            default:
+                webrtc::aec3::MatchedFilterCore(x_start_index, x2_sum_threshold, smoothing, x, y, h,
+                                                filters_updated, error_sum, compute_accumulated_error,
+                                                accumulated_error);
+        }
+    }
+
+} // namespace
+
+extern "C" {
+
+int Aec3OptimizationAvailable(int optimization) {
+    return available(static_cast<Aec3Optimization>(optimization)) ? 1 : 0;
+}
+
+double Aec3ApplyFilterError(int optimization, int num_partitions, int num_channels, unsigned seed) {
+    const auto tested = static_cast<Aec3Optimization>(optimization);
+    if (!available(tested)) {
+        return -1;
+    }
+    webrtc::Random random(seed);
+    RandomRenderBuffer render_buffer(random, num_partitions, num_channels);
+    const Partitions H = randomPartitions(random, num_partitions, num_channels);
+
+    FftData S_reference;
+    FftData S_tested;
+    applyFilter(Aec3Optimization::kNone, render_buffer.Get(), num_partitions, H, &S_reference);
+    applyFilter(tested, render_buffer.Get(), num_partitions, H, &S_tested);
+
+    ErrorMeter error;
+    error.Add(S_reference, S_tested);
+    return error.Relative();
+}
+
+double Aec3AdaptPartitionsError(int optimization, int num_partitions, int num_channels, unsigned seed) {
+    const auto tested = static_cast<Aec3Optimization>(optimization);
+    if (!available(tested)) {
+        return -1;
+    }
+    webrtc::Random random(seed);
+    RandomRenderBuffer render_buffer(random, num_partitions, num_channels);
+    Partitions H_reference = randomPartitions(random, num_partitions, num_channels);
+    Partitions H_tested = H_reference;
+    FftData G;
+    randomize(random, &G);
+
+    adaptPartitions(Aec3Optimization::kNone, render_buffer.Get(), G, num_partitions, &H_reference);
+    adaptPartitions(tested, render_buffer.Get(), G, num_partitions, &H_tested);
+
+    ErrorMeter error;
+    for (int p = 0; p < num_partitions; ++p) {
+        for (int ch = 0; ch < num_channels; ++ch) {
+            error.Add(H_reference[p][ch], H_tested[p][ch]);
+        }
+    }
+    return error.Relative();
+}
+
+double Aec3FrequencyResponseError(int optimization, int num_partitions, int num_channels, unsigned seed) {
+    const auto tested = static_cast<Aec3Optimization>(optimization);
+    if (!available(tested)) {
+        return -1;
+    }
+    webrtc::Random random(seed);
+    const Partitions H = randomPartitions(random, num_partitions, num_channels);
+
+    Spectra H2_reference(num_partitions);
+    Spectra H2_tested(num_partitions);
+    computeFrequencyResponse(Aec3Optimization::kNone, num_partitions, H, &H2_reference);
+    computeFrequencyResponse(tested, num_partitions, H, &H2_tested);
+
+    ErrorMeter error;
+    for (int p = 0; p < num_partitions; ++p) {
+        error.Add(H2_reference[p], H2_tested[p]);
+    }
+    return error.Relative();
+}
+
+double Aec3ErlError(int optimization, int num_partitions, unsigned seed) {
+    const auto tested = static_cast<Aec3Optimization>(optimization);
+    if (!available(tested)) {
+        return -1;
+    }
+    webrtc::Random random(seed);
+    Spectra H2(num_partitions);
+    for (auto &H2_p : H2) {
+        for (float &v : H2_p) {
+            v = random.Rand<float>();
+        }
+    }
+
+    std::array<float, kFftLengthBy2Plus1> erl_reference;
+    std::array<float, kFftLengthBy2Plus1> erl_tested;
+    webrtc::ComputeErl(Aec3Optimization::kNone, H2, erl_reference);
+    webrtc::ComputeErl(tested, H2, erl_tested);
+
+    ErrorMeter error;
+    error.Add(erl_reference, erl_tested);
+    return error.Relative();
+}
+
+double Aec3MatchedFilterError(int optimization, int filter_size, int render_size, int x_start_index,
+                              int compute_accumulated_error, unsigned seed) {
+    const auto tested = static_cast<Aec3Optimization>(optimization);
+    if (!available(tested)) {
+        return -1;
+    }
+    webrtc::Random random(seed);
+    std::vector<float> x(render_size);
+    std::vector<float> y(webrtc::kBlockSize / 4);
+    std::vector<float> h_reference(filter_size);
+    randomize(random, x, 2000.f);
+    randomize(random, y, 2000.f);
+    randomize(random, h_reference, 0.1f);
+    std::vector<float> h_tested = h_reference;
+    std::vector<float> accumulated_error_reference(filter_size / 4);
+    std::vector<float> accumulated_error_tested(filter_size / 4);
+    std::vector<float> scratch_memory(filter_size);
+
+    bool updated_reference = false;
+    bool updated_tested = false;
+    float error_sum_reference = 0.f;
+    float error_sum_tested = 0.f;
+    matchedFilterCore(Aec3Optimization::kNone, x_start_index, 1.f, 0.7f, x, y, h_reference,
+                      &updated_reference, &error_sum_reference, compute_accumulated_error != 0,
+                      accumulated_error_reference, scratch_memory);
+    matchedFilterCore(tested, x_start_index, 1.f, 0.7f, x, y, h_tested, &updated_tested, &error_sum_tested,
+                      compute_accumulated_error != 0, accumulated_error_tested, scratch_memory);
+
+    ErrorMeter error;
+    if (updated_reference != updated_tested) {
+        error.Mismatch();
+    }
+    error.Add(h_reference, h_tested);
+    ErrorMeter error_sum;
+    error_sum.Add(error_sum_reference, error_sum_tested);
+    double result = std::max(error.Relative(), error_sum.Relative());
+    if (compute_accumulated_error != 0) {
+        ErrorMeter accumulated_error;
+        accumulated_error.Add(accumulated_error_reference, accumulated_error_tested);
+        result = std::max(result, accumulated_error.Relative());
+    }
+    return result;
+}
+
+double Aec3SpectrumError(int optimization, unsigned seed) {
+    const auto tested = static_cast<Aec3Optimization>(optimization);
+    if (!available(tested)) {
+        return -1;
+    }
+    webrtc::Random random(seed);
+    FftData X;
+    randomize(random, &X);
+
+    std::array<float, kFftLengthBy2Plus1> reference;
+    std::array<float, kFftLengthBy2Plus1> power;
+    X.Spectrum(Aec3Optimization::kNone, reference);
+    X.Spectrum(tested, power);
+
+    ErrorMeter error;
+    error.Add(reference, power);
+    return error.Relative();
+}
+
+double Aec3VectorMathError(int optimization, int op, int length, unsigned seed) {
+    const auto tested = static_cast<Aec3Optimization>(optimization);
+    if (!available(tested)) {
+        return -1;
+    }
+    webrtc::Random random(seed);
+    std::vector<float> x(length);
+    std::vector<float> y(length);
+    std::vector<float> reference(length);
+    randomize(random, x, 2.f);
+    randomize(random, y, 2.f);
+    randomize(random, reference, 2.f);
+    if (op == 0) {
+        for (float &v : reference) {
+            v = std::fabs(v);
+        }
+    }
+    std::vector<float> z = reference;
+
+    webrtc::aec3::VectorMath reference_math(Aec3Optimization::kNone);
+    webrtc::aec3::VectorMath tested_math(tested);
+    switch (op) {
+        case 0:
+            reference_math.Sqrt(reference);
+            tested_math.Sqrt(z);
+            break;
+        case 1:
+            reference_math.Multiply(x, y, reference);
+            tested_math.Multiply(x, y, z);
+            break;
+        default:
+            reference_math.Accumulate(x, reference);
+            tested_math.Accumulate(x, z);
+    }
+
+    ErrorMeter error;
+    error.Add(reference, z);
+    return error.Relative();
+}
+
+} // extern "C"
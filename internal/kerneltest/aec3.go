@@ -0,0 +1,192 @@
+package kerneltest
+
+// #include <kerneltest.h>
+import "C"
+
+// Aec3Optimization mirrors webrtc::Aec3Optimization.
+type Aec3Optimization int
+
+const (
+	Aec3None Aec3Optimization = iota
+	Aec3Sse2
+	Aec3Avx2
+	Aec3Avx512
+	Aec3Neon
+)
+
+func (o Aec3Optimization) String() string {
+	switch o {
+	case Aec3None:
+		return "None"
+	case Aec3Sse2:
+		return "SSE2"
+	case Aec3Avx2:
+		return "AVX2"
+	case Aec3Avx512:
+		return "AVX512"
+	case Aec3Neon:
+		return "NEON"
+	}
+	return "Unknown"
+}
+
+// Available reports whether the kernels of o can run on this CPU and build.
+func (o Aec3Optimization) Available() bool {
+	return C.Aec3OptimizationAvailable(C.int(o)) != 0
+}
+
+// Aec3VectorMathOp selects the webrtc::aec3::VectorMath operation to check.
+type Aec3VectorMathOp int
+
+const (
+	Aec3Sqrt Aec3VectorMathOp = iota
+	Aec3Multiply
+	Aec3Accumulate
+)
+
+// The functions below return the largest difference between the outputs of
+// the kernel for o and of the plain C++ kernel, relative to the largest plain
+// output, for inputs drawn from seed.
+
+// Aec3ApplyFilterError checks aec3::ApplyFilter.
+func Aec3ApplyFilterError(o Aec3Optimization, numPartitions, numChannels int, seed uint32) float64 {
+	return float64(C.Aec3ApplyFilterError(C.int(o), C.int(numPartitions), C.int(numChannels), C.uint(seed)))
+}
+
+// Aec3AdaptPartitionsError checks aec3::AdaptPartitions.
+func Aec3AdaptPartitionsError(o Aec3Optimization, numPartitions, numChannels int, seed uint32) float64 {
+	return float64(C.Aec3AdaptPartitionsError(C.int(o), C.int(numPartitions), C.int(numChannels), C.uint(seed)))
+}
+
+// Aec3FrequencyResponseError checks aec3::ComputeFrequencyResponse.
+func Aec3FrequencyResponseError(o Aec3Optimization, numPartitions, numChannels int, seed uint32) float64 {
+	return float64(C.Aec3FrequencyResponseError(C.int(o), C.int(numPartitions), C.int(numChannels), C.uint(seed)))
+}
+
+// Aec3ErlError checks ComputeErl.
+func Aec3ErlError(o Aec3Optimization, numPartitions int, seed uint32) float64 {
+	return float64(C.Aec3ErlError(C.int(o), C.int(numPartitions), C.uint(seed)))
+}
+
+// Aec3MatchedFilterError checks the matched filter core for filterSize taps
+// starting at xStartIndex in a renderSize sample render buffer.
+func Aec3MatchedFilterError(o Aec3Optimization, filterSize, renderSize, xStartIndex int, accumulatedError bool, seed uint32) float64 {
+	computeAccumulatedError := 0
+	if accumulatedError {
+		computeAccumulatedError = 1
+	}
+	return float64(C.Aec3MatchedFilterError(C.int(o), C.int(filterSize), C.int(renderSize), C.int(xStartIndex),
+		C.int(computeAccumulatedError), C.uint(seed)))
+}
+
+// Aec3SpectrumError checks FftData::Spectrum.
+func Aec3SpectrumError(o Aec3Optimization, seed uint32) float64 {
+	return float64(C.Aec3SpectrumError(C.int(o), C.uint(seed)))
+}
+
+// Aec3VectorMathError checks op on length elements.
+func Aec3VectorMathError(o Aec3Optimization, op Aec3VectorMathOp, length int, seed uint32) float64 {
+	return float64(C.Aec3VectorMathError(C.int(o), C.int(op), C.int(length), C.uint(seed)))
+}
+
+// Aec3FftTransform selects the webrtc::Aec3Fft call to check.
+type Aec3FftTransform int
+
+const (
+	Aec3Fft Aec3FftTransform = iota
+	Aec3PaddedFft
+	Aec3PaddedFftSqrtHanning
+	Aec3ZeroPaddedFft
+	Aec3ZeroPaddedFftHanning
+	Aec3Ifft
+)
+
+func (t Aec3FftTransform) String() string {
+	switch t {
+	case Aec3Fft:
+		return "Fft"
+	case Aec3PaddedFft:
+		return "PaddedFft"
+	case Aec3PaddedFftSqrtHanning:
+		return "PaddedFftSqrtHanning"
+	case Aec3ZeroPaddedFft:
+		return "ZeroPaddedFft"
+	case Aec3ZeroPaddedFftHanning:
+		return "ZeroPaddedFftHanning"
+	case Aec3Ifft:
+		return "Ifft"
+	}
+	return "Unknown"
+}
+
+// Aec3FftError checks transform t of Aec3Fft against the plain C Ooura FFT,
+// over 20 random inputs.
+func Aec3FftError(o Aec3Optimization, t Aec3FftTransform, seed uint32) float64 {
+	return float64(C.Aec3FftError(C.int(o), C.int(t), C.uint(seed)))
+}
+
+// Aec3FftRun runs transform t of Aec3Fft n times.
+func Aec3FftRun(o Aec3Optimization, t Aec3FftTransform, n int) {
+	C.Aec3FftRun(C.int(o), C.int(t), C.int(n))
+}
+
+// Aec3UnityGainError checks that SuppressionFilter.ApplyUnityGain matches
+// ApplyGain with unity gain and no comfort noise, switching between them
+// every idlePeriod blocks, or using ApplyUnityGain throughout if idlePeriod is
+// 0.
+func Aec3UnityGainError(sampleRateHz, numChannels, idlePeriod int, seed uint32) float64 {
+	return float64(C.Aec3UnityGainError(C.int(sampleRateHz), C.int(numChannels), C.int(idlePeriod), C.uint(seed)))
+}
+
+// Aec3InactiveRenderBlocks returns RenderSignalAnalyzer.InactiveRenderBlocks
+// after numBlocks blocks with samples of magnitude level in activeChannel and
+// numSilentBlocks silent blocks.
+func Aec3InactiveRenderBlocks(numChannels, activeChannel int, level float32, numBlocks, numSilentBlocks int) int {
+	return int(C.Aec3InactiveRenderBlocks(C.int(numChannels), C.int(activeChannel), C.float(level),
+		C.int(numBlocks), C.int(numSilentBlocks)))
+}
+
+// Aec3DelayEstimator mirrors webrtc::EchoCanceller3Config::Delay::Estimator.
+type Aec3DelayEstimator int
+
+const (
+	Aec3MatchedFilter Aec3DelayEstimator = iota
+	Aec3FftCorrelation
+)
+
+func (e Aec3DelayEstimator) String() string {
+	switch e {
+	case Aec3MatchedFilter:
+		return "MatchedFilter"
+	case Aec3FftCorrelation:
+		return "FftCorrelation"
+	}
+	return "Unknown"
+}
+
+// Aec3EchoPathDelay runs the echo path delay estimator e at 16 kHz on
+// numBlocks blocks of uniform noise of amplitude renderLevel, captured
+// delaySamples later with added noise of amplitude noiseLevel. It returns the
+// last delay estimate in samples, or -1 if there was none.
+func Aec3EchoPathDelay(e Aec3DelayEstimator, downSamplingFactor, numFilters, delaySamples int,
+	renderLevel, noiseLevel float32, numBlocks int, seed uint32) int {
+	return int(C.Aec3EchoPathDelay(C.int(e), C.int(downSamplingFactor), C.int(numFilters), C.int(delaySamples),
+		C.float(renderLevel), C.float(noiseLevel), C.int(numBlocks), C.uint(seed)))
+}
+
+// Aec3ClockdriftCompensation runs the echo path delay estimator behind a
+// render drift compensator for numBlocks blocks of an echo whose render clock
+// runs drift samples per sample fast, compensating the rates the estimator
+// reports, and returns the compensated drift. As the echo path delay shrinks
+// by drift samples per sample, that should be close to -drift.
+func Aec3ClockdriftCompensation(drift float32, numBlocks int, seed uint32) float64 {
+	return float64(C.Aec3ClockdriftCompensation(C.float(drift), C.int(numBlocks), C.uint(seed)))
+}
+
+// Aec3DriftCompensatorPassThroughError returns the largest difference between
+// the input and output blocks of a render drift compensator with no drift, or
+// +Inf if it does not give one block per input block.
+func Aec3DriftCompensatorPassThroughError(numBands, numChannels, numBlocks int, seed uint32) float64 {
+	return float64(C.Aec3DriftCompensatorPassThroughError(C.int(numBands), C.int(numChannels), C.int(numBlocks),
+		C.uint(seed)))
+}
@@ -0,0 +1,179 @@
+// aec3_delay.cpp - Checks of the AEC3 echo path delay estimation and clock drift compensation
+
+#include <kerneltest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <google.com/webrtc/api/audio/echo_canceller3_config.h>
+#include <google.com/webrtc/audio_processing/aec3/aec3_common.h>
+#include <google.com/webrtc/audio_processing/aec3/block.h>
+#include <google.com/webrtc/audio_processing/aec3/delay_estimate.h>
+#include <google.com/webrtc/audio_processing/aec3/echo_path_delay_estimator.h>
+#include <google.com/webrtc/audio_processing/aec3/render_delay_buffer.h>
+#include <google.com/webrtc/audio_processing/aec3/render_drift_compensator.h>
+#include <google.com/webrtc/audio_processing/logging/apm_data_dumper.h>
+#include <google.com/webrtc/rtc_base/random.h>
+
+namespace {
+
+    using webrtc::EchoCanceller3Config;
+    using webrtc::kBlockSize;
+
+    constexpr int kSampleRateHz = 16000;
+
+// Low-passed noise, which linear interpolation resamples accurately.
+    std::vector<float> lowpassNoise(webrtc::Random &random, float level, size_t length) {
+        std::vector<float> x(length);
+        float lowpass = 0.f;
+        for (float &v : x) {
+            lowpass = 0.5f * lowpass + 0.5f * level * 2.f * (random.Rand<float>() - 0.5f);
+            v = lowpass;
+        }
+        return x;
+    }
+
+} // namespace
+
+extern "C" {
+
+int Aec3EchoPathDelay(int estimator, int down_sampling_factor, int num_filters, int delay_samples,
+                      float render_level, float noise_level, int num_blocks, unsigned seed) {
+    EchoCanceller3Config config;
+    config.delay.delay_headroom_samples = 0;
+    config.delay.down_sampling_factor = down_sampling_factor;
+    config.delay.num_filters = num_filters;
+    config.delay.estimator = static_cast<EchoCanceller3Config::Delay::Estimator>(estimator);
+
+    webrtc::ApmDataDumper data_dumper(0);
+    std::unique_ptr<webrtc::RenderDelayBuffer> render_delay_buffer(
+            webrtc::RenderDelayBuffer::Create(config, kSampleRateHz, /*num_render_channels=*/1));
+    webrtc::EchoPathDelayEstimator delay_estimator(&data_dumper, config, /*num_capture_channels=*/1);
+
+    webrtc::Random random(seed);
+    webrtc::Block render(/*num_bands=*/1, /*num_channels=*/1);
+    webrtc::Block capture(/*num_bands=*/1, /*num_channels=*/1);
+    // The render signal of the last delay_samples samples, to delay it by.
+    std::vector<float> delay_line(delay_samples, 0.f);
+    size_t delay_index = 0;
+    std::optional<webrtc::DelayEstimate> estimate;
+    for (int i = 0; i < num_blocks; ++i) {
+        auto x = render.View(0, 0);
+        auto y = capture.View(0, 0);
+        for (size_t k = 0; k < kBlockSize; ++k) {
+            x[k] = render_level * 2.f * (random.Rand<float>() - 0.5f);
+            float delayed = x[k];
+            if (delay_samples > 0) {
+                delayed = delay_line[delay_index];
+                delay_line[delay_index] = x[k];
+                delay_index = (delay_index + 1) % delay_line.size();
+            }
+            y[k] = delayed + noise_level * 2.f * (random.Rand<float>() - 0.5f);
+        }
+
+        render_delay_buffer->Insert(render);
+        if (i == 0) {
+            render_delay_buffer->Reset();
+        }
+        render_delay_buffer->PrepareCaptureProcessing();
+        // The estimator resets itself after half a second of a consistent
+        // estimate, so keep the last one.
+        auto block_estimate =
+                delay_estimator.EstimateDelay(render_delay_buffer->GetDownsampledRenderBuffer(), capture);
+        render_delay_buffer->FinishCaptureProcessing();
+        if (block_estimate) {
+            estimate = block_estimate;
+        }
+    }
+    return estimate ? static_cast<int>(estimate->delay) : -1;
+}
+
+double Aec3ClockdriftCompensation(float drift, int num_blocks, unsigned seed) {
+    EchoCanceller3Config config;
+    config.delay.compensate_clock_drift = true;
+    webrtc::ApmDataDumper data_dumper(0);
+    std::unique_ptr<webrtc::RenderDelayBuffer> render_delay_buffer(
+            webrtc::RenderDelayBuffer::Create(config, kSampleRateHz, /*num_render_channels=*/1));
+    webrtc::EchoPathDelayEstimator delay_estimator(&data_dumper, config, /*num_capture_channels=*/1);
+    webrtc::RenderDriftCompensator compensator(/*num_bands=*/1, /*num_channels=*/1);
+
+    webrtc::Random random(seed);
+    const std::vector<float> x = lowpassNoise(random, 10000.f, (num_blocks + 2) * kBlockSize * (1 + drift) + 1);
+    // The render device plays 1 + drift samples per capture sample, so the
+    // render blocks arrive faster than the capture blocks and the capture
+    // signal holds the render signal 800 samples before, stretched in time.
+    webrtc::Block render(/*num_bands=*/1, /*num_channels=*/1);
+    webrtc::Block capture(/*num_bands=*/1, /*num_channels=*/1);
+    int num_render_blocks = 0;
+    for (int i = 0; i < num_blocks; ++i) {
+        while (num_render_blocks < (i + 1) * (1 + drift)) {
+            auto r = render.View(0, 0);
+            std::copy(x.begin() + num_render_blocks * kBlockSize, x.begin() + (num_render_blocks + 1) * kBlockSize,
+                      r.begin());
+            compensator.Process(render, [&](const webrtc::Block &block) { render_delay_buffer->Insert(block); });
+            ++num_render_blocks;
+        }
+        auto y = capture.View(0, 0);
+        for (size_t k = 0; k < kBlockSize; ++k) {
+            const double t = (static_cast<double>(i * kBlockSize + k) - 800.0) * (1 + drift);
+            if (t < 0) {
+                y[k] = 0.f;
+                continue;
+            }
+            const size_t n = static_cast<size_t>(t);
+            const float f = static_cast<float>(t - n);
+            y[k] = 0.5f * ((1.f - f) * x[n] + f * x[n + 1]);
+        }
+
+        if (i == 0) {
+            render_delay_buffer->Reset();
+        }
+        render_delay_buffer->PrepareCaptureProcessing();
+        delay_estimator.EstimateDelay(render_delay_buffer->GetDownsampledRenderBuffer(), capture);
+        render_delay_buffer->FinishCaptureProcessing();
+        // As BlockProcessor does.
+        if (auto rate = delay_estimator.TakeClockdriftRate()) {
+            compensator.AddDrift(*rate);
+        }
+    }
+    return compensator.drift();
+}
+
+double Aec3DriftCompensatorPassThroughError(int num_bands, int num_channels, int num_blocks, unsigned seed) {
+    webrtc::RenderDriftCompensator compensator(num_bands, num_channels);
+    webrtc::Random random(seed);
+    webrtc::Block block(num_bands, num_channels);
+    double max_difference = 0;
+    for (int i = 0; i < num_blocks; ++i) {
+        for (int b = 0; b < num_bands; ++b) {
+            for (int ch = 0; ch < num_channels; ++ch) {
+                for (float &v : block.View(b, ch)) {
+                    v = 32767.f * 2.f * (random.Rand<float>() - 0.5f);
+                }
+            }
+        }
+        int num_outputs = 0;
+        compensator.Process(block, [&](const webrtc::Block &output) {
+            ++num_outputs;
+            for (int b = 0; b < num_bands; ++b) {
+                for (int ch = 0; ch < num_channels; ++ch) {
+                    auto in = block.View(b, ch);
+                    auto out = output.View(b, ch);
+                    for (size_t k = 0; k < kBlockSize; ++k) {
+                        max_difference = std::max(max_difference, std::fabs(double(in[k]) - out[k]));
+                    }
+                }
+            }
+        });
+        if (num_outputs != 1) {
+            return std::numeric_limits<double>::infinity();
+        }
+    }
+    return max_difference;
+}
+
+} // extern "C"
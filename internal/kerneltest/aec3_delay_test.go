@@ -0,0 +1,69 @@
+package kerneltest
+
+import (
+	"fmt"
+	"testing"
+)
+
+var aec3DelayEstimators = []Aec3DelayEstimator{Aec3MatchedFilter, Aec3FftCorrelation}
+
+// The delay estimates are quantized to blocks of 64 samples, with an error of
+// up to a block.
+const aec3BlockSize = 64
+
+func checkAec3Delay(t *testing.T, what string, got, delay int) {
+	t.Helper()
+	if got < 0 {
+		t.Errorf("%s: no delay estimate, want %d samples", what, delay)
+	} else if block := delay / aec3BlockSize * aec3BlockSize; got < block-aec3BlockSize || got > block+aec3BlockSize {
+		t.Errorf("%s: estimated %d samples, want %d within a block", what, got, delay)
+	}
+}
+
+func TestAec3EchoPathDelay(t *testing.T) {
+	// Up to 400 ms, the delay of the Bluetooth paths the FFT correlation is
+	// meant for, with the default 5 filters.
+	delays := []int{64, 150, 800, 4000, 6400}
+	for _, e := range aec3DelayEstimators {
+		for _, ds := range []int{4, 8} {
+			for _, delay := range delays {
+				// One second of full-scale noise.
+				got := Aec3EchoPathDelay(e, ds, 5, delay, 32767, 0, 250, 1)
+				checkAec3Delay(t, fmtAec3Delay(e, ds, delay, "clean"), got, delay)
+
+				// Capture noise as loud as the echo.
+				got = Aec3EchoPathDelay(e, ds, 5, delay, 32767, 32767, 1000, 2)
+				checkAec3Delay(t, fmtAec3Delay(e, ds, delay, "0 dB echo to noise"), got, delay)
+			}
+		}
+	}
+}
+
+func TestAec3EchoPathDelayNoisyCapture(t *testing.T) {
+	// The whitened cross-spectrum still finds an echo 10 dB below the capture
+	// noise, where the matched filters give no or a wrong estimate.
+	for _, ds := range []int{4, 8} {
+		for _, delay := range []int{150, 4000, 6400} {
+			got := Aec3EchoPathDelay(Aec3FftCorrelation, ds, 5, delay, 32767, 3*32767, 1000, 3)
+			checkAec3Delay(t, fmtAec3Delay(Aec3FftCorrelation, ds, delay, "-10 dB echo to noise"), got, delay)
+		}
+	}
+}
+
+func TestAec3EchoPathDelayLowLevelRender(t *testing.T) {
+	// A render signal below the poor excitation limits gives no estimate.
+	for _, e := range aec3DelayEstimators {
+		for _, ds := range []int{4, 8} {
+			for _, delay := range []int{150, 4000} {
+				if got := Aec3EchoPathDelay(e, ds, 5, delay, 100, 0, 1000, 4); got >= 0 {
+					t.Errorf("%s: estimated %d samples, want no estimate",
+						fmtAec3Delay(e, ds, delay, "low level render"), got)
+				}
+			}
+		}
+	}
+}
+
+func fmtAec3Delay(e Aec3DelayEstimator, downSamplingFactor, delay int, what string) string {
+	return fmt.Sprintf("%v, down-sampling %d, %d samples delay, %s", e, downSamplingFactor, delay, what)
+}
@@ -0,0 +1,41 @@
+package kerneltest
+
+import (
+	"math"
+	"testing"
+)
+
+func TestAec3ClockdriftCompensation(t *testing.T) {
+	// Drifts from about 400 ppm on change the delay too fast for the matched
+	// filters to report each step, and are not detected.
+	for _, drift := range []float32{100e-6, -100e-6, 300e-6, -300e-6} {
+		for _, seed := range []uint32{1, 2} {
+			// 30 s, for the delay to step at least three times at 100 ppm.
+			got := Aec3ClockdriftCompensation(drift, 7500, seed)
+			want := -float64(drift)
+			if math.Abs(got-want) > 0.15*math.Abs(want) {
+				t.Errorf("%g ppm drift, seed %d: compensated %g ppm, want %g ppm within 15 %%",
+					drift*1e6, seed, got*1e6, want*1e6)
+			}
+		}
+	}
+}
+
+func TestAec3ClockdriftCompensationWithoutDrift(t *testing.T) {
+	for _, seed := range []uint32{1, 2, 3} {
+		if got := Aec3ClockdriftCompensation(0, 7500, seed); got != 0 {
+			t.Errorf("seed %d: compensated %g ppm without any drift", seed, got*1e6)
+		}
+	}
+}
+
+func TestAec3DriftCompensatorPassThrough(t *testing.T) {
+	for _, bands := range []int{1, 2, 3} {
+		for _, channels := range []int{1, 2} {
+			if err := Aec3DriftCompensatorPassThroughError(bands, channels, 100, 1); err != 0 {
+				t.Errorf("%d bands, %d channels: output differs from the input by %g without drift",
+					bands, channels, err)
+			}
+		}
+	}
+}
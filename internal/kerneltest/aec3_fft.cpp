@@ -0,0 +1,143 @@
+// aec3_fft.cpp - Checks of the Aec3Fft implementations against the Ooura FFT
+
+#include <kerneltest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <google.com/webrtc/api/array_view.h>
+#include <google.com/webrtc/audio_processing/aec3/aec3_common.h>
+#include <google.com/webrtc/audio_processing/aec3/aec3_fft.h>
+#include <google.com/webrtc/audio_processing/aec3/fft_data.h>
+#include <google.com/webrtc/rtc_base/random.h>
+
+namespace {
+
+    using webrtc::Aec3Fft;
+    using webrtc::Aec3Optimization;
+    using webrtc::FftData;
+    using webrtc::kFftLength;
+    using webrtc::kFftLengthBy2;
+
+    enum class Transform {
+        kFft, kPaddedFft, kPaddedFftSqrtHanning, kZeroPaddedFft, kZeroPaddedFftHanning, kIfft
+    };
+
+    struct Input {
+        std::array<float, kFftLengthBy2> x;
+        std::array<float, kFftLengthBy2> x_old;
+        FftData X;
+    };
+
+    void randomize(webrtc::Random &random, Input *input) {
+        for (float &v : input->x) {
+            v = 32767.f * (random.Rand<float>() - 0.5f);
+        }
+        for (float &v : input->x_old) {
+            v = 32767.f * (random.Rand<float>() - 0.5f);
+        }
+        for (float &v : input->X.re) {
+            v = 32767.f * (random.Rand<float>() - 0.5f);
+        }
+        for (float &v : input->X.im) {
+            v = 32767.f * (random.Rand<float>() - 0.5f);
+        }
+        input->X.im[0] = input->X.im[kFftLengthBy2] = 0.f;
+    }
+
+// Runs transform on input, writing forward transforms to X and the inverse
+// transform to x.
+    void run(const Aec3Fft &fft, Transform transform, const Input &input, FftData *X,
+             std::array<float, kFftLength> *x) {
+        switch (transform) {
+            case Transform::kFft:
+                std::copy(input.x_old.begin(), input.x_old.end(), x->begin());
+                std::copy(input.x.begin(), input.x.end(), x->begin() + kFftLengthBy2);
+                fft.Fft(x, X);
+                break;
+            case Transform::kPaddedFft:
+                fft.PaddedFft(input.x, input.x_old, X);
+                break;
+            case Transform::kPaddedFftSqrtHanning:
+                fft.PaddedFft(input.x, input.x_old, Aec3Fft::Window::kSqrtHanning, X);
+                break;
+            case Transform::kZeroPaddedFft:
+                fft.ZeroPaddedFft(input.x, Aec3Fft::Window::kRectangular, X);
+                break;
+            case Transform::kZeroPaddedFftHanning:
+                fft.ZeroPaddedFft(input.x, Aec3Fft::Window::kHanning, X);
+                break;
+            case Transform::kIfft:
+                fft.Ifft(input.X, x);
+                break;
+        }
+    }
+
+    bool available(Aec3Optimization optimization) {
+        return Aec3OptimizationAvailable(static_cast<int>(optimization)) != 0;
+    }
+
+} // namespace
+
+extern "C" {
+
+double Aec3FftError(int optimization, int transform, unsigned seed) {
+    const auto tested_optimization = static_cast<Aec3Optimization>(optimization);
+    if (!available(tested_optimization)) {
+        return -1;
+    }
+    // Aec3Fft falls back to the plain C Ooura FFT without an optimization.
+    const Aec3Fft reference(Aec3Optimization::kNone);
+    const Aec3Fft tested(tested_optimization);
+    const auto t = static_cast<Transform>(transform);
+
+    webrtc::Random random(seed);
+    double max_difference = 0;
+    double max_reference = 0;
+    for (int i = 0; i < 20; ++i) {
+        Input input;
+        randomize(random, &input);
+        FftData X_reference;
+        FftData X_tested;
+        std::array<float, kFftLength> x_reference;
+        std::array<float, kFftLength> x_tested;
+        run(reference, t, input, &X_reference, &x_reference);
+        run(tested, t, input, &X_tested, &x_tested);
+
+        auto add = [&](float r, float v) {
+            max_difference = std::max(max_difference, std::fabs(double(r) - v));
+            max_reference = std::max(max_reference, std::fabs(double(r)));
+        };
+        if (t == Transform::kIfft) {
+            for (size_t k = 0; k < kFftLength; ++k) {
+                add(x_reference[k], x_tested[k]);
+            }
+        } else {
+            for (size_t k = 0; k < X_reference.re.size(); ++k) {
+                add(X_reference.re[k], X_tested.re[k]);
+                add(X_reference.im[k], X_tested.im[k]);
+            }
+        }
+    }
+    return max_reference > 0 ? max_difference / max_reference : max_difference;
+}
+
+void Aec3FftRun(int optimization, int transform, int iterations) {
+    const Aec3Fft fft(static_cast<Aec3Optimization>(optimization));
+    const auto t = static_cast<Transform>(transform);
+    webrtc::Random random(1);
+    Input input;
+    randomize(random, &input);
+    FftData X;
+    X.Clear();
+    std::array<float, kFftLength> x{};
+    for (int i = 0; i < iterations; ++i) {
+        run(fft, t, input, &X, &x);
+        // Feed the output back so that the calls cannot be hoisted.
+        input.x[i % kFftLengthBy2] = X.re[1] * 1e-3f;
+        input.X.re[1] = x[1] * 1e-3f;
+    }
+}
+
+} // extern "C"
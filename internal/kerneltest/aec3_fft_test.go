@@ -0,0 +1,35 @@
+package kerneltest
+
+import "testing"
+
+var aec3FftTransforms = []Aec3FftTransform{
+	Aec3Fft,
+	Aec3PaddedFft,
+	Aec3PaddedFftSqrtHanning,
+	Aec3ZeroPaddedFft,
+	Aec3ZeroPaddedFftHanning,
+	Aec3Ifft,
+}
+
+func TestAec3FftMatchesOoura(t *testing.T) {
+	forEachAec3Optimization(t, func(t *testing.T, o Aec3Optimization) {
+		for _, transform := range aec3FftTransforms {
+			for seed := uint32(1); seed <= 5; seed++ {
+				checkAec3Error(t, transform.String(), Aec3FftError(o, transform, seed))
+			}
+		}
+	})
+}
+
+func BenchmarkAec3Fft(b *testing.B) {
+	for _, o := range []Aec3Optimization{Aec3None, Aec3Sse2, Aec3Avx2} {
+		if !o.Available() {
+			continue
+		}
+		for _, transform := range aec3FftTransforms {
+			b.Run(o.String()+"/"+transform.String(), func(b *testing.B) {
+				Aec3FftRun(o, transform, b.N)
+			})
+		}
+	}
+}
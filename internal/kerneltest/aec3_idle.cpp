@@ -0,0 +1,130 @@
+// aec3_idle.cpp - Checks of the AEC3 idle mode used while the render signal is inactive
+
+#include <kerneltest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+#include <google.com/webrtc/api/array_view.h>
+#include <google.com/webrtc/api/audio/echo_canceller3_config.h>
+#include <google.com/webrtc/audio_processing/aec3/aec3_common.h>
+#include <google.com/webrtc/audio_processing/aec3/aec3_fft.h>
+#include <google.com/webrtc/audio_processing/aec3/block.h>
+#include <google.com/webrtc/audio_processing/aec3/block_buffer.h>
+#include <google.com/webrtc/audio_processing/aec3/fft_buffer.h>
+#include <google.com/webrtc/audio_processing/aec3/fft_data.h>
+#include <google.com/webrtc/audio_processing/aec3/render_buffer.h>
+#include <google.com/webrtc/audio_processing/aec3/render_signal_analyzer.h>
+#include <google.com/webrtc/audio_processing/aec3/spectrum_buffer.h>
+#include <google.com/webrtc/audio_processing/aec3/suppression_filter.h>
+#include <google.com/webrtc/rtc_base/random.h>
+
+namespace {
+
+    using webrtc::Aec3Fft;
+    using webrtc::Aec3Optimization;
+    using webrtc::Block;
+    using webrtc::FftData;
+    using webrtc::kFftLengthBy2;
+    using webrtc::kFftLengthBy2Plus1;
+
+} // namespace
+
+extern "C" {
+
+double Aec3UnityGainError(int sample_rate_hz, int num_channels, int idle_period, unsigned seed) {
+    constexpr int kNumBlocks = 100;
+    const int num_bands = webrtc::NumBandsForRate(sample_rate_hz);
+    const Aec3Fft fft;
+    // ApplyGain() takes the transform of the lowest band, windowed together
+    // with the previous block, which is what ApplyUnityGain() is given.
+    webrtc::SuppressionFilter reference(Aec3Optimization::kNone, sample_rate_hz, num_channels);
+    webrtc::SuppressionFilter tested(Aec3Optimization::kNone, sample_rate_hz, num_channels);
+    std::vector<std::array<float, kFftLengthBy2>> e_old(num_channels, {0.f});
+    std::vector<FftData> E(num_channels);
+    std::vector<FftData> comfort_noise(num_channels);
+    std::vector<FftData> comfort_noise_high_bands(num_channels);
+    for (auto &N : comfort_noise) {
+        N.Clear();
+    }
+    for (auto &N : comfort_noise_high_bands) {
+        N.Clear();
+    }
+    std::array<float, kFftLengthBy2Plus1> unity_gain;
+    unity_gain.fill(1.f);
+
+    webrtc::Random random(seed);
+    double max_difference = 0;
+    double max_reference = 0;
+    for (int i = 0; i < kNumBlocks; ++i) {
+        Block e_reference(num_bands, num_channels);
+        for (int b = 0; b < num_bands; ++b) {
+            for (int ch = 0; ch < num_channels; ++ch) {
+                for (float &v : e_reference.View(b, ch)) {
+                    v = 16000.f * (random.Rand<float>() - 0.5f);
+                }
+            }
+        }
+        Block e_tested = e_reference;
+
+        for (int ch = 0; ch < num_channels; ++ch) {
+            fft.PaddedFft(e_reference.View(0, ch), e_old[ch], Aec3Fft::Window::kSqrtHanning, &E[ch]);
+        }
+        reference.ApplyGain(comfort_noise, comfort_noise_high_bands, unity_gain, 1.f, E, &e_reference);
+
+        // Alternate between the two paths every idle_period blocks, or stay
+        // idle throughout when idle_period is 0.
+        if (idle_period == 0 || (i / idle_period) % 2 == 1) {
+            tested.ApplyUnityGain(e_old, &e_tested);
+        } else {
+            tested.ApplyGain(comfort_noise, comfort_noise_high_bands, unity_gain, 1.f, E, &e_tested);
+        }
+
+        for (int ch = 0; ch < num_channels; ++ch) {
+            auto e0 = e_tested.View(0, ch);
+            std::copy(e0.begin(), e0.end(), e_old[ch].begin());
+        }
+        for (int b = 0; b < num_bands; ++b) {
+            for (int ch = 0; ch < num_channels; ++ch) {
+                auto r = e_reference.View(b, ch);
+                auto v = e_tested.View(b, ch);
+                for (size_t k = 0; k < kFftLengthBy2; ++k) {
+                    max_difference = std::max(max_difference, std::fabs(double(r[k]) - v[k]));
+                    max_reference = std::max(max_reference, std::fabs(double(r[k])));
+                }
+            }
+        }
+    }
+    return max_reference > 0 ? max_difference / max_reference : max_difference;
+}
+
+int Aec3InactiveRenderBlocks(int num_channels, int active_channel, float level, int num_blocks,
+                             int num_silent_blocks) {
+    const webrtc::EchoCanceller3Config config;
+    constexpr int kBufferSize = 10;
+    webrtc::BlockBuffer block_buffer(kBufferSize, /*num_bands=*/1, num_channels);
+    webrtc::SpectrumBuffer spectrum_buffer(kBufferSize, num_channels);
+    webrtc::FftBuffer fft_buffer(kBufferSize, num_channels);
+    webrtc::RenderBuffer render_buffer(&block_buffer, &spectrum_buffer, &fft_buffer);
+    webrtc::RenderSignalAnalyzer analyzer(config);
+
+    // The level is the magnitude of every sample of a square wave.
+    for (int i = 0; i < num_blocks + num_silent_blocks; ++i) {
+        Block &x = block_buffer.buffer[block_buffer.read];
+        for (int ch = 0; ch < num_channels; ++ch) {
+            auto x_ch = x.View(0, ch);
+            const float amplitude = i < num_blocks && ch == active_channel ? level : 0.f;
+            for (size_t k = 0; k < kFftLengthBy2; ++k) {
+                x_ch[k] = k % 2 == 0 ? amplitude : -amplitude;
+            }
+        }
+        analyzer.Update(render_buffer, std::nullopt);
+        block_buffer.IncReadIndex();
+    }
+    return static_cast<int>(analyzer.InactiveRenderBlocks());
+}
+
+} // extern "C"
@@ -0,0 +1,43 @@
+package kerneltest
+
+import "testing"
+
+func TestAec3ApplyUnityGain(t *testing.T) {
+	for _, sampleRateHz := range []int{16000, 32000, 48000} {
+		for _, channels := range []int{1, 2} {
+			// Idle throughout, and entering and leaving idle mode every block
+			// or every few blocks.
+			for _, period := range []int{0, 1, 3, 10} {
+				err := Aec3UnityGainError(sampleRateHz, channels, period, uint32(period+1))
+				if err < 0 || err > aec3Tolerance {
+					t.Errorf("%d Hz, %d channels, idle period %d: relative error %g, want at most %g",
+						sampleRateHz, channels, period, err, aec3Tolerance)
+				}
+			}
+		}
+	}
+}
+
+func TestAec3InactiveRenderBlocks(t *testing.T) {
+	// The default active render limit is a level of 100.
+	tests := []struct {
+		name                           string
+		channels, activeChannel        int
+		level                          float32
+		blocks, silentBlocks, inactive int
+	}{
+		{"active", 1, 0, 200, 20, 0, 0},
+		{"silence after activity", 1, 0, 200, 20, 25, 25},
+		{"long silence", 1, 0, 200, 1, 1000, 1000},
+		{"below the limit", 1, 0, 99, 20, 5, 25},
+		{"just above the limit", 1, 0, 101, 20, 0, 0},
+		{"active in the second channel", 2, 1, 200, 20, 0, 0},
+		{"silence after activity in the second channel", 2, 1, 200, 20, 7, 7},
+	}
+	for _, tt := range tests {
+		got := Aec3InactiveRenderBlocks(tt.channels, tt.activeChannel, tt.level, tt.blocks, tt.silentBlocks)
+		if got != tt.inactive {
+			t.Errorf("%s: %d inactive render blocks, want %d", tt.name, got, tt.inactive)
+		}
+	}
+}
@@ -0,0 +1,76 @@
+package kerneltest
+
+import "testing"
+
+// The SIMD kernels sum in a different order than the plain ones, so their
+// outputs only match to within float rounding.
+const aec3Tolerance = 1e-5
+
+var aec3Optimizations = []Aec3Optimization{Aec3Sse2, Aec3Avx2, Aec3Avx512, Aec3Neon}
+
+// forEachAec3Optimization runs check as a subtest for every optimization this
+// CPU supports.
+func forEachAec3Optimization(t *testing.T, check func(t *testing.T, o Aec3Optimization)) {
+	for _, o := range aec3Optimizations {
+		t.Run(o.String(), func(t *testing.T) {
+			if !o.Available() {
+				t.Skipf("%v is not available", o)
+			}
+			check(t, o)
+		})
+	}
+}
+
+func checkAec3Error(t *testing.T, what string, err float64) {
+	t.Helper()
+	if err < 0 || err > aec3Tolerance {
+		t.Errorf("%s: relative error %g, want at most %g", what, err, aec3Tolerance)
+	}
+}
+
+func TestAec3FilterKernels(t *testing.T) {
+	forEachAec3Optimization(t, func(t *testing.T, o Aec3Optimization) {
+		for _, partitions := range []int{1, 2, 12, 13, 40} {
+			for _, channels := range []int{1, 2, 3} {
+				for seed := uint32(1); seed <= 3; seed++ {
+					checkAec3Error(t, "ApplyFilter", Aec3ApplyFilterError(o, partitions, channels, seed))
+					checkAec3Error(t, "AdaptPartitions", Aec3AdaptPartitionsError(o, partitions, channels, seed))
+					checkAec3Error(t, "ComputeFrequencyResponse",
+						Aec3FrequencyResponseError(o, partitions, channels, seed))
+				}
+			}
+			checkAec3Error(t, "ComputeErl", Aec3ErlError(o, partitions, uint32(partitions)))
+		}
+	})
+}
+
+func TestAec3MatchedFilterKernels(t *testing.T) {
+	forEachAec3Optimization(t, func(t *testing.T, o Aec3Optimization) {
+		for _, filterSize := range []int{64, 208, 512} {
+			renderSize := 4*filterSize + 16
+			// Start at the beginning, in the middle and close enough to the end
+			// of the render buffer for the filter to wrap around.
+			for _, start := range []int{0, renderSize / 2, renderSize - filterSize/2 - 3} {
+				for _, accumulated := range []bool{false, true} {
+					err := Aec3MatchedFilterError(o, filterSize, renderSize, start, accumulated, uint32(start+1))
+					if err < 0 || err > aec3Tolerance {
+						t.Errorf("%d taps from %d, accumulated error %v: relative error %g, want at most %g",
+							filterSize, start, accumulated, err, aec3Tolerance)
+					}
+				}
+			}
+		}
+	})
+}
+
+func TestAec3VectorKernels(t *testing.T) {
+	forEachAec3Optimization(t, func(t *testing.T, o Aec3Optimization) {
+		checkAec3Error(t, "Spectrum", Aec3SpectrumError(o, 1))
+		// Lengths that are not multiples of 4, 8 or 16 exercise the tails.
+		for _, length := range []int{1, 7, 16, 17, 33, 65, 127} {
+			checkAec3Error(t, "Sqrt", Aec3VectorMathError(o, Aec3Sqrt, length, uint32(length)))
+			checkAec3Error(t, "Multiply", Aec3VectorMathError(o, Aec3Multiply, length, uint32(length)))
+			checkAec3Error(t, "Accumulate", Aec3VectorMathError(o, Aec3Accumulate, length, uint32(length)))
+		}
+	})
+}
@@ -0,0 +1,157 @@
+// interleave.cpp - Checks of the bridge interleave kernels against the plain loops
+
+#include <kerneltest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <interleave.h>
+
+#include <google.com/webrtc/rtc_base/random.h>
+#include <google.com/webrtc/rtc_base/system/arch.h>
+#include <google.com/webrtc/system_wrappers/include/cpu_features_wrapper.h>
+
+namespace {
+
+    using apm::InterleaveOptimization;
+
+    enum class Direction {
+        kDeinterleave, kInterleave, kDeinterleaveS16ToFloat, kInterleaveFloatToS16
+    };
+
+    bool available(InterleaveOptimization optimization) {
+        switch (optimization) {
+            case InterleaveOptimization::kNone:
+                return true;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+            case InterleaveOptimization::kSse2:
+                return webrtc::GetCPUInfo(webrtc::kSSE2) != 0;
+            case InterleaveOptimization::kAvx2:
+                return webrtc::GetCPUInfo(webrtc::kAVX2) != 0;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+            case InterleaveOptimization::kNeon:
+                return true;
+#endif
+            default:
+                return false;
+        }
+    }
+
+// Float samples in [-1.25, 1.25] to exercise the int16 clipping, with some
+// exactly halfway between two int16 values to exercise the rounding.
+    float randomSample(webrtc::Random &random) {
+        if (random.Rand(3) == 0) {
+            return (static_cast<float>(random.Rand(-40000, 40000)) + 0.5f) / 32768.f;
+        }
+        return 2.5f * (random.Rand<float>() - 0.5f);
+    }
+
+// Per-channel buffers with room to detect writes past num_frames.
+    struct Planar {
+        Planar(int num_channels, int num_frames, float fill)
+                : buffers(num_channels, std::vector<float>(num_frames + 1, fill)) {
+            for (auto &b : buffers) {
+                ptrs.push_back(b.data());
+            }
+        }
+
+        std::vector<std::vector<float>> buffers;
+        std::vector<float *> ptrs;
+    };
+
+    template<typename T>
+    double maxDifference(const std::vector<T> &reference, const std::vector<T> &tested) {
+        double difference = 0;
+        for (size_t k = 0; k < reference.size(); ++k) {
+            difference = std::max(difference, std::fabs(double(reference[k]) - double(tested[k])));
+        }
+        return difference;
+    }
+
+} // namespace
+
+extern "C" {
+
+int InterleaveOptimizationAvailable(int optimization) {
+    return available(static_cast<InterleaveOptimization>(optimization)) ? 1 : 0;
+}
+
+double InterleaveError(int optimization, int direction, int num_channels, int num_frames, unsigned seed) {
+    const auto tested = static_cast<InterleaveOptimization>(optimization);
+    if (!available(tested)) {
+        return -1;
+    }
+    const auto reference = InterleaveOptimization::kNone;
+    const int n = num_channels * num_frames;
+    webrtc::Random random(seed);
+
+    switch (static_cast<Direction>(direction)) {
+        case Direction::kDeinterleave:
+        case Direction::kDeinterleaveS16ToFloat: {
+            std::vector<float> src(n);
+            std::vector<int16_t> src_s16(n);
+            for (int k = 0; k < n; ++k) {
+                src[k] = randomSample(random);
+                src_s16[k] = static_cast<int16_t>(random.Rand(-32768, 32767));
+            }
+            Planar dst_reference(num_channels, num_frames, 7.f);
+            Planar dst_tested(num_channels, num_frames, 7.f);
+            if (static_cast<Direction>(direction) == Direction::kDeinterleave) {
+                apm::Deinterleave(reference, src.data(), dst_reference.ptrs.data(), num_channels, num_frames);
+                apm::Deinterleave(tested, src.data(), dst_tested.ptrs.data(), num_channels, num_frames);
+            } else {
+                apm::DeinterleaveS16ToFloat(reference, src_s16.data(), dst_reference.ptrs.data(), num_channels,
+                                            num_frames);
+                apm::DeinterleaveS16ToFloat(tested, src_s16.data(), dst_tested.ptrs.data(), num_channels,
+                                            num_frames);
+            }
+            double difference = 0;
+            for (int ch = 0; ch < num_channels; ++ch) {
+                difference = std::max(difference,
+                                      maxDifference(dst_reference.buffers[ch], dst_tested.buffers[ch]));
+            }
+            return difference;
+        }
+        case Direction::kInterleave: {
+            Planar src(num_channels, num_frames, 0.f);
+            for (auto &b : src.buffers) {
+                std::generate(b.begin(), b.end(), [&] { return randomSample(random); });
+            }
+            std::vector<float> dst_reference(n + 1, 7.f);
+            std::vector<float> dst_tested(n + 1, 7.f);
+            apm::Interleave(reference, src.ptrs.data(), dst_reference.data(), num_channels, num_frames);
+            apm::Interleave(tested, src.ptrs.data(), dst_tested.data(), num_channels, num_frames);
+            return maxDifference(dst_reference, dst_tested);
+        }
+        case Direction::kInterleaveFloatToS16: {
+            Planar src(num_channels, num_frames, 0.f);
+            for (auto &b : src.buffers) {
+                std::generate(b.begin(), b.end(), [&] { return randomSample(random); });
+            }
+            std::vector<int16_t> dst_reference(n + 1, 7);
+            std::vector<int16_t> dst_tested(n + 1, 7);
+            apm::InterleaveFloatToS16(reference, src.ptrs.data(), dst_reference.data(), num_channels, num_frames);
+            apm::InterleaveFloatToS16(tested, src.ptrs.data(), dst_tested.data(), num_channels, num_frames);
+            return maxDifference(dst_reference, dst_tested);
+        }
+    }
+    return -1;
+}
+
+int InterleaveFloatToS16Sample(int optimization, float v) {
+    const auto tested = static_cast<InterleaveOptimization>(optimization);
+    if (!available(tested)) {
+        return 0;
+    }
+    // Eight frames reach the vectorized loop of every kernel set.
+    std::vector<float> src(8, v);
+    float *ptrs[] = {src.data()};
+    std::vector<int16_t> dst(8);
+    apm::InterleaveFloatToS16(tested, ptrs, dst.data(), 1, 8);
+    return dst[0];
+}
+
+} // extern "C"
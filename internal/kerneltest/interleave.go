@@ -0,0 +1,70 @@
+package kerneltest
+
+// #include <kerneltest.h>
+import "C"
+
+// InterleaveOptimization mirrors apm::InterleaveOptimization.
+type InterleaveOptimization int
+
+const (
+	InterleaveNone InterleaveOptimization = iota
+	InterleaveSse2
+	InterleaveAvx2
+	InterleaveNeon
+)
+
+func (o InterleaveOptimization) String() string {
+	switch o {
+	case InterleaveNone:
+		return "None"
+	case InterleaveSse2:
+		return "SSE2"
+	case InterleaveAvx2:
+		return "AVX2"
+	case InterleaveNeon:
+		return "NEON"
+	}
+	return "Unknown"
+}
+
+// Available reports whether the kernels of o can run on this CPU and build.
+func (o InterleaveOptimization) Available() bool {
+	return C.InterleaveOptimizationAvailable(C.int(o)) != 0
+}
+
+// InterleaveDirection selects the bridge kernel to check.
+type InterleaveDirection int
+
+const (
+	Deinterleave InterleaveDirection = iota
+	Interleave
+	DeinterleaveS16ToFloat
+	InterleaveFloatToS16
+)
+
+func (d InterleaveDirection) String() string {
+	switch d {
+	case Deinterleave:
+		return "Deinterleave"
+	case Interleave:
+		return "Interleave"
+	case DeinterleaveS16ToFloat:
+		return "DeinterleaveS16ToFloat"
+	case InterleaveFloatToS16:
+		return "InterleaveFloatToS16"
+	}
+	return "Unknown"
+}
+
+// InterleaveError returns the largest absolute difference between kernel d
+// with o and the plain loops, for numFrames frames of numChannels channels
+// drawn from seed.
+func InterleaveError(o InterleaveOptimization, d InterleaveDirection, numChannels, numFrames int, seed uint32) float64 {
+	return float64(C.InterleaveError(C.int(o), C.int(d), C.int(numChannels), C.int(numFrames), C.uint(seed)))
+}
+
+// InterleaveFloatToS16Sample returns v converted to int16 by the
+// InterleaveFloatToS16 kernel of o.
+func InterleaveFloatToS16Sample(o InterleaveOptimization, v float32) int16 {
+	return int16(C.InterleaveFloatToS16Sample(C.int(o), C.float(v)))
+}
@@ -0,0 +1,62 @@
+package kerneltest
+
+import "testing"
+
+var interleaveOptimizations = []InterleaveOptimization{InterleaveSse2, InterleaveAvx2, InterleaveNeon}
+
+var interleaveDirections = []InterleaveDirection{
+	Deinterleave,
+	Interleave,
+	DeinterleaveS16ToFloat,
+	InterleaveFloatToS16,
+}
+
+func TestInterleaveKernels(t *testing.T) {
+	for _, o := range interleaveOptimizations {
+		t.Run(o.String(), func(t *testing.T) {
+			if !o.Available() {
+				t.Skipf("%v is not available", o)
+			}
+			for _, d := range interleaveDirections {
+				// Odd channel counts take the generic loops, and frame counts
+				// that are not multiples of 4 or 8 leave tails for them.
+				for _, channels := range []int{1, 2, 3, 5, 8} {
+					for _, frames := range []int{1, 3, 7, 8, 9, 80, 161, 479, 480} {
+						err := InterleaveError(o, d, channels, frames, uint32(channels*1000+frames))
+						if err != 0 {
+							t.Errorf("%v, %d channels, %d frames: differs from the plain loops by %g", d, channels, frames, err)
+						}
+					}
+				}
+			}
+		})
+	}
+}
+
+func TestInterleaveFloatToS16Rounding(t *testing.T) {
+	tests := []struct {
+		v    float32
+		want int16
+	}{
+		{0, 0},
+		{0.5 / 32768, 1},
+		{-0.5 / 32768, -1},
+		{0.49 / 32768, 0},
+		{2.5 / 32768, 3},
+		{-2.5 / 32768, -3},
+		{1, 32767},
+		{-1, -32768},
+		{1.5, 32767},
+		{-1.5, -32768},
+	}
+	for _, o := range append([]InterleaveOptimization{InterleaveNone}, interleaveOptimizations...) {
+		if !o.Available() {
+			continue
+		}
+		for _, tt := range tests {
+			if got := InterleaveFloatToS16Sample(o, tt.v); got != tt.want {
+				t.Errorf("%v: %g/32768 converts to %d, want %d", o, tt.v*32768, got, tt.want)
+			}
+		}
+	}
+}
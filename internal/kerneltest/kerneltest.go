@@ -0,0 +1,27 @@
+// Package kerneltest checks the SIMD kernels used by the wrapper and the
+// vendored WebRTC code against their plain C++ versions. cgo cannot be used
+// in test files, so the checks are C functions in this package, wrapped by
+// Go functions that the tests call. Nothing else imports it.
+package kerneltest
+
+/*
+#cgo CXXFLAGS: -I${SRCDIR}/../..
+#cgo CXXFLAGS: -I${SRCDIR}/../../google.com/webrtc
+#cgo CXXFLAGS: -I${SRCDIR}/../../google.com/abseil-cpp
+#cgo CXXFLAGS: -std=c++17
+#cgo CXXFLAGS: -DWEBRTC_APM_DEBUG_DUMP=0
+#cgo arm,neon CXXFLAGS: -mfpu=neon -mfloat-abi=hard -DWEBRTC_HAS_NEON
+#cgo arm64 CXXFLAGS: -DWEBRTC_HAS_NEON -DWEBRTC_ARCH_ARM64
+#cgo arm7 CXXFLAGS: -mfpu=neon -mfloat-abi=hard -DWEBRTC_HAS_NEON -DWEBRTC_ARCH_ARM_V7
+#cgo darwin CXXFLAGS: -DWEBRTC_MAC -DWEBRTC_POSIX
+#cgo ios CXXFLAGS: -DWEBRTC_IOS -DWEBRTC_MAC -DWEBRTC_POSIX
+#cgo linux CXXFLAGS: -DWEBRTC_LINUX -DWEBRTC_POSIX
+#cgo android CXXFLAGS: -DWEBRTC_LINUX -DWEBRTC_ANDROID -DWEBRTC_POSIX
+#cgo windows CXXFLAGS: -DWEBRTC_WIN
+*/
+import "C"
+
+import (
+	_ "github.com/CoyAce/apm"
+	_ "github.com/CoyAce/apm/google.com/webrtc"
+)
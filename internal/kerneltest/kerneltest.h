@@ -0,0 +1,122 @@
+// kerneltest.h - C entry points comparing SIMD kernels with their plain versions
+//
+// Each check runs a kernel on pseudo-random input, once with the given
+// optimization and once with the plain C++ code, and returns the largest
+// difference between the two outputs relative to the largest reference
+// output. The checks return -1 when the optimization is not available on the
+// running CPU or in this build.
+
+#ifndef APM_KERNELTEST_H
+#define APM_KERNELTEST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// AEC3 kernels. optimization is a webrtc::Aec3Optimization value.
+int Aec3OptimizationAvailable(int optimization);
+
+double Aec3ApplyFilterError(int optimization, int num_partitions, int num_channels, unsigned seed);
+
+double Aec3AdaptPartitionsError(int optimization, int num_partitions, int num_channels, unsigned seed);
+
+double Aec3FrequencyResponseError(int optimization, int num_partitions, int num_channels, unsigned seed);
+
+double Aec3ErlError(int optimization, int num_partitions, unsigned seed);
+
+// filter_size is the number of taps, x_start_index where the filter starts in
+// a render buffer of render_size samples, wrapping around its end.
+double Aec3MatchedFilterError(int optimization, int filter_size, int render_size, int x_start_index,
+                              int compute_accumulated_error, unsigned seed);
+
+double Aec3SpectrumError(int optimization, unsigned seed);
+
+// op is 0 for Sqrt, 1 for Multiply and 2 for Accumulate.
+double Aec3VectorMathError(int optimization, int op, int length, unsigned seed);
+
+// Aec3Fft. transform is 0 for Fft, 1 for PaddedFft, 2 for PaddedFft with a
+// sqrt-Hanning window, 3 for ZeroPaddedFft, 4 for ZeroPaddedFft with a Hanning
+// window and 5 for Ifft. The reference is the plain C Ooura FFT.
+double Aec3FftError(int optimization, int transform, unsigned seed);
+
+// Runs transform iterations times, for benchmarks.
+void Aec3FftRun(int optimization, int transform, int iterations);
+
+// AEC3 idle mode. Returns the largest difference between SuppressionFilter
+// with unity gain and no comfort noise, and the same filter switching to
+// ApplyUnityGain() every idle_period blocks, or throughout when idle_period is
+// 0, relative to the largest reference output.
+double Aec3UnityGainError(int sample_rate_hz, int num_channels, int idle_period, unsigned seed);
+
+// Returns RenderSignalAnalyzer::InactiveRenderBlocks() after num_blocks blocks
+// of a square wave of the given level in active_channel, followed by
+// num_silent_blocks blocks of silence.
+int Aec3InactiveRenderBlocks(int num_channels, int active_channel, float level, int num_blocks,
+                             int num_silent_blocks);
+
+// AEC3 delay estimation. estimator is a
+// webrtc::EchoCanceller3Config::Delay::Estimator value. Runs
+// EchoPathDelayEstimator at 16 kHz for num_blocks blocks of uniform noise of
+// amplitude render_level, with the capture signal being the render signal
+// delayed by delay_samples plus independent noise of amplitude noise_level.
+// Returns the last delay estimate in samples, or -1 if there was none.
+int Aec3EchoPathDelay(int estimator, int down_sampling_factor, int num_filters, int delay_samples,
+                      float render_level, float noise_level, int num_blocks, unsigned seed);
+
+// Runs EchoPathDelayEstimator at 16 kHz behind a RenderDriftCompensator,
+// adding each drift rate the estimator reports to the compensation as
+// BlockProcessor does, for num_blocks capture blocks of an echo whose render
+// device plays 1 + drift samples per capture sample. The echo path delay then
+// shrinks by drift samples per sample, which the compensation should cancel.
+// Returns the compensated drift at the end.
+double Aec3ClockdriftCompensation(float drift, int num_blocks, unsigned seed);
+
+// Returns the largest difference between the input of a
+// RenderDriftCompensator without any drift added and its output, which should
+// be the same block, over num_blocks random blocks. Returns infinity if a call
+// gives other than one block.
+double Aec3DriftCompensatorPassThroughError(int num_bands, int num_channels, int num_blocks, unsigned seed);
+
+// Noise suppressor kernels. optimization is a webrtc::NsOptimization value.
+int NsOptimizationAvailable(int optimization);
+
+// The array log and exp with optimization, for an array filled with x.
+float NsLog(int optimization, float x);
+
+float NsExp(int optimization, float x);
+
+double NsLogError(int optimization, int length, unsigned seed);
+
+// Unlike the other checks, returns the largest error relative to each
+// reference output, for inputs where the reference is a normal float.
+double NsExpError(int optimization, int length, unsigned seed);
+
+// The stateful kernels run for 300 frames of random spectra. With edge set,
+// some bins are zero, tiny or huge.
+double NsWienerFilterError(int optimization, int edge, unsigned seed);
+
+double NsSignalModelError(int optimization, int edge, unsigned seed);
+
+double NsSpeechProbabilityError(int optimization, int edge, unsigned seed);
+
+// NoiseSuppressor end to end, including the FFT. Returns the relative
+// difference of the output energy over 300 frames.
+double NsSuppressorError(int optimization, int sample_rate_hz, int num_channels, unsigned seed);
+
+// Bridge interleave kernels. optimization is an apm::InterleaveOptimization
+// value. direction is 0 for Deinterleave, 1 for Interleave, 2 for
+// DeinterleaveS16ToFloat and 3 for InterleaveFloatToS16. Returns the largest
+// absolute difference from the plain loops, including one sample past the
+// end of each output.
+int InterleaveOptimizationAvailable(int optimization);
+
+double InterleaveError(int optimization, int direction, int num_channels, int num_frames, unsigned seed);
+
+// Returns v converted by InterleaveFloatToS16 with optimization.
+int InterleaveFloatToS16Sample(int optimization, float v);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APM_KERNELTEST_H
@@ -0,0 +1,363 @@
+// ns.cpp - Checks of the noise suppressor SIMD kernels against the plain C++ versions
+
+#include <kerneltest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <google.com/webrtc/api/array_view.h>
+#include <google.com/webrtc/audio_processing/audio_buffer.h>
+#include <google.com/webrtc/audio_processing/ns/fast_math.h>
+#include <google.com/webrtc/audio_processing/ns/noise_suppressor.h>
+#include <google.com/webrtc/audio_processing/ns/ns_common.h>
+#include <google.com/webrtc/audio_processing/ns/ns_config.h>
+#include <google.com/webrtc/audio_processing/ns/signal_model_estimator.h>
+#include <google.com/webrtc/audio_processing/ns/speech_probability_estimator.h>
+#include <google.com/webrtc/audio_processing/ns/suppression_params.h>
+#include <google.com/webrtc/audio_processing/ns/wiener_filter.h>
+#include <google.com/webrtc/rtc_base/random.h>
+#include <google.com/webrtc/rtc_base/system/arch.h>
+#include <google.com/webrtc/system_wrappers/include/cpu_features_wrapper.h>
+
+namespace {
+
+    using webrtc::ArrayView;
+    using webrtc::kFftSizeBy2Plus1;
+    using webrtc::NsOptimization;
+
+    using Spectrum = std::array<float, kFftSizeBy2Plus1>;
+
+// Number of frames the stateful kernels are run for, beyond the startup
+// phases of the Wiener filter and the signal model.
+    constexpr int kNumFrames = 300;
+
+    bool available(NsOptimization optimization) {
+        switch (optimization) {
+            case NsOptimization::kNone:
+                return true;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+            case NsOptimization::kSse2:
+                return webrtc::GetCPUInfo(webrtc::kSSE2) != 0;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+            case NsOptimization::kNeon:
+                return true;
+#endif
+            default:
+                return false;
+        }
+    }
+
+// Tracks the largest difference between reference and tested outputs, and
+// the largest reference output to scale it by. Outputs that are not finite
+// must be the same in both.
+    class ErrorMeter {
+    public:
+        void Add(float reference, float tested) {
+            if (!std::isfinite(reference) || !std::isfinite(tested)) {
+                const bool same = std::isnan(reference) ? std::isnan(tested) : reference == tested;
+                mismatch_ = mismatch_ || !same;
+                return;
+            }
+            max_difference_ = std::max(max_difference_, std::fabs(double(reference) - tested));
+            max_reference_ = std::max(max_reference_, std::fabs(double(reference)));
+        }
+
+        void Add(ArrayView<const float> reference, ArrayView<const float> tested) {
+            for (size_t k = 0; k < reference.size(); ++k) {
+                Add(reference[k], tested[k]);
+            }
+        }
+
+        double Relative() const {
+            if (mismatch_) {
+                return 1.0;
+            }
+            return max_reference_ > 0 ? max_difference_ / max_reference_ : max_difference_;
+        }
+
+    private:
+        double max_difference_ = 0;
+        double max_reference_ = 0;
+        bool mismatch_ = false;
+    };
+
+// Draws a value that is uniform in the log domain between 10^min_exponent and
+// 10^max_exponent.
+    float logUniform(webrtc::Random &random, float min_exponent, float max_exponent) {
+        return std::pow(10.f, min_exponent + (max_exponent - min_exponent) * random.Rand<float>());
+    }
+
+// Spectra and SNRs as the noise suppressor computes them for one frame. With
+// edge set, some of the bins are zero, tiny or huge instead.
+    struct Frame {
+        Spectrum noise;
+        Spectrum prev_noise;
+        Spectrum parametric_noise;
+        Spectrum signal;
+        Spectrum prior_snr;
+        Spectrum post_snr;
+        float signal_spectral_sum;
+        float signal_energy;
+
+        void Randomize(webrtc::Random &random, bool edge) {
+            prev_noise = noise;
+            for (size_t k = 0; k < kFftSizeBy2Plus1; ++k) {
+                noise[k] = logUniform(random, 0.f, 4.f);
+                parametric_noise[k] = logUniform(random, 0.f, 4.f);
+                signal[k] = noise[k] * logUniform(random, -1.f, 2.f);
+                if (edge) {
+                    switch (random.Rand(0, 5)) {
+                        case 0:
+                            signal[k] = 0.f;
+                            break;
+                        case 1:
+                            signal[k] = 1e-30f;
+                            break;
+                        case 2:
+                            signal[k] = 1e12f;
+                            break;
+                        case 3:
+                            noise[k] = 1e-30f;
+                            break;
+                        default:
+                            break;
+                    }
+                }
+                prior_snr[k] = edge && random.Rand(0, 5) == 0 ? 1e6f : logUniform(random, -3.f, 2.f);
+                post_snr[k] = std::max(signal[k] / (noise[k] + 0.0001f) - 1.f, 0.f);
+            }
+            signal_spectral_sum = 0.f;
+            signal_energy = 0.f;
+            for (float s : signal) {
+                signal_spectral_sum += s;
+                signal_energy += s * s;
+            }
+            signal_energy /= kFftSizeBy2Plus1;
+        }
+    };
+
+// Runs the array log or exp on x with optimization.
+    void logOrExp(NsOptimization optimization, bool exp, ArrayView<const float> x, ArrayView<float> y) {
+        if (exp) {
+            webrtc::ExpApproximation(optimization, x, y);
+        } else {
+            webrtc::LogApproximation(optimization, x, y);
+        }
+    }
+
+// Returns the vector result for x. The array is long enough for every lane
+// to be computed by the SIMD code.
+    float vectorLogOrExp(NsOptimization optimization, bool exp, float x) {
+        std::array<float, 16> in;
+        std::array<float, 16> out;
+        in.fill(x);
+        logOrExp(optimization, exp, in, out);
+        return out[5];
+    }
+
+} // namespace
+
+extern "C" {
+
+int NsOptimizationAvailable(int optimization) {
+    return available(static_cast<NsOptimization>(optimization)) ? 1 : 0;
+}
+
+float NsLog(int optimization, float x) {
+    return vectorLogOrExp(static_cast<NsOptimization>(optimization), false, x);
+}
+
+float NsExp(int optimization, float x) {
+    return vectorLogOrExp(static_cast<NsOptimization>(optimization), true, x);
+}
+
+double NsLogError(int optimization, int length, unsigned seed) {
+    const auto tested = static_cast<NsOptimization>(optimization);
+    if (!available(tested)) {
+        return -1;
+    }
+    webrtc::Random random(seed);
+    std::vector<float> x(length);
+    for (float &v : x) {
+        v = logUniform(random, -30.f, 30.f);
+    }
+    std::vector<float> reference(length);
+    std::vector<float> y(length);
+    webrtc::LogApproximation(x, reference);
+    webrtc::LogApproximation(tested, x, y);
+    ErrorMeter meter;
+    meter.Add(reference, y);
+    return meter.Relative();
+}
+
+double NsExpError(int optimization, int length, unsigned seed) {
+    const auto tested = static_cast<NsOptimization>(optimization);
+    if (!available(tested)) {
+        return -1;
+    }
+    webrtc::Random random(seed);
+    std::vector<float> x(length);
+    for (float &v : x) {
+        // The range for which the scalar result is a normal float.
+        v = -87.f + 175.f * random.Rand<float>();
+    }
+    std::vector<float> reference(length);
+    std::vector<float> y(length);
+    webrtc::ExpApproximation(x, reference);
+    webrtc::ExpApproximation(tested, x, y);
+    // The outputs span 76 decades, so each is compared with its own reference.
+    double max_error = 0;
+    for (int k = 0; k < length; ++k) {
+        if (!std::isfinite(y[k])) {
+            return 1.0;
+        }
+        max_error = std::max(max_error, std::fabs(double(y[k]) - reference[k]) / reference[k]);
+    }
+    return max_error;
+}
+
+double NsWienerFilterError(int optimization, int edge, unsigned seed) {
+    const auto tested_optimization = static_cast<NsOptimization>(optimization);
+    if (!available(tested_optimization)) {
+        return -1;
+    }
+    const webrtc::SuppressionParams params(webrtc::NsConfig::SuppressionLevel::k12dB);
+    webrtc::WienerFilter reference(params, NsOptimization::kNone);
+    webrtc::WienerFilter tested(params, tested_optimization);
+    webrtc::Random random(seed);
+    Frame frame;
+    frame.noise.fill(1.f);
+    ErrorMeter meter;
+    for (int i = 0; i < kNumFrames; ++i) {
+        frame.Randomize(random, edge != 0);
+        reference.Update(i, frame.noise, frame.prev_noise, frame.parametric_noise, frame.signal);
+        tested.Update(i, frame.noise, frame.prev_noise, frame.parametric_noise, frame.signal);
+        meter.Add(reference.get_filter(), tested.get_filter());
+    }
+    return meter.Relative();
+}
+
+double NsSignalModelError(int optimization, int edge, unsigned seed) {
+    const auto tested_optimization = static_cast<NsOptimization>(optimization);
+    if (!available(tested_optimization)) {
+        return -1;
+    }
+    webrtc::SignalModelEstimator reference(NsOptimization::kNone);
+    webrtc::SignalModelEstimator tested(tested_optimization);
+    webrtc::Random random(seed);
+    Frame frame;
+    frame.noise.fill(1.f);
+    ErrorMeter lrt;
+    ErrorMeter spectral_diff;
+    ErrorMeter spectral_flatness;
+    ErrorMeter avg_log_lrt;
+    for (int i = 0; i < kNumFrames; ++i) {
+        frame.Randomize(random, edge != 0);
+        for (auto *estimator : {&reference, &tested}) {
+            estimator->AdjustNormalization(i, frame.signal_energy);
+            estimator->Update(frame.prior_snr, frame.post_snr, frame.noise, frame.signal,
+                              frame.signal_spectral_sum, frame.signal_energy);
+        }
+        const webrtc::SignalModel &r = reference.get_model();
+        const webrtc::SignalModel &t = tested.get_model();
+        lrt.Add(r.lrt, t.lrt);
+        spectral_diff.Add(r.spectral_diff, t.spectral_diff);
+        spectral_flatness.Add(r.spectral_flatness, t.spectral_flatness);
+        avg_log_lrt.Add(r.avg_log_lrt, t.avg_log_lrt);
+    }
+    // The features have different scales, so each is judged on its own.
+    return std::max({lrt.Relative(), spectral_diff.Relative(), spectral_flatness.Relative(),
+                     avg_log_lrt.Relative()});
+}
+
+double NsSpeechProbabilityError(int optimization, int edge, unsigned seed) {
+    const auto tested_optimization = static_cast<NsOptimization>(optimization);
+    if (!available(tested_optimization)) {
+        return -1;
+    }
+    webrtc::SpeechProbabilityEstimator reference(NsOptimization::kNone);
+    webrtc::SpeechProbabilityEstimator tested(tested_optimization);
+    webrtc::Random random(seed);
+    Frame frame;
+    frame.noise.fill(1.f);
+    ErrorMeter meter;
+    for (int i = 0; i < kNumFrames; ++i) {
+        frame.Randomize(random, edge != 0);
+        for (auto *estimator : {&reference, &tested}) {
+            estimator->Update(i, frame.prior_snr, frame.post_snr, frame.noise, frame.signal,
+                              frame.signal_spectral_sum, frame.signal_energy);
+        }
+        meter.Add(reference.get_prior_probability(), tested.get_prior_probability());
+        meter.Add(reference.get_probability(), tested.get_probability());
+    }
+    return meter.Relative();
+}
+
+// The quantile noise estimator steps its estimates up or down depending on
+// comparisons, which rounding differences can flip, so that even the plain
+// code changes individual output samples by up to a few percent for a one ulp
+// change of the input. The output energy is robust against that.
+double NsSuppressorError(int optimization, int sample_rate_hz, int num_channels, unsigned seed) {
+    const auto tested_optimization = static_cast<NsOptimization>(optimization);
+    if (!available(tested_optimization)) {
+        return -1;
+    }
+    webrtc::NsConfig config;
+    config.target_level = webrtc::NsConfig::SuppressionLevel::k12dB;
+    const size_t rate = sample_rate_hz;
+    const size_t channels = num_channels;
+    webrtc::NoiseSuppressor reference(config, rate, channels, NsOptimization::kNone);
+    webrtc::NoiseSuppressor tested(config, rate, channels, tested_optimization);
+    webrtc::AudioBuffer reference_audio(rate, channels, rate, channels, rate, channels);
+    webrtc::AudioBuffer tested_audio(rate, channels, rate, channels, rate, channels);
+
+    webrtc::Random random(seed);
+    const size_t frame_length = rate / 100;
+    double reference_energy = 0;
+    double tested_energy = 0;
+    for (int i = 0; i < kNumFrames; ++i) {
+        // Noise with a tone that comes and goes, at a level that changes every
+        // 50 frames, so that the estimators see speech-like and pause frames.
+        const float noise_level = 30.f * std::pow(10.f, float(i / 50 % 3));
+        const float tone_level = i % 40 < 20 ? 3000.f : 0.f;
+        for (size_t ch = 0; ch < channels; ++ch) {
+            for (size_t n = 0; n < frame_length; ++n) {
+                const float v = noise_level * (random.Rand<float>() - 0.5f) +
+                                tone_level * std::sin(0.07f * float(i * frame_length + n) * float(ch + 1));
+                reference_audio.channels()[ch][n] = v;
+                tested_audio.channels()[ch][n] = v;
+            }
+        }
+        for (auto *audio : {&reference_audio, &tested_audio}) {
+            if (rate > 16000) {
+                audio->SplitIntoFrequencyBands();
+            }
+        }
+        reference.Analyze(reference_audio);
+        reference.Process(&reference_audio);
+        tested.Analyze(tested_audio);
+        tested.Process(&tested_audio);
+        for (auto *audio : {&reference_audio, &tested_audio}) {
+            if (rate > 16000) {
+                audio->MergeFrequencyBands();
+            }
+        }
+        for (size_t ch = 0; ch < channels; ++ch) {
+            for (size_t n = 0; n < frame_length; ++n) {
+                const float r = reference_audio.channels()[ch][n];
+                const float t = tested_audio.channels()[ch][n];
+                if (!std::isfinite(t)) {
+                    return 1.0;
+                }
+                reference_energy += double(r) * r;
+                tested_energy += double(t) * t;
+            }
+        }
+    }
+    return std::fabs(tested_energy - reference_energy) / reference_energy;
+}
+
+} // extern "C"
@@ -0,0 +1,80 @@
+package kerneltest
+
+// #include <kerneltest.h>
+import "C"
+
+// NsOptimization mirrors webrtc::NsOptimization.
+type NsOptimization int
+
+const (
+	NsNone NsOptimization = iota
+	NsSse2
+	NsNeon
+)
+
+func (o NsOptimization) String() string {
+	switch o {
+	case NsNone:
+		return "None"
+	case NsSse2:
+		return "SSE2"
+	case NsNeon:
+		return "NEON"
+	}
+	return "Unknown"
+}
+
+// Available reports whether the kernels of o can run on this CPU and build.
+func (o NsOptimization) Available() bool {
+	return C.NsOptimizationAvailable(C.int(o)) != 0
+}
+
+// NsLog returns the array LogApproximation of x with o.
+func NsLog(o NsOptimization, x float32) float32 {
+	return float32(C.NsLog(C.int(o), C.float(x)))
+}
+
+// NsExp returns the array ExpApproximation of x with o.
+func NsExp(o NsOptimization, x float32) float32 {
+	return float32(C.NsExp(C.int(o), C.float(x)))
+}
+
+// NsLogError checks LogApproximation on length positive values spanning 60
+// decades.
+func NsLogError(o NsOptimization, length int, seed uint32) float64 {
+	return float64(C.NsLogError(C.int(o), C.int(length), C.uint(seed)))
+}
+
+// NsExpError checks ExpApproximation on length values in [-87, 88], and
+// returns the largest error relative to each plain output.
+func NsExpError(o NsOptimization, length int, seed uint32) float64 {
+	return float64(C.NsExpError(C.int(o), C.int(length), C.uint(seed)))
+}
+
+// NsWienerFilterError checks WienerFilter::Update.
+func NsWienerFilterError(o NsOptimization, edge bool, seed uint32) float64 {
+	return float64(C.NsWienerFilterError(C.int(o), cBool(edge), C.uint(seed)))
+}
+
+// NsSignalModelError checks the features of SignalModelEstimator.
+func NsSignalModelError(o NsOptimization, edge bool, seed uint32) float64 {
+	return float64(C.NsSignalModelError(C.int(o), cBool(edge), C.uint(seed)))
+}
+
+// NsSpeechProbabilityError checks SpeechProbabilityEstimator.
+func NsSpeechProbabilityError(o NsOptimization, edge bool, seed uint32) float64 {
+	return float64(C.NsSpeechProbabilityError(C.int(o), cBool(edge), C.uint(seed)))
+}
+
+// NsSuppressorError checks the output energy of NoiseSuppressor. Its
+// individual samples are too sensitive to rounding to compare.
+func NsSuppressorError(o NsOptimization, sampleRateHz, numChannels int, seed uint32) float64 {
+	return float64(C.NsSuppressorError(C.int(o), C.int(sampleRateHz), C.int(numChannels), C.uint(seed)))
+}
+
+func cBool(b bool) C.int {
+	if b {
+		return 1
+	}
+	return 0
+}
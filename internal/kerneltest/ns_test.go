@@ -0,0 +1,102 @@
+package kerneltest
+
+import (
+	"math"
+	"testing"
+)
+
+// The SIMD kernels sum in a different order than the plain ones and their exp
+// replaces powf by a polynomial, so the outputs match to within float rounding
+// of the polynomial error.
+const nsTolerance = 1e-5
+
+var nsOptimizations = []NsOptimization{NsSse2, NsNeon}
+
+// forEachNsOptimization runs check as a subtest for every optimization this
+// CPU supports.
+func forEachNsOptimization(t *testing.T, check func(t *testing.T, o NsOptimization)) {
+	for _, o := range nsOptimizations {
+		t.Run(o.String(), func(t *testing.T) {
+			if !o.Available() {
+				t.Skipf("%v is not available", o)
+			}
+			check(t, o)
+		})
+	}
+}
+
+func checkNsError(t *testing.T, what string, err, tolerance float64) {
+	t.Helper()
+	if err < 0 || err > tolerance {
+		t.Errorf("%s: relative error %g, want at most %g", what, err, tolerance)
+	}
+}
+
+func TestNsFastMath(t *testing.T) {
+	forEachNsOptimization(t, func(t *testing.T, o NsOptimization) {
+		// Lengths that are not multiples of 4 exercise the scalar tails.
+		for _, length := range []int{1, 3, 4, 7, 65, 129} {
+			checkNsError(t, "Log", NsLogError(o, length, uint32(length)), nsTolerance)
+			// The polynomial is accurate to 2e-7 relative.
+			checkNsError(t, "Exp", NsExpError(o, length, uint32(length)), 1e-6)
+		}
+	})
+}
+
+func TestNsFastMathEdges(t *testing.T) {
+	forEachNsOptimization(t, func(t *testing.T, o NsOptimization) {
+		// The bit pattern log matches the scalar one for all positive inputs,
+		// including denormals and infinity.
+		for _, x := range []float32{1e-45, 1e-40, 1.1754944e-38, 1, 3, math.MaxFloat32, float32(math.Inf(1))} {
+			if got, want := NsLog(o, x), NsLog(NsNone, x); got != want {
+				t.Errorf("log(%g) = %g, want %g", x, got, want)
+			}
+		}
+		// 2^p saturates at the exponents of the smallest and largest normal
+		// floats, where the scalar powf underflows to denormals and zero or
+		// overflows to infinity.
+		const minPow2, maxPow2 = 1.1754944e-38, 1.7014118e+38
+		for _, x := range []float32{-88, -200, -1e4, float32(math.Inf(-1))} {
+			if got := NsExp(o, x); got != minPow2 {
+				t.Errorf("exp(%g) = %g, want %g", x, got, float32(minPow2))
+			}
+		}
+		for _, x := range []float32{89, 200, 1e4, float32(math.Inf(1))} {
+			if got := NsExp(o, x); got != maxPow2 {
+				t.Errorf("exp(%g) = %g, want %g", x, got, float32(maxPow2))
+			}
+		}
+		// Just inside the range, the results match the scalar ones.
+		for _, x := range []float32{-87, -50, -1e-3, 0, 1e-3, 50, 88} {
+			got, want := NsExp(o, x), NsExp(NsNone, x)
+			if math.Abs(float64(got-want)) > 1e-6*float64(want) {
+				t.Errorf("exp(%g) = %g, want %g", x, got, want)
+			}
+		}
+	})
+}
+
+func TestNsKernels(t *testing.T) {
+	forEachNsOptimization(t, func(t *testing.T, o NsOptimization) {
+		for _, edge := range []bool{false, true} {
+			for seed := uint32(1); seed <= 3; seed++ {
+				checkNsError(t, "WienerFilter", NsWienerFilterError(o, edge, seed), nsTolerance)
+				checkNsError(t, "SignalModelEstimator", NsSignalModelError(o, edge, seed), nsTolerance)
+				checkNsError(t, "SpeechProbabilityEstimator", NsSpeechProbabilityError(o, edge, seed), nsTolerance)
+			}
+		}
+	})
+}
+
+func TestNsSuppressor(t *testing.T) {
+	forEachNsOptimization(t, func(t *testing.T, o NsOptimization) {
+		for _, rate := range []int{16000, 32000, 48000} {
+			for _, channels := range []int{1, 2} {
+				for seed := uint32(1); seed <= 3; seed++ {
+					// About 0.01 dB.
+					checkNsError(t, "NoiseSuppressor", NsSuppressorError(o, rate, channels, seed), 2.5e-3)
+				}
+			}
+		}
+	})
+}
@@ -0,0 +1,178 @@
+// pool.cpp - Pool of pre-initialized audio processors
+
+#include <pool.h>
+
+#include <mutex>
+#include <vector>
+
+#ifndef WEBRTC_POSIX
+#define WEBRTC_POSIX
+#endif
+
+#include <google.com/webrtc/audio_processing/include/audio_processing.h>
+
+namespace {
+
+    class Pool {
+    public:
+        Pool(ApmConfig apmConfig, int capacity) : config_(apmConfig), capacity_(capacity) {
+            idle_.reserve(capacity);
+            released_.reserve(capacity);
+        }
+
+        ~Pool() {
+            for (ApmHandle handle: idle_) Destroy(handle);
+            for (ApmHandle handle: released_) Destroy(handle);
+        }
+
+        ApmHandle Acquire(int *error_code) {
+            *error_code = webrtc::AudioProcessing::kNoError;
+            ApmHandle released = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!idle_.empty()) {
+                    ApmHandle handle = idle_.back();
+                    idle_.pop_back();
+                    return handle;
+                }
+                if (!released_.empty()) {
+                    released = released_.back();
+                    released_.pop_back();
+                }
+            }
+            // Resetting is still much cheaper than building a processor
+            if (released) {
+                reset(released);
+                return released;
+            }
+            return Create(config_, error_code);
+        }
+
+        void Release(ApmHandle handle) {
+            // The reset is left to Fill() so that the releasing thread only
+            // pays for a push.
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (heldLocked() < capacity_) {
+                    released_.push_back(handle);
+                    return;
+                }
+            }
+            Destroy(handle);
+        }
+
+        int Fill() {
+            while (true) {
+                ApmHandle handle;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (released_.empty()) break;
+                    handle = released_.back();
+                    released_.pop_back();
+                }
+                // Reset outside the lock: it re-initializes every submodule
+                reset(handle);
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                idle_.push_back(handle);
+            }
+
+            while (IdleHandles() < capacity_) {
+                int error_code;
+                ApmHandle handle = Create(config_, &error_code);
+                if (!handle) return error_code;
+
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (heldLocked() >= capacity_) {
+                    // Filled concurrently by releases
+                    lock.unlock();
+                    Destroy(handle);
+                    break;
+                }
+                idle_.push_back(handle);
+            }
+            return webrtc::AudioProcessing::kNoError;
+        }
+
+        int IdleHandles() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return heldLocked();
+        }
+
+    private:
+        int heldLocked() const {
+            return static_cast<int>(idle_.size() + released_.size());
+        }
+
+        // Brings a released handle back to the pool's configuration and a
+        // just-created state. ResetHandle() also drops the runtime gains the
+        // apply may have queued.
+        void reset(ApmHandle handle) {
+            ApplyConfig(handle, config_);
+            ResetHandle(handle);
+        }
+
+        const ApmConfig config_;
+        const int capacity_;
+
+        std::mutex mutex_;
+        // Ready to be handed out
+        std::vector<ApmHandle> idle_;
+        // Released and not reset yet
+        std::vector<ApmHandle> released_;
+    };
+
+} // anonymous namespace
+
+extern "C" {
+
+ApmPoolHandle CreatePool(ApmConfig apmConfig, int capacity, int *error_code) {
+    *error_code = 0;
+    if (capacity < 0) {
+        *error_code = webrtc::AudioProcessing::kBadParameterError;
+        return nullptr;
+    }
+
+    auto *pool = new Pool(apmConfig, capacity);
+    *error_code = pool->Fill();
+    if (*error_code != webrtc::AudioProcessing::kNoError) {
+        delete pool;
+        return nullptr;
+    }
+    return static_cast<ApmPoolHandle>(pool);
+}
+
+void DestroyPool(ApmPoolHandle pool) {
+    if (pool) {
+        delete static_cast<Pool *>(pool);
+    }
+}
+
+ApmHandle AcquireHandle(ApmPoolHandle pool, int *error_code) {
+    if (!pool) {
+        *error_code = webrtc::AudioProcessing::kNullPointerError;
+        return nullptr;
+    }
+    return static_cast<Pool *>(pool)->Acquire(error_code);
+}
+
+void ReleaseHandle(ApmPoolHandle pool, ApmHandle handle) {
+    if (!handle) return;
+    if (!pool) {
+        Destroy(handle);
+        return;
+    }
+    static_cast<Pool *>(pool)->Release(handle);
+}
+
+int FillPool(ApmPoolHandle pool) {
+    if (!pool) return webrtc::AudioProcessing::kNullPointerError;
+    return static_cast<Pool *>(pool)->Fill();
+}
+
+int pool_idle_handles(ApmPoolHandle pool) {
+    if (!pool) return 0;
+    return static_cast<Pool *>(pool)->IdleHandles();
+}
+
+} // extern "C"
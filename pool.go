@@ -0,0 +1,90 @@
+package apm
+
+/*
+#include <pool.h>
+*/
+import "C"
+import (
+	"fmt"
+)
+
+// Pool keeps pre-initialized handles built from one Config so that new
+// participants get a ready-to-use processor without building one. It is
+// safe for concurrent use; Close must not race with other calls.
+type Pool struct {
+	ptr C.ApmPoolHandle
+}
+
+// NewPool creates a pool and fills it with capacity idle handles
+func NewPool(config Config, capacity int) (*Pool, error) {
+	var errorCode C.int
+	ptr := C.CreatePool(parseConfig(config), C.int(capacity), &errorCode)
+	if ptr == nil {
+		return nil, fmt.Errorf("failed to create pool: error code %d", int(errorCode))
+	}
+
+	return &Pool{ptr: ptr}, nil
+}
+
+// Close destroys the pool and its idle handles. Handles still acquired stay
+// valid and must be released with Destroy.
+func (p *Pool) Close() {
+	if p.ptr != nil {
+		C.DestroyPool(p.ptr)
+		p.ptr = nil
+	}
+}
+
+// Acquire takes a handle from the pool, building a new one if it is empty
+func (p *Pool) Acquire() (*Handle, error) {
+	if p.ptr == nil {
+		return nil, fmt.Errorf("pool is closed")
+	}
+
+	var errorCode C.int
+	ptr := C.AcquireHandle(p.ptr, &errorCode)
+	if ptr == nil {
+		return nil, fmt.Errorf("failed to acquire audio processor: error code %d", int(errorCode))
+	}
+
+	return &Handle{ptr: ptr, numSamplesPerFrame: int(C.num_samples_per_frame(ptr))}, nil
+}
+
+// Release returns a handle obtained from Acquire to the pool, which resets it
+// in the next Fill, or in Acquire if no reset handle is ready. The handle must
+// not be used afterwards.
+func (p *Pool) Release(h *Handle) {
+	if h.ptr == nil {
+		return
+	}
+	if p.ptr == nil {
+		h.Destroy()
+		return
+	}
+
+	C.ReleaseHandle(p.ptr, h.ptr)
+	h.ptr = nil
+}
+
+// Fill resets released handles, then builds handles until the pool holds its
+// capacity of idle ones. Run it off the join path, e.g. from a background
+// goroutine.
+func (p *Pool) Fill() error {
+	if p.ptr == nil {
+		return fmt.Errorf("pool is closed")
+	}
+
+	if result := C.FillPool(p.ptr); C.is_success(result) == 0 {
+		return fmt.Errorf("failed to fill pool: error code %d", int(result))
+	}
+	return nil
+}
+
+// Idle returns the number of handles the pool holds for Acquire, including
+// released ones not reset yet
+func (p *Pool) Idle() int {
+	if p.ptr == nil {
+		return 0
+	}
+	return int(C.pool_idle_handles(p.ptr))
+}
@@ -0,0 +1,55 @@
+// pool.h - C interface to a pool of pre-initialized audio processors
+//
+// Building a processor allocates and initializes every submodule, which
+// dominates join latency when many participants arrive at once. A pool
+// builds processors ahead of time; acquiring one is a pointer pop, and
+// released processors are reset in place, off the releasing thread, and
+// reused.
+
+#ifndef APM_POOL_H
+#define APM_POOL_H
+
+#include <bridge.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Opaque handle to the pool
+typedef void *ApmPoolHandle;
+
+// Create a pool of processors built from apmConfig and fill it with capacity
+// idle processors.
+// Returns NULL on failure, sets error code
+ApmPoolHandle CreatePool(ApmConfig apmConfig, int capacity, int *error_code);
+
+// Destroy the pool and its idle processors. Processors still acquired are
+// owned by the caller and must be released to Destroy() instead.
+void DestroyPool(ApmPoolHandle pool);
+
+// Take a ready-to-use processor from the pool. If none is ready, a released
+// one is reset first, or if there is none either a new one is built, as
+// Create() would.
+// Returns NULL on failure, sets error code
+ApmHandle AcquireHandle(ApmPoolHandle pool, int *error_code);
+
+// Return a processor obtained from AcquireHandle(). It is kept for reuse and
+// reset to the pool's configuration by the next FillPool(), or destroyed if
+// the pool is already full.
+void ReleaseHandle(ApmPoolHandle pool, ApmHandle handle);
+
+// Reset the released processors, then build processors until the pool holds
+// capacity idle ones, e.g. from a background thread after a burst of joins or
+// leaves.
+// Returns 0 on success, error code on failure
+int FillPool(ApmPoolHandle pool);
+
+// Get the number of idle processors in the pool, including released ones not
+// reset yet
+int pool_idle_handles(ApmPoolHandle pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APM_POOL_H
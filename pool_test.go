@@ -0,0 +1,239 @@
+package apm
+
+import (
+	"testing"
+	"time"
+)
+
+var poolTestConfig = Config{
+	CaptureChannels: 1,
+	RenderChannels:  1,
+	EchoCancellation: EchoCancellationConfig{
+		Enabled: true,
+	},
+	NoiseSuppression: NoiseSuppressionConfig{
+		Enabled:          true,
+		SuppressionLevel: NsLevelHigh,
+	},
+	GainControl: GainControlConfig{
+		Enabled:    true,
+		HeadroomDB: 5,
+		MaxGainDB:  30,
+	},
+	HighPassFilterEnabled: true,
+}
+
+// processAndCompare runs the same frames through a and b and fails on the
+// first differing sample
+func processAndCompare(t *testing.T, a, b *Handle) {
+	t.Helper()
+	for i := 0; i < 20; i++ {
+		render := generateSineWave(300, 0.3, NumSamplesPerFrame)
+		capture := generateSineWave(440, 0.5, NumSamplesPerFrame)
+		got := append([]float32(nil), capture...)
+		want := append([]float32(nil), capture...)
+		if err := a.ProcessRenderFrame(append([]float32(nil), render...), 1); err != nil {
+			t.Fatalf("ProcessRenderFrame failed: %v", err)
+		}
+		if err := b.ProcessRenderFrame(append([]float32(nil), render...), 1); err != nil {
+			t.Fatalf("ProcessRenderFrame failed: %v", err)
+		}
+		if err := a.ProcessCaptureFrame(got, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed: %v", err)
+		}
+		if err := b.ProcessCaptureFrame(want, 1); err != nil {
+			t.Fatalf("ProcessCaptureFrame failed: %v", err)
+		}
+		for j := range want {
+			if got[j] != want[j] {
+				t.Fatalf("frame %d sample %d: %v, want %v", i, j, got[j], want[j])
+			}
+		}
+	}
+}
+
+func TestPoolAcquireRelease(t *testing.T) {
+	p, err := NewPool(poolTestConfig, 2)
+	if err != nil {
+		t.Fatalf("NewPool failed: %v", err)
+	}
+	defer p.Close()
+
+	if p.Idle() != 2 {
+		t.Fatalf("Idle() = %d, want 2", p.Idle())
+	}
+
+	handles := make([]*Handle, 3)
+	for i := range handles {
+		handles[i], err = p.Acquire()
+		if err != nil {
+			t.Fatalf("Acquire failed: %v", err)
+		}
+	}
+	if p.Idle() != 0 {
+		t.Errorf("Idle() = %d after draining, want 0", p.Idle())
+	}
+
+	for _, h := range handles {
+		p.Release(h)
+	}
+	if p.Idle() != 2 {
+		t.Errorf("Idle() = %d after releasing 3 handles, want capacity 2", p.Idle())
+	}
+
+	if _, err := p.Acquire(); err != nil {
+		t.Fatalf("Acquire failed: %v", err)
+	}
+	if err := p.Fill(); err != nil {
+		t.Fatalf("Fill failed: %v", err)
+	}
+	if p.Idle() != 2 {
+		t.Errorf("Idle() = %d after Fill, want 2", p.Idle())
+	}
+}
+
+func TestPoolReleasedHandleMatchesFresh(t *testing.T) {
+	for _, fill := range []bool{false, true} {
+		name := "reset by Acquire"
+		if fill {
+			name = "reset by Fill"
+		}
+		t.Run(name, func(t *testing.T) {
+			p, err := NewPool(poolTestConfig, 1)
+			if err != nil {
+				t.Fatalf("NewPool failed: %v", err)
+			}
+			defer p.Close()
+
+			// Dirty a handle's state and config, leave a gain change queued,
+			// then hand it back
+			h, err := p.Acquire()
+			if err != nil {
+				t.Fatalf("Acquire failed: %v", err)
+			}
+			changed := poolTestConfig
+			changed.NoiseSuppression.SuppressionLevel = NsLevelLow
+			changed.GainControl.GainDB = 6
+			h.ApplyConfig(changed)
+			h.SetStreamDelayMs(80)
+			frame := make([]float32, NumSamplesPerFrame)
+			for i := 0; i < 20; i++ {
+				copy(frame, generateSineWave(440, 0.5, NumSamplesPerFrame))
+				if err := h.ProcessCaptureFrame(frame, 1); err != nil {
+					t.Fatalf("ProcessCaptureFrame failed: %v", err)
+				}
+			}
+			changed.GainControl.GainDB = 12
+			h.ApplyConfig(changed)
+			p.Release(h)
+			if fill {
+				if err := p.Fill(); err != nil {
+					t.Fatalf("Fill failed: %v", err)
+				}
+			}
+			if p.Idle() != 1 {
+				t.Errorf("Idle() = %d after Release, want 1", p.Idle())
+			}
+
+			reused, err := p.Acquire()
+			if err != nil {
+				t.Fatalf("Acquire failed: %v", err)
+			}
+			defer reused.Destroy()
+			fresh, err := Create(poolTestConfig)
+			if err != nil {
+				t.Fatalf("Create failed: %v", err)
+			}
+			defer fresh.Destroy()
+			processAndCompare(t, reused, fresh)
+		})
+	}
+}
+
+func TestHandleCreateLike(t *testing.T) {
+	prototype, err := Create(poolTestConfig)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer prototype.Destroy()
+	prototype.SetStreamDelayMs(40)
+
+	like, err := prototype.CreateLike()
+	if err != nil {
+		t.Fatalf("CreateLike failed: %v", err)
+	}
+	defer like.Destroy()
+
+	if like.NumSamplesPerFrame() != prototype.NumSamplesPerFrame() {
+		t.Errorf("NumSamplesPerFrame() = %d, want %d", like.NumSamplesPerFrame(), prototype.NumSamplesPerFrame())
+	}
+	if like.StreamDelayMs() != 40 {
+		t.Errorf("GetStreamDelayMs() = %d, want 40", like.StreamDelayMs())
+	}
+
+	fresh, err := Create(poolTestConfig)
+	if err != nil {
+		t.Fatalf("Create failed: %v", err)
+	}
+	defer fresh.Destroy()
+	fresh.SetStreamDelayMs(40)
+	processAndCompare(t, like, fresh)
+}
+
+// =============================================================================
+// Benchmarks
+// =============================================================================
+
+func BenchmarkCreateDestroy(b *testing.B) {
+	for i := 0; i < b.N; i++ {
+		h, err := Create(poolTestConfig)
+		if err != nil {
+			b.Fatalf("Create failed: %v", err)
+		}
+		h.Destroy()
+	}
+}
+
+func BenchmarkCreateLikeDestroy(b *testing.B) {
+	prototype, err := Create(poolTestConfig)
+	if err != nil {
+		b.Fatalf("Create failed: %v", err)
+	}
+	defer prototype.Destroy()
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		h, err := prototype.CreateLike()
+		if err != nil {
+			b.Fatalf("CreateLike failed: %v", err)
+		}
+		h.Destroy()
+	}
+}
+
+// BenchmarkPoolAcquireRelease measures a full join/leave cycle. The join
+// path alone, the time Acquire takes, is reported as ns/acquire; the rest is
+// the reset done by Fill, which callers can keep off the join path.
+func BenchmarkPoolAcquireRelease(b *testing.B) {
+	p, err := NewPool(poolTestConfig, 1)
+	if err != nil {
+		b.Fatalf("NewPool failed: %v", err)
+	}
+	defer p.Close()
+
+	var acquire time.Duration
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		start := time.Now()
+		h, err := p.Acquire()
+		acquire += time.Since(start)
+		if err != nil {
+			b.Fatalf("Acquire failed: %v", err)
+		}
+		p.Release(h)
+		if err := p.Fill(); err != nil {
+			b.Fatalf("Fill failed: %v", err)
+		}
+	}
+	b.ReportMetric(float64(acquire.Nanoseconds())/float64(b.N), "ns/acquire")
+}